@@ -13,8 +13,11 @@
  * **Key Algorithms:**
  * - Survivor-centric assignment: Optimize wait times for people in need
  * - Drone-centric assignment: Maximize drone utilization efficiency
+ * - Batch assignment: Minimum total distance matching per cycle
+ * - Partitioned assignment: Drone-centric, in parallel over map regions
  * - Manhattan distance calculations for grid-based pathfinding
  * - Real-time mission completion detection and status management
+ * - Event-driven wake-ups that re-plan only around what changed
  * 
  * **Performance Features:**
  * - Sub-millisecond response times for mission assignments
@@ -30,6 +33,10 @@
 
 #define _POSIX_C_SOURCE 199309L
 #include "headers/ai.h"
+#include "headers/ai_events.h"
+#include "headers/ai_partition.h"
+#include "headers/assignment.h"
+#include "headers/mission_trace.h"
 #include "headers/server_throughput.h"
 #include <limits.h>
 #include <stdio.h>
@@ -41,6 +48,9 @@
 #include <json-c/json.h>
 #include <sys/socket.h>
 
+AiStrategy ai_strategy = AI_STRATEGY_DRONE_CENTRIC;
+int ai_event_driven = 1;
+
 /**
  * @brief Calculate Manhattan distance between two coordinates
  * 
@@ -56,145 +66,344 @@ int calculate_distance(Coord a, Coord b)
 }
 
 /**
- * @brief Assign a mission to a drone to rescue a specific survivor
+ * @brief Claim a survivor for a drone and queue the mission message
  * 
- * Updates drone and survivor status and sends mission assignment
- * to networked drone clients
+ * Body of mission_batch_assign() and mission_batch_claim(). Local drones
+ * are assigned completely here; networked drones are pinned and their
+ * message is left in @p batch for mission_batch_flush().
  * 
+ * @param batch Batch receiving the message of a networked drone
  * @param drone Pointer to the drone to assign
  * @param survivor_index Index of the survivor to rescue
+ * @param report_conflict Count a survivor or drone that is no longer available as an error
+ * @return 1 if assigned, 0 if the drone or survivor was taken, -1 on invalid arguments or allocation failure
  */
 // clang-format off
-void assign_mission(Drone *drone, int survivor_index)
+static int reserve_mission(MissionBatch *batch, Drone *drone, int survivor_index, int report_conflict)
 // clang-format on
 {
-    if (!drone || survivor_index < 0 || survivor_index >= num_survivors)
+    if (!batch || !drone || survivor_index < 0 || survivor_index >= survivor_store.count)
     {
         fprintf(stderr, "Invalid drone or survivor index in assign_mission\n");
         perf_record_error();
-        return;
+        return -1;
     }
 
     // Measure mission assignment response time
     struct timespec start_time, end_time;
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-    // Lock both drone and survivor mutex to prevent race conditions
+    // Room for the message first, so a claim never has to be undone for lack of it
+    if (drone->socket > 0 && batch->count == batch->capacity)
+    {
+        int capacity = batch->capacity > 0 ? batch->capacity * 2 : MISSION_BATCH_INITIAL;
+        // clang-format off
+        MissionSend *sends = realloc(batch->sends, capacity * sizeof(MissionSend));
+        // clang-format on
+        if (!sends)
+        {
+            perror("Failed to queue mission assignment");
+            perf_record_error();
+            return -1;
+        }
+        batch->sends = sends;
+        batch->capacity = capacity;
+    }
+
+    // Claim the survivor by compare-and-swap; only the drone needs its lock
     pthread_mutex_lock(&drone->lock);
-    pthread_mutex_lock(&survivors_mutex);
+    if (drone->status != IDLE || !survivor_claim(survivor_index))
+    {
+        int drone_status = drone->status;
+        pthread_mutex_unlock(&drone->lock);
+        if (report_conflict)
+        {
+            // Mission assignment failed - record as error
+            perf_record_error();
+            printf("Failed to assign mission: drone %d status=%d, survivor %d status=%d\n",
+                   drone->id,
+                   drone_status,
+                   survivor_index,
+                   survivor_store.status[survivor_index]);
+        }
+        return 0;
+    }
 
-    // Only proceed if the survivor still needs help and drone is idle
-    if (survivor_array[survivor_index].status == 0 && drone->status == IDLE)
+    // Set drone target to survivor position and update its status
+    drone->target = survivor_store_coord(&survivor_store, survivor_index);
+    drone_set_status(drone, ON_MISSION);
+    survivor_store.times[survivor_index].assigned_ns = mission_trace_now();
+    survivor_store.times[survivor_index].sent_ns = 0;
+
+    // Set timestamp
+    time_t t;
+    time(&t);
+    localtime_r(&t, &drone->last_update);
+
+    if (drone->socket <= 0)
     {
-        // Set drone target to survivor position
-        drone->target.x = survivor_array[survivor_index].coord.x;
-        drone->target.y = survivor_array[survivor_index].coord.y;
+        // For local drones (not networked), the assignment is the delivery
+        survivor_store.times[survivor_index].sent_ns = survivor_store.times[survivor_index].assigned_ns;
+        int drone_id = drone->id;
+        pthread_mutex_unlock(&drone->lock);
+
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        double response_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
+                               (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
+        perf_record_latency(PERF_OP_ASSIGN_MISSION, response_time);
+
+        printf("Local mission assigned to drone %d for survivor %d (%.2fms)\n",
+               drone_id,
+               survivor_index,
+               response_time);
+        return 1;
+    }
 
-        // Update drone status
-        drone->status = ON_MISSION;
+    // Copy what the message needs, so it is built and sent without any lock;
+    // the pin keeps unregister_drone() from freeing the drone until then
+    // clang-format off
+    MissionSend *send = &batch->sends[batch->count++];
+    // clang-format on
+    send->drone = drone;
+    send->survivor_index = survivor_index;
+    send->socket = drone->socket;
+    send->encoding = drone->encoding;
+    send->drone_id = drone->id;
+    send->target = drone->target;
+    send->start_time = start_time;
+    drone->pins++;
+    pthread_mutex_unlock(&drone->lock);
+    return 1;
+}
 
-        // Update survivor status to "being helped"
-        survivor_array[survivor_index].status = 1;
+/**
+ * @brief Build and send one queued mission, rolling it back if the send fails
+ * 
+ * @param send Mission queued by reserve_mission(); its drone is unpinned here
+ * @return 1 if sent, -1 if the send failed and the assignment was rolled back
+ */
+// clang-format off
+static int send_mission(const MissionSend *send)
+// clang-format on
+{
+    struct timespec end_time;
+    // clang-format off
+    Drone *drone = send->drone;
+    // clang-format on
+    int survivor_index = send->survivor_index;
 
-        // Set timestamp
-        time_t t;
-        time(&t);
-        localtime_r(&t, &drone->last_update);
+    // Create a mission assignment message in the drone's encoding
+    // clang-format off
+    char wire_buffer[WIRE_MAX_MESSAGE_SIZE];
+    struct json_object *mission = NULL;
+    const char *mission_str;
+    size_t mission_size;
 
-        // Check if this is a networked drone client
-        if (drone->socket > 0)
-        {
-            // Create a mission assignment message according to the protocol
-            // clang-format off
-            struct json_object *mission = json_object_new_object();
-            json_object_object_add(mission, "type", json_object_new_string("ASSIGN_MISSION"));
-
-            // Generate a unique mission ID
-            char mission_id[16];
-            snprintf(mission_id, sizeof(mission_id), "M%d", survivor_index);
-            json_object_object_add(mission, "mission_id", json_object_new_string(mission_id));
-
-            // Set priority (based on distance or other factors)
-            json_object_object_add(mission, "priority", json_object_new_string("high"));
-
-            // Target coordinates
-            struct json_object *target = json_object_new_object();
-            json_object_object_add(target, "x", json_object_new_int(survivor_array[survivor_index].coord.x));
-            json_object_object_add(target, "y", json_object_new_int(survivor_array[survivor_index].coord.y));
-            json_object_object_add(mission, "target", target);
-
-            // Set expiry time (one hour from now)
-            json_object_object_add(mission, "expiry", json_object_new_int(time(NULL) + 3600));
-
-            // Send the mission to the drone client
-            const char *mission_str = json_object_to_json_string(mission);
-            size_t mission_size = strlen(mission_str);
-            ssize_t bytes_sent = send(drone->socket, mission_str, mission_size, 0);
-            // clang-format on
+    if (send->encoding == WIRE_ENCODING_BINARY)
+    {
+        WireAssignment assignment;
+        assignment.mission_id = (unsigned int)survivor_index;
+        assignment.target = send->target;
+        assignment.expiry = time(NULL) + 3600;
+        mission_size = wire_encode_assignment(wire_buffer, &assignment);
+        mission_str = wire_buffer;
+    }
+    else
+    {
+        mission = json_object_new_object();
+        json_object_object_add(mission, "type", json_object_new_string("ASSIGN_MISSION"));
 
-            if (bytes_sent > 0)
-            {
-                perf_record_mission_assigned(bytes_sent);
-
-                // Record mission assignment response time
-                clock_gettime(CLOCK_MONOTONIC, &end_time);
-                double response_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
-                                       (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-                perf_record_response_time(response_time);
-
-                printf("Mission assigned to drone %d for survivor %d (%zd bytes, %.2fms)\n",
-                       drone->id,
-                       survivor_index,
-                       bytes_sent,
-                       response_time);
-            }
-            else
-            {
-                perror("Failed to send mission assignment");
-                perf_record_error();
+        // Generate a unique mission ID
+        char mission_id[16];
+        snprintf(mission_id, sizeof(mission_id), "M%d", survivor_index);
+        json_object_object_add(mission, "mission_id", json_object_new_string(mission_id));
 
-                // Rollback the status changes if sending failed
-                drone->status = IDLE;
-                survivor_array[survivor_index].status = 0;
-            }
+        // Set priority (based on distance or other factors)
+        json_object_object_add(mission, "priority", json_object_new_string("high"));
 
-            // Free the JSON object
-            json_object_put(mission);
-        }
-        else
-        {
-            // For local drones (not networked), just record the assignment
-            clock_gettime(CLOCK_MONOTONIC, &end_time);
-            double response_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
-                                   (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-            perf_record_response_time(response_time);
+        // Target coordinates
+        struct json_object *target = json_object_new_object();
+        json_object_object_add(target, "x", json_object_new_int(send->target.x));
+        json_object_object_add(target, "y", json_object_new_int(send->target.y));
+        json_object_object_add(mission, "target", target);
 
-            printf("Local mission assigned to drone %d for survivor %d (%.2fms)\n",
-                   drone->id,
-                   survivor_index,
-                   response_time);
-        }
+        // Set expiry time (one hour from now)
+        json_object_object_add(mission, "expiry", json_object_new_int(time(NULL) + 3600));
+
+        mission_str = json_object_to_json_string(mission);
+        mission_size = strlen(mission_str);
+    }
+    // clang-format on
+
+    // Send the mission to the drone client; a full socket buffer blocks only this thread
+    ssize_t bytes_sent = drone_send_all(send->socket, mission_str, mission_size);
+    uint64_t sent_ns = mission_trace_now();
+    int result = 1;
+
+    if (bytes_sent > 0)
+    {
+        perf_record_mission_assigned(bytes_sent);
+
+        // Record mission assignment response time
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        double response_time = (end_time.tv_sec - send->start_time.tv_sec) * 1000.0 +
+                               (end_time.tv_nsec - send->start_time.tv_nsec) / 1000000.0;
+        perf_record_latency(PERF_OP_ASSIGN_MISSION, response_time);
+
+        printf("Mission assigned to drone %d for survivor %d (%zd bytes, %.2fms)\n",
+               send->drone_id,
+               survivor_index,
+               bytes_sent,
+               response_time);
     }
     else
     {
-        // Mission assignment failed - record as error
+        perror("Failed to send mission assignment");
         perf_record_error();
-        printf("Failed to assign mission: drone %d status=%d, survivor %d status=%d\n",
-               drone->id,
-               drone->status,
-               survivor_index,
-               survivor_index < num_survivors ? survivor_array[survivor_index].status : -1);
+        result = -1;
     }
 
-    // Unlock mutexes
-    pthread_mutex_unlock(&survivors_mutex);
+    // Stamp the delivery or roll the status changes back, unless the drone
+    // has moved on already, then let unregister_drone() free the drone. The
+    // completion handler takes the drone lock before tracing, so a rescue
+    // reported before this stamp is traced with sent_ns 0 and no dispatch
+    // or travel stage, instead of counting the send as travel.
+    pthread_mutex_lock(&drone->lock);
+    int same_mission =
+        drone->status == ON_MISSION && drone->target.x == send->target.x && drone->target.y == send->target.y;
+    if (same_mission && result > 0)
+        survivor_store.times[survivor_index].sent_ns = sent_ns;
+    else if (same_mission)
+        drone_set_status(drone, IDLE);
+    if (--drone->pins == 0)
+        pthread_cond_broadcast(&drone->unpinned);
     pthread_mutex_unlock(&drone->lock);
+    if (result < 0)
+        survivor_release(survivor_index);
+
+    // Free the JSON object (NULL for binary drones)
+    if (mission)
+        json_object_put(mission);
+    return result;
+}
+
+/**
+ * @brief Claim a survivor for a drone, leaving a networked drone's message in a batch
+ * 
+ * @param batch Batch to queue the message in
+ * @param drone Pointer to the drone to assign
+ * @param survivor_index Index of the survivor to rescue
+ * @return 1 if assigned, 0 if the drone or survivor was taken, -1 on failure
+ */
+// clang-format off
+int mission_batch_assign(MissionBatch *batch, Drone *drone, int survivor_index)
+// clang-format on
+{
+    return reserve_mission(batch, drone, survivor_index, 1);
+}
+
+/**
+ * @brief Like mission_batch_assign(), without reporting a lost claim
+ * 
+ * @param batch Batch to queue the message in
+ * @param drone Pointer to the drone to assign
+ * @param survivor_index Index of the survivor to rescue
+ * @return 1 if assigned, 0 if the drone or survivor was taken, -1 on failure
+ */
+// clang-format off
+int mission_batch_claim(MissionBatch *batch, Drone *drone, int survivor_index)
+// clang-format on
+{
+    return reserve_mission(batch, drone, survivor_index, 0);
+}
+
+/**
+ * @brief Send every mission queued in a batch and empty it
+ * 
+ * @param batch Batch filled by mission_batch_assign() or mission_batch_claim()
+ * @return Number of sends that failed and were rolled back
+ */
+// clang-format off
+int mission_batch_flush(MissionBatch *batch)
+// clang-format on
+{
+    int failed = 0;
+    for (int i = 0; i < batch->count; i++)
+    {
+        if (send_mission(&batch->sends[i]) < 0)
+            failed++;
+    }
+    batch->count = 0;
+    return failed;
+}
+
+/**
+ * @brief Release the memory of an empty batch
+ * 
+ * @param batch Batch already flushed with mission_batch_flush()
+ */
+// clang-format off
+void mission_batch_destroy(MissionBatch *batch)
+// clang-format on
+{
+    free(batch->sends);
+    memset(batch, 0, sizeof(MissionBatch));
+}
+
+/**
+ * @brief Assign and send a mission in one call
+ * 
+ * Body of assign_mission() and claim_mission(), with a one-slot batch on
+ * the stack
+ */
+// clang-format off
+static int assign_mission_now(Drone *drone, int survivor_index, int report_conflict)
+// clang-format on
+{
+    MissionSend slot;
+    MissionBatch batch = { &slot, 0, 1 };
+    int result = reserve_mission(&batch, drone, survivor_index, report_conflict);
+    if (result == 1 && mission_batch_flush(&batch) > 0)
+        result = -1;
+    return result;
+}
+
+/**
+ * @brief Assign a mission to a drone to rescue a specific survivor
+ * 
+ * Updates drone and survivor status and sends mission assignment
+ * to networked drone clients
+ * 
+ * @param drone Pointer to the drone to assign
+ * @param survivor_index Index of the survivor to rescue
+ * @return 1 if assigned, 0 if the drone or survivor was taken, -1 on failure
+ */
+// clang-format off
+int assign_mission(Drone *drone, int survivor_index)
+// clang-format on
+{
+    return assign_mission_now(drone, survivor_index, 1);
+}
+
+/**
+ * @brief Assign a mission if the survivor is still waiting, without reporting a lost claim
+ * 
+ * @param drone Pointer to the drone to assign
+ * @param survivor_index Index of the survivor to rescue
+ * @return 1 if assigned, 0 if the drone or survivor was taken, -1 on failure
+ */
+// clang-format off
+int claim_mission(Drone *drone, int survivor_index)
+// clang-format on
+{
+    return assign_mission_now(drone, survivor_index, 0);
 }
 
 /**
  * @brief Find the closest idle drone to a specific survivor
  * 
- * Searches through all drones to find the closest one that is idle
+ * Queries idle_drone_index, which only visits the buckets around the
+ * survivor instead of locking every drone in the list
  * 
  * @param survivor_index Index of the survivor
  * @return Pointer to the closest idle drone, or NULL if none available
@@ -203,103 +412,224 @@ void assign_mission(Drone *drone, int survivor_index)
 Drone *find_closest_idle_drone(int survivor_index)
 // clang-format on
 {
-    if (survivor_index < 0 || survivor_index >= num_survivors)
+    if (survivor_index < 0 || survivor_index >= survivor_store.count)
     {
         fprintf(stderr, "Invalid survivor index in find_closest_idle_drone\n");
         perf_record_error();
         return NULL;
     }
-    //clang-format on
-    Drone *closest_drone = NULL;
-    int min_distance = INT_MAX;
 
     pthread_mutex_lock(&survivors_mutex);
-    Coord survivor_pos = survivor_array[survivor_index].coord;
+    Coord survivor_pos = survivor_store_coord(&survivor_store, survivor_index);
     pthread_mutex_unlock(&survivors_mutex);
 
-    // Lock the drones list for iteration
-    pthread_mutex_lock(&drones->lock);
+    // clang-format off
+    void *closest_drone = NULL;
+    // clang-format on
+    if (spatial_index_nearest(&idle_drone_index, survivor_pos, &closest_drone) < 0)
+    {
+        return NULL;
+    }
+
+    return (Drone *)closest_drone;
+}
+
+/**
+ * @brief Find the closest waiting survivor to a specific drone
+ * 
+ * Queries waiting_survivor_index, which only visits the buckets around
+ * the drone and does not hold survivors_mutex while searching
+ * 
+ * @param drone Pointer to the drone
+ * @return Index of the closest waiting survivor, or -1 if none available
+ */
+// clang-format off
+int find_closest_waiting_survivor(Drone *drone)
+// clang-format on
+{
+    if (!drone)
+    {
+        fprintf(stderr, "Invalid drone pointer in find_closest_waiting_survivor\n");
+        perf_record_error();
+        return -1;
+    }
+
+    // Lock the drone to get its current position
+    pthread_mutex_lock(&drone->lock);
+    Coord drone_pos = drone->coord;
+    pthread_mutex_unlock(&drone->lock);
+
+    return spatial_index_nearest(&waiting_survivor_index, drone_pos, NULL);
+}
+
+/**
+ * @brief One assignment pass of the drone-centric strategy
+ * 
+ * For each idle drone, assigns the closest waiting survivor
+ * 
+ * @return Number of missions assigned
+ */
+int run_drone_centric_cycle(void)
+{
+    int missions_assigned = 0;
+    MissionBatch batch = { 0 };
 
-    // Iterate through all drones in the list to find the closest idle one
+    pthread_mutex_lock(&drones->lock);
+    // clang-format off
     Node *current = drones->head;
-    while (current != NULL)
     // clang-format on
+    while (current != NULL)
     {
-        //clang-format off
+        // clang-format off
         Drone *d = (Drone *)current->data;
-        //clang-format on
+        // clang-format on
         // Lock this specific drone to check its status
         pthread_mutex_lock(&d->lock);
 
+        // Only consider idle drones
         if (d->status == IDLE)
         {
-            int dist = calculate_distance(d->coord, survivor_pos);
-            if (dist < min_distance)
+            // Unlock drone before searching for survivor to avoid deadlocks
+            pthread_mutex_unlock(&d->lock);
+
+            // Find the closest waiting survivor
+            int survivor_index = find_closest_waiting_survivor(d);
+
+            // If a waiting survivor was found, assign the drone to help
+            if (survivor_index >= 0 && mission_batch_assign(&batch, d, survivor_index) == 1)
             {
-                min_distance = dist;
-                closest_drone = d;
+                missions_assigned++;
+                printf("Drone %d assigned to closest survivor %d\n", d->id, survivor_index);
             }
         }
+        else
+        {
+            pthread_mutex_unlock(&d->lock);
+        }
 
-        pthread_mutex_unlock(&d->lock);
         current = current->next;
     }
 
     pthread_mutex_unlock(&drones->lock);
 
-    return closest_drone;
+    // Send with drones->lock released, so a full socket holds up no one else
+    missions_assigned -= mission_batch_flush(&batch);
+    mission_batch_destroy(&batch);
+    return missions_assigned;
 }
 
 /**
- * @brief Find the closest waiting survivor to a specific drone
+ * @brief Re-plan around one event
  * 
- * Searches through all survivors to find the closest one waiting for help
+ * Pairs the waiting survivor closest to @p origin with the idle drone
+ * closest to it until one side runs out
  * 
- * @param drone Pointer to the drone
- * @return Index of the closest waiting survivor, or -1 if none available
+ * @param origin Cell where the event happened
+ * @return Number of missions assigned
  */
-// clang-format off
-int find_closest_waiting_survivor(Drone *drone)
-// clang-format on
+int run_event_assignment(Coord origin)
 {
-    if (!drone)
+    int missions_assigned = 0;
+    MissionBatch batch = { 0 };
+
+    // Held like in run_drone_centric_cycle(), so no drone is freed while we use it
+    pthread_mutex_lock(&drones->lock);
+    while (1)
     {
-        fprintf(stderr, "Invalid drone pointer in find_closest_waiting_survivor\n");
-        perf_record_error();
-        return -1;
+        int survivor_index = spatial_index_nearest(&waiting_survivor_index, origin, NULL);
+        if (survivor_index < 0)
+            break;
+
+        // clang-format off
+        Drone *drone = find_closest_idle_drone(survivor_index);
+        // clang-format on
+        if (drone == NULL)
+            break;
+
+        int result = mission_batch_assign(&batch, drone, survivor_index);
+        if (result == 1)
+        {
+            missions_assigned++;
+        }
+        else if (result < 0)
+        {
+            // Nothing was claimed; the same pair would come up again
+            break;
+        }
+        // Otherwise the drone or survivor was taken meanwhile and is no longer indexed: try the next pair
     }
+    pthread_mutex_unlock(&drones->lock);
 
-    int closest_survivor_index = -1;
-    int min_distance = INT_MAX;
+    missions_assigned -= mission_batch_flush(&batch);
+    mission_batch_destroy(&batch);
+    return missions_assigned;
+}
 
-    // Lock the drone to get its current position
-    pthread_mutex_lock(&drone->lock);
-    Coord drone_pos = drone->coord;
-    pthread_mutex_unlock(&drone->lock);
+/**
+ * @brief Event-driven loop shared by the AI controllers
+ * 
+ * Sleeps on ai_events and runs one planning step per wake-up. Returns
+ * only if waiting fails, after clearing ai_event_driven so the caller
+ * falls back to polling.
+ * 
+ * @param full_pass Assignment pass of the strategy, run at start and after lost events
+ * @param per_event Non-zero to re-plan around each event with
+ *                  run_event_assignment(), zero to run @p full_pass per wake-up
+ */
+static void run_event_driven_loop(int (*full_pass)(void), int per_event)
+{
+    static AiEvent events[AI_EVENT_CAPACITY];
 
-    // Lock the survivors mutex for iteration
-    pthread_mutex_lock(&survivors_mutex);
+    printf("AI controller is event-driven: waking on new survivors and idle drones\n");
+
+    // Catch up with everything that happened before the first wait
+    full_pass();
 
-    // Iterate through all survivors to find the closest waiting one
-    for (int i = 0; i < num_survivors; i++)
+    while (1)
     {
-        // Only consider survivors who are waiting for help (status 0)
-        if (survivor_array[i].status == 0)
+        int overflowed = 0;
+        int count = ai_events_take(&ai_events, events, &overflowed);
+        if (count < 0)
         {
-            Coord survivor_pos = survivor_array[i].coord;
-            int dist = calculate_distance(drone_pos, survivor_pos);
+            perror("Failed to wait for AI events; polling every second instead");
+            perf_record_error();
+            ai_event_driven = 0;
+            return;
+        }
+        if (count == 0 && !overflowed)
+            continue;
+
+        struct timespec ai_start, ai_end;
+        clock_gettime(CLOCK_MONOTONIC, &ai_start);
 
-            if (dist < min_distance)
+        int missions_assigned = 0;
+        if (overflowed || !per_event)
+        {
+            if (overflowed)
+                printf("AI event queue overflowed; running a full pass\n");
+            missions_assigned = full_pass();
+        }
+        else
+        {
+            for (int i = 0; i < count; i++)
             {
-                min_distance = dist;
-                closest_survivor_index = i;
+                missions_assigned += run_event_assignment(events[i].coord);
             }
         }
-    }
 
-    pthread_mutex_unlock(&survivors_mutex);
+        clock_gettime(CLOCK_MONOTONIC, &ai_end);
+        double ai_processing_time =
+            (ai_end.tv_sec - ai_start.tv_sec) * 1000.0 + (ai_end.tv_nsec - ai_start.tv_nsec) / 1000000.0;
+        perf_record_latency(PERF_OP_AI_CYCLE, ai_processing_time);
 
-    return closest_survivor_index;
+        if (missions_assigned > 0)
+        {
+            printf("AI woke for %d event(s): assigned %d missions in %.2fms\n",
+                   count,
+                   missions_assigned,
+                   ai_processing_time);
+        }
+    }
 }
 
 /**
@@ -328,11 +658,15 @@ void *drone_centric_ai_controller(void *args)
     pthread_mutex_unlock(&drones->lock);
 
     pthread_mutex_lock(&survivors_mutex);
-    int initial_survivor_count = num_survivors;
+    int initial_survivor_count = survivor_store.count;
     pthread_mutex_unlock(&survivors_mutex);
 
     printf("AI Controller: Initial count - Drones: %d, Survivors: %d\n", initial_drone_count, initial_survivor_count);
 
+    // Returns only if waiting for events fails; poll from then on
+    if (ai_event_driven)
+        run_event_driven_loop(run_drone_centric_cycle, 1);
+
     int ai_cycle_count = 0;
 
     while (1)
@@ -347,33 +681,9 @@ void *drone_centric_ai_controller(void *args)
             clock_gettime(CLOCK_MONOTONIC, &ai_start);
         }
 
-        // Debug: Count survivors that are waiting for help
-        int waiting_survivors = 0;
-        pthread_mutex_lock(&survivors_mutex);
-        for (int i = 0; i < num_survivors; i++)
-        {
-            if (survivor_array[i].status == 0)
-            {
-                waiting_survivors++;
-            }
-        }
-        pthread_mutex_unlock(&survivors_mutex);
-
-        // Debug: Count idle drones
-        int idle_drone_count = 0;
-        pthread_mutex_lock(&drones->lock);
-        Node *count_current = drones->head;
-        while (count_current != NULL)
-        {
-            Drone *d = (Drone *)count_current->data;
-            pthread_mutex_lock(&d->lock);
-            if (d->status == IDLE)
-            {
-                idle_drone_count++;
-            }
-            pthread_mutex_unlock(&d->lock);
-            count_current = count_current->next;
-        }
+        // Both counts come from the spatial indexes, without scanning
+        int waiting_survivors = spatial_index_count(&waiting_survivor_index);
+        int idle_drone_count = spatial_index_count(&idle_drone_index);
 
         // Only print debug info if there are both idle drones and waiting survivors
         if (idle_drone_count > 0 && waiting_survivors > 0)
@@ -381,58 +691,278 @@ void *drone_centric_ai_controller(void *args)
             printf(
                 "AI Controller: Found %d idle drones and %d waiting survivors\n", idle_drone_count, waiting_survivors);
         }
-        pthread_mutex_unlock(&drones->lock);
 
         // First phase: For each idle drone, find the closest survivor and assign a mission
-        pthread_mutex_lock(&drones->lock);
+        missions_assigned = run_drone_centric_cycle();
+
+        // Record AI processing performance every 10 cycles
+        if (ai_cycle_count % 10 == 0) {
+            clock_gettime(CLOCK_MONOTONIC, &ai_end);
+            double ai_processing_time = (ai_end.tv_sec - ai_start.tv_sec) * 1000.0 + 
+                                       (ai_end.tv_nsec - ai_start.tv_nsec) / 1000000.0;
+            perf_record_latency(PERF_OP_AI_CYCLE, ai_processing_time);
+            
+            if (missions_assigned > 0 || (idle_drone_count > 0 && waiting_survivors > 0)) {
+                printf("AI cycle %d: Assigned %d missions in %.2fms\n", 
+                       ai_cycle_count, missions_assigned, ai_processing_time);
+            }
+        }
+
+        // Sleep to avoid excessive CPU usage
+        sleep(1);
+    }
+
+    return NULL;
+}
+
+/** @brief qsort and bsearch comparison of two ints */
+static int compare_ints(const void *a, const void *b)
+{
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief One assignment pass of the batch strategy
+ * 
+ * Matches all idle drones to waiting survivors at once so that the total
+ * distance travelled is minimal, then assigns the matched pairs
+ * 
+ * @return Number of missions assigned
+ */
+int run_batch_assignment_cycle(void)
+{
+    int missions_assigned = 0;
+    MissionBatch batch = { 0 };
+
+    pthread_mutex_lock(&drones->lock);
+
+    int capacity = drones->number_of_elements;
+    if (capacity == 0 || spatial_index_count(&waiting_survivor_index) == 0)
+    {
+        pthread_mutex_unlock(&drones->lock);
+        return 0;
+    }
+
+    // clang-format off
+    Drone **idle = malloc(capacity * sizeof(Drone *));
+    int *row_start = malloc((capacity + 1) * sizeof(int));
+    int *row_to_col = malloc(capacity * sizeof(int));
+    AssignmentEdge *edges = malloc(capacity * AI_BATCH_CANDIDATES * sizeof(AssignmentEdge));
+    int *col_survivor = malloc(capacity * AI_BATCH_CANDIDATES * sizeof(int));
+    // clang-format on
+    if (!idle || !row_start || !row_to_col || !edges || !col_survivor)
+    {
+        perror("Failed to allocate batch assignment");
+        perf_record_error();
+        free(idle);
+        free(row_start);
+        free(row_to_col);
+        free(edges);
+        free(col_survivor);
+        pthread_mutex_unlock(&drones->lock);
+        return run_drone_centric_cycle();
+    }
+
+    // Snapshot idle drones and their candidate survivors
+    int rows = 0;
+    int edge_count = 0;
+    // clang-format off
+    Node *current = drones->head;
+    // clang-format on
+    while (current != NULL)
+    {
         // clang-format off
-        Node *current = drones->head;
+        Drone *d = (Drone *)current->data;
         // clang-format on
-        while (current != NULL)
-        {
-            // clang-format off
-            Drone *d = (Drone *)current->data;
-            // // clang-format on
-            // Lock this specific drone to check its status
-            pthread_mutex_lock(&d->lock);
+        pthread_mutex_lock(&d->lock);
+        int is_idle = d->status == IDLE;
+        Coord drone_pos = d->coord;
+        pthread_mutex_unlock(&d->lock);
 
-            // Only consider idle drones
-            if (d->status == IDLE)
+        if (is_idle)
+        {
+            int keys[AI_BATCH_CANDIDATES];
+            int distances[AI_BATCH_CANDIDATES];
+            int found =
+                spatial_index_nearest_k(&waiting_survivor_index, drone_pos, AI_BATCH_CANDIDATES, keys, distances);
+
+            idle[rows] = d;
+            row_start[rows++] = edge_count;
+            for (int i = 0; i < found; i++)
             {
-                // Unlock drone before searching for survivor to avoid deadlocks
-                pthread_mutex_unlock(&d->lock);
+                edges[edge_count].col = keys[i];
+                edges[edge_count].cost = distances[i];
+                edge_count++;
+            }
+        }
+        current = current->next;
+    }
+    row_start[rows] = edge_count;
+
+    // Number the candidate survivors densely, so the solver's arrays scale
+    // with the candidates instead of with the highest survivor index
+    for (int e = 0; e < edge_count; e++)
+        col_survivor[e] = edges[e].col;
+    qsort(col_survivor, edge_count, sizeof(int), compare_ints);
+    int cols = 0;
+    for (int e = 0; e < edge_count; e++)
+    {
+        if (cols == 0 || col_survivor[e] != col_survivor[cols - 1])
+            col_survivor[cols++] = col_survivor[e];
+    }
+    for (int e = 0; e < edge_count; e++)
+    {
+        // clang-format off
+        int *col = bsearch(&edges[e].col, col_survivor, cols, sizeof(int), compare_ints);
+        // clang-format on
+        edges[e].col = (int)(col - col_survivor);
+    }
 
-                // Find the closest waiting survivor
-                int survivor_index = find_closest_waiting_survivor(d);
+    int matched = solve_assignment(rows, cols, row_start, edges, row_to_col);
+    for (int row = 0; row < rows && matched > 0; row++)
+    {
+        if (row_to_col[row] >= 0 && mission_batch_assign(&batch, idle[row], col_survivor[row_to_col[row]]) == 1)
+            missions_assigned++;
+    }
 
-                // If a waiting survivor was found, assign the drone to help
-                if (survivor_index >= 0)
-                {
-                    assign_mission(d, survivor_index);
-                    missions_assigned++;
-                    printf("Drone %d assigned to closest survivor %d\n", d->id, survivor_index);
-                }
-            }
-            else
+    // Drones left out by the candidate lists take the closest remaining survivor
+    for (int row = 0; row < rows; row++)
+    {
+        if (matched >= 0 && row_to_col[row] >= 0)
+            continue;
+
+        int survivor_index = find_closest_waiting_survivor(idle[row]);
+        if (survivor_index >= 0 && mission_batch_assign(&batch, idle[row], survivor_index) == 1)
+            missions_assigned++;
+    }
+
+    pthread_mutex_unlock(&drones->lock);
+
+    missions_assigned -= mission_batch_flush(&batch);
+    mission_batch_destroy(&batch);
+
+    free(idle);
+    free(row_start);
+    free(row_to_col);
+    free(edges);
+    free(col_survivor);
+    return missions_assigned;
+}
+
+/**
+ * @brief AI controller function using the batch strategy
+ * 
+ * Every cycle, matches all idle drones to waiting survivors at once
+ * 
+ * @param args Unused parameter
+ * @return NULL when thread terminates
+ */
+// clang-format off
+void *batch_ai_controller(void *args)
+// clang-format on
+{
+    (void)args; // Unused parameter
+
+    // Give the system time to initialize
+    sleep(3);
+
+    printf("Starting batch assignment AI controller with throughput monitoring...\n");
+
+    // Returns only if waiting for events fails; poll from then on
+    if (ai_event_driven)
+        run_event_driven_loop(run_batch_assignment_cycle, 0);
+
+    int ai_cycle_count = 0;
+
+    while (1)
+    {
+        ai_cycle_count++;
+
+        // Measure AI processing time every 10 cycles
+        struct timespec ai_start, ai_end;
+        if (ai_cycle_count % 10 == 0)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &ai_start);
+        }
+
+        int missions_assigned = run_batch_assignment_cycle();
+
+        // Record AI processing performance every 10 cycles
+        if (ai_cycle_count % 10 == 0)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &ai_end);
+            double ai_processing_time =
+                (ai_end.tv_sec - ai_start.tv_sec) * 1000.0 + (ai_end.tv_nsec - ai_start.tv_nsec) / 1000000.0;
+            perf_record_latency(PERF_OP_AI_CYCLE, ai_processing_time);
+
+            if (missions_assigned > 0)
             {
-                pthread_mutex_unlock(&d->lock);
+                printf("AI cycle %d: Batch assigned %d missions in %.2fms\n", ai_cycle_count, missions_assigned,
+                       ai_processing_time);
             }
+        }
 
-            current = current->next;
+        // Sleep to avoid excessive CPU usage
+        sleep(1);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief AI controller function using the partitioned strategy
+ * 
+ * Every cycle, assigns the map's regions in parallel on the worker pool
+ * 
+ * @param args Unused parameter
+ * @return NULL when thread terminates
+ */
+// clang-format off
+void *partitioned_ai_controller(void *args)
+// clang-format on
+{
+    (void)args; // Unused parameter
+
+    // Give the system time to initialize
+    sleep(3);
+
+    printf("Starting partitioned AI controller with throughput monitoring...\n");
+
+    // Returns only if waiting for events fails; poll from then on
+    if (ai_event_driven)
+        run_event_driven_loop(run_partitioned_assignment_cycle, 0);
+
+    int ai_cycle_count = 0;
+
+    while (1)
+    {
+        ai_cycle_count++;
+
+        // Measure AI processing time every 10 cycles
+        struct timespec ai_start, ai_end;
+        if (ai_cycle_count % 10 == 0)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &ai_start);
         }
 
-        pthread_mutex_unlock(&drones->lock);
+        int missions_assigned = run_partitioned_assignment_cycle();
 
         // Record AI processing performance every 10 cycles
-        if (ai_cycle_count % 10 == 0) {
+        if (ai_cycle_count % 10 == 0)
+        {
             clock_gettime(CLOCK_MONOTONIC, &ai_end);
-            double ai_processing_time = (ai_end.tv_sec - ai_start.tv_sec) * 1000.0 + 
-                                       (ai_end.tv_nsec - ai_start.tv_nsec) / 1000000.0;
-            perf_record_response_time(ai_processing_time);
-            
-            if (missions_assigned > 0 || (idle_drone_count > 0 && waiting_survivors > 0)) {
-                printf("AI cycle %d: Assigned %d missions in %.2fms\n", 
-                       ai_cycle_count, missions_assigned, ai_processing_time);
+            double ai_processing_time =
+                (ai_end.tv_sec - ai_start.tv_sec) * 1000.0 + (ai_end.tv_nsec - ai_start.tv_nsec) / 1000000.0;
+            perf_record_latency(PERF_OP_AI_CYCLE, ai_processing_time);
+
+            if (missions_assigned > 0)
+            {
+                printf("AI cycle %d: Partitioned assigned %d missions in %.2fms (%d workers, %d regions, %d "
+                       "reconciled)\n",
+                       ai_cycle_count, missions_assigned, ai_processing_time, ai_partition_stats.workers,
+                       ai_partition_stats.regions, ai_partition_stats.reconciled);
             }
         }
 
@@ -443,6 +973,45 @@ void *drone_centric_ai_controller(void *args)
     return NULL;
 }
 
+/**
+ * @brief One assignment pass of the survivor-centric strategy
+ * 
+ * For each waiting survivor, assigns the closest idle drone
+ * 
+ * @return Number of missions assigned
+ */
+int run_survivor_centric_cycle(void)
+{
+    int missions_assigned = 0;
+    MissionBatch batch = { 0 };
+
+    // Held like in run_drone_centric_cycle(), so no drone is freed while we use it
+    pthread_mutex_lock(&drones->lock);
+
+    // Visit waiting survivors only, skipping the rest through the status bitset
+    for (int i = 0;; i++)
+    {
+        pthread_mutex_lock(&survivors_mutex);
+        i = survivor_store_next(&survivor_store, 0, i);
+        pthread_mutex_unlock(&survivors_mutex);
+        if (i < 0)
+            break;
+
+        // Find the closest idle drone
+        // clang-format off
+        Drone *drone = find_closest_idle_drone(i);
+        // clang-format on
+        // If an idle drone was found, assign it to help this survivor
+        if (drone != NULL && mission_batch_assign(&batch, drone, i) == 1)
+            missions_assigned++;
+    }
+    pthread_mutex_unlock(&drones->lock);
+
+    missions_assigned -= mission_batch_flush(&batch);
+    mission_batch_destroy(&batch);
+    return missions_assigned;
+}
+
 /**
  * @brief Main AI controller function - loops through survivors instead of drones
  * 
@@ -463,6 +1032,10 @@ void *ai_controller(void *args)
 
     printf("Starting survivor-centric AI controller with throughput monitoring...\n");
 
+    // Returns only if waiting for events fails; poll from then on
+    if (ai_event_driven)
+        run_event_driven_loop(run_survivor_centric_cycle, 1);
+
     int ai_cycle_count = 0;
 
     while (1)
@@ -473,37 +1046,8 @@ void *ai_controller(void *args)
         struct timespec ai_start, ai_end;
         clock_gettime(CLOCK_MONOTONIC, &ai_start);
 
-        // Scan through all survivors to find those waiting for help
-        pthread_mutex_lock(&survivors_mutex);
-        int current_num_survivors = num_survivors;
-        pthread_mutex_unlock(&survivors_mutex);
-
-        int missions_assigned = 0;
-
         // First phase: Assign missions to idle drones
-        for (int i = 0; i < current_num_survivors; i++)
-        {
-            pthread_mutex_lock(&survivors_mutex);
-
-            // Skip survivors that are already being helped or rescued
-            if (survivor_array[i].status != 0)
-            {
-                pthread_mutex_unlock(&survivors_mutex);
-                continue;
-            }
-            pthread_mutex_unlock(&survivors_mutex);
-
-            // Find the closest idle drone
-            // clang-format off
-            Drone *drone = find_closest_idle_drone(i);
-            // clang-format on
-            // If an idle drone was found, assign it to help this survivor
-            if (drone != NULL)
-            {
-                assign_mission(drone, i);
-                missions_assigned++;
-            }
-        }
+        int missions_assigned = run_survivor_centric_cycle();
 
         // Second phase: Check for mission completions
         int missions_completed = 0;
@@ -531,23 +1075,24 @@ void *ai_controller(void *args)
                 {
                     // Find which survivor this drone was helping
                     pthread_mutex_lock(&survivors_mutex);
-                    for (int j = 0; j < num_survivors; j++)
+                    for (int j = survivor_store_next(&survivor_store, 1, 0); j >= 0;
+                         j = survivor_store_next(&survivor_store, 1, j + 1))
                     {
-                        if (survivor_array[j].status == 1 && survivor_array[j].coord.x == d->target.x &&
-                            survivor_array[j].coord.y == d->target.y)
+                        if (survivor_store.x[j] == d->target.x && survivor_store.y[j] == d->target.y)
                         {
                             // Mark survivor as rescued
-                            survivor_array[j].status = 2; // 2 = rescued (won't be drawn)
+                            survivor_set_status(j, 2); // 2 = rescued (won't be drawn)
 
                             // Set rescue timestamp
                             time_t t;
                             time(&t);
-                            localtime_r(&t, &survivor_array[j].helped_time);
+                            localtime_r(&t, &survivor_store.times[j].helped_time);
+                            survivor_trace_rescue(j, d->id);
 
                             missions_completed++;
 
                             // Reset drone to idle
-                            d->status = IDLE;
+                            drone_set_status(d, IDLE);
 
                             printf("AI detected mission completion: Drone %d rescued survivor %d\n", d->id, j);
 
@@ -568,7 +1113,7 @@ void *ai_controller(void *args)
         clock_gettime(CLOCK_MONOTONIC, &ai_end);
         double ai_processing_time = (ai_end.tv_sec - ai_start.tv_sec) * 1000.0 +
                                     (ai_end.tv_nsec - ai_start.tv_nsec) / 1000000.0;
-        perf_record_response_time(ai_processing_time);
+        perf_record_latency(PERF_OP_AI_CYCLE, ai_processing_time);
 
         // Log AI performance every 10 cycles
         if (ai_cycle_count % 10 == 0)
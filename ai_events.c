@@ -0,0 +1,94 @@
+/**
+ * @file ai_events.c
+ * @brief Wake-up events for the event-driven AI controller
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the queue declared in ai_events.h. The eventfd
+ * counter only says "look at the queue"; the events themselves are kept
+ * in the array, so one read() may be followed by any number of them.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup ai_algorithms
+ */
+
+#include "headers/ai_events.h"
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+AiEventQueue ai_events = { .lock = PTHREAD_MUTEX_INITIALIZER, .fd = -1 };
+
+int ai_events_init(AiEventQueue *queue)
+{
+    int fd = eventfd(0, EFD_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    pthread_mutex_lock(&queue->lock);
+    queue->fd = fd;
+    queue->count = 0;
+    queue->overflowed = 0;
+    pthread_mutex_unlock(&queue->lock);
+    return 0;
+}
+
+void ai_events_destroy(AiEventQueue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    if (queue->fd >= 0)
+        close(queue->fd);
+    queue->fd = -1;
+    queue->count = 0;
+    queue->overflowed = 0;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void ai_events_post(AiEventQueue *queue, AiEventType type, Coord coord)
+{
+    pthread_mutex_lock(&queue->lock);
+    if (queue->fd < 0)
+    {
+        pthread_mutex_unlock(&queue->lock);
+        return;
+    }
+
+    int was_empty = queue->count == 0 && !queue->overflowed;
+    if (queue->count < AI_EVENT_CAPACITY)
+        queue->events[queue->count++] = (AiEvent){ type, coord };
+    else
+        queue->overflowed = 1;
+
+    // Later events ride on the wake-up already pending; writing under the
+    // lock keeps the fd from being closed underneath us
+    if (was_empty)
+    {
+        uint64_t one = 1;
+        if (write(queue->fd, &one, sizeof(one)) < 0)
+            queue->overflowed = 1;
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
+
+int ai_events_take(AiEventQueue *queue, AiEvent *events, int *overflowed)
+{
+    uint64_t signals;
+    while (read(queue->fd, &signals, sizeof(signals)) < 0)
+    {
+        if (errno != EINTR)
+            return -1;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    int count = queue->count;
+    memcpy(events, queue->events, count * sizeof(AiEvent));
+    *overflowed = queue->overflowed;
+    queue->count = 0;
+    queue->overflowed = 0;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
@@ -0,0 +1,584 @@
+/**
+ * @file ai_partition.c
+ * @brief Parallel drone-centric assignment over map regions
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the cycle declared in ai_partition.h. Drones and
+ * survivors are copied into per-region slices (counting sort, so each
+ * region's entries are contiguous), the regions are handed to a
+ * persistent worker pool, and the drones left over are reconciled on the
+ * calling thread. Mission messages are queued per region and sent by the
+ * calling thread once drones->lock is released.
+ *
+ * The pool is woken with a generation counter under a mutex rather than a
+ * barrier, so a helper that failed to start never holds up a cycle.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup ai_algorithms
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "headers/ai_partition.h"
+#include "headers/ai.h"
+#include "headers/globals.h"
+#include "headers/server_throughput.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+int ai_partition_workers = 0;
+AiPartitionStats ai_partition_stats;
+
+/**
+ * @brief A waiting survivor as copied into a region
+ */
+typedef struct partition_survivor {
+    int index;   /**< Index in survivor_store */
+    Coord coord; /**< Position when the snapshot was taken */
+} PartitionSurvivor;
+
+/**
+ * @brief Everything the workers share during one cycle
+ *
+ * Written by the calling thread before the workers are woken; during the
+ * cycle each region's slots are written only by the worker that took it.
+ */
+static struct {
+    int band_rows; /**< Regions along map x */
+    int band_cols; /**< Regions along map y */
+    int regions;   /**< band_rows * band_cols */
+    // clang-format off
+    Drone **drones;                  /**< Idle drones, grouped by region */
+    Coord *drone_coords;             /**< Position of each drone when snapshotted */
+    int *drone_start;                /**< First drone of each region, regions + 1 entries */
+    PartitionSurvivor *survivors;    /**< Waiting survivors, grouped by region, halo copies included */
+    int *survivor_start;             /**< First survivor of each region, regions + 1 entries */
+    unsigned char *deferred;         /**< Drones left for reconciliation */
+    int *missions;                   /**< Missions assigned by each region */
+    int *conflicts;                  /**< Claims lost by each region */
+    MissionBatch *batches;           /**< Messages claimed by each region, sent after the cycle */
+    // clang-format on
+    atomic_int next_region; /**< Next region a worker should take */
+} cycle;
+
+/**
+ * @brief Worker threads that help the calling thread
+ */
+static struct {
+    pthread_mutex_t lock;  /**< Protects everything below */
+    pthread_cond_t wake;   /**< Signalled when generation changes or stopping is set */
+    pthread_cond_t done;   /**< Signalled when busy drops to 0 */
+    pthread_t threads[AI_PARTITION_MAX_WORKERS - 1]; /**< Started helpers */
+    int helpers;           /**< Helpers started */
+    int workers;           /**< Worker count the pool was started for, 0 if stopped */
+    unsigned long generation; /**< Incremented once per cycle */
+    int busy;              /**< Helpers still working on the current cycle */
+    int stopping;          /**< Set by ai_partition_shutdown() */
+} pool = { .lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER, .done = PTHREAD_COND_INITIALIZER };
+
+/**
+ * @brief Milliseconds on the monotonic clock
+ */
+static double now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief First cell of band @p band when @p cells cells are cut into @p bands bands
+ */
+static int band_start(int band, int cells, int bands)
+{
+    return (int)((long)band * cells / bands);
+}
+
+/**
+ * @brief Band holding cell @p cell, clamped to the map
+ */
+static int band_of(int cell, int cells, int bands)
+{
+    if (cell < 0)
+        return 0;
+    if (cell >= cells)
+        return bands - 1;
+    return (int)(((long)(cell + 1) * bands - 1) / cells);
+}
+
+/**
+ * @brief Number of workers the next cycle runs on
+ */
+static int resolve_workers(void)
+{
+    long workers = ai_partition_workers;
+    if (workers <= 0)
+        workers = sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1)
+        workers = 1;
+    if (workers > AI_PARTITION_MAX_WORKERS)
+        workers = AI_PARTITION_MAX_WORKERS;
+    return (int)workers;
+}
+
+/**
+ * @brief Cut the map into about AI_PARTITION_REGIONS_PER_WORKER regions per worker
+ *
+ * The grid follows the map's aspect ratio, and no region is narrower than
+ * twice the halo, so a survivor is copied into at most four regions.
+ */
+static void plan_regions(int workers)
+{
+    int target = workers * AI_PARTITION_REGIONS_PER_WORKER;
+    int max_rows = map.height / (2 * AI_PARTITION_HALO);
+    int max_cols = map.width / (2 * AI_PARTITION_HALO);
+
+    int rows = 1;
+    while ((long)(rows + 1) * (rows + 1) * map.width <= (long)target * map.height)
+        rows++;
+    if (rows > max_rows)
+        rows = max_rows > 0 ? max_rows : 1;
+
+    int cols = target / rows;
+    if (cols > max_cols)
+        cols = max_cols;
+    if (cols < 1)
+        cols = 1;
+
+    cycle.band_rows = rows;
+    cycle.band_cols = cols;
+    cycle.regions = rows * cols;
+}
+
+/**
+ * @brief Region of the cell a drone is in
+ */
+static int region_of(Coord coord)
+{
+    return band_of(coord.x, map.height, cycle.band_rows) * cycle.band_cols +
+           band_of(coord.y, map.width, cycle.band_cols);
+}
+
+/**
+ * @brief Assign the idle drones of one region to its survivors
+ *
+ * A lost claim removes that survivor from the region's index too, so the
+ * drone simply tries the next closest one.
+ */
+static void assign_region(int region)
+{
+    int first_drone = cycle.drone_start[region];
+    int last_drone = cycle.drone_start[region + 1];
+    int first_survivor = cycle.survivor_start[region];
+    int survivor_count = cycle.survivor_start[region + 1] - first_survivor;
+    if (first_drone == last_drone)
+        return;
+
+    int band_row = region / cycle.band_cols;
+    int band_col = region % cycle.band_cols;
+    int x0 = band_start(band_row, map.height, cycle.band_rows) - AI_PARTITION_HALO;
+    int y0 = band_start(band_col, map.width, cycle.band_cols) - AI_PARTITION_HALO;
+    int height = band_start(band_row + 1, map.height, cycle.band_rows) + AI_PARTITION_HALO - x0;
+    int width = band_start(band_col + 1, map.width, cycle.band_cols) + AI_PARTITION_HALO - y0;
+
+    // Private to this worker, so its lock is never contended
+    SpatialIndex local;
+    if (survivor_count == 0 || spatial_index_init(&local, height, width, 1, survivor_count) != 0)
+    {
+        memset(&cycle.deferred[first_drone], 1, last_drone - first_drone);
+        return;
+    }
+    for (int k = 0; k < survivor_count; k++)
+    {
+        Coord c = cycle.survivors[first_survivor + k].coord;
+        spatial_index_insert(&local, k, MAKE_COORD(c.x - x0, c.y - y0), NULL);
+    }
+
+    for (int d = first_drone; d < last_drone; d++)
+    {
+        // clang-format off
+        Drone *drone = cycle.drones[d];
+        // clang-format on
+        Coord origin = MAKE_COORD(cycle.drone_coords[d].x - x0, cycle.drone_coords[d].y - y0);
+        while (1)
+        {
+            int key = spatial_index_nearest(&local, origin, NULL);
+            if (key < 0)
+            {
+                cycle.deferred[d] = 1;
+                break;
+            }
+            spatial_index_remove(&local, key);
+
+            int survivor_index = cycle.survivors[first_survivor + key].index;
+            int result = mission_batch_claim(&cycle.batches[region], drone, survivor_index);
+            if (result > 0)
+            {
+                cycle.missions[region]++;
+                break;
+            }
+            if (result < 0)
+                break;
+
+            // Taken by a neighbouring region, unless the drone itself left
+            cycle.conflicts[region]++;
+            pthread_mutex_lock(&drone->lock);
+            int idle = drone->status == IDLE;
+            pthread_mutex_unlock(&drone->lock);
+            if (!idle)
+                break;
+        }
+    }
+
+    spatial_index_destroy(&local);
+}
+
+/**
+ * @brief Take regions until none are left
+ */
+static void assign_regions(void)
+{
+    int region;
+    while ((region = atomic_fetch_add(&cycle.next_region, 1)) < cycle.regions)
+    {
+        assign_region(region);
+    }
+}
+
+/**
+ * @brief Helper thread: one assign_regions() per generation
+ *
+ * @param arg Generation at the time the helper was started
+ */
+static void *partition_worker(void *arg)
+{
+    unsigned long seen = (unsigned long)(uintptr_t)arg;
+
+    pthread_mutex_lock(&pool.lock);
+    while (1)
+    {
+        while (pool.generation == seen && !pool.stopping)
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        if (pool.stopping)
+            break;
+        seen = pool.generation;
+        pthread_mutex_unlock(&pool.lock);
+
+        assign_regions();
+
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.busy == 0)
+            pthread_cond_signal(&pool.done);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+/**
+ * @brief Start workers - 1 helpers, restarting the pool if its size changed
+ *
+ * @return Threads available to the cycle, the calling thread included
+ */
+static int start_pool(int workers)
+{
+    if (pool.workers == workers)
+        return pool.helpers + 1;
+    ai_partition_shutdown();
+
+    pthread_mutex_lock(&pool.lock);
+    pool.stopping = 0;
+    pool.workers = workers;
+    for (int i = 0; i < workers - 1; i++)
+    {
+        if (pthread_create(&pool.threads[pool.helpers], NULL, partition_worker, (void *)(uintptr_t)pool.generation) !=
+            0)
+        {
+            perror("Failed to start AI partition worker");
+            perf_record_error();
+            break;
+        }
+        pool.helpers++;
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return pool.helpers + 1;
+}
+
+void ai_partition_shutdown(void)
+{
+    pthread_mutex_lock(&pool.lock);
+    pool.stopping = 1;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (int i = 0; i < pool.helpers; i++)
+    {
+        pthread_join(pool.threads[i], NULL);
+    }
+    pool.helpers = 0;
+    pool.workers = 0;
+}
+
+/**
+ * @brief Release the cycle's buffers
+ */
+static void free_cycle(void)
+{
+    free(cycle.drones);
+    free(cycle.drone_coords);
+    free(cycle.drone_start);
+    free(cycle.survivors);
+    free(cycle.survivor_start);
+    free(cycle.deferred);
+    free(cycle.missions);
+    free(cycle.conflicts);
+    for (int r = 0; cycle.batches && r < cycle.regions; r++)
+    {
+        mission_batch_destroy(&cycle.batches[r]);
+    }
+    free(cycle.batches);
+    memset(&cycle, 0, sizeof(cycle));
+}
+
+/**
+ * @brief Copy the idle drones and waiting survivors into their regions (drones->lock held)
+ *
+ * @return 0 on success, -1 if an allocation failed
+ */
+static int snapshot_regions(void)
+{
+    int regions = cycle.regions;
+    int capacity = drones->number_of_elements;
+    // clang-format off
+    Drone **idle = malloc((capacity > 0 ? capacity : 1) * sizeof(Drone *));
+    Coord *idle_coords = malloc((capacity > 0 ? capacity : 1) * sizeof(Coord));
+    int *idle_regions = malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    // clang-format on
+    cycle.drone_start = calloc(regions + 1, sizeof(int));
+    cycle.survivor_start = calloc(regions + 1, sizeof(int));
+    cycle.missions = calloc(regions, sizeof(int));
+    cycle.conflicts = calloc(regions, sizeof(int));
+    cycle.batches = calloc(regions, sizeof(MissionBatch));
+    if (!idle || !idle_coords || !idle_regions || !cycle.drone_start || !cycle.survivor_start || !cycle.missions ||
+        !cycle.conflicts || !cycle.batches)
+    {
+        free(idle);
+        free(idle_coords);
+        free(idle_regions);
+        return -1;
+    }
+
+    int idle_count = 0;
+    // clang-format off
+    for (Node *current = drones->head; current != NULL && idle_count < capacity; current = current->next)
+    {
+        Drone *d = (Drone *)current->data;
+        // clang-format on
+        pthread_mutex_lock(&d->lock);
+        int is_idle = d->status == IDLE;
+        Coord drone_pos = d->coord;
+        pthread_mutex_unlock(&d->lock);
+
+        if (is_idle)
+        {
+            idle[idle_count] = d;
+            idle_coords[idle_count] = drone_pos;
+            idle_regions[idle_count] = region_of(drone_pos);
+            cycle.drone_start[idle_regions[idle_count] + 1]++;
+            idle_count++;
+        }
+    }
+
+    // Counting sort by region, keeping list order within a region
+    cycle.drones = malloc((idle_count > 0 ? idle_count : 1) * sizeof(Drone *));
+    cycle.drone_coords = malloc((idle_count > 0 ? idle_count : 1) * sizeof(Coord));
+    cycle.deferred = calloc(idle_count > 0 ? idle_count : 1, 1);
+    if (!cycle.drones || !cycle.drone_coords || !cycle.deferred)
+    {
+        free(idle);
+        free(idle_coords);
+        free(idle_regions);
+        return -1;
+    }
+    for (int r = 0; r < regions; r++)
+    {
+        cycle.drone_start[r + 1] += cycle.drone_start[r];
+    }
+    // clang-format off
+    int *fill = malloc((regions > 0 ? regions : 1) * sizeof(int));
+    // clang-format on
+    if (!fill)
+    {
+        free(idle);
+        free(idle_coords);
+        free(idle_regions);
+        return -1;
+    }
+    memcpy(fill, cycle.drone_start, regions * sizeof(int));
+    for (int i = 0; i < idle_count; i++)
+    {
+        int slot = fill[idle_regions[i]]++;
+        cycle.drones[slot] = idle[i];
+        cycle.drone_coords[slot] = idle_coords[i];
+    }
+    free(idle);
+    free(idle_coords);
+    free(idle_regions);
+    ai_partition_stats.drones = idle_count;
+
+    // Copy the waiting survivors out, then bucket them without the lock
+    pthread_mutex_lock(&survivors_mutex);
+    int waiting = survivor_store.status_count[0];
+    // clang-format off
+    PartitionSurvivor *snapshot = malloc((waiting > 0 ? waiting : 1) * sizeof(PartitionSurvivor));
+    // clang-format on
+    int survivor_count = 0;
+    if (snapshot)
+    {
+        for (int i = survivor_store_next(&survivor_store, 0, 0); i >= 0 && survivor_count < waiting;
+             i = survivor_store_next(&survivor_store, 0, i + 1))
+        {
+            snapshot[survivor_count++] = (PartitionSurvivor){ i, survivor_store_coord(&survivor_store, i) };
+        }
+    }
+    pthread_mutex_unlock(&survivors_mutex);
+    if (!snapshot)
+    {
+        free(fill);
+        return -1;
+    }
+    ai_partition_stats.survivors = survivor_count;
+
+    // Every region whose widened area holds the survivor gets a copy
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (int r = 0; r < regions; r++)
+            {
+                cycle.survivor_start[r + 1] += cycle.survivor_start[r];
+            }
+            memcpy(fill, cycle.survivor_start, regions * sizeof(int));
+            cycle.survivors = malloc((cycle.survivor_start[regions] > 0 ? cycle.survivor_start[regions] : 1) *
+                                     sizeof(PartitionSurvivor));
+            if (!cycle.survivors)
+                break;
+        }
+
+        for (int i = 0; i < survivor_count; i++)
+        {
+            Coord c = snapshot[i].coord;
+            int row_first = band_of(c.x - AI_PARTITION_HALO, map.height, cycle.band_rows);
+            int row_last = band_of(c.x + AI_PARTITION_HALO, map.height, cycle.band_rows);
+            int col_first = band_of(c.y - AI_PARTITION_HALO, map.width, cycle.band_cols);
+            int col_last = band_of(c.y + AI_PARTITION_HALO, map.width, cycle.band_cols);
+            for (int row = row_first; row <= row_last; row++)
+            {
+                for (int col = col_first; col <= col_last; col++)
+                {
+                    int region = row * cycle.band_cols + col;
+                    if (pass == 0)
+                        cycle.survivor_start[region + 1]++;
+                    else
+                        cycle.survivors[fill[region]++] = snapshot[i];
+                }
+            }
+        }
+    }
+    free(snapshot);
+    free(fill);
+    return cycle.survivors ? 0 : -1;
+}
+
+int run_partitioned_assignment_cycle(void)
+{
+    int missions_assigned = 0;
+    MissionBatch reconciled = { 0 };
+
+    if (spatial_index_count(&waiting_survivor_index) == 0 || spatial_index_count(&idle_drone_index) == 0)
+        return 0;
+
+    // A cancelled AI thread must not leave workers holding drones it no longer locks
+    int cancel_state;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancel_state);
+
+    int workers = start_pool(resolve_workers());
+    memset(&ai_partition_stats, 0, sizeof(ai_partition_stats));
+    ai_partition_stats.workers = workers;
+
+    double start_ms = now_ms();
+    pthread_mutex_lock(&drones->lock);
+
+    plan_regions(workers);
+    ai_partition_stats.regions = cycle.regions;
+    if (snapshot_regions() != 0)
+    {
+        perror("Failed to allocate partitioned assignment");
+        perf_record_error();
+        free_cycle();
+        pthread_mutex_unlock(&drones->lock);
+        pthread_setcancelstate(cancel_state, NULL);
+        return run_drone_centric_cycle();
+    }
+    double snapshot_end_ms = now_ms();
+
+    // Wake the helpers and work alongside them
+    atomic_store(&cycle.next_region, 0);
+    pthread_mutex_lock(&pool.lock);
+    pool.busy = pool.helpers;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    assign_regions();
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.busy > 0)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+    double regions_end_ms = now_ms();
+
+    for (int r = 0; r < cycle.regions; r++)
+    {
+        missions_assigned += cycle.missions[r];
+        ai_partition_stats.conflicts += cycle.conflicts[r];
+    }
+
+    // Reconciliation: drones whose region had nothing left for them
+    for (int d = 0; d < ai_partition_stats.drones; d++)
+    {
+        if (!cycle.deferred[d])
+            continue;
+
+        int survivor_index = find_closest_waiting_survivor(cycle.drones[d]);
+        if (survivor_index >= 0 && mission_batch_claim(&reconciled, cycle.drones[d], survivor_index) > 0)
+        {
+            ai_partition_stats.reconciled++;
+            missions_assigned++;
+        }
+    }
+
+    pthread_mutex_unlock(&drones->lock);
+
+    // Send with drones->lock released; the queued drones are pinned until then
+    for (int r = 0; r < cycle.regions; r++)
+    {
+        missions_assigned -= mission_batch_flush(&cycle.batches[r]);
+    }
+    missions_assigned -= mission_batch_flush(&reconciled);
+    mission_batch_destroy(&reconciled);
+    free_cycle();
+    pthread_setcancelstate(cancel_state, NULL);
+
+    ai_partition_stats.missions = missions_assigned;
+    ai_partition_stats.snapshot_ms = snapshot_end_ms - start_ms;
+    ai_partition_stats.regions_ms = regions_end_ms - snapshot_end_ms;
+    ai_partition_stats.reconcile_ms = now_ms() - regions_end_ms;
+    return missions_assigned;
+}
@@ -0,0 +1,273 @@
+/**
+ * @file assignment.c
+ * @brief Minimum-cost bipartite assignment (sparse Hungarian algorithm)
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of solve_assignment() declared in assignment.h. Dijkstra
+ * uses a binary heap with lazy deletion; per-search state is reset only
+ * for the columns the search touched, so a row that finds a free column
+ * right away costs O(its edges), not O(columns).
+ *
+ * Every row also owns a private "skip" column (index cols + row) priced
+ * above any possible total of real pairs. Each row is then always
+ * matched, and minimizing the total cost maximizes the number of real
+ * pairs first; without it, rows added early could keep columns that a
+ * cheaper later row should have had when columns are scarce.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup ai_algorithms
+ */
+
+#include "headers/assignment.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @struct heap_item
+ * @brief Tentative distance of a column in the Dijkstra heap
+ */
+typedef struct heap_item {
+    long dist; /**< Reduced-cost distance from the row being added */
+    int col;   /**< Column the distance belongs to */
+} HeapItem;
+
+/**
+ * @struct solver
+ * @brief Working memory of one solve_assignment() call
+ */
+typedef struct solver {
+    // clang-format off
+    long *row_potential;  /**< Dual value of each row */
+    long *col_potential;  /**< Dual value of each column */
+    long *dist;           /**< Tentative distance of each column, LONG_MAX if untouched */
+    int *col_to_row;      /**< Row matched to each column, -1 if free */
+    int *pred;            /**< Row from which each column was reached */
+    int *settled;         /**< Columns whose distance is final, in order */
+    int *touched;         /**< Columns whose dist/pred must be reset */
+    char *done;           /**< Non-zero once a column is settled */
+    HeapItem *heap;       /**< Binary min-heap on dist */
+    // clang-format on
+    int heap_size;        /**< Number of items in heap */
+    int cols;             /**< Real columns; skip columns follow them */
+    long skip_cost;       /**< Cost of leaving a row unmatched */
+} Solver;
+
+/**
+ * @brief Push a column onto the heap
+ */
+static void heap_push(Solver *s, long dist, int col)
+{
+    int i = s->heap_size++;
+    while (i > 0 && s->heap[(i - 1) / 2].dist > dist)
+    {
+        s->heap[i] = s->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    s->heap[i].dist = dist;
+    s->heap[i].col = col;
+}
+
+/**
+ * @brief Pop the column with the smallest distance
+ */
+static HeapItem heap_pop(Solver *s)
+{
+    HeapItem top = s->heap[0];
+    HeapItem last = s->heap[--s->heap_size];
+    int i = 0;
+
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= s->heap_size)
+            break;
+        if (child + 1 < s->heap_size && s->heap[child + 1].dist < s->heap[child].dist)
+            child++;
+        if (s->heap[child].dist >= last.dist)
+            break;
+        s->heap[i] = s->heap[child];
+        i = child;
+    }
+    if (s->heap_size > 0)
+        s->heap[i] = last;
+    return top;
+}
+
+/**
+ * @brief Offer a shorter path to a column reached from @p row
+ */
+static void relax(Solver *s, int col, long dist, int row, int *touched_count)
+{
+    if (s->done[col] || dist >= s->dist[col])
+        return;
+
+    if (s->dist[col] == LONG_MAX)
+        s->touched[(*touched_count)++] = col;
+    s->dist[col] = dist;
+    s->pred[col] = row;
+    heap_push(s, dist, col);
+}
+
+/**
+ * @brief Match one more row by the cheapest augmenting path
+ *
+ * The row's skip column is always reachable, so this always succeeds.
+ */
+static void augment_row(Solver *s, int row, const int *row_start, const AssignmentEdge *edges, int *row_to_col)
+{
+    int touched_count = 0;
+    int settled_count = 0;
+    int free_col = -1;
+    long free_dist = 0;
+
+    s->heap_size = 0;
+    for (int e = row_start[row]; e < row_start[row + 1]; e++)
+    {
+        int col = edges[e].col;
+        relax(s, col, edges[e].cost - s->row_potential[row] - s->col_potential[col], row, &touched_count);
+    }
+    relax(s, s->cols + row, s->skip_cost - s->row_potential[row] - s->col_potential[s->cols + row], row,
+          &touched_count);
+
+    while (s->heap_size > 0)
+    {
+        HeapItem item = heap_pop(s);
+        if (s->done[item.col] || item.dist > s->dist[item.col])
+            continue;
+
+        s->done[item.col] = 1;
+        s->settled[settled_count++] = item.col;
+
+        int next_row = s->col_to_row[item.col];
+        if (next_row < 0)
+        {
+            free_col = item.col;
+            free_dist = item.dist;
+            break;
+        }
+
+        // Continue through the row currently holding this column
+        for (int e = row_start[next_row]; e < row_start[next_row + 1]; e++)
+        {
+            int col = edges[e].col;
+            long reduced = edges[e].cost - s->row_potential[next_row] - s->col_potential[col];
+            relax(s, col, item.dist + reduced, next_row, &touched_count);
+        }
+        int skip = s->cols + next_row;
+        relax(s, skip, item.dist + s->skip_cost - s->row_potential[next_row] - s->col_potential[skip], next_row,
+              &touched_count);
+    }
+
+    // Keep every reduced cost non-negative and the matched ones at zero
+    for (int i = 0; i < settled_count; i++)
+    {
+        int col = s->settled[i];
+        long delta = free_dist - s->dist[col];
+        s->col_potential[col] -= delta;
+        if (col != free_col)
+            s->row_potential[s->col_to_row[col]] += delta;
+    }
+    s->row_potential[row] += free_dist;
+
+    // Flip the matching along the path back to the new row
+    int col = free_col;
+    for (;;)
+    {
+        int r = s->pred[col];
+        int previous = row_to_col[r];
+        row_to_col[r] = col;
+        s->col_to_row[col] = r;
+        if (r == row)
+            break;
+        col = previous;
+    }
+
+    for (int i = 0; i < touched_count; i++)
+    {
+        s->dist[s->touched[i]] = LONG_MAX;
+        s->done[s->touched[i]] = 0;
+    }
+}
+
+int solve_assignment(int rows, int cols, const int *row_start, const AssignmentEdge *edges, int *row_to_col)
+{
+    Solver s;
+    int edge_count = row_start[rows];
+    int total_cols = cols + rows;
+    int matched = 0;
+    long max_cost = 0;
+
+    for (int e = 0; e < edge_count; e++)
+    {
+        if (edges[e].cost > max_cost)
+            max_cost = edges[e].cost;
+    }
+    s.cols = cols;
+    s.skip_cost = (max_cost + 1) * (rows + 1);
+
+    s.row_potential = malloc((rows + 1) * sizeof(long));
+    s.col_potential = calloc(total_cols + 1, sizeof(long));
+    s.dist = malloc((total_cols + 1) * sizeof(long));
+    s.col_to_row = malloc((total_cols + 1) * sizeof(int));
+    s.pred = malloc((total_cols + 1) * sizeof(int));
+    s.settled = malloc((total_cols + 1) * sizeof(int));
+    s.touched = malloc((total_cols + 1) * sizeof(int));
+    s.done = calloc(total_cols + 1, 1);
+    s.heap = malloc((edge_count + rows + 1) * sizeof(HeapItem));
+
+    if (!s.row_potential || !s.col_potential || !s.dist || !s.col_to_row || !s.pred || !s.settled ||
+        !s.touched || !s.done || !s.heap)
+    {
+        perror("Failed to allocate assignment solver");
+        matched = -1;
+    }
+    else
+    {
+        for (int col = 0; col < total_cols; col++)
+        {
+            s.dist[col] = LONG_MAX;
+            s.col_to_row[col] = -1;
+        }
+
+        for (int row = 0; row < rows; row++)
+        {
+            // Start each row at its cheapest pair so reduced costs are >= 0
+            long cheapest = s.skip_cost;
+            for (int e = row_start[row]; e < row_start[row + 1]; e++)
+            {
+                if (edges[e].cost < cheapest)
+                    cheapest = edges[e].cost;
+            }
+            s.row_potential[row] = cheapest;
+            row_to_col[row] = -1;
+        }
+
+        for (int row = 0; row < rows; row++)
+        {
+            augment_row(&s, row, row_start, edges, row_to_col);
+        }
+
+        for (int row = 0; row < rows; row++)
+        {
+            if (row_to_col[row] >= cols)
+                row_to_col[row] = -1;
+            else
+                matched++;
+        }
+    }
+
+    free(s.row_potential);
+    free(s.col_potential);
+    free(s.dist);
+    free(s.col_to_row);
+    free(s.pred);
+    free(s.settled);
+    free(s.touched);
+    free(s.done);
+    free(s.heap);
+    return matched;
+}
@@ -13,7 +13,8 @@
  * **Core Functionality:**
  * - Autonomous movement and navigation toward assigned targets
  * - Real-time network communication with the coordination server
- * - JSON-based protocol implementation for all message types
+ * - JSON-based protocol, or the compact binary encoding from wire.h when
+ *   the server accepts it at HANDSHAKE (disable with --json)
  * - Performance monitoring and metrics collection
  * - Thread-safe status updates and mission reporting
  * 
@@ -39,6 +40,9 @@
 #define _DEFAULT_SOURCE
 #include <arpa/inet.h>
 #include "headers/drone.h"
+#include "headers/framer.h"
+#include "headers/message_parser.h"
+#include "headers/wire.h"
 #include "headers/globals.h"
 #include "headers/map.h"
 #include "headers/server_throughput.h"
@@ -83,6 +87,90 @@ int sock;
 /** @brief Mutex to protect socket access between threads */
 pthread_mutex_t sock_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/** @brief Encodings offered to the server in HANDSHAKE */
+static unsigned int offered_encodings = WIRE_ENCODING_JSON | WIRE_ENCODING_BINARY;
+
+/** @brief Encoding chosen by the server in HANDSHAKE_ACK (JSON until then) */
+static WireEncoding wire_encoding = WIRE_ENCODING_JSON;
+
+/**
+ * @brief Send a drone → server message in the negotiated encoding
+ * 
+ * STATUS_UPDATE, MISSION_COMPLETE and HEARTBEAT_RESPONSE are supported.
+ * JSON messages carry the same fields as always and are newline-terminated.
+ * 
+ * @param message Message to send
+ * @return Bytes sent for the message itself, or -1 on failure
+ */
+static ssize_t send_drone_message(const DroneMessage *message)
+{
+    char wire_buffer[WIRE_MAX_MESSAGE_SIZE];
+    struct json_object *json = NULL;
+    const char *data;
+    size_t size;
+
+    if (wire_encoding == WIRE_ENCODING_BINARY)
+    {
+        size = wire_encode_drone_message(wire_buffer, message);
+        data = wire_buffer;
+    }
+    else
+    {
+        json = json_object_new_object();
+        json_object_object_add(json, "drone_id", json_object_new_int(my_drone.id));
+        json_object_object_add(json, "timestamp", json_object_new_int(time(NULL)));
+
+        if (message->type == DRONE_MSG_STATUS_UPDATE)
+        {
+            json_object_object_add(json, "type", json_object_new_string("STATUS_UPDATE"));
+
+            // Include current location
+            struct json_object *location = json_object_new_object();
+            json_object_object_add(location, "x", json_object_new_int(message->location.x));
+            json_object_object_add(location, "y", json_object_new_int(message->location.y));
+            json_object_object_add(json, "location", location);
+
+            // Include current status and battery level
+            json_object_object_add(json, "status", json_object_new_string(message->status == IDLE ? "idle" : "busy"));
+            json_object_object_add(json, "battery", json_object_new_int(message->battery));
+        }
+        else if (message->type == DRONE_MSG_MISSION_COMPLETE)
+        {
+            json_object_object_add(json, "type", json_object_new_string("MISSION_COMPLETE"));
+            json_object_object_add(json, "success", json_object_new_boolean(message->success));
+            json_object_object_add(json, "details", json_object_new_string("Mission completed successfully."));
+
+            // Add target location to help server find the correct survivor
+            struct json_object *target_location = json_object_new_object();
+            json_object_object_add(target_location, "x", json_object_new_int(message->target.x));
+            json_object_object_add(target_location, "y", json_object_new_int(message->target.y));
+            json_object_object_add(json, "target_location", target_location);
+        }
+        else
+        {
+            json_object_object_add(json, "type", json_object_new_string("HEARTBEAT_RESPONSE"));
+        }
+
+        data = json_object_to_json_string(json);
+        size = strlen(data);
+    }
+
+    ssize_t bytes_sent = -1;
+    if (size > 0)
+    {
+        pthread_mutex_lock(&sock_mutex);
+        bytes_sent = send(sock, data, size, 0);
+        // Send a newline character to separate JSON messages
+        if (json)
+            send(sock, "\n", 1, 0);
+        pthread_mutex_unlock(&sock_mutex);
+    }
+
+    if (json)
+        json_object_put(json);
+    return bytes_sent;
+}
+
 /**
  * @brief Main drone behavior implementation
  * 
@@ -142,32 +230,13 @@ void* drone_behavior(void *arg)
                 clock_gettime(CLOCK_MONOTONIC, &start_time);
 
                 // Send a STATUS_UPDATE message to the server
-                struct json_object *status_update = json_object_new_object();
-                json_object_object_add(status_update, "type", json_object_new_string("STATUS_UPDATE"));
-                json_object_object_add(status_update, "drone_id", json_object_new_int(my_drone.id));
-                json_object_object_add(status_update, "timestamp", json_object_new_int(time(NULL)));
-
-                // Include current location
-                struct json_object *location = json_object_new_object();
-                json_object_object_add(location, "x", json_object_new_int(my_drone.coord.x));
-                json_object_object_add(location, "y", json_object_new_int(my_drone.coord.y));
-                json_object_object_add(status_update, "location", location);
-
-                // Include current status
-                json_object_object_add(
-                    status_update, "status", json_object_new_string(my_drone.status == IDLE ? "idle" : "busy"));
-                json_object_object_add(
-                    status_update, "battery", json_object_new_int(100)); // Add battery level for better info
-
-                // Send the update
-                const char *update_str = json_object_to_json_string(status_update);
-                size_t message_size = strlen(update_str);
-
-                pthread_mutex_lock(&sock_mutex);
-                ssize_t bytes_sent = send(sock, update_str, message_size, 0);
-                // Send a newline character to separate JSON messages
-                send(sock, "\n", 1, 0);
-                pthread_mutex_unlock(&sock_mutex);
+                DroneMessage status_update;
+                memset(&status_update, 0, sizeof(status_update));
+                status_update.type = DRONE_MSG_STATUS_UPDATE;
+                status_update.location = my_drone.coord;
+                status_update.status = my_drone.status;
+                status_update.battery = 100;
+                ssize_t bytes_sent = send_drone_message(&status_update);
 
                 // Record throughput metrics
                 if (bytes_sent > 0)
@@ -178,16 +247,13 @@ void* drone_behavior(void *arg)
                     clock_gettime(CLOCK_MONOTONIC, &end_time);
                     double response_time_ms = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
                                               (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-                    perf_record_response_time(response_time_ms);
+                    perf_record_latency(PERF_OP_STATUS_UPDATE, response_time_ms);
                 }
                 else
                 {
                     perf_record_error();
                 }
 
-                // Free the JSON object
-                json_object_put(status_update);
-
                 printf("Status update sent: Position (%d, %d) - %zd bytes\n",
                        my_drone.coord.x,
                        my_drone.coord.y,
@@ -222,28 +288,12 @@ void* drone_behavior(void *arg)
             struct timespec start_time, end_time;
             clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-            struct json_object *mission_complete = json_object_new_object();
-            json_object_object_add(mission_complete, "type", json_object_new_string("MISSION_COMPLETE"));
-            json_object_object_add(mission_complete, "drone_id", json_object_new_int(my_drone.id));
-            json_object_object_add(mission_complete, "timestamp", json_object_new_int(time(NULL)));
-            json_object_object_add(mission_complete, "success", json_object_new_boolean(1));
-            json_object_object_add(
-                mission_complete, "details", json_object_new_string("Mission completed successfully."));
-
-            // Add target location to help server find the correct survivor
-            struct json_object *target_location = json_object_new_object();
-            json_object_object_add(target_location, "x", json_object_new_int(my_drone.target.x));
-            json_object_object_add(target_location, "y", json_object_new_int(my_drone.target.y));
-            json_object_object_add(mission_complete, "target_location", target_location);
-
-            const char *mission_complete_str = json_object_to_json_string(mission_complete);
-            size_t message_size = strlen(mission_complete_str);
-
-            pthread_mutex_lock(&sock_mutex);
-            ssize_t send_result = send(sock, mission_complete_str, message_size, 0);
-            // Send a newline character to separate JSON messages
-            send(sock, "\n", 1, 0);
-            pthread_mutex_unlock(&sock_mutex);
+            DroneMessage mission_complete;
+            memset(&mission_complete, 0, sizeof(mission_complete));
+            mission_complete.type = DRONE_MSG_MISSION_COMPLETE;
+            mission_complete.target = my_drone.target;
+            mission_complete.success = 1;
+            ssize_t send_result = send_drone_message(&mission_complete);
 
             // Record throughput metrics
             if (send_result > 0)
@@ -254,7 +304,7 @@ void* drone_behavior(void *arg)
                 clock_gettime(CLOCK_MONOTONIC, &end_time);
                 double response_time_ms = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
                                           (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-                perf_record_response_time(response_time_ms);
+                perf_record_latency(PERF_OP_MISSION_COMPLETE, response_time_ms);
 
                 printf("*** MISSION_COMPLETE message sent successfully (%zd bytes, %.2fms)\n",
                        send_result,
@@ -266,8 +316,6 @@ void* drone_behavior(void *arg)
                 perf_record_error();
             }
 
-            json_object_put(mission_complete);
-
             // Reset the drone's status to IDLE
             my_drone.status = IDLE;
             printf("*** Drone status changed to IDLE\n");
@@ -322,6 +370,115 @@ void* drone_status_monitor(void *arg)
     return NULL;
 }
 
+/**
+ * @brief Block until the next complete message from the server is available
+ * 
+ * Messages split across reads are reassembled and coalesced messages are
+ * returned one at a time.
+ * 
+ * @param framer Receive framer for the server connection
+ * @param frame Receives the next message
+ * @return 1 when a frame is available, 0 if the server disconnected,
+ *         -1 on a receive error or oversized message
+ */
+static int receive_frame(MessageFramer *framer, Frame *frame)
+{
+    while (1)
+    {
+        int result = framer_next(framer, frame);
+        if (result != 0)
+        {
+            return result;
+        }
+
+        size_t space;
+        char *dest = framer_write_space(framer, &space);
+        ssize_t bytes_received = recv(sock, dest, space, 0);
+        if (bytes_received <= 0)
+        {
+            return bytes_received == 0 ? 0 : -1;
+        }
+
+        framer_commit(framer, (size_t)bytes_received);
+        perf_record_status_update(bytes_received);
+    }
+}
+
+/**
+ * @brief Parse a frame as JSON without copying it
+ * 
+ * @param frame Frame returned by receive_frame()
+ * @return Parsed object (caller must json_object_put), or NULL
+ */
+static struct json_object *parse_frame(const Frame *frame)
+{
+    char saved = frame->data[frame->length];
+    frame->data[frame->length] = '\0';
+    struct json_object *parsed = json_tokener_parse(frame->data);
+    frame->data[frame->length] = saved;
+    return parsed;
+}
+
+/**
+ * @brief Answer a HEARTBEAT from the server
+ */
+static void respond_to_heartbeat(void)
+{
+    // Measure heartbeat response time
+    struct timespec hb_start, hb_end;
+    clock_gettime(CLOCK_MONOTONIC, &hb_start);
+
+    DroneMessage heartbeat_response;
+    memset(&heartbeat_response, 0, sizeof(heartbeat_response));
+    heartbeat_response.type = DRONE_MSG_HEARTBEAT_RESPONSE;
+    ssize_t hb_bytes_sent = send_drone_message(&heartbeat_response);
+
+    if (hb_bytes_sent > 0)
+    {
+        perf_record_heartbeat(hb_bytes_sent);
+
+        // Record heartbeat response time
+        clock_gettime(CLOCK_MONOTONIC, &hb_end);
+        double hb_time = (hb_end.tv_sec - hb_start.tv_sec) * 1000.0 + (hb_end.tv_nsec - hb_start.tv_nsec) / 1000000.0;
+        perf_record_latency(PERF_OP_HEARTBEAT, hb_time);
+    }
+    else
+    {
+        perf_record_error();
+    }
+}
+
+/**
+ * @brief Start flying toward a newly assigned mission target
+ * 
+ * @param target Survivor location from ASSIGN_MISSION
+ */
+static void accept_mission(Coord target)
+{
+    pthread_mutex_lock(&my_drone.lock);
+    my_drone.target = target;
+    my_drone.status = ON_MISSION;
+    printf("*** MISSION STATUS CHANGE: Drone %d status set to ON_MISSION\n", my_drone.id);
+    pthread_mutex_unlock(&my_drone.lock);
+
+    printf("Mission assigned: Target (%d, %d) - Current position: (%d, %d)\n",
+           target.x,
+           target.y,
+           my_drone.coord.x,
+           my_drone.coord.y);
+}
+
+/**
+ * @brief Print command line usage
+ * 
+ * @param program Executable name
+ */
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [--json]\n", program);
+    printf("  --json    Only offer the JSON encoding at HANDSHAKE (default: offer binary too)\n");
+}
+
 /**
  * @brief Main function for the drone client
  * 
@@ -329,12 +486,28 @@ void* drone_status_monitor(void *arg)
  * handshake process, and processes messages from the server including
  * mission assignments and heartbeats.
  *
+ * @param argc Argument count
+ * @param argv Arguments; --json disables the binary encoding
  * @return EXIT_SUCCESS on successful execution, EXIT_FAILURE otherwise
  */
-int main()
+int main(int argc, char *argv[])
 {
     struct sockaddr_in server_addr;
-    char buffer[BUFFER_SIZE];
+    MessageFramer framer;
+    Frame frame;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+        {
+            offered_encodings = WIRE_ENCODING_JSON;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
 
     printf("Drone Client Starting - Initializing Performance Monitoring...\n");
 
@@ -419,12 +592,21 @@ int main()
     json_object_object_add(coord, "y", json_object_new_int(my_drone.coord.y));
     json_object_object_add(drone_info, "coord", coord);
 
+    // Offer the compact binary encoding; the server decides in HANDSHAKE_ACK
+    struct json_object *encodings = json_object_new_array();
+    if (offered_encodings & WIRE_ENCODING_BINARY)
+        json_object_array_add(encodings, json_object_new_string(WIRE_ENCODING_NAME_BINARY));
+    json_object_array_add(encodings, json_object_new_string(WIRE_ENCODING_NAME_JSON));
+    json_object_object_add(drone_info, "encodings", encodings);
+
     // Convert JSON object to string and send it
     const char *json_str = json_object_to_json_string(drone_info);
     size_t handshake_size = strlen(json_str);
 
     pthread_mutex_lock(&sock_mutex);
     ssize_t bytes_sent = send(sock, json_str, handshake_size, 0);
+    // Send a newline character to separate JSON messages
+    send(sock, "\n", 1, 0);
     pthread_mutex_unlock(&sock_mutex);
 
     if (bytes_sent > 0)
@@ -440,33 +622,53 @@ int main()
     // Free JSON object
     json_object_put(drone_info);
 
+    if (framer_init(&framer, BUFFER_SIZE, FRAME_BRACE) != 0)
+    {
+        perror("Failed to allocate receive buffer");
+        perf_record_error();
+        close(sock);
+        export_metrics_json("client_error_metrics.json");
+        stop_perf_monitor(throughput_monitor);
+        exit(EXIT_FAILURE);
+    }
+
     // Wait for HANDSHAKE_ACK from the server
-    int bytes_received = recv(sock, buffer, BUFFER_SIZE - 1, 0);
-    if (bytes_received > 0)
+    int frame_result = receive_frame(&framer, &frame);
+    if (frame_result > 0)
     {
-        buffer[bytes_received] = '\0';
-        printf("Server response: %s (%d bytes)\n", buffer, bytes_received);
+        printf("Server response: %.*s (%zu bytes)\n", (int)frame.length, frame.data, frame.length);
 
         // Record handshake response time
         clock_gettime(CLOCK_MONOTONIC, &handshake_end);
         double handshake_time = (handshake_end.tv_sec - handshake_start.tv_sec) * 1000.0 +
                                 (handshake_end.tv_nsec - handshake_start.tv_nsec) / 1000000.0;
-        perf_record_response_time(handshake_time);
-        perf_record_status_update(bytes_received);
+        perf_record_latency(PERF_OP_HANDSHAKE, handshake_time);
 
         // Parse the response to ensure it's a HANDSHAKE_ACK
-        struct json_object *response = json_tokener_parse(buffer);
-        struct json_object *type;
+        struct json_object *response = parse_frame(&frame);
+        struct json_object *type, *encoding;
         if (json_object_object_get_ex(response, "type", &type) &&
             strcmp(json_object_get_string(type), "HANDSHAKE_ACK") == 0)
         {
-            printf("Handshake acknowledged by server (%.2fms response time).\n", handshake_time);
+            // Servers without binary support send no "encoding": stay on JSON
+            if ((offered_encodings & WIRE_ENCODING_BINARY) &&
+                json_object_object_get_ex(response, "encoding", &encoding) &&
+                strcmp(json_object_get_string(encoding), WIRE_ENCODING_NAME_BINARY) == 0)
+            {
+                wire_encoding = WIRE_ENCODING_BINARY;
+                framer_set_mode(&framer, FRAME_BINARY);
+            }
+
+            printf("Handshake acknowledged by server (%.2fms response time, %s encoding).\n",
+                   handshake_time,
+                   wire_encoding == WIRE_ENCODING_BINARY ? WIRE_ENCODING_NAME_BINARY : WIRE_ENCODING_NAME_JSON);
         }
         else
         {
             fprintf(stderr, "Unexpected response from server. Exiting.\n");
             perf_record_error();
             json_object_put(response);
+            framer_destroy(&framer);
             close(sock);
             export_metrics_json("client_error_metrics.json");
             stop_perf_monitor(throughput_monitor);
@@ -478,6 +680,7 @@ int main()
     {
         perror("Failed to receive HANDSHAKE_ACK");
         perf_record_error();
+        framer_destroy(&framer);
         close(sock);
         export_metrics_json("client_error_metrics.json");
         stop_perf_monitor(throughput_monitor);
@@ -508,86 +711,67 @@ int main()
         printf("Waiting for messages from server...\n");
         fflush(stdout); // Ensure the message is printed immediately
 
-        bytes_received = recv(sock, buffer, BUFFER_SIZE - 1, 0);
-        if (bytes_received > 0)
+        frame_result = receive_frame(&framer, &frame);
+        if (frame_result > 0)
         {
-            buffer[bytes_received] = '\0';
-            printf("Message from server: %s (%d bytes)\n", buffer, bytes_received);
-            perf_record_status_update(bytes_received);
-
-            // Parse the server message
-            struct json_object *message = json_tokener_parse(buffer);
-            struct json_object *type;
-            if (json_object_object_get_ex(message, "type", &type))
+            if (wire_encoding == WIRE_ENCODING_BINARY)
             {
-                const char *message_type = json_object_get_string(type);
+                printf("Message from server: binary type 0x%02x (%zu bytes)\n",
+                       (unsigned char)frame.data[1],
+                       frame.length);
 
-                if (strcmp(message_type, "HEARTBEAT") == 0)
+                WireAssignment assignment;
+                int message_type = wire_frame_type(frame.data, frame.length);
+                if (message_type == WIRE_HEARTBEAT)
                 {
-                    // Measure heartbeat response time
-                    struct timespec hb_start, hb_end;
-                    clock_gettime(CLOCK_MONOTONIC, &hb_start);
-
-                    // Respond to heartbeat
-                    struct json_object *heartbeat_response = json_object_new_object();
-                    json_object_object_add(heartbeat_response, "type", json_object_new_string("HEARTBEAT_RESPONSE"));
-                    json_object_object_add(heartbeat_response, "drone_id", json_object_new_int(my_drone.id));
-                    json_object_object_add(heartbeat_response, "timestamp", json_object_new_int(time(NULL)));
-                    const char *response_str = json_object_to_json_string(heartbeat_response);
-                    size_t response_size = strlen(response_str);
-
-                    pthread_mutex_lock(&sock_mutex);
-                    ssize_t hb_bytes_sent = send(sock, response_str, response_size, 0);
-                    pthread_mutex_unlock(&sock_mutex);
-
-                    if (hb_bytes_sent > 0)
-                    {
-                        perf_record_heartbeat(hb_bytes_sent);
+                    respond_to_heartbeat();
+                }
+                else if (message_type == WIRE_ASSIGN_MISSION &&
+                         wire_decode_assignment(frame.data, frame.length, &assignment) == 0)
+                {
+                    accept_mission(assignment.target);
+                }
+                else if (message_type < 0)
+                {
+                    fprintf(stderr, "Invalid binary message from server\n");
+                    perf_record_error();
+                }
+                // Other binary types are newer than this client; skip them
+            }
+            else
+            {
+                printf("Message from server: %.*s (%zu bytes)\n", (int)frame.length, frame.data, frame.length);
 
-                        // Record heartbeat response time
-                        clock_gettime(CLOCK_MONOTONIC, &hb_end);
-                        double hb_time = (hb_end.tv_sec - hb_start.tv_sec) * 1000.0 +
-                                         (hb_end.tv_nsec - hb_start.tv_nsec) / 1000000.0;
-                        perf_record_response_time(hb_time);
-                    }
-                    else
+                // Parse the server message
+                struct json_object *message = parse_frame(&frame);
+                struct json_object *type;
+                if (json_object_object_get_ex(message, "type", &type))
+                {
+                    const char *message_type = json_object_get_string(type);
+
+                    if (strcmp(message_type, "HEARTBEAT") == 0)
                     {
-                        perf_record_error();
+                        respond_to_heartbeat();
                     }
-
-                    json_object_put(heartbeat_response);
-                }
-                else if (strcmp(message_type, "ASSIGN_MISSION") == 0)
-                {
-                    // Handle mission assignment
-                    struct json_object *target;
-                    if (json_object_object_get_ex(message, "target", &target))
+                    else if (strcmp(message_type, "ASSIGN_MISSION") == 0)
                     {
-                        struct json_object *x, *y;
-                        if (json_object_object_get_ex(target, "x", &x) && json_object_object_get_ex(target, "y", &y))
+                        // Handle mission assignment
+                        struct json_object *target;
+                        if (json_object_object_get_ex(message, "target", &target))
                         {
-                            int target_x = json_object_get_int(x);
-                            int target_y = json_object_get_int(y);
-
-                            pthread_mutex_lock(&my_drone.lock);
-                            my_drone.target.x = target_x;
-                            my_drone.target.y = target_y;
-                            my_drone.status = ON_MISSION;
-                            printf("*** MISSION STATUS CHANGE: Drone %d status set to ON_MISSION\n", my_drone.id);
-                            pthread_mutex_unlock(&my_drone.lock);
-
-                            printf("Mission assigned: Target (%d, %d) - Current position: (%d, %d)\n",
-                                   target_x,
-                                   target_y,
-                                   my_drone.coord.x,
-                                   my_drone.coord.y);
+                            struct json_object *x, *y;
+                            if (json_object_object_get_ex(target, "x", &x) &&
+                                json_object_object_get_ex(target, "y", &y))
+                            {
+                                accept_mission(MAKE_COORD(json_object_get_int(x), json_object_get_int(y)));
+                            }
                         }
                     }
                 }
+                json_object_put(message);
             }
-            json_object_put(message);
         }
-        else if (bytes_received == 0)
+        else if (frame_result == 0)
         {
             printf("Server disconnected.\n");
             perf_record_connection(0); // Record disconnection
@@ -609,6 +793,7 @@ int main()
 
     // Cleanup resources
     pthread_mutex_destroy(&my_drone.lock);
+    framer_destroy(&framer);
     close(sock);
 
     // Record final disconnection and export metrics
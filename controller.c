@@ -12,28 +12,43 @@
  * 
  * **System Architecture:**
  * - Multi-threaded architecture with dedicated threads for each subsystem
- * - Real-time SDL-based visualization with interactive display
+ * - Real-time SDL-based visualization with interactive display, or a
+ *   headless mode without any rendering (--headless, or the
+ *   drone_server_headless build, which is compiled with HEADLESS and does
+ *   not link SDL at all)
  * - TCP/IP server for drone client connections
  * - Continuous survivor generation for realistic emergency simulation
  * - AI-driven mission assignment and optimization
  * 
  * **Thread Management:**
- * - Main thread: SDL rendering and event processing (10 FPS)
- * - Drone server thread: Network connection handling
+ * - Main thread: SDL rendering and event processing (10 FPS), or in
+ *   headless mode a once-per-second statistics tick
+ * - World snapshot thread: copies drones and survivors for the renderer,
+ *   which draws without taking simulation locks (not started headless)
+ * - Drone server thread: Network connection handling (thread per drone,
+ *   or an epoll reactor pool when started with --server=epoll)
  * - Survivor generator thread: Continuous emergency simulation
- * - AI controller thread: Mission assignment and optimization
+ * - AI controller thread: Mission assignment and optimization, woken by
+ *   new survivors and idle drones (--ai-wake=poll for the 1-second loop);
+ *   with --ai=partitioned it drives a pool of region workers
  * - Performance monitor thread: Metrics collection and logging
+ * - Metrics endpoint thread: Prometheus scrapes (only with --metrics-port)
  * 
  * **Performance Monitoring:**
  * - Real-time throughput tracking with CSV logging
  * - Comprehensive metrics export in JSON format
- * - Frame-based statistics updates for visualization
+ * - Spawn-to-rescue mission traces, split into waiting, dispatch and
+ *   travel latencies (final_mission_traces.json)
+ * - Optional live Prometheus endpoint on its own port (--metrics-port=N)
+ * - Statistics counters maintained at each state transition, optionally
+ *   cross-checked against a full recount every frame (--verify-stats)
  * - Graceful shutdown with final performance reports
  * 
  * **System Lifecycle:**
- * 1. Initialize all subsystems (lists, map, SDL, networking)
+ * 1. Initialize all subsystems (lists, map, SDL unless headless, networking)
  * 2. Start all service threads (server, AI, survivor generation)
- * 3. Run main simulation loop with real-time visualization
+ * 3. Run main simulation loop with real-time visualization, or the
+ *    headless statistics loop
  * 4. Handle graceful shutdown with proper resource cleanup
  * 
  * @copyright Copyright (c) 2024
@@ -45,16 +60,30 @@
 #include "headers/globals.h"
 #include "headers/map.h"
 #include "headers/drone.h"
+#include "headers/drone_reactor.h"
 #include "headers/survivor.h"
 #include "headers/ai.h"
+#include "headers/ai_events.h"
+#include "headers/ai_partition.h"
 #include "headers/list.h"
+#ifndef HEADLESS
 #include "headers/view.h"
+#include "headers/world_snapshot.h"
+#endif
 #include "headers/server_throughput.h"
+#include "headers/metrics_http.h"
+#include "headers/mission_trace.h"
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <signal.h>
+#include <time.h>
 #include <unistd.h>
 
+/** Seconds between statistics lines in headless mode */
+#define HEADLESS_STATS_INTERVAL 5
+
 // Global lists defined in globals.h
 // clang-format off
 List *survivors = NULL;
@@ -69,15 +98,32 @@ pthread_t ai_thread;
 // Throughput monitoring thread
 pthread_t throughput_monitor;
 
+#ifndef HEADLESS
+// World snapshot publisher, started only with the SDL window
+static pthread_t snapshot_thread;
+static int snapshot_started = 0;
+#endif
+
+// Metrics endpoint thread, started only when metrics_http_port is set
+static pthread_t metrics_http_thread;
+static int metrics_http_started = 0;
+
 // Graceful shutdown flag
 volatile int running = 1;
 
-// Statistics variables - made global for view.c to access
-int waiting_count = 0;
-int helped_count = 0;
-int rescued_count = 0;
-int idle_drones = 0;
-int mission_drones = 0;
+// Recount the statistics every frame and report drift (--verify-stats)
+static int verify_stats = 0;
+
+// Map size in cells (--map=ROWSxCOLS)
+static int map_rows = 30;
+static int map_cols = 40;
+
+// Run without a window (--headless); always set in the HEADLESS build
+#ifdef HEADLESS
+static int headless = 1;
+#else
+static int headless = 0;
+#endif
 // clang-format on
 /**
  * Signal handler for graceful shutdown
@@ -95,24 +141,25 @@ void handle_signal(int sig)
 void initialize_lists()
 {
     // Create lists with appropriate capacities
-    survivors = create_list(sizeof(Survivor), 1000);
-    if (!survivors)
+    survivors = create_list(sizeof(Survivor), 1000, LIST_BACKEND_LINKED);
+    if (!survivors || list_set_key(survivors, SURVIVOR_INFO_SIZE, survivor_list_key) != 0)
     {
         fprintf(stderr, "Failed to create survivors list\n");
         perf_record_error();
         exit(EXIT_FAILURE);
     }
 
-    helpedsurvivors = create_list(sizeof(Survivor), 1000);
-    if (!helpedsurvivors)
+    helpedsurvivors = create_list(sizeof(Survivor), 1000, LIST_BACKEND_LINKED);
+    if (!helpedsurvivors || list_set_key(helpedsurvivors, SURVIVOR_INFO_SIZE, survivor_list_key) != 0)
     {
         fprintf(stderr, "Failed to create helpedsurvivors list\n");
         perf_record_error();
         exit(EXIT_FAILURE);
     }
 
-    drones = create_list(sizeof(Drone), 100);
-    if (!drones)
+    // The fleet is not bounded: grow in blocks of 100 instead of blocking registration
+    drones = create_list(sizeof(Drone), 100, LIST_BACKEND_GROWABLE);
+    if (!drones || list_set_key(drones, sizeof(((Drone *)0)->id), drone_list_key) != 0)
     {
         fprintf(stderr, "Failed to create drones list\n");
         perf_record_error();
@@ -127,6 +174,7 @@ void cleanup_resources()
 {
     // Free map resources
     freemap();
+    spatial_index_destroy(&idle_drone_index);
 
     // Destroy lists
     if (survivors)
@@ -137,77 +185,303 @@ void cleanup_resources()
         drones->destroy(drones);
 
     // Cleanup SDL
-    quit_all();
+#ifndef HEADLESS
+    if (!headless)
+        quit_all();
+#endif
 }
 
 /**
- * Update all statistics for the simulation
- * Used by both controller and view
+ * Per-frame statistics hook, used by both controller and view
+ *
+ * Folds the mission traces recorded since the last call into the stage
+ * histograms. The counters are kept current by the survivor and drone
+ * state transitions, so there is nothing to recount. With --verify-stats
+ * every counter is checked against a full recount instead.
  */
 void update_simulation_stats()
 {
-    // Reset counters
-    waiting_count = 0;
-    helped_count = 0;
-    idle_drones = 0;
-    mission_drones = 0;
-
-    // Count survivors by status
-    pthread_mutex_lock(&survivors_mutex);
-    for (int i = 0; i < num_survivors; i++)
+    mission_trace_aggregate(&mission_traces);
+
+    if (!verify_stats)
+        return;
+
+    if (survivor_stats_verify() != 0 || drone_stats_verify() != 0)
+    {
+        perf_record_error();
+    }
+}
+
+/**
+ * Print command line usage
+ * @param program Name the program was invoked as
+ */
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [options]\n", program);
+    printf("  --server=threads|epoll  Drone connection model (default: threads)\n");
+    printf("  --workers=N             epoll reactor workers (default: one per CPU)\n");
+    printf("  --framing=brace|newline Message framing on drone connections (default: brace)\n");
+    printf("  --wire=auto|json        auto: use the binary encoding with drones that offer it\n");
+    printf("                          json: always use JSON (default: auto)\n");
+    printf("  --ai=drone|survivor|batch|partitioned  AI assignment strategy (default: drone)\n");
+    printf("  --ai-workers=N          Threads of --ai=partitioned (default: one per CPU)\n");
+    printf("  --ai-wake=events|poll   events: run the AI when survivors or idle drones appear\n");
+    printf("                          poll: run a full AI pass every second (default: events)\n");
+    printf("  --verify-stats          Check the statistics counters against a full recount every frame\n");
+    printf("  --metrics-port=N        Serve Prometheus metrics on http://127.0.0.1:N/metrics (default: off)\n");
+    printf("  --map=ROWSxCOLS         Map size in cells (default: 30x40)\n");
+    printf("  --max-survivors=N       Survivors kept before rescued ones are recycled (default: %d)\n",
+           SURVIVOR_CAPACITY_DEFAULT);
+#ifdef HEADLESS
+    printf("  --headless              Accepted for compatibility; this build never opens a window\n");
+#else
+    printf("  --headless              Run without the SDL window\n");
+#endif
+    printf("  --help                  Show this message\n");
+}
+
+/**
+ * Parse command line options into the module configuration globals
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 to continue, 1 to exit successfully, -1 on invalid options
+ */
+static int parse_arguments(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
     {
-        if (survivor_array[i].status == 0)
+        if (strcmp(argv[i], "--server=threads") == 0)
+        {
+            server_mode = SERVER_MODE_THREADS;
+        }
+        else if (strcmp(argv[i], "--server=epoll") == 0)
+        {
+            server_mode = SERVER_MODE_EPOLL;
+        }
+        else if (strncmp(argv[i], "--workers=", 10) == 0)
+        {
+            reactor_worker_count = atoi(argv[i] + 10);
+            if (reactor_worker_count <= 0)
+            {
+                fprintf(stderr, "Invalid worker count: %s\n", argv[i] + 10);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "--framing=brace") == 0)
+        {
+            drone_frame_mode = FRAME_BRACE;
+        }
+        else if (strcmp(argv[i], "--framing=newline") == 0)
+        {
+            drone_frame_mode = FRAME_NEWLINE;
+        }
+        else if (strcmp(argv[i], "--wire=auto") == 0)
+        {
+            drone_wire_encodings = WIRE_ENCODING_JSON | WIRE_ENCODING_BINARY;
+        }
+        else if (strcmp(argv[i], "--wire=json") == 0)
+        {
+            drone_wire_encodings = WIRE_ENCODING_JSON;
+        }
+        else if (strcmp(argv[i], "--ai=drone") == 0)
+        {
+            ai_strategy = AI_STRATEGY_DRONE_CENTRIC;
+        }
+        else if (strcmp(argv[i], "--ai=survivor") == 0)
+        {
+            ai_strategy = AI_STRATEGY_SURVIVOR_CENTRIC;
+        }
+        else if (strcmp(argv[i], "--ai=batch") == 0)
+        {
+            ai_strategy = AI_STRATEGY_BATCH;
+        }
+        else if (strcmp(argv[i], "--ai=partitioned") == 0)
+        {
+            ai_strategy = AI_STRATEGY_PARTITIONED;
+        }
+        else if (strncmp(argv[i], "--ai-workers=", 13) == 0)
+        {
+            char *end;
+            long workers = strtol(argv[i] + 13, &end, 10);
+            if (end == argv[i] + 13 || *end != '\0' || workers <= 0 || workers > INT_MAX)
+            {
+                fprintf(stderr, "Invalid AI worker count: %s\n", argv[i] + 13);
+                print_usage(argv[0]);
+                return -1;
+            }
+            ai_partition_workers = (int)workers;
+        }
+        else if (strcmp(argv[i], "--ai-wake=events") == 0)
         {
-            waiting_count++;
+            ai_event_driven = 1;
         }
-        else if (survivor_array[i].status == 1)
+        else if (strcmp(argv[i], "--ai-wake=poll") == 0)
         {
-            helped_count++;
+            ai_event_driven = 0;
         }
-        else if (survivor_array[i].status == 2)
+        else if (strcmp(argv[i], "--verify-stats") == 0)
         {
-            survivor_array[i].status = 3;
-            rescued_count++;
+            verify_stats = 1;
+        }
+        else if (strncmp(argv[i], "--metrics-port=", 15) == 0)
+        {
+            metrics_http_port = atoi(argv[i] + 15);
+            if (metrics_http_port <= 0 || metrics_http_port > 65535)
+            {
+                fprintf(stderr, "Invalid metrics port: %s\n", argv[i] + 15);
+                return -1;
+            }
+        }
+        else if (strncmp(argv[i], "--map=", 6) == 0)
+        {
+            char rest;
+            if (sscanf(argv[i] + 6, "%dx%d%c", &map_rows, &map_cols, &rest) != 2 || map_rows <= 0 || map_cols <= 0)
+            {
+                fprintf(stderr, "Invalid map size: %s\n", argv[i] + 6);
+                return -1;
+            }
+        }
+        else if (strncmp(argv[i], "--max-survivors=", 16) == 0)
+        {
+            survivor_capacity = atoi(argv[i] + 16);
+            if (survivor_capacity <= 0 || survivor_capacity > SURVIVOR_STORE_MAX)
+            {
+                fprintf(stderr, "Invalid survivor capacity: %s (1 to %d)\n", argv[i] + 16, SURVIVOR_STORE_MAX);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "--headless") == 0)
+        {
+            headless = 1;
+        }
+        else if (strcmp(argv[i], "--help") == 0)
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return -1;
         }
     }
-    pthread_mutex_unlock(&survivors_mutex);
+    return 0;
+}
+
+/**
+ * Print the simulation counters on one line
+ */
+static void print_simulation_stats(void)
+{
+    printf("Stats: Waiting: %d, Being Helped: %d, Rescued: %d, Drones: Idle=%d, On Mission=%d\n",
+           waiting_count,
+           helped_count,
+           rescued_count,
+           idle_drones,
+           mission_drones);
+}
 
-    // Count drones by status from the list
-    pthread_mutex_lock(&drones->lock);
+#ifndef HEADLESS
+/**
+ * Main loop with the SDL window: render at 10 FPS until the window is
+ * closed or running is cleared
+ *
+ * Drones and survivors are drawn from the latest world snapshot, so a
+ * frame never holds drones->lock, a drone's lock or survivors_mutex.
+ */
+static void run_sdl_loop(void)
+{
+    int frame_count = 0;
 
-    // Iterate through all drones in the list
-    // clang-format off
-    Node* current = drones->head;
-    // clang-format on
-    while (current != NULL)
+    while (running)
     {
+        // Process SDL events
+        if (check_events())
+        {
+            running = 0;
+            break;
+        }
+
+        // Clear screen
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        // Draw elements - grid, drones, and survivors - from the latest snapshot
         // clang-format off
-        Drone* d = (Drone*)current->data;
+        const WorldSnapshot *snapshot = world_snapshot_acquire(&world_snapshots);
         // clang-format on
-        // Lock this specific drone to check its status
-        pthread_mutex_lock(&d->lock);
+        draw_grid();
+        draw_survivors(snapshot);
+        draw_drones(snapshot);
 
-        if (d->status == IDLE)
-        {
-            idle_drones++;
-        }
-        else if (d->status == ON_MISSION)
+        // Update simulation statistics (used by both controller and view)
+        update_simulation_stats();
+
+        // Draw the info panel (will use the updated stats)
+        draw_info_panel(snapshot);
+
+        // Print statistics every 50 frames (with throughput info)
+        if (frame_count % 50 == 0)
         {
-            mission_drones++;
+            print_simulation_stats();
+
+            // Log current performance metrics every 100 frames
+            if (frame_count % 100 == 0)
+            {
+                log_perf_metrics();
+            }
         }
 
-        pthread_mutex_unlock(&d->lock);
-        current = current->next;
+        // Present the frame
+        SDL_RenderPresent(renderer);
+
+        // Delay for frame rate control
+        SDL_Delay(100); // 10 FPS
+
+        frame_count++;
     }
+}
+#endif
+
+/**
+ * Main loop without a window: tick once per second until running is
+ * cleared, printing statistics every HEADLESS_STATS_INTERVAL seconds
+ *
+ * Nothing here takes drones->lock or survivors_mutex (the counters are
+ * atomics), so the simulation threads never wait on the main thread.
+ * Performance metrics are logged by the monitor thread on its own timer.
+ */
+static void run_headless_loop(void)
+{
+    struct timespec tick = { .tv_sec = 1, .tv_nsec = 0 };
+    int seconds = 0;
+
+    while (running)
+    {
+        if (seconds % HEADLESS_STATS_INTERVAL == 0)
+            print_simulation_stats();
+
+        update_simulation_stats();
 
-    pthread_mutex_unlock(&drones->lock);
+        // A signal interrupts the sleep, so shutdown is noticed at once
+        nanosleep(&tick, NULL);
+        seconds++;
+    }
 }
 
 /**
  * Main function - entry point for the drone coordination system
  */
-int main()
+int main(int argc, char *argv[])
 {
+    int parse_result = parse_arguments(argc, argv);
+    if (parse_result != 0)
+    {
+        return parse_result < 0 ? 1 : 0;
+    }
+
     printf("Emergency Drone Coordination System - Phase 1\n");
     printf("---------------------------------------------\n");
 
@@ -219,22 +493,41 @@ int main()
         return 1;
     }
 
-    // Set up signal handler for Ctrl+C
+    // Set up signal handlers for Ctrl+C and for service managers
     signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
 
     // Initialize global lists
     initialize_lists();
 
-    // Initialize map (40x30 grid)
-    init_map(30, 40);
+    // Initialize map (30 rows x 40 columns unless --map is given)
+    init_map(map_rows, map_cols);
+
+    // Index idle drones on the same grid, one bucket per cell
+    if (spatial_index_init(&idle_drone_index, map.height, map.width, 1, 100) != 0)
+    {
+        fprintf(stderr, "Failed to create idle drone index\n");
+        perf_record_error();
+        exit(EXIT_FAILURE);
+    }
 
-    // Initialize survivor array
+    // Initialize survivor array and the traces of their rescues
+    mission_trace_init(&mission_traces);
     initialize_survivors();
 
+    // Let the AI sleep until a survivor or an idle drone appears
+    if (ai_event_driven && ai_events_init(&ai_events) != 0)
+    {
+        perror("Failed to create the AI event queue; the AI will poll every second");
+        perf_record_error();
+        ai_event_driven = 0;
+    }
+
+#ifndef HEADLESS
     // Initialize SDL window
-    if (init_sdl_window() != 0)
+    if (!headless && init_sdl_window() != 0)
     {
-        fprintf(stderr, "Failed to initialize SDL window\n");
+        fprintf(stderr, "Failed to initialize SDL window (use --headless to run without one)\n");
         perf_record_error();
         cleanup_resources();
         cleanup_survivors();
@@ -243,14 +536,24 @@ int main()
         return 1;
     }
 
-    // Draw initial grid
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-    draw_grid();
-    SDL_RenderPresent(renderer);
+    if (!headless)
+    {
+        // Draw initial grid
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        draw_grid();
+        SDL_RenderPresent(renderer);
+    }
+#endif
+    if (headless)
+        printf("Running headless: no window, statistics every %d seconds\n", HEADLESS_STATS_INTERVAL);
 
-    // Start drone server thread
-    int result = pthread_create(&drone_server_thread, NULL, drone_server, NULL);
+    // Start drone server thread with the selected connection model
+    printf("Drone server mode: %s\n", server_mode == SERVER_MODE_EPOLL ? "epoll reactor" : "thread per connection");
+    // clang-format off
+    void *(*server_entry)(void *) = server_mode == SERVER_MODE_EPOLL ? drone_reactor : drone_server;
+    // clang-format on
+    int result = pthread_create(&drone_server_thread, NULL, server_entry, NULL);
     if (result != 0)
     {
         fprintf(stderr, "Error creating drone server thread: %d\n", result);
@@ -275,8 +578,17 @@ int main()
         return 1;
     }
 
-    // Start AI controller thread
-    int ai_result = pthread_create(&ai_thread, NULL, drone_centric_ai_controller, NULL);
+    // Start AI controller thread with the selected strategy
+    // clang-format off
+    void *(*ai_entry)(void *) = drone_centric_ai_controller;
+    // clang-format on
+    if (ai_strategy == AI_STRATEGY_SURVIVOR_CENTRIC)
+        ai_entry = ai_controller;
+    else if (ai_strategy == AI_STRATEGY_BATCH)
+        ai_entry = batch_ai_controller;
+    else if (ai_strategy == AI_STRATEGY_PARTITIONED)
+        ai_entry = partitioned_ai_controller;
+    int ai_result = pthread_create(&ai_thread, NULL, ai_entry, NULL);
     if (ai_result != 0)
     {
         fprintf(stderr, "Error creating AI controller thread: %d\n", ai_result);
@@ -288,78 +600,81 @@ int main()
         return 1;
     }
 
-    // Start main rendering loop
-    int frame_count = 0;
-    running = 1;
-
-    printf("Main simulation loop started - monitoring server throughput...\n");
+    // Start the metrics endpoint; the simulation runs on without it if it fails
+    if (metrics_http_port > 0)
+    {
+        int metrics_result = pthread_create(&metrics_http_thread, NULL, metrics_http_server, NULL);
+        if (metrics_result != 0)
+        {
+            fprintf(stderr, "Error creating metrics endpoint thread: %d\n", metrics_result);
+            perf_record_error();
+        }
+        else
+        {
+            metrics_http_started = 1;
+        }
+    }
 
-    while (running)
+#ifndef HEADLESS
+    // Start publishing world snapshots for the renderer
+    if (!headless)
     {
-        // Process SDL events
-        if (check_events())
+        world_snapshot_init(&world_snapshots);
+        int snapshot_result = pthread_create(&snapshot_thread, NULL, world_snapshot_publisher, NULL);
+        if (snapshot_result != 0)
         {
+            fprintf(stderr, "Error creating world snapshot thread: %d\n", snapshot_result);
+            perf_record_error();
             running = 0;
-            break;
         }
-
-        // Clear screen
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-
-        // Draw elements - grid, drones, and survivors
-        draw_grid();
-        draw_survivors();
-        draw_drones();
-
-        // Update simulation statistics (used by both controller and view)
-        update_simulation_stats();
-
-        // Draw the info panel (will use the updated stats)
-        draw_info_panel();
-
-        // Print statistics every 50 frames (with throughput info)
-        if (frame_count % 50 == 0)
+        else
         {
-            printf("Stats: Waiting: %d, Being Helped: %d, Rescued: %d, Drones: Idle=%d, On Mission=%d\n",
-                   waiting_count,
-                   helped_count,
-                   rescued_count,
-                   idle_drones,
-                   mission_drones);
-
-            // Log current performance metrics every 100 frames
-            if (frame_count % 100 == 0)
-            {
-                log_perf_metrics();
-            }
+            snapshot_started = 1;
         }
+    }
+#endif
 
-        // Present the frame
-        SDL_RenderPresent(renderer);
-
-        // Delay for frame rate control
-        SDL_Delay(100); // 10 FPS
+    printf("Main simulation loop started - monitoring server throughput...\n");
 
-        frame_count++;
-    }
+#ifdef HEADLESS
+    run_headless_loop();
+#else
+    if (headless)
+        run_headless_loop();
+    else
+        run_sdl_loop();
+#endif
 
     printf("Shutting down system - finalizing performance metrics...\n");
 
     // Cancel threads
     pthread_cancel(ai_thread);
     pthread_join(ai_thread, NULL);
+    ai_partition_shutdown();
 
     pthread_cancel(survivor_thread);
     pthread_join(survivor_thread, NULL);
 
+    // The endpoint and the snapshot publisher poll the running flag, so they stop on their own
+    if (metrics_http_started)
+        pthread_join(metrics_http_thread, NULL);
+#ifndef HEADLESS
+    if (snapshot_started)
+    {
+        pthread_join(snapshot_thread, NULL);
+        world_snapshot_destroy(&world_snapshots);
+    }
+#endif
+
     // Cleanup
     cleanup_resources();
     cleanup_survivors();
+    ai_events_destroy(&ai_events);
 
     // Export final performance metrics
     printf("Exporting final performance metrics...\n");
     export_metrics_json("final_drone_metrics.json");
+    mission_trace_export_json(&mission_traces, "final_mission_traces.json");
     stop_perf_monitor(throughput_monitor);
 
     printf("System shutdown complete.\n");
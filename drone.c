@@ -12,7 +12,13 @@
  * 
  * **Network Architecture:**
  * - Multi-threaded TCP server with concurrent client handling
+ * - Optional epoll reactor (drone_reactor.c) selected through server_mode;
+ *   both models share the protocol handlers defined here
+ * - Per-connection MessageFramer ring buffers, so messages split across or
+ *   coalesced into reads are all delivered
  * - JSON-based communication protocol for all message types
+ * - Incoming messages decoded without allocation by message_parser.c;
+ *   json-c is only the fallback for frames that parser rejects
  * - Per-client connection threads with dedicated message processing
  * - Automatic client registration and connection management
  * - Graceful handling of connection failures and timeouts
@@ -54,10 +60,13 @@
  */
 
 #define _POSIX_C_SOURCE 199309L
+#define _DEFAULT_SOURCE // SO_REUSEPORT
 #include "headers/drone.h"
+#include "headers/ai_events.h"
 #include "headers/globals.h"
 #include "headers/server_throughput.h"
 #include "headers/list.h"
+#include "headers/message_parser.h"
 #include "headers/survivor.h" // Added include for survivor-related variables
 #include <stdlib.h>
 #include <stdio.h>
@@ -65,6 +74,8 @@
 #include <unistd.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <json-c/json.h>
@@ -76,33 +87,61 @@ int num_drones = 20;
 /** @brief Server port for drone communication */
 #define SERVER_PORT 8080
 
+/** @brief Connection model selected at startup (thread-per-connection by default) */
+ServerMode server_mode = SERVER_MODE_THREADS;
+
+/** @brief Framing used on drone connections (brace framing accepts every client) */
+FrameMode drone_frame_mode = FRAME_BRACE;
+
+/** @brief Encodings offered to drones at HANDSHAKE */
+unsigned int drone_wire_encodings = WIRE_ENCODING_JSON | WIRE_ENCODING_BINARY;
+
+/** @brief Idle drones bucketed by map cell (see drone_index_update()) */
+SpatialIndex idle_drone_index;
+
+/** @brief Next drone id; ids are never reused, so they can key idle_drone_index */
+static int next_drone_id = 0;
+
+/** @brief Listed drones that are IDLE, changed only by drone_set_status() */
+atomic_int idle_drones = 0;
+
+/** @brief Listed drones that are ON_MISSION, changed only by drone_set_status() */
+atomic_int mission_drones = 0;
+
 /**
- * @brief Server thread function to listen for drone connections
- * 
- * Creates a socket server that listens for incoming drone client connections
- * and launches a new thread for each connected drone
- * 
- * @param arg Unused thread parameter
- * @return NULL when thread terminates
+ * @brief Milliseconds elapsed between two monotonic timestamps
+ *
+ * @param start Earlier timestamp
+ * @param end Later timestamp
+ * @return Elapsed time in milliseconds
  */
-// clang-format off
-void *drone_server(void *arg)
-// clang-format on
+static double elapsed_ms(const struct timespec *start, const struct timespec *end)
 {
-    (void)arg;
+    return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1000000.0;
+}
 
+/**
+ * @brief Create the TCP listening socket for drone connections
+ * 
+ * @param port TCP port to bind
+ * @param reuse_port Non-zero to set SO_REUSEPORT so several sockets can share the port
+ * @return Listening socket descriptor, or -1 on failure
+ */
+int create_drone_listener(int port, int reuse_port)
+{
     int server_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (server_fd < 0)
     {
         perror("Socket creation failed");
         perf_record_error();
-        return NULL;
+        return -1;
     }
 
     struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
     server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(SERVER_PORT);
+    server_addr.sin_port = htons(port);
 
     int opt = 1;
     if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0)
@@ -110,7 +149,15 @@ void *drone_server(void *arg)
         perror("Set socket options failed");
         perf_record_error();
         close(server_fd);
-        return NULL;
+        return -1;
+    }
+
+    if (reuse_port && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+    {
+        perror("Set SO_REUSEPORT failed");
+        perf_record_error();
+        close(server_fd);
+        return -1;
     }
     // clang-format off
     if (bind(server_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
@@ -119,14 +166,38 @@ void *drone_server(void *arg)
         perror("Bind failed");
         perf_record_error();
         close(server_fd);
-        return NULL;
+        return -1;
     }
 
-    if (listen(server_fd, 3) < 0)
+    if (listen(server_fd, MAX_PENDING_CONNECTIONS) < 0)
     {
         perror("Listen failed");
         perf_record_error();
         close(server_fd);
+        return -1;
+    }
+
+    return server_fd;
+}
+
+/**
+ * @brief Server thread function to listen for drone connections
+ * 
+ * Creates a socket server that listens for incoming drone client connections
+ * and launches a new thread for each connected drone
+ * 
+ * @param arg Unused thread parameter
+ * @return NULL when thread terminates
+ */
+// clang-format off
+void *drone_server(void *arg)
+// clang-format on
+{
+    (void)arg;
+
+    int server_fd = create_drone_listener(SERVER_PORT, 0);
+    if (server_fd < 0)
+    {
         return NULL;
     }
 
@@ -190,7 +261,8 @@ void *drone_server(void *arg)
  * @brief Handle communication with a connected drone client
  * 
  * Processes messages from a drone client, including handshake, status
- * updates, mission completions, and heartbeats
+ * updates, mission completions, and heartbeats. Reads go straight into a
+ * MessageFramer so partial messages survive until the next recv().
  * 
  * @param arg Pointer to socket descriptor
  * @return NULL when thread terminates
@@ -202,137 +274,334 @@ void *handle_drone_client(void *arg)
     int sock = *((int *)arg);
     free(arg); // Free the allocated memory for the socket pointer
 
-    char buffer[4096];
+    MessageFramer framer;
     ssize_t bytes_received;
-    struct timespec start_time, end_time;
+    struct timespec start_time;
+    // clang-format off
+    Node *node = NULL;
+    // clang-format on
+
+    if (framer_init(&framer, DRONE_FRAMER_CAPACITY, drone_frame_mode) != 0)
+    {
+        perror("Failed to allocate receive buffer");
+        perf_record_error();
+        close(sock);
+        perf_record_connection(0);
+        return NULL;
+    }
 
     // Measure handshake response time
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-    // Receive HANDSHAKE message
-    bytes_received = recv(sock, buffer, sizeof(buffer) - 1, 0);
-    if (bytes_received <= 0)
+    // Receive directly into the framer; messages may span or share reads
+    while (1)
     {
-        if (bytes_received == 0)
-            printf("Client disconnected before handshake\n");
-        else
+        size_t space;
+        // clang-format off
+        char *dest = framer_write_space(&framer, &space);
+        // clang-format on
+        bytes_received = recv(sock, dest, space, 0);
+        if (bytes_received <= 0)
         {
-            perror("Error receiving handshake");
-            perf_record_error();
+            if (node == NULL)
+            {
+                if (bytes_received == 0)
+                    printf("Client disconnected before handshake\n");
+                else
+                {
+                    perror("Error receiving handshake");
+                    perf_record_error();
+                }
+            }
+            else if (bytes_received == 0)
+            {
+                printf("Drone %d disconnected\n", ((Drone *)node->data)->id);
+            }
+            else
+            {
+                perror("Error receiving from drone");
+                perf_record_error();
+            }
+            break;
         }
-        close(sock);
+
+        framer_commit(&framer, (size_t)bytes_received);
+        perf_record_status_update(bytes_received);
+
+        if (process_drone_frames(sock, &node, &framer, &start_time) != 0)
+        {
+            break;
+        }
+    }
+
+    if (node)
+    {
+        unregister_drone(node);
+    }
+    else
+    {
         perf_record_connection(0);
-        return NULL;
     }
 
-    buffer[bytes_received] = '\0'; // Null-terminate the received data
-    printf("Received handshake data: %zd bytes\n", bytes_received);
-    perf_record_status_update(bytes_received);
+    framer_destroy(&framer);
+    close(sock);
+    return NULL;
+}
 
-    // Parse the received JSON data
-    // clang-format off
-    struct json_object *parsed_json = json_tokener_parse(buffer);
+/**
+ * @brief Read an {"x": int, "y": int} member of a json-c object
+ * 
+ * @param parent Object holding the member
+ * @param key Member name
+ * @param coord Receives the coordinates
+ * @return 1 if both coordinates were present, 0 otherwise
+ */
+// clang-format off
+static int json_get_coord(struct json_object *parent, const char *key, Coord *coord)
+{
+    struct json_object *coord_obj, *x_obj, *y_obj;
+    // clang-format on
+    if (!json_object_object_get_ex(parent, key, &coord_obj) || !json_object_object_get_ex(coord_obj, "x", &x_obj) ||
+        !json_object_object_get_ex(coord_obj, "y", &y_obj))
+    {
+        return 0;
+    }
+    coord->x = json_object_get_int(x_obj);
+    coord->y = json_object_get_int(y_obj);
+    return 1;
+}
+
+/**
+ * @brief Decode a drone message with json-c
+ * 
+ * Slow path for frames parse_drone_message() does not accept, such as
+ * strings with escape sequences or fractional coordinates. Fills the same
+ * DroneMessage so the handlers do not care which path was taken.
+ * 
+ * @param message Start of the JSON object
+ * @param length Length of the object; message[length] must be writable
+ * @param decoded Receives the decoded fields
+ * @return 0 on success, -1 if the frame is not valid JSON
+ */
+// clang-format off
+static int parse_drone_message_json(char *message, size_t length, DroneMessage *decoded)
+{
+    char saved = message[length];
+    message[length] = '\0';
+    struct json_object *parsed_json = json_tokener_parse(message);
+    message[length] = saved; // Restore the buffer
+    struct json_object *value;
     // clang-format on
     if (parsed_json == NULL)
+    {
+        return -1;
+    }
+
+    memset(decoded, 0, sizeof(DroneMessage));
+
+    if (json_object_object_get_ex(parsed_json, "type", &value))
+    {
+        const char *type = json_object_get_string(value);
+        decoded->type = drone_message_type_from_name(type, strlen(type));
+    }
+
+    // HANDSHAKE reports its position as "coord", STATUS_UPDATE as "location"
+    if (json_get_coord(parsed_json, "location", &decoded->location) ||
+        json_get_coord(parsed_json, "coord", &decoded->location))
+    {
+        decoded->fields |= DRONE_FIELD_LOCATION;
+    }
+
+    if (json_get_coord(parsed_json, "target_location", &decoded->target))
+    {
+        decoded->fields |= DRONE_FIELD_TARGET;
+    }
+
+    if (json_object_object_get_ex(parsed_json, "encodings", &value) && json_object_is_type(value, json_type_array))
+    {
+        size_t count = json_object_array_length(value);
+        for (size_t i = 0; i < count; i++)
+        {
+            const char *name = json_object_get_string(json_object_array_get_idx(value, i));
+            if (name)
+                decoded->encodings |= drone_encoding_from_name(name, strlen(name));
+        }
+        decoded->fields |= DRONE_FIELD_ENCODINGS;
+    }
+
+    if (json_object_object_get_ex(parsed_json, "status", &value))
+    {
+        const char *status_str = json_object_get_string(value);
+        int status = drone_status_from_name(status_str, strlen(status_str));
+        if (status >= 0)
+        {
+            decoded->status = status;
+            decoded->fields |= DRONE_FIELD_STATUS;
+        }
+    }
+
+    if (json_object_object_get_ex(parsed_json, "battery", &value))
+    {
+        decoded->battery = json_object_get_int(value);
+        decoded->fields |= DRONE_FIELD_BATTERY;
+    }
+
+    if (json_object_object_get_ex(parsed_json, "timestamp", &value))
+    {
+        decoded->timestamp = (long)json_object_get_int64(value);
+        decoded->fields |= DRONE_FIELD_TIMESTAMP;
+    }
+
+    if (json_object_object_get_ex(parsed_json, "success", &value))
+    {
+        decoded->success = json_object_get_boolean(value);
+        decoded->fields |= DRONE_FIELD_SUCCESS;
+    }
+
+    json_object_put(parsed_json);
+    return 0;
+}
+
+/**
+ * @brief Decode a drone message, trying the allocation-free parser first
+ * 
+ * @param message Start of the JSON object
+ * @param length Length of the object; message[length] must be writable
+ * @param decoded Receives the decoded fields
+ * @return 0 on success, -1 if the frame is not valid JSON
+ */
+// clang-format off
+static int decode_drone_message(char *message, size_t length, DroneMessage *decoded)
+// clang-format on
+{
+    if (parse_drone_message(message, length, decoded) == 0)
+    {
+        return 0;
+    }
+    return parse_drone_message_json(message, length, decoded);
+}
+
+/**
+ * @brief Send a whole message to a drone, waiting at most DRONE_SEND_TIMEOUT_MS
+ * 
+ * Drone sockets may be non-blocking (epoll reactor), so send() can accept
+ * only part of a message. The rest is sent as the socket drains. If the
+ * message cannot be finished in time, the connection is shut down: the
+ * drone would otherwise read the next message glued to a truncated one.
+ * 
+ * @param sock Connected drone socket
+ * @param data Message to send
+ * @param length Size of the message in bytes
+ * @return @p length on success, -1 on error or timeout
+ */
+ssize_t drone_send_all(int sock, const char *data, size_t length)
+{
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    size_t sent = 0;
+
+    while (sent < length)
+    {
+        ssize_t result = send(sock, data + sent, length - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (result > 0)
+        {
+            sent += (size_t)result;
+            continue;
+        }
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            int timeout = DRONE_SEND_TIMEOUT_MS - (int)elapsed_ms(&start, &now);
+            struct pollfd pfd = { .fd = sock, .events = POLLOUT };
+            if (timeout > 0 && (poll(&pfd, 1, timeout) >= 0 || errno == EINTR))
+                continue;
+            if (timeout <= 0)
+                errno = ETIMEDOUT;
+        }
+        break;
+    }
+
+    if (sent == length)
+        return (ssize_t)sent;
+    if (sent > 0)
+        shutdown(sock, SHUT_RDWR);
+    return -1;
+}
+
+/**
+ * @brief Validate a HANDSHAKE message and register the drone it describes
+ * 
+ * Parses the handshake, sends HANDSHAKE_ACK and only then adds a new drone
+ * bound to @p sock to the global drones list, so no mission can reach the
+ * drone before its ACK. Shared by the threaded handler and the epoll
+ * reactor.
+ * 
+ * @param sock Connected client socket
+ * @param message Start of the handshake JSON object
+ * @param length Length of the object in bytes; message[length] must be writable
+ * @param start_time Monotonic time the handshake started arriving
+ * @return List node holding the registered drone, or NULL on failure
+ */
+// clang-format off
+Node *register_drone(int sock, char *message, size_t length, const struct timespec *start_time)
+// clang-format on
+{
+    struct timespec end_time;
+    DroneMessage handshake;
+
+    // Parse the received JSON data
+    if (decode_drone_message(message, length, &handshake) != 0)
     {
         printf("Failed to parse JSON data\n");
         perf_record_error();
-        close(sock);
-        perf_record_connection(0);
         return NULL;
     }
 
     // Verify it's a handshake message
-    // clang-format off
-    struct json_object *type_obj;
-    // clang-format on
-    if (!json_object_object_get_ex(parsed_json, "type", &type_obj) ||
-        strcmp(json_object_get_string(type_obj), "HANDSHAKE") != 0)
+    if (handshake.type != DRONE_MSG_HANDSHAKE)
     {
         printf("Not a valid handshake message\n");
         perf_record_error();
-        json_object_put(parsed_json);
-        close(sock);
-        perf_record_connection(0);
         return NULL;
     }
 
-    // Extract drone information from the JSON
+    // Extract drone information from the message
     Drone drone;
     memset(&drone, 0, sizeof(Drone));
 
     // If no ID provided, generate a new one
     pthread_mutex_lock(&drones->lock);
-    drone.id = drones->number_of_elements; // Use current size as new ID
+    drone.id = next_drone_id++;
     pthread_mutex_unlock(&drones->lock);
 
-    // Get drone status
-    // clang-format off
-    struct json_object *status_obj;
-    // clang-format on
-    if (json_object_object_get_ex(parsed_json, "status", &status_obj))
-    {
-        const char *status_str = json_object_get_string(status_obj);
-        if (strcmp(status_str, "IDLE") == 0)
-            drone.status = IDLE;
-        else if (strcmp(status_str, "ON_MISSION") == 0)
-            drone.status = ON_MISSION;
-        else
-            drone.status = IDLE; // Default to IDLE
-    }
-    else
-    {
-        drone.status = IDLE; // Default to IDLE
-    }
+    // Get drone status, defaulting to IDLE; the drone is listed as
+    // DISCONNECTED until drone_set_status() counts and indexes it
+    DroneStatus status = (handshake.fields & DRONE_FIELD_STATUS) ? (DroneStatus)handshake.status : IDLE;
+    drone.status = DISCONNECTED;
 
     // Get drone coordinates
-    // clang-format off
-    struct json_object *coord_obj;
-    // clang-format on
-    if (json_object_object_get_ex(parsed_json, "coord", &coord_obj))
+    if (handshake.fields & DRONE_FIELD_LOCATION)
     {
-        // clang-format off
-        struct json_object *x_obj, *y_obj;
-        // clang-format on
-        if (json_object_object_get_ex(coord_obj, "x", &x_obj) && json_object_object_get_ex(coord_obj, "y", &y_obj))
-        {
-            drone.coord.x = json_object_get_int(x_obj);
-            drone.coord.y = json_object_get_int(y_obj);
-        }
+        drone.coord = handshake.location;
     }
 
     // Set initial target to current position
     drone.target = drone.coord;
 
+    // Switch to the binary encoding only if both sides support it
+    drone.encoding = (handshake.encodings & drone_wire_encodings & WIRE_ENCODING_BINARY) ? WIRE_ENCODING_BINARY
+                                                                                          : WIRE_ENCODING_JSON;
+
     // Set last update time to current time
     time_t t = time(NULL);
     localtime_r(&t, &drone.last_update);
 
-    // Free the parsed JSON object as we've extracted the needed data
-    json_object_put(parsed_json);
-
-    // Add the drone to the list
-    pthread_mutex_init(&drone.lock, NULL);
-
     // Initialize the socket field with the client socket
     drone.socket = sock;
 
     // clang-format off
-    Node *node = drones->add(drones, &drone);
-    // clang-format on
-    if (!node)
-    {
-        fprintf(stderr, "Failed to add drone %d to list\n", drone.id);
-        perf_record_error();
-        pthread_mutex_destroy(&drone.lock);
-        close(sock);
-        perf_record_connection(0);
-        return NULL;
-    }
-
-    // Get a pointer to the actual drone in the list
-    // clang-format off
-    Drone *d = (Drone *)node->data;
 
     // Send HANDSHAKE_ACK response
     struct json_object *handshake_ack = json_object_new_object();
@@ -345,250 +614,320 @@ void *handle_drone_client(void *arg)
     json_object_object_add(config, "heartbeat_interval", json_object_new_int(10));
     json_object_object_add(handshake_ack, "config", config);
 
-    // Send the handshake acknowledgment
+    // Negotiated encoding for every message after this one
+    json_object_object_add(handshake_ack,
+                           "encoding",
+                           json_object_new_string(drone.encoding == WIRE_ENCODING_BINARY ? WIRE_ENCODING_NAME_BINARY
+                                                                                          : WIRE_ENCODING_NAME_JSON));
+    json_object_object_add(handshake_ack, "protocol_version", json_object_new_int(WIRE_PROTOCOL_VERSION));
+
+    // Send the acknowledgment before the drone is listed: once it is, the AI
+    // may send it a mission in the negotiated encoding, which the drone only
+    // reads after the ACK
     const char *ack_str = json_object_to_json_string(handshake_ack);
     size_t ack_size = strlen(ack_str);
-    ssize_t bytes_sent = send(sock, ack_str, ack_size, 0);
+    ssize_t bytes_sent = drone_send_all(sock, ack_str, ack_size);
     // clang-format on
+    json_object_put(handshake_ack);
+
+    if (bytes_sent < 0)
+    {
+        perror("Failed to send handshake acknowledgment");
+        perf_record_error();
+        return NULL;
+    }
+
+    perf_record_heartbeat(bytes_sent);
+
+    // Record handshake response time
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double response_time = elapsed_ms(start_time, &end_time);
+    perf_record_latency(PERF_OP_HANDSHAKE, response_time);
 
-    if (bytes_sent > 0)
+    printf("Handshake acknowledgment sent to drone %d (%zd bytes, %.2fms)\n", drone.id, bytes_sent, response_time);
+
+    // Add the drone to the list
+    pthread_mutex_init(&drone.lock, NULL);
+    pthread_cond_init(&drone.unpinned, NULL);
+
+    // clang-format off
+    Node *node = drones->add(drones, &drone);
+    // clang-format on
+    if (!node)
     {
-        perf_record_heartbeat(bytes_sent);
+        fprintf(stderr, "Failed to add drone %d to list\n", drone.id);
+        perf_record_error();
+        pthread_mutex_destroy(&drone.lock);
+        pthread_cond_destroy(&drone.unpinned);
+        return NULL;
+    }
+
+    // Get a pointer to the actual drone in the list
+    // clang-format off
+    Drone *d = (Drone *)node->data;
+    // clang-format on
+    pthread_mutex_lock(&d->lock);
+    drone_set_status(d, status);
+    pthread_mutex_unlock(&d->lock);
+
+    // Wake the AI only for a drone that has its ACK and can take a mission
+    if (status == IDLE)
+        ai_events_post(&ai_events, AI_EVENT_DRONE_IDLE, drone.coord);
+
+    return node;
+}
 
-        // Record handshake response time
-        clock_gettime(CLOCK_MONOTONIC, &end_time);
-        double response_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
-                               (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-        perf_record_response_time(response_time);
+/**
+ * @brief Mark a drone as disconnected and stop mission sends still using it
+ * 
+ * Shutting the socket down makes a pending send fail instead of waiting
+ * for buffer space.
+ * 
+ * @param d Drone to mark; the caller holds d->lock
+ */
+// clang-format off
+static void drone_disconnect(Drone *d)
+// clang-format on
+{
+    drone_set_status(d, DISCONNECTED);
+    if (d->pins > 0)
+        shutdown(d->socket, SHUT_RDWR);
+}
 
-        printf("Handshake acknowledgment sent to drone %d (%zd bytes, %.2fms)\n", d->id, bytes_sent, response_time);
+/**
+ * @brief Remove a disconnected drone that no send pins any more from the list
+ * 
+ * @param node List node returned by register_drone()
+ * @param id The drone's id, for the log message
+ */
+// clang-format off
+static void drone_remove(Node *node, int id)
+// clang-format on
+{
+    if (drones->removenode(drones, node) == 0)
+    {
+        printf("Drone %d removed from list\n", id);
     }
     else
     {
+        printf("Failed to remove drone %d from list\n", id);
         perf_record_error();
     }
 
-    json_object_put(handshake_ack);
+    perf_record_connection(0); // Record disconnection
+}
 
-    // Main loop to handle communication with this drone
-    while (1)
-    {
-        clock_gettime(CLOCK_MONOTONIC, &start_time);
+/**
+ * @brief Mark a drone as disconnected and remove it from the drones list
+ * 
+ * @param node List node returned by register_drone()
+ * 
+ * @note The caller still owns (and must close) the drone's socket
+ */
+// clang-format off
+void unregister_drone(Node *node)
+{
+    Drone *d = (Drone *)node->data;
+    // clang-format on
+    int id = d->id;
 
-        bytes_received = recv(sock, buffer, sizeof(buffer) - 1, 0);
-        if (bytes_received <= 0)
+    // Mark drone as disconnected, then wait for mission sends still using it
+    pthread_mutex_lock(&d->lock);
+    drone_disconnect(d);
+    while (d->pins > 0)
+        pthread_cond_wait(&d->unpinned, &d->lock);
+    pthread_mutex_unlock(&d->lock);
+
+    drone_remove(node, id);
+}
+
+/**
+ * @brief Unregister a drone unless a mission send still pins it
+ * 
+ * @param node List node returned by register_drone()
+ * @return 0 if the drone was removed, 1 if it is marked disconnected but
+ *         still pinned; call again later and keep the socket open until then
+ */
+// clang-format off
+int try_unregister_drone(Node *node)
+{
+    Drone *d = (Drone *)node->data;
+    // clang-format on
+    int id = d->id;
+
+    pthread_mutex_lock(&d->lock);
+    drone_disconnect(d);
+    int pinned = d->pins > 0;
+    pthread_mutex_unlock(&d->lock);
+
+    if (pinned)
+        return 1;
+
+    drone_remove(node, id);
+    return 0;
+}
+
+/**
+ * @brief Dispatch every complete frame buffered on a drone connection
+ * 
+ * The first frame on a connection must be the HANDSHAKE; it registers the
+ * drone and stores its list node in @p node. Every later frame is handed
+ * to process_drone_message() in place, without copying.
+ * 
+ * @param sock Client socket the data was received on
+ * @param node In/out: registered drone node, NULL before the handshake
+ * @param framer Connection framer holding the received bytes
+ * @param handshake_start Monotonic time the handshake started arriving
+ * @return 0 to keep the connection open, -1 to close it
+ */
+// clang-format off
+int process_drone_frames(int sock, Node **node, MessageFramer *framer, const struct timespec *handshake_start)
+// clang-format on
+{
+    Frame frame;
+    int result;
+
+    while ((result = framer_next(framer, &frame)) > 0)
+    {
+        if (*node == NULL)
         {
-            if (bytes_received == 0)
-                printf("Drone %d disconnected\n", d->id);
-            else
+            *node = register_drone(sock, frame.data, frame.length, handshake_start);
+            if (*node == NULL)
             {
-                perror("Error receiving from drone");
-                perf_record_error();
+                return -1;
+            }
+
+            // Bytes after the handshake are rescanned in the negotiated framing
+            if (((Drone *)(*node)->data)->encoding == WIRE_ENCODING_BINARY)
+            {
+                framer_set_mode(framer, FRAME_BINARY);
             }
+            continue;
+        }
 
-            // Mark drone as disconnected
+        process_drone_message((Drone *)(*node)->data, frame.data, frame.length);
+    }
+
+    if (result < 0)
+    {
+        fprintf(stderr, "Message on socket %d exceeds %d bytes, closing connection\n", sock, DRONE_FRAMER_CAPACITY);
+        perf_record_error();
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Parse and handle a single JSON message from a registered drone
+ * 
+ * Handles STATUS_UPDATE, MISSION_COMPLETE and HEARTBEAT_RESPONSE. Unknown
+ * message types are ignored. The message is decoded into a DroneMessage on
+ * the stack by the allocation-free parser; json-c is only used for frames
+ * that parser rejects. Drones that negotiated the binary encoding are
+ * decoded with wire_decode_drone_message() instead.
+ * 
+ * @param d Drone the message was received from
+ * @param message Start of the JSON object
+ * @param length Length of the object; message[length] must be writable
+ */
+// clang-format off
+void process_drone_message(Drone *d, char *message, size_t length)
+// clang-format on
+{
+    struct timespec start_time, end_time;
+    DroneMessage decoded;
+    time_t t;
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    int result = d->encoding == WIRE_ENCODING_BINARY ? wire_decode_drone_message(message, length, &decoded)
+                                                     : decode_drone_message(message, length, &decoded);
+    if (result != 0)
+    {
+        printf("Failed to decode message from drone %d\n", d->id);
+        perf_record_error();
+        return;
+    }
+
+    // Handle different message types
+    switch (decoded.type)
+    {
+        case DRONE_MSG_STATUS_UPDATE:
+            // Handle status update
             pthread_mutex_lock(&d->lock);
-            d->status = DISCONNECTED;
-            pthread_mutex_unlock(&d->lock);
 
-            if (drones->removenode(drones, node) == 0)
+            // Update drone location
+            if (decoded.fields & DRONE_FIELD_LOCATION)
             {
-                printf("Drone %d removed from list\n", d->id);
+                d->coord = decoded.location;
+            }
+
+            // Update status
+            if (decoded.fields & DRONE_FIELD_STATUS)
+            {
+                int became_idle = decoded.status == IDLE && d->status != IDLE;
+                drone_set_status(d, (DroneStatus)decoded.status);
+                if (became_idle)
+                    ai_events_post(&ai_events, AI_EVENT_DRONE_IDLE, d->coord);
             }
             else
             {
-                printf("Failed to remove drone %d from list\n", d->id);
-                perf_record_error();
+                drone_index_update(d);
             }
 
-            perf_record_connection(0); // Record disconnection
-            break;
-        }
+            // Update last update time
+            time(&t);
+            localtime_r(&t, &d->last_update);
 
-        buffer[bytes_received] = '\0';
-        perf_record_status_update(bytes_received);
+            pthread_mutex_unlock(&d->lock);
 
-        // Try to parse multiple JSON messages in a single buffer
-        char *json_start = buffer;
-        char *json_end = NULL;
-        int json_depth = 0;
-        int in_string = 0;
-        int escape_next = 0;
+            // Record processing time
+            clock_gettime(CLOCK_MONOTONIC, &end_time);
+            perf_record_latency(PERF_OP_STATUS_UPDATE, elapsed_ms(&start_time, &end_time));
+            break;
 
-        for (int i = 0; i < bytes_received; i++)
+        case DRONE_MSG_MISSION_COMPLETE:
         {
-            // Track JSON structure to find complete objects
-            if (escape_next)
-            {
-                escape_next = 0;
-                continue;
-            }
+            // Handle mission completion
+            printf("Received MISSION_COMPLETE message from drone %d\n", d->id);
 
-            if (buffer[i] == '\\' && !escape_next)
-            {
-                escape_next = 1;
-                continue;
-            }
+            // Get target location if provided in the message
+            Coord target_coord = (decoded.fields & DRONE_FIELD_TARGET) ? decoded.target : d->target;
 
-            if (buffer[i] == '"' && !escape_next)
-            {
-                in_string = !in_string;
-                continue;
-            }
+            pthread_mutex_lock(&d->lock);
+            drone_set_status(d, IDLE);
+            pthread_mutex_unlock(&d->lock);
 
-            if (!in_string)
-            {
-                if (buffer[i] == '{')
-                {
-                    if (json_depth == 0)
-                    {
-                        json_start = buffer + i;
-                    }
-                    json_depth++;
-                }
-                else if (buffer[i] == '}')
-                {
-                    json_depth--;
-                    if (json_depth == 0)
-                    {
-                        json_end = buffer + i + 1;
-
-                        // We found a complete JSON object, process it
-                        // clang-format off
-                        char temp = *json_end;
-                        *json_end = '\0';
-                        
-                        clock_gettime(CLOCK_MONOTONIC, &start_time); // Reset timer for individual message
-                        parsed_json = json_tokener_parse(json_start);
-                        
-                        *json_end = temp; // Restore the buffer
-                        // clang-format on
-                        if (parsed_json == NULL)
-                        {
-                            printf("Failed to parse JSON data from drone %d\n", d->id);
-                            perf_record_error();
-                            continue;
-                        }
-
-                        // Handle different message types
-                        if (json_object_object_get_ex(parsed_json, "type", &type_obj))
-                        {
-                            // clang-format off
-                            const char *msg_type = json_object_get_string(type_obj);
-                            // clang-format on
-                            if (strcmp(msg_type, "STATUS_UPDATE") == 0)
-                            {
-                                // Handle status update
-                                pthread_mutex_lock(&d->lock);
-
-                                // Update drone location
-                                // clang-format off
-                                struct json_object *location_obj;
-                                // clang-format on
-                                if (json_object_object_get_ex(parsed_json, "location", &location_obj))
-                                {
-                                    // clang-format off
-                                    struct json_object *x_obj, *y_obj;
-                                    // clang-format on
-                                    if (json_object_object_get_ex(location_obj, "x", &x_obj) &&
-                                        json_object_object_get_ex(location_obj, "y", &y_obj))
-                                    {
-                                        d->coord.x = json_object_get_int(x_obj);
-                                        d->coord.y = json_object_get_int(y_obj);
-                                    }
-                                }
-
-                                // Update status
-                                // clang-format off
-                                struct json_object *status_obj;
-                                // clang-format on
-                                if (json_object_object_get_ex(parsed_json, "status", &status_obj))
-                                {
-                                    // clang-format off
-                                    const char *status_str = json_object_get_string(status_obj);
-                                    // clang-format on
-                                    if (strcmp(status_str, "idle") == 0)
-                                        d->status = IDLE;
-                                    else if (strcmp(status_str, "busy") == 0)
-                                        d->status = ON_MISSION;
-                                }
-
-                                // Update last update time
-                                time(&t);
-                                localtime_r(&t, &d->last_update);
-
-                                pthread_mutex_unlock(&d->lock);
-
-                                // Record processing time
-                                clock_gettime(CLOCK_MONOTONIC, &end_time);
-                                double processing_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
-                                                         (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-                                perf_record_response_time(processing_time);
-                            }
-                            else if (strcmp(msg_type, "MISSION_COMPLETE") == 0)
-                            {
-                                // Handle mission completion
-                                printf("Received MISSION_COMPLETE message from drone %d\n", d->id);
-
-                                // Get target location if provided in the message
-                                Coord target_coord = d->target; // Default to current target
-                                // clang-format off
-                                struct json_object *target_location;
-                                // clang-format on
-                                if (json_object_object_get_ex(parsed_json, "target_location", &target_location))
-                                {
-                                    // clang-format off
-                                    struct json_object *x_obj, *y_obj;
-                                    // clang-format on
-                                    if (json_object_object_get_ex(target_location, "x", &x_obj) &&
-                                        json_object_object_get_ex(target_location, "y", &y_obj))
-                                    {
-                                        target_coord.x = json_object_get_int(x_obj);
-                                        target_coord.y = json_object_get_int(y_obj);
-                                    }
-                                }
-
-                                pthread_mutex_lock(&d->lock);
-                                d->status = IDLE;
-                                pthread_mutex_unlock(&d->lock);
-
-                                // Call update_drone_status with explicit target coordinates
-                                update_drone_status(d, &target_coord);
-
-                                // Record mission completion processing time
-                                clock_gettime(CLOCK_MONOTONIC, &end_time);
-                                double processing_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
-                                                         (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-                                perf_record_response_time(processing_time);
-                            }
-                            else if (strcmp(msg_type, "HEARTBEAT_RESPONSE") == 0)
-                            {
-                                // Update last contact time
-                                pthread_mutex_lock(&d->lock);
-                                time(&t);
-                                localtime_r(&t, &d->last_update);
-                                pthread_mutex_unlock(&d->lock);
-
-                                // Record heartbeat response time
-                                clock_gettime(CLOCK_MONOTONIC, &end_time);
-                                double heartbeat_time = (end_time.tv_sec - start_time.tv_sec) * 1000.0 +
-                                                        (end_time.tv_nsec - start_time.tv_nsec) / 1000000.0;
-                                perf_record_response_time(heartbeat_time);
-                            }
-                        }
-
-                        json_object_put(parsed_json);
-
-                        // Move to next character after this JSON object
-                        json_start = json_end;
-                    }
-                }
-            }
+            // Call update_drone_status with explicit target coordinates
+            update_drone_status(d, &target_coord);
+
+            // Wake the AI once the survivor is marked rescued
+            pthread_mutex_lock(&d->lock);
+            Coord idle_at = d->coord;
+            pthread_mutex_unlock(&d->lock);
+            ai_events_post(&ai_events, AI_EVENT_DRONE_IDLE, idle_at);
+
+            // Record mission completion processing time
+            clock_gettime(CLOCK_MONOTONIC, &end_time);
+            perf_record_latency(PERF_OP_MISSION_COMPLETE, elapsed_ms(&start_time, &end_time));
+            break;
         }
-    }
 
-    close(sock);
-    return NULL;
+        case DRONE_MSG_HEARTBEAT_RESPONSE:
+            // Update last contact time
+            pthread_mutex_lock(&d->lock);
+            time(&t);
+            localtime_r(&t, &d->last_update);
+            pthread_mutex_unlock(&d->lock);
+
+            // Record heartbeat response time
+            clock_gettime(CLOCK_MONOTONIC, &end_time);
+            perf_record_latency(PERF_OP_HEARTBEAT, elapsed_ms(&start_time, &end_time));
+            break;
+
+        default:
+            break;
+    }
 }
 
 /**
@@ -615,19 +954,19 @@ void update_drone_status(Drone *drone, Coord *target)
 
     // Find which survivor this drone was helping
     pthread_mutex_lock(&survivors_mutex);
-    for (int j = 0; j < num_survivors; j++)
+    for (int j = survivor_store_next(&survivor_store, 1, 0); j >= 0; j = survivor_store_next(&survivor_store, 1, j + 1))
     {
         // Check for survivors being helped (status 1) that match the drone's target location
-        if (survivor_array[j].status == 1 && survivor_array[j].coord.x == target->x &&
-            survivor_array[j].coord.y == target->y)
+        if (survivor_store.x[j] == target->x && survivor_store.y[j] == target->y)
         {
             // Mark survivor as rescued
-            survivor_array[j].status = 2; // 2 = rescued (won't be drawn)
+            survivor_set_status(j, 2); // 2 = rescued (won't be drawn)
 
             // Set rescue timestamp
             time_t t;
             time(&t);
-            localtime_r(&t, &survivor_array[j].helped_time);
+            localtime_r(&t, &survivor_store.times[j].helped_time);
+            survivor_trace_rescue(j, drone->id);
 
             printf("Server updated survivor %d status to rescued by drone %d\n", j, drone->id);
 
@@ -647,6 +986,98 @@ void update_drone_status(Drone *drone, Coord *target)
     // The drone status has already been set to IDLE in the calling function
 }
 
+/**
+ * @brief Reflect a drone's status and coord in idle_drone_index
+ * 
+ * @param drone Drone whose state changed; the caller holds drone->lock
+ */
+void drone_index_update(Drone *drone)
+{
+    if (drone->status == IDLE)
+    {
+        if (spatial_index_insert(&idle_drone_index, drone->id, drone->coord, drone) != 0)
+        {
+            fprintf(stderr, "Failed to index idle drone %d\n", drone->id);
+            perf_record_error();
+        }
+    }
+    else
+    {
+        spatial_index_remove(&idle_drone_index, drone->id);
+    }
+}
+
+/**
+ * @brief Add @p delta to the statistics counter of a drone status
+ */
+static void count_drone_status(DroneStatus status, int delta)
+{
+    if (status == IDLE)
+        atomic_fetch_add_explicit(&idle_drones, delta, memory_order_relaxed);
+    else if (status == ON_MISSION)
+        atomic_fetch_add_explicit(&mission_drones, delta, memory_order_relaxed);
+}
+
+/**
+ * @brief Change a drone's status, its index entry and the statistics
+ * 
+ * @param drone Drone to update; the caller holds drone->lock
+ * @param status New status
+ */
+void drone_set_status(Drone *drone, DroneStatus status)
+{
+    count_drone_status(drone->status, -1);
+    count_drone_status(status, 1);
+    drone->status = status;
+    drone_index_update(drone);
+}
+
+/**
+ * @brief Recount drones by status and compare with the statistics
+ * 
+ * Holds every drone's lock while counting, since drone_set_status() only
+ * needs the drone's own lock.
+ * 
+ * @return 0 if the counters match, -1 otherwise
+ */
+int drone_stats_verify(void)
+{
+    int idle = 0;
+    int on_mission = 0;
+
+    pthread_mutex_lock(&drones->lock);
+    // clang-format off
+    for (Node *current = drones->head; current != NULL; current = current->next)
+    {
+        Drone *d = (Drone *)current->data;
+        // clang-format on
+        pthread_mutex_lock(&d->lock);
+        if (d->status == IDLE)
+            idle++;
+        else if (d->status == ON_MISSION)
+            on_mission++;
+    }
+
+    int counted_idle = atomic_load_explicit(&idle_drones, memory_order_relaxed);
+    int counted_mission = atomic_load_explicit(&mission_drones, memory_order_relaxed);
+
+    // clang-format off
+    for (Node *current = drones->head; current != NULL; current = current->next)
+    {
+        pthread_mutex_unlock(&((Drone *)current->data)->lock);
+    }
+    // clang-format on
+    pthread_mutex_unlock(&drones->lock);
+
+    if (counted_idle != idle || counted_mission != on_mission)
+    {
+        fprintf(stderr, "Drone counters out of step: idle %d (recount %d), on mission %d (recount %d)\n",
+                counted_idle, idle, counted_mission, on_mission);
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * @brief Clean up drone resources
  * 
@@ -684,4 +1115,15 @@ void cleanup_drones()
     }
 
     // Drones list itself will be destroyed in controller.c cleanup_resources()
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Key of a Drone stored in a List
+ * 
+ * @param data Drone element
+ * @return Address of its id
+ */
+const void *drone_list_key(const void *data)
+{
+    return &((const Drone *)data)->id;
+}
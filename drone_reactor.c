@@ -0,0 +1,479 @@
+/**
+ * @file drone_reactor.c
+ * @brief Edge-triggered epoll reactor for drone client connections
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implements the SERVER_MODE_EPOLL connection model. Each worker thread owns
+ * an epoll instance, a listening socket bound with SO_REUSEPORT and every
+ * connection accepted through it. Connection state lives in a small
+ * per-connection structure instead of a thread stack.
+ *
+ * **Event Loop:**
+ * - Listening sockets and client sockets are registered with EPOLLET
+ * - Accept and recv are repeated until EAGAIN, as edge triggering requires
+ * - Bytes are received straight into the connection's MessageFramer
+ * - The first frame on a connection is the HANDSHAKE; later frames are
+ *   dispatched through process_drone_frames()
+ * - An incomplete trailing message stays in the framer until more arrives
+ *
+ * **Thread Safety:**
+ * A connection is only ever touched by the worker that accepted it. All
+ * shared simulation state is reached through the drone protocol handlers,
+ * which use the same locks as the threaded server.
+ *
+ * **Blocking:**
+ * Workers never wait on the AI. A closed connection whose drone is still
+ * pinned by a mission send is parked on the worker's closing list and
+ * reaped on a later loop pass (see reactor_reap()). The only send on a
+ * worker is HANDSHAKE_ACK, the first write on a fresh socket, which always
+ * fits the empty send buffer.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "headers/drone_reactor.h"
+#include "headers/drone.h"
+#include "headers/globals.h"
+#include "headers/server_throughput.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+/** @brief Reactor worker count (0 = one per online CPU) */
+int reactor_worker_count = 0;
+
+/**
+ * @struct reactor_connection
+ * @brief Per-connection state owned by a single reactor worker
+ */
+typedef struct reactor_connection {
+    int fd;                            /**< Non-blocking client socket */
+    Node *node;                        /**< Registered drone, NULL until the handshake completes */
+    struct timespec handshake_start; /**< When the first handshake bytes arrived */
+    MessageFramer framer;            /**< Receive ring buffer and message framing state */
+    struct reactor_worker *worker;   /**< Worker that accepted the connection */
+    struct reactor_connection *next; /**< Next connection on the worker's closing list */
+} ReactorConnection;
+
+/**
+ * @struct reactor_worker
+ * @brief One epoll event loop and its listening socket
+ */
+typedef struct reactor_worker {
+    int index;         /**< Worker number, for log messages */
+    int epoll_fd;      /**< epoll instance owned by this worker */
+    int listen_fd;     /**< Listening socket watched by this worker */
+    int owns_listener; /**< Non-zero if this worker must close listen_fd */
+    pthread_t thread;  /**< Worker thread handle */
+    // clang-format off
+    ReactorConnection *closing; /**< Closed connections whose drone a mission send still pins */
+    // clang-format on
+} ReactorWorker;
+
+/**
+ * @brief Put a descriptor into non-blocking mode
+ *
+ * @param fd Descriptor to modify
+ * @return 0 on success, -1 on failure
+ */
+static int set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Release a connection whose drone, if any, is unregistered
+ *
+ * @param conn Connection to free
+ */
+// clang-format off
+static void reactor_free(ReactorConnection *conn)
+// clang-format on
+{
+    // Closing the descriptor also removes it from the epoll set
+    close(conn->fd);
+    framer_destroy(&conn->framer);
+    free(conn);
+}
+
+/**
+ * @brief Close a connection and unregister its drone if it had one
+ *
+ * If a mission send still pins the drone, the connection is parked on the
+ * worker's closing list instead: the socket stops being watched but stays
+ * open, so its number cannot be reused by a new drone while the send may
+ * still write to it.
+ *
+ * @param conn Connection to close; freed now or by reactor_reap()
+ */
+// clang-format off
+static void reactor_close(ReactorConnection *conn)
+// clang-format on
+{
+    if (conn->node == NULL)
+    {
+        perf_record_connection(0);
+    }
+    else if (try_unregister_drone(conn->node) != 0)
+    {
+        epoll_ctl(conn->worker->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+        conn->next = conn->worker->closing;
+        conn->worker->closing = conn;
+        return;
+    }
+
+    reactor_free(conn);
+}
+
+/**
+ * @brief Free the parked connections whose drone is no longer pinned
+ *
+ * @param worker Worker owning the closing list
+ */
+// clang-format off
+static void reactor_reap(ReactorWorker *worker)
+{
+    ReactorConnection **link = &worker->closing;
+    // clang-format on
+    while (*link != NULL)
+    {
+        // clang-format off
+        ReactorConnection *conn = *link;
+        // clang-format on
+        if (try_unregister_drone(conn->node) == 0)
+        {
+            *link = conn->next;
+            reactor_free(conn);
+        }
+        else
+        {
+            link = &conn->next;
+        }
+    }
+}
+
+/**
+ * @brief Drain a readable connection until the socket would block
+ *
+ * @param conn Connection reported readable by epoll
+ */
+// clang-format off
+static void reactor_read(ReactorConnection *conn)
+// clang-format on
+{
+    while (1)
+    {
+        if (conn->node == NULL && conn->framer.tail == conn->framer.head)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &conn->handshake_start);
+        }
+
+        size_t space;
+        // clang-format off
+        char *dest = framer_write_space(&conn->framer, &space);
+        // clang-format on
+        ssize_t bytes_received = recv(conn->fd, dest, space, 0);
+        if (bytes_received > 0)
+        {
+            framer_commit(&conn->framer, (size_t)bytes_received);
+            perf_record_status_update(bytes_received);
+
+            if (process_drone_frames(conn->fd, &conn->node, &conn->framer, &conn->handshake_start) < 0)
+            {
+                reactor_close(conn);
+                return;
+            }
+            continue;
+        }
+
+        if (bytes_received == 0)
+        {
+            if (conn->node)
+                printf("Drone %d disconnected\n", ((Drone *)conn->node->data)->id);
+            else
+                printf("Client disconnected before handshake\n");
+            reactor_close(conn);
+            return;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return; // Drained; wait for the next edge
+        }
+
+        perror("Error receiving from drone");
+        perf_record_error();
+        reactor_close(conn);
+        return;
+    }
+}
+
+/**
+ * @brief Accept every pending connection on a worker's listening socket
+ *
+ * @param worker Worker whose listener became readable
+ */
+// clang-format off
+static void reactor_accept(ReactorWorker *worker)
+// clang-format on
+{
+    while (1)
+    {
+        struct sockaddr_in client_addr;
+        socklen_t addr_len = sizeof(client_addr);
+        // clang-format off
+        int new_socket = accept(worker->listen_fd, (struct sockaddr *)&client_addr, &addr_len);
+        // clang-format on
+        if (new_socket < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                perror("Accept failed");
+                perf_record_error();
+            }
+            return;
+        }
+
+        printf(
+            "New drone connection accepted from %s:%d\n", inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port));
+        perf_record_connection(1);
+
+        // clang-format off
+        ReactorConnection *conn = calloc(1, sizeof(ReactorConnection));
+        // clang-format on
+        if (conn == NULL || framer_init(&conn->framer, DRONE_FRAMER_CAPACITY, drone_frame_mode) != 0 ||
+            set_nonblocking(new_socket) < 0)
+        {
+            perror("Failed to set up drone connection");
+            perf_record_error();
+            if (conn)
+                framer_destroy(&conn->framer);
+            free(conn);
+            close(new_socket);
+            perf_record_connection(0);
+            continue;
+        }
+        conn->fd = new_socket;
+        conn->worker = worker;
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = conn;
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, new_socket, &ev) < 0)
+        {
+            perror("epoll_ctl add connection failed");
+            perf_record_error();
+            framer_destroy(&conn->framer);
+            free(conn);
+            close(new_socket);
+            perf_record_connection(0);
+            continue;
+        }
+
+        // Data may already be waiting; with EPOLLET no edge would report it
+        reactor_read(conn);
+    }
+}
+
+/**
+ * @brief Worker thread: run one epoll loop until shutdown
+ *
+ * Nothing on this loop waits for other threads: a drone that a mission
+ * send still pins is unregistered by reactor_reap() on a later pass, at
+ * most REACTOR_POLL_TIMEOUT_MS after the send let go of it.
+ *
+ * @param arg Pointer to this worker's ReactorWorker
+ * @return NULL on shutdown or fatal epoll error
+ */
+// clang-format off
+static void *reactor_worker_loop(void *arg)
+{
+    ReactorWorker *worker = (ReactorWorker *)arg;
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+    // clang-format on
+
+    while (running)
+    {
+        int count = epoll_wait(worker->epoll_fd, events, REACTOR_MAX_EVENTS, REACTOR_POLL_TIMEOUT_MS);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait failed");
+            perf_record_error();
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            // The listening socket is registered with a NULL pointer
+            if (events[i].data.ptr == NULL)
+            {
+                reactor_accept(worker);
+            }
+            else
+            {
+                reactor_read((ReactorConnection *)events[i].data.ptr);
+            }
+        }
+
+        if (worker->closing != NULL)
+        {
+            reactor_reap(worker);
+        }
+    }
+
+    // Shutting down: wait out the sends that still pin parked drones
+    while (worker->closing != NULL)
+    {
+        // clang-format off
+        ReactorConnection *conn = worker->closing;
+        // clang-format on
+        worker->closing = conn->next;
+        unregister_drone(conn->node);
+        reactor_free(conn);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Server thread function running the epoll reactor
+ *
+ * @param arg Unused thread parameter
+ * @return NULL when all workers have terminated
+ */
+// clang-format off
+void *drone_reactor(void *arg)
+// clang-format on
+{
+    (void)arg;
+
+    int worker_count = reactor_worker_count;
+    if (worker_count <= 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = cpus > 0 ? (int)cpus : 1;
+    }
+    if (worker_count > REACTOR_MAX_WORKERS)
+    {
+        worker_count = REACTOR_MAX_WORKERS;
+    }
+
+    ReactorWorker workers[REACTOR_MAX_WORKERS];
+    memset(workers, 0, sizeof(workers));
+    int started = 0;
+    int shared_listener = 0;
+
+    for (int i = 0; i < worker_count; i++)
+    {
+        workers[i].index = i;
+
+        // Prefer one SO_REUSEPORT listener per worker; fall back to sharing
+        // worker 0's listener (a shared accept queue) if that fails. Once
+        // one worker fell back, the rest share without retrying, which
+        // would only log the same failure again.
+        workers[i].listen_fd = shared_listener ? -1 : create_drone_listener(DRONE_SERVER_PORT, 1);
+        workers[i].owns_listener = 1;
+        if (workers[i].listen_fd < 0)
+        {
+            shared_listener = 1;
+            if (i == 0)
+            {
+                workers[i].listen_fd = create_drone_listener(DRONE_SERVER_PORT, 0);
+                if (workers[i].listen_fd < 0)
+                    break;
+            }
+            else
+            {
+                workers[i].listen_fd = workers[0].listen_fd;
+                workers[i].owns_listener = 0;
+            }
+        }
+
+        if (workers[i].owns_listener && set_nonblocking(workers[i].listen_fd) < 0)
+        {
+            perror("Failed to make listener non-blocking");
+            perf_record_error();
+            close(workers[i].listen_fd);
+            break;
+        }
+
+        workers[i].epoll_fd = epoll_create1(0);
+        if (workers[i].epoll_fd < 0)
+        {
+            perror("epoll_create1 failed");
+            perf_record_error();
+            if (workers[i].owns_listener)
+                close(workers[i].listen_fd);
+            break;
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        // A shared listener is level-triggered and exclusive so a single
+        // worker is woken per pending connection.
+        ev.events = workers[i].owns_listener ? (EPOLLIN | EPOLLET) : (EPOLLIN | EPOLLEXCLUSIVE);
+        ev.data.ptr = NULL;
+        if (epoll_ctl(workers[i].epoll_fd, EPOLL_CTL_ADD, workers[i].listen_fd, &ev) < 0 ||
+            pthread_create(&workers[i].thread, NULL, reactor_worker_loop, &workers[i]) != 0)
+        {
+            perror("Failed to start reactor worker");
+            perf_record_error();
+            close(workers[i].epoll_fd);
+            if (workers[i].owns_listener)
+                close(workers[i].listen_fd);
+            break;
+        }
+
+        started++;
+    }
+
+    if (started == 0)
+    {
+        fprintf(stderr, "Drone reactor failed to start\n");
+        return NULL;
+    }
+
+    printf("Drone reactor listening on port %d with %d epoll worker(s)...\n", DRONE_SERVER_PORT, started);
+
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    for (int i = 0; i < started; i++)
+    {
+        close(workers[i].epoll_fd);
+        if (workers[i].owns_listener)
+            close(workers[i].listen_fd);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,286 @@
+/**
+ * @file framer.c
+ * @brief Per-connection ring buffer that splits a TCP byte stream into messages
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the MessageFramer declared in framer.h. The ring is
+ * addressed with free-running counters so "full" and "empty" never need a
+ * separate flag, and the scanner state is kept between calls so partial
+ * messages are never rescanned from the beginning.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#include "headers/framer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Round a size up to the next power of two
+ *
+ * @param value Requested size (> 0)
+ * @return Smallest power of two >= value
+ */
+static size_t round_up_pow2(size_t value)
+{
+    size_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+int framer_init(MessageFramer *framer, size_t capacity, FrameMode mode)
+{
+    memset(framer, 0, sizeof(MessageFramer));
+    framer->capacity = round_up_pow2(capacity > 0 ? capacity : 1);
+    framer->mode = mode;
+
+    // One spare byte past the end so a frame ending at the physical end of
+    // the ring still has a writable byte after it.
+    framer->buffer = malloc(framer->capacity + 1);
+    if (!framer->buffer)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+void framer_destroy(MessageFramer *framer)
+{
+    free(framer->buffer);
+    free(framer->scratch);
+    framer->buffer = NULL;
+    framer->scratch = NULL;
+}
+
+char *framer_write_space(MessageFramer *framer, size_t *available)
+{
+    // Nothing buffered and no frame in progress: restart at the beginning
+    // of the ring so the next read gets the largest contiguous region.
+    if (framer->head == framer->tail && framer->depth == 0)
+    {
+        framer->head = framer->tail = framer->scan = 0;
+    }
+
+    size_t used = framer->tail - framer->head;
+    size_t index = framer->tail & (framer->capacity - 1);
+    size_t contiguous = framer->capacity - index;
+    size_t free_space = framer->capacity - used;
+
+    *available = free_space < contiguous ? free_space : contiguous;
+    return framer->buffer + index;
+}
+
+void framer_commit(MessageFramer *framer, size_t bytes)
+{
+    framer->tail += bytes;
+}
+
+/**
+ * @brief Describe the bytes [start, start + length) as a contiguous frame
+ *
+ * @param framer Framer owning the bytes
+ * @param start Free-running position of the first byte
+ * @param length Number of bytes
+ * @param frame Receives the frame
+ * @return 1 on success, -1 if the scratch buffer cannot be allocated
+ */
+static int emit_frame(MessageFramer *framer, size_t start, size_t length, Frame *frame)
+{
+    size_t index = start & (framer->capacity - 1);
+
+    if (index + length <= framer->capacity)
+    {
+        frame->data = framer->buffer + index;
+        frame->length = length;
+        return 1;
+    }
+
+    // The frame wraps around the end of the ring; linearize it
+    if (!framer->scratch)
+    {
+        framer->scratch = malloc(framer->capacity + 1);
+        if (!framer->scratch)
+        {
+            return -1;
+        }
+    }
+
+    size_t first = framer->capacity - index;
+    memcpy(framer->scratch, framer->buffer + index, first);
+    memcpy(framer->scratch + first, framer->buffer, length - first);
+    frame->data = framer->scratch;
+    frame->length = length;
+    return 1;
+}
+
+/**
+ * @brief Scan for the next brace-balanced JSON object
+ */
+static int next_brace_frame(MessageFramer *framer, Frame *frame)
+{
+    size_t mask = framer->capacity - 1;
+
+    while (framer->scan < framer->tail)
+    {
+        size_t position = framer->scan++;
+        char c = framer->buffer[position & mask];
+
+        if (framer->depth == 0)
+        {
+            if (c == '{')
+            {
+                framer->depth = 1;
+                framer->frame_start = position;
+            }
+            else
+            {
+                // Separator or noise between objects: release it
+                framer->head = framer->scan;
+            }
+            continue;
+        }
+
+        if (framer->in_string)
+        {
+            if (framer->escape_next)
+                framer->escape_next = 0;
+            else if (c == '\\')
+                framer->escape_next = 1;
+            else if (c == '"')
+                framer->in_string = 0;
+            continue;
+        }
+
+        if (c == '"')
+        {
+            framer->in_string = 1;
+        }
+        else if (c == '{')
+        {
+            framer->depth++;
+        }
+        else if (c == '}' && --framer->depth == 0)
+        {
+            framer->head = framer->scan;
+            return emit_frame(framer, framer->frame_start, framer->scan - framer->frame_start, frame);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Scan for the next non-empty newline-terminated line
+ */
+static int next_line_frame(MessageFramer *framer, Frame *frame)
+{
+    size_t mask = framer->capacity - 1;
+
+    while (framer->scan < framer->tail)
+    {
+        size_t position = framer->scan++;
+        if (framer->buffer[position & mask] != '\n')
+        {
+            continue;
+        }
+
+        size_t start = framer->head;
+        size_t length = position - start;
+        framer->head = framer->scan;
+
+        if (length > 0 && framer->buffer[(start + length - 1) & mask] == '\r')
+        {
+            length--;
+        }
+        if (length == 0)
+        {
+            continue; // Skip empty lines
+        }
+        return emit_frame(framer, start, length, frame);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Extract the next length-prefixed binary message
+ */
+static int next_binary_frame(MessageFramer *framer, Frame *frame)
+{
+    size_t mask = framer->capacity - 1;
+
+    // Separator left over from the text frame before the mode switch
+    while (framer->skip_separator && framer->head != framer->tail)
+    {
+        char c = framer->buffer[framer->head & mask];
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+            framer->skip_separator = 0;
+        else
+            framer->head++;
+    }
+
+    size_t available = framer->tail - framer->head;
+    if (available < FRAME_BINARY_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    // The length occupies the last two header bytes, most significant first
+    size_t start = framer->head;
+    size_t length = ((size_t)(unsigned char)framer->buffer[(start + FRAME_BINARY_HEADER_SIZE - 2) & mask] << 8) |
+                    (unsigned char)framer->buffer[(start + FRAME_BINARY_HEADER_SIZE - 1) & mask];
+    size_t total = FRAME_BINARY_HEADER_SIZE + length;
+
+    if (total > framer->capacity)
+    {
+        return -1;
+    }
+    if (available < total)
+    {
+        return 0;
+    }
+
+    framer->head = framer->scan = start + total;
+    return emit_frame(framer, start, total, frame);
+}
+
+int framer_next(MessageFramer *framer, Frame *frame)
+{
+    int result;
+    switch (framer->mode)
+    {
+        case FRAME_NEWLINE:
+            result = next_line_frame(framer, frame);
+            break;
+        case FRAME_BINARY:
+            result = next_binary_frame(framer, frame);
+            break;
+        default:
+            result = next_brace_frame(framer, frame);
+            break;
+    }
+
+    if (result == 0 && framer->tail - framer->head == framer->capacity)
+    {
+        return -1; // A single message larger than the whole ring
+    }
+    return result;
+}
+
+void framer_set_mode(MessageFramer *framer, FrameMode mode)
+{
+    framer->skip_separator = mode == FRAME_BINARY && framer->mode != FRAME_BINARY;
+    framer->mode = mode;
+    framer->scan = framer->head;
+    framer->depth = 0;
+    framer->in_string = 0;
+    framer->escape_next = 0;
+}
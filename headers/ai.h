@@ -21,8 +21,19 @@
  * **AI Strategies:**
  * - Survivor-centric: Assign closest drone to each waiting survivor
  * - Drone-centric: Assign closest survivor to each idle drone
+ * - Batch: Match all idle drones to waiting survivors at once, minimizing
+ *   the total travel distance of the cycle (see assignment.h)
+ * - Partitioned: Drone-centric, run in parallel over map regions by a
+ *   pool of worker threads (see ai_partition.h)
  * - Distance optimization using Manhattan distance calculations
  * 
+ * **Wake-up:**
+ * By default the AI thread sleeps on ai_events (see ai_events.h) and
+ * wakes as soon as a survivor starts waiting or a drone becomes idle; the
+ * greedy strategies then only re-plan around the cell where that
+ * happened. With ai_event_driven cleared it polls with a full pass every
+ * second instead.
+ * 
  * @copyright Copyright (c) 2024
  * 
  * @ingroup core_modules
@@ -48,6 +59,47 @@
  * @{
  */
 
+/**
+ * @brief Candidate survivors listed per drone by the batch strategy
+ * 
+ * Each idle drone is offered its AI_BATCH_CANDIDATES nearest waiting
+ * survivors. The batch matching is exactly optimal while there are at
+ * most this many idle drones, and close to it beyond that.
+ */
+#define AI_BATCH_CANDIDATES 32
+
+/**
+ * @enum AiStrategy
+ * @brief Assignment strategy run by the AI thread
+ * 
+ * Selected once at startup (see controller.c command line options) so the
+ * strategies can be compared under the same load.
+ */
+typedef enum {
+    AI_STRATEGY_DRONE_CENTRIC = 0,    /**< drone_centric_ai_controller() */
+    AI_STRATEGY_SURVIVOR_CENTRIC = 1, /**< ai_controller() */
+    AI_STRATEGY_BATCH = 2,            /**< batch_ai_controller() */
+    AI_STRATEGY_PARTITIONED = 3       /**< partitioned_ai_controller() */
+} AiStrategy;
+
+/**
+ * @brief Strategy the AI thread runs with
+ * 
+ * Defaults to AI_STRATEGY_DRONE_CENTRIC. Must be set before the AI thread
+ * is started.
+ */
+extern AiStrategy ai_strategy;
+
+/**
+ * @brief Whether the AI thread waits for ai_events instead of polling
+ * 
+ * Defaults to 1. When set, the controller calls ai_events_init() before
+ * starting the AI thread; if that fails it clears the flag and the AI
+ * falls back to a full pass every second. Must be set before the AI
+ * thread is started.
+ */
+extern int ai_event_driven;
+
 /**
  * @brief Main AI controller using survivor-centric assignment strategy
  * 
@@ -81,7 +133,10 @@
  * @pre Global drone and survivor lists must be available
  * @post Continuous mission assignment until thread termination
  * 
- * @note Runs with 1-second cycle time for balanced performance
+ * @note Runs with 1-second cycle time for balanced performance, or
+ *       event-driven with run_event_assignment() (see ai_event_driven);
+ *       the completion phase only runs when polling, since event-driven
+ *       drones report MISSION_COMPLETE themselves
  * @note Includes both assignment and completion phases
  * @warning Must be properly cancelled during system shutdown
  * 
@@ -125,7 +180,8 @@ void* ai_controller(void *args);
  * @pre Global drone and survivor lists must be available
  * @post Continuous mission assignment until thread termination
  * 
- * @note Runs with 1-second cycle time for balanced performance
+ * @note Runs with 1-second cycle time for balanced performance, or
+ *       event-driven with run_event_assignment() (see ai_event_driven)
  * @note Does not include explicit completion detection phase
  * @warning Must be properly cancelled during system shutdown
  * 
@@ -135,6 +191,122 @@ void* ai_controller(void *args);
 // clang-format off
 void* drone_centric_ai_controller(void *args);
 // clang-format on
+
+/**
+ * @brief Run one assignment pass of the survivor-centric strategy
+ * 
+ * The first phase of ai_controller(): for every waiting survivor, in
+ * array order, find the closest idle drone and assign it. Exposed so the
+ * pass can be timed on its own (see tests/ai_benchmark.c).
+ * 
+ * **Thread Safety:**
+ * Holds drones->lock while assigning, like run_drone_centric_cycle().
+ * 
+ * @return Number of missions assigned
+ * 
+ * @see find_closest_idle_drone() for the drone query
+ */
+int run_survivor_centric_cycle(void);
+
+/**
+ * @brief Run one assignment pass of the drone-centric strategy
+ * 
+ * The assignment phase of drone_centric_ai_controller(): for every idle
+ * drone, in list order, find the closest waiting survivor and assign it.
+ * 
+ * **Thread Safety:**
+ * Holds drones->lock while claiming survivors, so no drone is freed
+ * meanwhile, and releases it before sending: the missions are collected
+ * in a MissionBatch and sent by mission_batch_flush() afterwards, so a
+ * drone with a full socket never keeps drones->lock held. Missions whose
+ * send fails are rolled back and not counted.
+ * 
+ * @return Number of missions assigned
+ * 
+ * @see find_closest_waiting_survivor() for the survivor query
+ */
+int run_drone_centric_cycle(void);
+
+/**
+ * @brief AI controller using the batch assignment strategy
+ * 
+ * Same loop and timing as drone_centric_ai_controller(), but each cycle
+ * decides all assignments together with run_batch_assignment_cycle().
+ * Event-driven, it runs one such cycle per wake-up (covering every event
+ * that woke it), since the matching needs all idle drones at once.
+ * Greedy strategies give each drone its closest survivor in turn, which
+ * can leave a later drone with a long trip; the batch strategy minimizes
+ * the sum of all trips assigned in the cycle.
+ * 
+ * @param args Unused thread parameter (required for pthread compatibility)
+ * @return NULL when thread terminates
+ * 
+ * @warning Must be properly cancelled during system shutdown
+ * 
+ * @see drone_centric_ai_controller() for the greedy equivalent
+ */
+// clang-format off
+void* batch_ai_controller(void *args);
+// clang-format on
+
+/**
+ * @brief Run one assignment pass of the batch strategy
+ * 
+ * Snapshots the idle drones, lists each one's AI_BATCH_CANDIDATES nearest
+ * waiting survivors from waiting_survivor_index, and solves the resulting
+ * minimum-distance assignment with solve_assignment(). The candidates are
+ * numbered densely first, so the solver's work arrays grow with the number
+ * of candidates, not with the highest survivor index. Drones left
+ * unmatched by their candidate lists fall back to
+ * find_closest_waiting_survivor().
+ * 
+ * **Thread Safety:**
+ * Holds drones->lock while matching and claiming, and sends after
+ * releasing it, like run_drone_centric_cycle().
+ * 
+ * @return Number of missions assigned
+ * 
+ * @see solve_assignment() for the matching algorithm
+ */
+int run_batch_assignment_cycle(void);
+
+/**
+ * @brief Re-plan around one event instead of running a full pass
+ * 
+ * Pairs the waiting survivor closest to @p origin with the idle drone
+ * closest to that survivor, and repeats until either side runs out or an
+ * assignment does not go through. For a new survivor this is the closest
+ * idle drone; for a newly idle drone it is the survivor nearest to it,
+ * unless another idle drone is even closer to that survivor.
+ * 
+ * Between events every waiting survivor has been offered every idle
+ * drone, so the pairs around @p origin are the only new ones possible.
+ * 
+ * @param origin Cell where a survivor started waiting or a drone became idle
+ * @return Number of missions assigned
+ * 
+ * @see ai_events_take() for where the events come from
+ */
+int run_event_assignment(Coord origin);
+
+/**
+ * @brief AI controller using the partitioned strategy
+ * 
+ * Same loop and timing as batch_ai_controller(), but each cycle runs
+ * run_partitioned_assignment_cycle(), which splits the map into regions
+ * and assigns them on ai_partition_workers threads. Event-driven, it runs
+ * one cycle per wake-up.
+ * 
+ * @param args Unused thread parameter (required for pthread compatibility)
+ * @return NULL when thread terminates
+ * 
+ * @warning Must be properly cancelled during system shutdown
+ * 
+ * @see drone_centric_ai_controller() for the single-threaded equivalent
+ */
+// clang-format off
+void* partitioned_ai_controller(void *args);
+// clang-format on
 /** @} */ // end of ai_controllers group
 
 /**
@@ -143,6 +315,95 @@ void* drone_centric_ai_controller(void *args);
  * @{
  */
 
+/** @brief Missions a MissionBatch has room for before its first growth */
+#define MISSION_BATCH_INITIAL 16
+
+/**
+ * @struct mission_send
+ * @brief A claimed mission whose message has not been sent yet
+ * 
+ * Holds a pin on its drone (Drone::pins), so unregister_drone() waits for
+ * the send instead of freeing the drone under it.
+ */
+typedef struct mission_send {
+    // clang-format off
+    Drone *drone;               /**< Drone on the mission, pinned */
+    // clang-format on
+    int survivor_index;         /**< Survivor the drone was assigned */
+    int socket;                 /**< Drone socket when the mission was claimed */
+    WireEncoding encoding;      /**< Drone encoding when the mission was claimed */
+    int drone_id;               /**< Drone id, for logging */
+    Coord target;               /**< Survivor position the drone was sent to */
+    struct timespec start_time; /**< When the assignment started, for its latency */
+} MissionSend;
+
+/**
+ * @struct mission_batch
+ * @brief Missions claimed under drones->lock, to be sent once it is released
+ * 
+ * An assignment pass claims survivors with mission_batch_assign() while it
+ * holds drones->lock, releases the lock, then calls mission_batch_flush().
+ * Local drones need no message and are never queued. Zero-initialize
+ * (`MissionBatch batch = { 0 };`) and release with mission_batch_destroy().
+ */
+typedef struct mission_batch {
+    // clang-format off
+    MissionSend *sends; /**< Queued missions */
+    // clang-format on
+    int count;          /**< Missions queued */
+    int capacity;       /**< Missions sends has room for */
+} MissionBatch;
+
+/**
+ * @brief Claim a survivor for a drone and queue its mission message
+ * 
+ * Does everything assign_mission() does except the send: the drone is
+ * locked, checked to be idle, the survivor claimed with survivor_claim(),
+ * and the drone set ON_MISSION. A networked drone is pinned and its
+ * message queued in @p batch; a local drone's assignment is complete.
+ * 
+ * @param batch Batch to queue the message in
+ * @param drone Drone receiving the mission; the caller keeps it from
+ *              being freed for the duration of the call (drones->lock)
+ * @param survivor_index Survivor to rescue
+ * @return 1 if assigned, 0 if the drone was not idle or the survivor not
+ *         waiting (logged and counted as an error), -1 on invalid
+ *         arguments or if the batch cannot grow (nothing claimed)
+ */
+int mission_batch_assign(MissionBatch *batch, Drone *drone, int survivor_index);
+
+/**
+ * @brief Like mission_batch_assign(), but a lost claim is not an error
+ * 
+ * @param batch Batch to queue the message in
+ * @param drone Drone receiving the mission
+ * @param survivor_index Survivor to rescue
+ * @return 1 if assigned, 0 if the survivor or drone was already taken, -1
+ *         on failure
+ * 
+ * @see claim_mission() for the immediate equivalent
+ */
+int mission_batch_claim(MissionBatch *batch, Drone *drone, int survivor_index);
+
+/**
+ * @brief Send every queued mission and empty the batch
+ * 
+ * Call with no lock held: each send may wait up to DRONE_SEND_TIMEOUT_MS
+ * for a full socket. A failed send is rolled back as in assign_mission().
+ * Every queued drone is unpinned.
+ * 
+ * @param batch Batch filled by mission_batch_assign() or mission_batch_claim()
+ * @return Number of missions whose send failed
+ */
+int mission_batch_flush(MissionBatch *batch);
+
+/**
+ * @brief Release the memory of a flushed batch
+ * 
+ * @param batch Batch to release; it is left empty and can be reused
+ */
+void mission_batch_destroy(MissionBatch *batch);
+
 /**
  * @brief Assign a rescue mission to a specific drone for a specific survivor
  * 
@@ -152,12 +413,16 @@ void* drone_centric_ai_controller(void *args);
  * 
  * **Assignment Process:**
  * 1. Validate drone and survivor parameters
- * 2. Lock both drone and survivor for atomic updates
- * 3. Verify both entities are in assignable states
- * 4. Update drone target coordinates and status
- * 5. Update survivor status to "being helped"
- * 6. Send mission message to networked drones
- * 7. Record performance metrics and timestamps
+ * 2. Lock the drone and check that it is idle
+ * 3. Claim the survivor with survivor_claim() (waiting to "being helped")
+ * 4. Update drone target coordinates and status, then unlock
+ * 5. Build and send the mission message to networked drones, with no
+ *    lock held
+ * 6. Record performance metrics and timestamps
+ * 
+ * survivors_mutex is never taken, and a drone whose socket buffer is full
+ * blocks only the calling thread in send(), not the generator, the other
+ * drones or the renderer.
  * 
  * **Network Communication:**
  * For networked drone clients, creates a JSON mission message containing:
@@ -168,29 +433,56 @@ void* drone_centric_ai_controller(void *args);
  * 
  * **Error Handling:**
  * - Validates all input parameters
- * - Rolls back status changes on network failures
+ * - Rolls back status changes on network failures: the drone goes back
+ *   to idle unless it was given something else meanwhile, and the
+ *   survivor is released with survivor_release()
  * - Records errors in performance monitoring system
  * - Provides detailed logging for debugging
  * 
  * @param drone Pointer to the drone receiving the mission assignment
  * @param survivor_index Array index of the survivor requiring rescue
+ * @return 1 if assigned, 0 if the drone was not idle or the survivor not
+ *         waiting (logged and counted as an error), -1 on invalid arguments
+ *         or a failed send (rolled back); callers count only 1
  * 
  * @pre drone must be valid pointer to initialized drone
- * @pre survivor_index must be valid array index (0 <= index < num_survivors)
+ * @pre survivor_index must be valid store index (0 <= index < survivor_store.count)
  * @pre Drone should be in IDLE status for successful assignment
  * @pre Survivor should have status 0 (waiting) for assignment
  * @post Drone status is ON_MISSION with target set to survivor location
  * @post Survivor status is 1 (being helped)
  * @post Network message sent to remote drones if applicable
  * 
- * @note Function is thread-safe with proper mutex coordination
+ * @note Function is thread-safe, but sends before returning: callers keep
+ *       the drone from being freed without holding drones->lock across
+ *       the call. Assignment passes that hold drones->lock use a
+ *       MissionBatch instead
  * @note Handles both local and networked drone types automatically
  * @warning Assignment may fail if entities are in wrong states
  * 
  * @see find_closest_idle_drone() for drone selection
  * @see update_drone_status() for mission completion handling
  */
-void assign_mission(Drone *drone, int survivor_index);
+int assign_mission(Drone *drone, int survivor_index);
+
+/**
+ * @brief Assign a mission, treating a survivor that is already taken as a lost claim
+ * 
+ * Same as assign_mission(), except that a survivor that is no longer
+ * waiting (or a drone no longer idle) is reported through the return
+ * value instead of being logged and counted as an error. The survivor's
+ * 0 to 1 compare-and-swap in survivor_claim() is the claim, so when
+ * several threads offer the same survivor exactly one of them wins
+ * without taking survivors_mutex.
+ * 
+ * @param drone Pointer to the drone receiving the mission assignment
+ * @param survivor_index Array index of the survivor requiring rescue
+ * @return 1 if assigned, 0 if the survivor or drone was already taken,
+ *         -1 on invalid arguments or a failed send (rolled back)
+ * 
+ * @see run_partitioned_assignment_cycle() for the concurrent claims
+ */
+int claim_mission(Drone *drone, int survivor_index);
 
 /** @} */ // end of mission_assignment group
 
@@ -251,40 +543,36 @@ int calculate_distance(Coord a, Coord b);
 /**
  * @brief Find the closest idle drone to a specific survivor location
  * 
- * Searches through all available drones to find the one that is both
- * idle and closest to the specified survivor. This function implements
- * the core optimization logic for survivor-centric mission assignment.
+ * Returns the idle drone closest to the specified survivor. This function
+ * implements the core optimization logic for survivor-centric mission
+ * assignment.
  * 
  * **Search Algorithm:**
  * 1. Validate survivor index and get survivor coordinates
- * 2. Initialize minimum distance tracker
- * 3. Iterate through all drones in the global list
- * 4. For each drone, check if status is IDLE
- * 5. Calculate distance to survivor location
- * 6. Track drone with minimum distance
- * 7. Return closest idle drone or NULL if none available
+ * 2. Query idle_drone_index, which visits map buckets in rings of growing
+ *    Manhattan distance around the survivor
+ * 3. Stop once no bucket further out can hold a closer drone
+ * 4. Return closest idle drone or NULL if none available
  * 
  * **Thread Safety:**
- * - Locks global drone list during iteration
- * - Locks individual drone mutexes for status checking
  * - Uses survivor mutex for coordinate access
- * - Prevents race conditions with concurrent operations
+ * - Takes only the index lock for the search; no drone mutex is locked
+ * - mission_batch_assign() re-checks the drone's status under its lock
  * 
  * **Performance Characteristics:**
- * - O(n) time complexity where n = number of drones
- * - Linear search through drone list
- * - Minimal memory allocation
- * - Efficient for typical drone fleet sizes
+ * - Cost depends on the distance to the nearest idle drone, not on the
+ *   fleet size
+ * - No list or per-drone lock traffic
+ * - No memory allocation
  * 
  * @param survivor_index Index of survivor in global survivor array
  * @return Pointer to closest idle drone, or NULL if none available
  * 
- * @pre survivor_index must be valid (0 <= index < num_survivors)
- * @pre Global drone list must be initialized
+ * @pre survivor_index must be valid (0 <= index < survivor_store.count)
+ * @pre idle_drone_index must be initialized
  * @pre Survivor array must be accessible
  * @post Returns optimal drone or NULL without side effects
  * 
- * @note Thread-safe through careful mutex coordination
  * @note May return NULL if no drones are idle
  * @warning Returned pointer may become invalid if drone disconnects
  * 
@@ -304,30 +592,28 @@ Drone *find_closest_idle_drone(int survivor_index);
 /**
  * @brief Find the closest waiting survivor to a specific drone location
  * 
- * Searches through all survivors to find the one that is waiting for
- * rescue and closest to the specified drone. This function implements
- * the core optimization logic for drone-centric mission assignment.
+ * Returns the waiting survivor closest to the specified drone. This
+ * function implements the core optimization logic for drone-centric
+ * mission assignment.
  * 
  * **Search Algorithm:**
  * 1. Validate drone pointer and get drone coordinates
- * 2. Initialize minimum distance tracker
- * 3. Iterate through all survivors in the global array
- * 4. For each survivor, check if status is 0 (waiting)
- * 5. Calculate distance from drone location
- * 6. Track survivor with minimum distance
- * 7. Return index of closest waiting survivor
+ * 2. Query waiting_survivor_index, which visits map buckets in rings of
+ *    growing Manhattan distance around the drone
+ * 3. Stop once no bucket further out can hold a closer survivor
+ * 4. Return index of closest waiting survivor
  * 
  * **Thread Safety:**
  * - Locks drone mutex for coordinate access
- * - Locks survivor mutex for array iteration
- * - Prevents race conditions during search
- * - Safe concurrent execution with other AI operations
+ * - Takes only the index lock for the search; survivors_mutex is not
+ *   held, so the generator and renderer are not blocked
+ * - mission_batch_assign() claims the survivor by compare-and-swap, so one
+ *   that was taken meanwhile is not assigned twice
  * 
  * **Performance Characteristics:**
- * - O(n) time complexity where n = number of survivors
- * - Linear search through survivor array
- * - Efficient for typical survivor populations
- * - Minimal computational overhead
+ * - Cost depends on the distance to the nearest waiting survivor, not on
+ *   the number of survivors
+ * - No memory allocation
  * 
  * **Return Value:**
  * Returns array index rather than pointer for consistency with
@@ -338,10 +624,9 @@ Drone *find_closest_idle_drone(int survivor_index);
  * @return Index of closest waiting survivor, or -1 if none available
  * 
  * @pre drone must be valid pointer to initialized drone
- * @pre Global survivor array must be initialized
+ * @pre Global survivor array and waiting_survivor_index must be initialized
  * @post Returns optimal survivor index or -1 without side effects
  * 
- * @note Thread-safe through careful mutex coordination
  * @note Returns -1 if no survivors are waiting for rescue
  * @note Index remains valid until survivor array is modified
  * 
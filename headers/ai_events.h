@@ -0,0 +1,129 @@
+/**
+ * @file ai_events.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Wake-up events for the event-driven AI controller
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * The simulation posts an event whenever something the AI can act on
+ * appears: a survivor starts waiting (spawned or recycled) or a drone
+ * becomes idle (connected, or reported MISSION_COMPLETE). Each event
+ * carries the coordinate where it happened, so the AI only has to re-plan
+ * around that spot instead of rescanning every drone and survivor.
+ *
+ * **Wake-up:**
+ * Events are appended to a fixed array under a mutex. The first event
+ * posted to an empty queue also writes to an eventfd, which is what the
+ * AI thread blocks on in read(), so an idle AI thread uses no CPU and a
+ * busy one is woken once per batch rather than once per event. read() is
+ * a cancellation point and no lock is held across it, so the thread can
+ * still be stopped with pthread_cancel().
+ *
+ * **Overflow:**
+ * When the array is full, further events are not stored; the queue is
+ * marked overflowed instead and the AI runs a full assignment pass.
+ *
+ * **Thread Safety:**
+ * ai_events_post() may be called from any thread, including with
+ * survivors_mutex or a drone lock held (the queue lock is always taken
+ * last). ai_events_take() is meant for a single consumer.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup ai_algorithms
+ */
+
+#ifndef AI_EVENTS_H
+#define AI_EVENTS_H
+
+#include "coord.h"
+#include <pthread.h>
+
+/**
+ * @defgroup ai_events AI Wake-up Events
+ * @brief Event queue the event-driven AI controller sleeps on
+ * @ingroup ai_algorithms
+ * @{
+ */
+
+/** @brief Events held before the queue overflows */
+#define AI_EVENT_CAPACITY 1024
+
+/**
+ * @enum AiEventType
+ * @brief What changed
+ */
+typedef enum {
+    AI_EVENT_SURVIVOR_WAITING, /**< A survivor was added or recycled as waiting */
+    AI_EVENT_DRONE_IDLE        /**< A drone connected idle or finished its mission */
+} AiEventType;
+
+/**
+ * @struct ai_event
+ * @brief One change the AI should react to
+ */
+typedef struct ai_event {
+    AiEventType type; /**< What changed */
+    Coord coord;      /**< Where: the survivor's or the drone's cell */
+} AiEvent;
+
+/**
+ * @struct ai_event_queue
+ * @brief Pending events and the eventfd that signals them
+ */
+typedef struct ai_event_queue {
+    pthread_mutex_t lock;              /**< Protects everything below */
+    int fd;                            /**< eventfd, -1 while events are off */
+    int count;                         /**< Events stored in events[] */
+    int overflowed;                    /**< Events were lost since the last take */
+    AiEvent events[AI_EVENT_CAPACITY]; /**< Pending events, oldest first */
+} AiEventQueue;
+
+/**
+ * @brief Event queue of the AI thread
+ *
+ * Posting to it does nothing until ai_events_init() has been called, so
+ * programs that run the AI passes directly (tests/ai_benchmark.c) are not
+ * affected.
+ */
+extern AiEventQueue ai_events;
+
+/**
+ * @brief Create the eventfd and start accepting events
+ *
+ * @param queue Queue to initialize; its lock must already be initialized
+ * @return 0 on success, -1 if the eventfd could not be created (errno set)
+ */
+int ai_events_init(AiEventQueue *queue);
+
+/**
+ * @brief Stop accepting events and close the eventfd
+ *
+ * @param queue Queue to destroy; no thread may be waiting on it
+ */
+void ai_events_destroy(AiEventQueue *queue);
+
+/**
+ * @brief Post an event and wake the consumer if the queue was empty
+ *
+ * @param queue Queue to post to
+ * @param type What changed
+ * @param coord Where it happened
+ */
+void ai_events_post(AiEventQueue *queue, AiEventType type, Coord coord);
+
+/**
+ * @brief Block until events are posted, then take all of them
+ *
+ * May return 0 events if a wake-up raced with an earlier take.
+ *
+ * @param queue Queue to wait on
+ * @param events Receives up to AI_EVENT_CAPACITY events, oldest first
+ * @param overflowed Set to 1 if events were lost, 0 otherwise
+ * @return Number of events taken, or -1 if waiting failed (errno set)
+ */
+int ai_events_take(AiEventQueue *queue, AiEvent *events, int *overflowed);
+
+/** @} */ // end of ai_events group
+
+#endif // AI_EVENTS_H
@@ -0,0 +1,117 @@
+/**
+ * @file ai_partition.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Parallel drone-centric assignment over map regions
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * The single-threaded strategies walk every idle drone in turn, so a
+ * large fleet keeps one core busy while the others wait. The partitioned
+ * strategy cuts the map into a grid of regions and assigns them on a pool
+ * of worker threads.
+ *
+ * **Cycle:**
+ * 1. Snapshot (calling thread): idle drones are bucketed by the region of
+ *    their cell; waiting survivors by every region whose area, widened by
+ *    AI_PARTITION_HALO cells on each side, contains them, so drones near
+ *    a border still see the survivors just across it.
+ * 2. Regions (all workers): each region gets a private SpatialIndex of
+ *    its survivors, so searches take no shared lock, and gives each of
+ *    its idle drones, in list order, the closest survivor it has not
+ *    handed out yet. The survivor is claimed with mission_batch_claim().
+ *    Workers take regions from a shared counter, and there are
+ *    AI_PARTITION_REGIONS_PER_WORKER regions per worker, so crowded
+ *    regions do not hold up the cycle.
+ * 3. Reconciliation (calling thread): a survivor in the halo of two
+ *    regions can be offered by both. The survivor's 0 to 1 status change
+ *    decides the conflict, and the losing drone, like a drone whose
+ *    region ran out of survivors, is given the closest waiting survivor
+ *    overall with find_closest_waiting_survivor().
+ *
+ * drones->lock is held while claiming, as in run_drone_centric_cycle(),
+ * so no drone is freed while a worker uses it. Each region queues its
+ * mission messages in its own MissionBatch; the calling thread sends them
+ * all after releasing drones->lock.
+ *
+ * **Thread Safety:**
+ * run_partitioned_assignment_cycle() must be called from one thread at a
+ * time (the AI thread). Cancellation is disabled for the duration of a
+ * cycle, so pthread_cancel() on the AI thread takes effect between
+ * cycles, never while workers hold a drone.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup ai_algorithms
+ */
+
+#ifndef AI_PARTITION_H
+#define AI_PARTITION_H
+
+/**
+ * @defgroup ai_partition Partitioned Assignment
+ * @brief Drone-centric assignment run in parallel over map regions
+ * @ingroup ai_algorithms
+ * @{
+ */
+
+/** @brief Cells a region's survivor set extends beyond its own area on each side */
+#define AI_PARTITION_HALO 4
+
+/** @brief Regions cut per worker thread, for load balancing */
+#define AI_PARTITION_REGIONS_PER_WORKER 4
+
+/** @brief Upper bound on partition worker threads */
+#define AI_PARTITION_MAX_WORKERS 64
+
+/**
+ * @brief Number of threads assigning regions, the calling thread included
+ *
+ * 0 (the default) uses one per online CPU. Values above
+ * AI_PARTITION_MAX_WORKERS are clamped. A change takes effect at the next
+ * cycle, which restarts the pool.
+ */
+extern int ai_partition_workers;
+
+/**
+ * @struct ai_partition_stats
+ * @brief What the last partitioned cycle did and where its time went
+ */
+typedef struct ai_partition_stats {
+    int workers;         /**< Threads that assigned regions */
+    int regions;         /**< Regions the map was cut into */
+    int drones;          /**< Idle drones in the snapshot */
+    int survivors;       /**< Waiting survivors in the snapshot */
+    int missions;        /**< Missions assigned, reconciliation included */
+    int conflicts;       /**< Claims lost to another region */
+    int reconciled;      /**< Missions assigned by the reconciliation pass */
+    double snapshot_ms;  /**< Serial: copying and bucketing drones and survivors */
+    double regions_ms;   /**< Parallel: assigning the regions */
+    double reconcile_ms; /**< Serial: reconciliation pass and mission sends */
+} AiPartitionStats;
+
+/**
+ * @brief Statistics of the last cycle (read from the AI thread only)
+ */
+extern AiPartitionStats ai_partition_stats;
+
+/**
+ * @brief Run one partitioned assignment pass
+ *
+ * Starts the worker pool on first use. If a worker cannot be started the
+ * cycle runs on the threads that did start.
+ *
+ * @return Number of missions assigned
+ */
+int run_partitioned_assignment_cycle(void);
+
+/**
+ * @brief Stop and join the worker pool
+ *
+ * Safe to call when the pool was never started. The next cycle starts a
+ * new pool.
+ */
+void ai_partition_shutdown(void);
+
+/** @} */ // end of ai_partition group
+
+#endif // AI_PARTITION_H
@@ -0,0 +1,75 @@
+/**
+ * @file assignment.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Minimum-cost bipartite assignment (sparse Hungarian algorithm)
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Solves the assignment problem used by the batch AI strategy: given rows
+ * (idle drones), columns (waiting survivors) and the cost of each allowed
+ * row/column pair, match every row to a distinct column so that the total
+ * cost is minimal.
+ *
+ * **Algorithm:**
+ * The Hungarian method in its shortest-augmenting-path form. Rows are
+ * added one at a time; for each, Dijkstra's algorithm over reduced costs
+ * (cost minus row and column potentials) finds the cheapest way to give it
+ * a column, possibly re-matching earlier rows, and the potentials are then
+ * updated so every reduced cost stays non-negative. The search stops at the
+ * first free column reached, so when free columns are plentiful (many more
+ * survivors than drones) most rows cost a handful of heap operations.
+ *
+ * **Sparse Input:**
+ * Only the listed pairs may be matched. The batch AI lists each drone's K
+ * nearest waiting survivors. That is exact whenever K is at least the
+ * number of rows: a row's optimal column is always among its rows-many
+ * cheapest, since at most rows - 1 of them can be taken by other rows.
+ * When there are fewer columns than rows, the solver also picks which
+ * rows to leave unmatched so that the matched total is minimal.
+ *
+ * **Thread Safety:**
+ * Stateless and reentrant; all working memory is allocated per call.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup ai_algorithms
+ */
+
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+/**
+ * @defgroup assignment Batch Assignment Solver
+ * @brief Minimum-cost matching of drones to survivors
+ * @ingroup ai_algorithms
+ * @{
+ */
+
+/**
+ * @struct assignment_edge
+ * @brief One allowed row/column pair
+ */
+typedef struct assignment_edge {
+    int col;  /**< Column index, 0 <= col < cols */
+    int cost; /**< Cost of matching the row to this column */
+} AssignmentEdge;
+
+/**
+ * @brief Find a minimum-cost matching over the allowed pairs
+ *
+ * The matching returned has maximum size, and no other matching of that
+ * size has a lower total cost.
+ *
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param row_start Offsets into @p edges, rows + 1 entries: the pairs of
+ *                  row i are edges[row_start[i]] .. edges[row_start[i+1] - 1]
+ * @param edges Allowed pairs, grouped by row
+ * @param row_to_col Receives the column of each row, or -1 if unmatched
+ * @return Number of matched rows, or -1 on allocation failure
+ */
+int solve_assignment(int rows, int cols, const int *row_start, const AssignmentEdge *edges, int *row_to_col);
+
+/** @} */ // end of assignment group
+
+#endif // ASSIGNMENT_H
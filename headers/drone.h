@@ -28,7 +28,11 @@
 #include "coord.h"
 #include <time.h>
 #include <pthread.h>
+#include <sys/types.h>
 #include "list.h"
+#include "framer.h"
+#include "wire.h"
+#include "spatial_index.h"
 
 // Forward declaration to avoid circular dependency
 struct list;
@@ -54,6 +58,19 @@ typedef enum {
     DISCONNECTED = 2 /**< Drone has lost connection or been removed */
 } DroneStatus;
 
+/**
+ * @enum ServerMode
+ * @brief Connection handling model used by the drone server
+ * 
+ * Selected once at startup (see controller.c command line options) so the
+ * two models can be compared against each other under the same load.
+ * Both models share the same protocol handlers in drone.c.
+ */
+typedef enum {
+    SERVER_MODE_THREADS = 0, /**< One blocking handler thread per connected drone */
+    SERVER_MODE_EPOLL = 1    /**< Edge-triggered epoll reactor with one worker per core */
+} ServerMode;
+
 /**
  * @struct drone
  * @brief Structure representing a rescue drone in the system
@@ -75,14 +92,17 @@ typedef enum {
  * @warning Always lock the mutex before accessing/modifying drone properties
  */
 typedef struct drone {
-    int id;                /**< Unique identifier for this drone (auto-assigned) */
-    pthread_t thread_id;   /**< Thread ID for drone's operation handler */
-    DroneStatus status;    /**< Current operational status */
-    Coord coord;           /**< Current position on the map grid */
-    Coord target;          /**< Target coordinates for current mission */
-    struct tm last_update; /**< Timestamp of last communication or status update */
-    pthread_mutex_t lock;  /**< Mutex for thread-safe property access */
-    int socket;            /**< Network socket for client communication (-1 for local drones) */
+    int id;                  /**< Unique identifier for this drone (auto-assigned) */
+    pthread_t thread_id;     /**< Thread ID for drone's operation handler */
+    DroneStatus status;      /**< Current operational status */
+    Coord coord;             /**< Current position on the map grid */
+    Coord target;            /**< Target coordinates for current mission */
+    struct tm last_update;   /**< Timestamp of last communication or status update */
+    pthread_mutex_t lock;    /**< Mutex for thread-safe property access */
+    int socket;              /**< Network socket for client communication (-1 for local drones) */
+    WireEncoding encoding;   /**< Message encoding negotiated at HANDSHAKE (networked drones) */
+    int pins;                /**< Mission sends in progress that use this drone (under lock) */
+    pthread_cond_t unpinned; /**< Signalled when pins drops to 0 */
 } Drone;
 
 /**
@@ -102,6 +122,44 @@ extern List *drones;
  */
 extern int num_drones;
 
+/**
+ * @brief Connection model the drone server runs with
+ * 
+ * Defaults to SERVER_MODE_THREADS. Must be set before the server thread
+ * is started.
+ * 
+ * @see drone_server() for the threaded model
+ * @see drone_reactor() for the epoll model
+ */
+extern ServerMode server_mode;
+
+/**
+ * @brief Framing mode used for new drone connections
+ * 
+ * FRAME_BRACE (default) works with every client. FRAME_NEWLINE requires
+ * every client message to be newline-terminated, as clientDrone.c does.
+ */
+extern FrameMode drone_frame_mode;
+
+/**
+ * @brief Message encodings the server accepts (mask of WireEncoding bits)
+ * 
+ * Both JSON and binary by default. A drone gets the binary encoding only
+ * if it offers it in HANDSHAKE and it is allowed here; JSON is always the
+ * fallback. Frames still use drone_frame_mode until the HANDSHAKE_ACK.
+ */
+extern unsigned int drone_wire_encodings;
+
+/**
+ * @brief Spatial index of every IDLE drone, keyed by drone id
+ * 
+ * Covers the map grid with one bucket per cell and is kept in step with
+ * each drone's status and coord by drone_index_update(). The AI queries it
+ * instead of walking the drones list. Initialized by the controller after
+ * init_map().
+ */
+extern SpatialIndex idle_drone_index;
+
 /**
  * @defgroup drone_server Drone Server Functions
  * @brief TCP/IP server for handling drone client connections
@@ -168,8 +226,126 @@ void* drone_server(void *arg);
  */
 void *handle_drone_client(void *arg);
 void initialize_drones();
+
+/**
+ * @brief Create the TCP listening socket used for drone connections
+ * 
+ * Binds to all interfaces with SO_REUSEADDR and listens with a backlog of
+ * MAX_PENDING_CONNECTIONS so reconnect storms are not dropped.
+ * 
+ * @param port TCP port to bind
+ * @param reuse_port Non-zero to also set SO_REUSEPORT, letting each reactor
+ *                   worker own a listening socket on the same port
+ * @return Listening socket descriptor, or -1 on failure (error is logged)
+ */
+int create_drone_listener(int port, int reuse_port);
 /** @} */ // end of drone_server group
 
+/**
+ * @defgroup drone_protocol Drone Protocol Handlers
+ * @brief Message handling shared by the threaded server and the epoll reactor
+ * 
+ * These functions never block on the socket for reading; they only act on
+ * bytes that the caller has already received. That lets the same code run
+ * from a dedicated client thread or from a reactor worker.
+ * @{
+ */
+
+/**
+ * @brief Send a whole message to a drone, waiting at most DRONE_SEND_TIMEOUT_MS
+ * 
+ * Every message to a drone goes through here. Partial writes on
+ * non-blocking sockets are continued when the socket drains; a message
+ * that cannot be finished in time shuts the connection down, so the drone
+ * never reads a truncated message.
+ * 
+ * @param sock Connected drone socket
+ * @param data Message to send
+ * @param length Size of the message in bytes
+ * @return @p length on success, -1 on error or timeout (errno is set)
+ */
+ssize_t drone_send_all(int sock, const char *data, size_t length);
+
+/**
+ * @brief Validate a HANDSHAKE message and register the drone it describes
+ * 
+ * Parses the handshake, replies with HANDSHAKE_ACK and then adds a new
+ * drone bound to @p sock to the global drones list. The drone is only
+ * visible to the AI once its ACK has been sent, so the first mission
+ * always follows the ACK in the negotiated encoding.
+ * 
+ * @param sock Connected client socket
+ * @param message Start of the handshake JSON object
+ * @param length Length of the object; message[length] must be writable
+ * @param start_time Monotonic time the handshake started arriving, used for
+ *                   the handshake response time metric
+ * @return List node holding the registered drone, or NULL on failure
+ * 
+ * @note On failure the caller still owns and must close the socket
+ * @see unregister_drone() for the reverse operation
+ */
+// clang-format off
+Node *register_drone(int sock, char *message, size_t length, const struct timespec *start_time);
+
+/**
+ * @brief Mark a drone as disconnected and remove it from the drones list
+ * 
+ * If a mission is being sent to the drone (see MissionBatch), the socket
+ * is shut down so the send fails at once, and the drone is only removed
+ * once the sender has let go of it.
+ * 
+ * @param node List node returned by register_drone()
+ * 
+ * @note Records the disconnection metric; the caller closes the socket
+ */
+void unregister_drone(Node *node);
+
+/**
+ * @brief Unregister a drone without waiting for a mission send that pins it
+ * 
+ * Like unregister_drone(), but a drone still pinned by a send is only
+ * marked disconnected (and its socket shut down) and stays in the list.
+ * Used by the epoll reactor, whose workers must not block on the AI.
+ * 
+ * @param node List node returned by register_drone()
+ * @return 0 if the drone was removed, 1 if it is still pinned
+ * 
+ * @note Until it returns 0 the caller must keep the socket open, so its
+ *       descriptor number is not reused while the send may still use it
+ */
+int try_unregister_drone(Node *node);
+
+/**
+ * @brief Dispatch every complete frame buffered on a drone connection
+ * 
+ * The first frame on a connection is treated as the HANDSHAKE and
+ * registers the drone; every later frame goes to process_drone_message().
+ * Frames are processed in place inside the framer's ring buffer.
+ * 
+ * @param sock Client socket the data was received on
+ * @param node In/out: registered drone node, NULL until the handshake
+ * @param framer Connection framer holding the received bytes
+ * @param handshake_start Monotonic time the handshake started arriving
+ * @return 0 to keep the connection open, -1 if it must be closed
+ *         (failed handshake or a message larger than the framer)
+ */
+int process_drone_frames(int sock, Node **node, MessageFramer *framer, const struct timespec *handshake_start);
+
+/**
+ * @brief Parse and handle one STATUS_UPDATE, MISSION_COMPLETE or HEARTBEAT_RESPONSE
+ * 
+ * @param d Drone the message was received from
+ * @param message Start of the JSON object
+ * @param length Length of the object; message[length] must be writable
+ * 
+ * **Thread Safety:** Takes d->lock for state changes; safe to call from any
+ * thread as long as only one thread reads from the drone's socket.
+ */
+void process_drone_message(Drone *d, char *message, size_t length);
+// clang-format on
+
+/** @} */ // end of drone_protocol group
+
 /**
  * @defgroup drone_management Drone Lifecycle Management
  * @brief Functions for drone initialization, update, and cleanup
@@ -206,6 +382,57 @@ void initialize_drones();
  */
 void update_drone_status(Drone *drone, Coord *target);
 
+/**
+ * @brief Reflect a drone's current status and coord in idle_drone_index
+ * 
+ * Indexes the drone at its coord if it is IDLE and removes it otherwise.
+ * Must be called after every change to a drone's status or coord.
+ * 
+ * @param drone Drone whose state changed
+ * 
+ * **Thread Safety:** The caller must hold drone->lock, so the index never
+ * disagrees with the drone for longer than the critical section.
+ */
+void drone_index_update(Drone *drone);
+
+/**
+ * @brief Change a drone's status
+ * 
+ * Every status change of a listed drone goes through here, so the
+ * idle_drones and mission_drones statistics and idle_drone_index stay in
+ * step with the drone. Also calls drone_index_update().
+ * 
+ * @param drone Drone to update
+ * @param status New status
+ * 
+ * **Thread Safety:** The caller must hold drone->lock.
+ */
+void drone_set_status(Drone *drone, DroneStatus status);
+
+/**
+ * @brief Cross-check the drone statistics against a full recount
+ * 
+ * Walks the drones list with every drone locked. Used by the controller's
+ * --verify-stats mode.
+ * 
+ * @return 0 if idle_drones and mission_drones match the recount, -1
+ *         (after logging the difference) otherwise
+ * 
+ * **Thread Safety:** Takes drones->lock and each drone's lock; the caller
+ * must hold none of them.
+ */
+int drone_stats_verify(void);
+
+/**
+ * @brief Key extractor for lists of Drone (see list_set_key())
+ * 
+ * Drone lists are keyed on the unique drone id.
+ * 
+ * @param data Drone element
+ * @return Address of its id field
+ */
+const void *drone_list_key(const void *data);
+
 /**
  * @brief Clean up all drone resources during system shutdown
  * 
@@ -243,12 +470,18 @@ void cleanup_drones(void);
 /** @brief Maximum size for JSON messages */
 #define DRONE_MESSAGE_SIZE 4096
 
-/** @brief Maximum number of pending connections */
-#define MAX_PENDING_CONNECTIONS 10
+/** @brief Per-connection receive ring size (holds at least two full messages) */
+#define DRONE_FRAMER_CAPACITY (2 * DRONE_MESSAGE_SIZE)
+
+/** @brief Listen backlog for the drone server (the kernel clamps it to somaxconn) */
+#define MAX_PENDING_CONNECTIONS 4096
 
 /** @brief Timeout for socket operations (seconds) */
 #define SOCKET_TIMEOUT_SEC 30
 
+/** @brief Longest a message to a drone may wait for socket buffer space (milliseconds) */
+#define DRONE_SEND_TIMEOUT_MS 1000
+
 /** @brief Heartbeat interval for connected drones (seconds) */
 #define DRONE_HEARTBEAT_INTERVAL 10
 
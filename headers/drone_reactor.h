@@ -0,0 +1,81 @@
+/**
+ * @file drone_reactor.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Edge-triggered epoll reactor for drone client connections
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Alternative to the thread-per-connection model of drone_server(). A small
+ * pool of worker threads (one per core by default) each run an epoll loop
+ * over their own SO_REUSEPORT listening socket and all connections accepted
+ * on it. Sockets are non-blocking and registered edge-triggered, so a worker
+ * drains each socket until EAGAIN before moving on.
+ *
+ * **Key Features:**
+ * - No stack or scheduler cost per connected drone
+ * - Kernel-balanced accepts through SO_REUSEPORT, with a shared accept
+ *   queue fallback (tried and logged once) when the option is not available
+ * - Same HANDSHAKE / STATUS_UPDATE / MISSION_COMPLETE / HEARTBEAT_RESPONSE
+ *   handling as the threaded server (see drone_protocol group)
+ * - Partial messages are kept per connection until they complete
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#ifndef DRONE_REACTOR_H
+#define DRONE_REACTOR_H
+
+/**
+ * @defgroup drone_reactor Epoll Drone Reactor
+ * @brief Event-driven connection handling for large drone fleets
+ * @ingroup networking
+ * @{
+ */
+
+/** @brief Maximum number of events fetched per epoll_wait() call */
+#define REACTOR_MAX_EVENTS 256
+
+/** @brief epoll_wait() timeout so workers notice shutdown (milliseconds) */
+#define REACTOR_POLL_TIMEOUT_MS 500
+
+/** @brief Upper bound on reactor worker threads */
+#define REACTOR_MAX_WORKERS 64
+
+/**
+ * @brief Number of reactor worker threads to start
+ *
+ * 0 (the default) starts one worker per online CPU. Values above
+ * REACTOR_MAX_WORKERS are clamped.
+ */
+extern int reactor_worker_count;
+
+/**
+ * @brief Server thread function running the epoll reactor
+ *
+ * Creates the worker pool, one listening socket per worker, and waits for
+ * the workers to exit. Workers stop when the global running flag is
+ * cleared.
+ *
+ * **Thread Safety:**
+ * Each connection is owned by exactly one worker, so per-connection state
+ * needs no locking. Shared state (drones list, survivors) is accessed
+ * through the same handlers and locks as the threaded server.
+ *
+ * @param arg Unused thread parameter (required for pthread compatibility)
+ * @return NULL when all workers have terminated
+ *
+ * @note Drop-in replacement for drone_server() as a thread entry point
+ * @note Workers do not wait for mission sends from the AI thread; a drone
+ *       pinned by one is unregistered once the send let go of it
+ *
+ * @see drone_server() for the thread-per-connection model
+ */
+// clang-format off
+void *drone_reactor(void *arg);
+// clang-format on
+
+/** @} */ // end of drone_reactor group
+
+#endif // DRONE_REACTOR_H
@@ -0,0 +1,175 @@
+/**
+ * @file framer.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Per-connection ring buffer that splits a TCP byte stream into messages
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * TCP delivers a byte stream, not messages: one recv() may return half a
+ * message or several coalesced ones. A MessageFramer owns the receive
+ * buffer of a single connection, keeps partial messages across reads and
+ * hands out complete frames in place.
+ *
+ * **Framing Modes:**
+ * - FRAME_BRACE: a frame is one brace-balanced JSON object; bytes between
+ *   objects (whitespace, newlines) are skipped. Works with every client.
+ * - FRAME_NEWLINE: a frame is one line; empty lines are skipped and a
+ *   trailing '\\r' is removed.
+ * - FRAME_BINARY: a frame is a FRAME_BINARY_HEADER_SIZE-byte header whose
+ *   last two bytes hold the big-endian payload length, followed by that
+ *   payload (see wire.h). The frame includes the header.
+ *
+ * **Typical Use:**
+ * ```
+ * size_t space;
+ * char *dst = framer_write_space(&framer, &space);
+ * ssize_t n = recv(sock, dst, space, 0);
+ * framer_commit(&framer, n);
+ * Frame frame;
+ * while (framer_next(&framer, &frame) > 0)
+ *     handle(frame.data, frame.length);
+ * ```
+ *
+ * **Thread Safety:**
+ * A framer belongs to one connection and must only be used by the thread
+ * currently reading that connection. It has no internal locking.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#ifndef FRAMER_H
+#define FRAMER_H
+
+#include <stddef.h>
+
+/**
+ * @defgroup framer Message Framing
+ * @brief Stream-to-message framing for drone connections
+ * @ingroup networking
+ * @{
+ */
+
+/**
+ * @enum FrameMode
+ * @brief How message boundaries are detected in the byte stream
+ */
+typedef enum {
+    FRAME_BRACE = 0,  /**< Brace-balanced JSON objects (string-aware) */
+    FRAME_NEWLINE = 1, /**< Newline-delimited messages */
+    FRAME_BINARY = 2   /**< Length-prefixed binary messages */
+} FrameMode;
+
+/** @brief Size of the header that prefixes every FRAME_BINARY message */
+#define FRAME_BINARY_HEADER_SIZE 4
+
+/**
+ * @struct frame
+ * @brief A complete message located inside a framer's buffer
+ *
+ * data[length] is always a valid, writable byte so parsers may place a
+ * temporary terminator there, provided they restore it.
+ *
+ * @warning Valid only until the next framer_write_space() or framer_commit()
+ */
+typedef struct frame {
+    char *data;    /**< First byte of the message */
+    size_t length; /**< Message length in bytes (excluding any delimiter) */
+} Frame;
+
+/**
+ * @struct message_framer
+ * @brief Ring buffer plus resumable scanner state for one connection
+ *
+ * Positions are free-running byte counters; the physical index is the
+ * counter masked by (capacity - 1). Scanning resumes where the previous
+ * call stopped, so each byte is examined once regardless of how the
+ * message was split across reads.
+ */
+typedef struct message_framer {
+    char *buffer;       /**< Ring storage (capacity + 1 bytes, last one spare) */
+    char *scratch;      /**< Lazily allocated buffer for frames that wrap */
+    size_t capacity;    /**< Ring size in bytes (power of two) */
+    size_t head;        /**< Oldest byte still needed */
+    size_t tail;        /**< Next byte to be written by recv() */
+    size_t scan;        /**< Next byte to be examined by the scanner */
+    size_t frame_start; /**< Start of the frame being assembled (brace mode) */
+    int depth;          /**< Current brace nesting depth */
+    int in_string;      /**< Scanner is inside a JSON string literal */
+    int escape_next;    /**< Previous byte was a backslash inside a string */
+    int skip_separator; /**< Drop whitespace before the next binary frame */
+    FrameMode mode;     /**< Active framing mode */
+} MessageFramer;
+
+/**
+ * @brief Initialize a framer
+ *
+ * @param framer Framer to initialize
+ * @param capacity Ring size in bytes; rounded up to a power of two. This is
+ *                 also the largest message the framer can hold.
+ * @param mode Initial framing mode
+ * @return 0 on success, -1 if memory allocation fails
+ *
+ * @see framer_destroy() for cleanup
+ */
+int framer_init(MessageFramer *framer, size_t capacity, FrameMode mode);
+
+/**
+ * @brief Release the memory held by a framer
+ *
+ * @param framer Framer to destroy (safe to call on a zeroed framer)
+ */
+void framer_destroy(MessageFramer *framer);
+
+/**
+ * @brief Get the contiguous free region to receive into
+ *
+ * @param framer Framer to write into
+ * @param available Receives the number of bytes that may be written
+ * @return Pointer to write to; *available is 0 when the ring is full
+ *
+ * @note Receiving directly into this region avoids any intermediate copy
+ */
+char *framer_write_space(MessageFramer *framer, size_t *available);
+
+/**
+ * @brief Account for bytes written into the region from framer_write_space()
+ *
+ * @param framer Framer that was written to
+ * @param bytes Number of bytes actually written
+ */
+void framer_commit(MessageFramer *framer, size_t bytes);
+
+/**
+ * @brief Extract the next complete frame
+ *
+ * Frames are returned in place whenever they are contiguous in the ring.
+ * A frame that straddles the wrap point is linearized into the scratch
+ * buffer; this is the only copy the framer ever makes.
+ *
+ * @param framer Framer to read from
+ * @param frame Receives the frame on success
+ * @return 1 if a frame was produced, 0 if more data is needed, -1 if the
+ *         pending message does not fit in the ring (the connection should
+ *         be dropped)
+ */
+int framer_next(MessageFramer *framer, Frame *frame);
+
+/**
+ * @brief Change the framing mode at a frame boundary
+ *
+ * Bytes already received but not yet returned are rescanned under the new
+ * mode. When a text mode switches to FRAME_BINARY, whitespace before the
+ * first binary header (such as the newline sent after a JSON HANDSHAKE,
+ * even if it arrives later) is dropped: a binary header never starts with
+ * whitespace.
+ *
+ * @param framer Framer to modify
+ * @param mode New framing mode
+ */
+void framer_set_mode(MessageFramer *framer, FrameMode mode);
+
+/** @} */ // end of framer group
+
+#endif // FRAMER_H
@@ -31,6 +31,7 @@
 #include "drone.h"
 #include "survivor.h"
 #include "list.h"
+#include <stdatomic.h>
 
 // Forward declarations to avoid circular dependencies
 struct map;
@@ -112,9 +113,6 @@ extern struct list *drones;
 /** @brief Maximum number of concurrent drone connections */
 #define MAX_DRONES 100
 
-/** @brief Maximum number of survivors that can be tracked */
-#define MAX_SURVIVORS 1000
-
 /** @brief Default TCP port for drone-server communication */
 #define DEFAULT_SERVER_PORT 8080
 
@@ -156,20 +154,27 @@ extern volatile int running;
  * @{
  */
 
+/*
+ * The statistics are updated at every state transition rather than
+ * recounted per frame: the survivor counters by survivor_set_status() and
+ * add_survivor(), the drone counters by drone_set_status(). They are
+ * atomic so the view can read them without any lock.
+ */
+
 /** @brief Number of survivors currently waiting for rescue */
-extern int waiting_count;
+extern atomic_int waiting_count;
 
 /** @brief Number of survivors currently being helped */
-extern int helped_count;
+extern atomic_int helped_count;
 
 /** @brief Total number of survivors successfully rescued */
-extern int rescued_count;
+extern atomic_int rescued_count;
 
 /** @brief Number of drones currently idle and available */
-extern int idle_drones;
+extern atomic_int idle_drones;
 
 /** @brief Number of drones currently on active missions */
-extern int mission_drones;
+extern atomic_int mission_drones;
 
 /** @} */ // end of statistics_globals group
 
@@ -0,0 +1,107 @@
+/**
+ * @file latency_histogram.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Lock-free log-linear histogram of latencies
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Latencies are counted in nanosecond buckets laid out the way HDR
+ * histograms lay them out: every power of two is split into
+ * LATENCY_SUB_BUCKETS linear buckets, so a bucket is never wider than
+ * 1/LATENCY_SUB_BUCKETS of the values it holds.
+ *
+ * **Layout:**
+ * - 0 .. 63 ns: one bucket per nanosecond
+ * - [2^k, 2^(k+1)) for k >= 6: LATENCY_SUB_BUCKETS buckets of 2^(k-5) ns
+ * - Values of 2^LATENCY_MAX_MAGNITUDE ns (about 68.7 s) and above are
+ *   counted in the last bucket
+ *
+ * Percentiles are reported as the middle of the bucket holding the
+ * requested rank, which is within 1/64 (about 1.6%) of the true value.
+ *
+ * **Thread Safety:**
+ * Recording is one relaxed atomic increment and takes no lock, so any
+ * number of threads can record at once. Percentiles read the counts with
+ * relaxed loads; samples recorded meanwhile may or may not be included.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup monitoring
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @defgroup latency_histogram Latency Histogram
+ * @brief Log-linear latency histogram with lock-free recording
+ * @ingroup monitoring
+ * @{
+ */
+
+/** @brief log2 of the number of linear buckets per power of two */
+#define LATENCY_SUB_BUCKET_BITS 5
+
+/** @brief Linear buckets per power of two */
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+
+/** @brief Values of 2^LATENCY_MAX_MAGNITUDE ns and above share the last bucket */
+#define LATENCY_MAX_MAGNITUDE 36
+
+/** @brief Number of buckets in a histogram */
+#define LATENCY_BUCKETS ((LATENCY_MAX_MAGNITUDE - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+/**
+ * @struct latency_histogram
+ * @brief Sample counts per latency bucket
+ *
+ * A zero-initialized histogram is empty and ready to record.
+ */
+typedef struct latency_histogram {
+    atomic_ulong counts[LATENCY_BUCKETS]; /**< Samples recorded in each bucket */
+} LatencyHistogram;
+
+/**
+ * @brief Empty a histogram
+ *
+ * @param histogram Histogram to empty; not safe against concurrent recording
+ */
+void latency_histogram_reset(LatencyHistogram *histogram);
+
+/**
+ * @brief Count one latency sample
+ *
+ * @param histogram Histogram to record into
+ * @param latency_ns Latency in nanoseconds
+ */
+void latency_histogram_record(LatencyHistogram *histogram, uint64_t latency_ns);
+
+/**
+ * @brief Compute several percentiles from one snapshot of the counts
+ *
+ * @param histogram Histogram to read
+ * @param percentiles Percentiles to compute, each in (0, 100]
+ * @param count Number of percentiles
+ * @param values_ms Out: value at each percentile in milliseconds, 0 if
+ *        the histogram is empty
+ * @return Number of samples in the snapshot
+ */
+unsigned long latency_histogram_percentiles(const LatencyHistogram *histogram,
+                                            const double *percentiles,
+                                            int count,
+                                            double *values_ms);
+
+/**
+ * @brief Approximate sum of every sample, from the bucket middles
+ *
+ * @param histogram Histogram to read
+ * @return Sum of the samples in milliseconds, within about 1.6%
+ */
+double latency_histogram_sum_ms(const LatencyHistogram *histogram);
+
+/** @} */ // end of latency_histogram group
+
+#endif // LATENCY_HISTOGRAM_H
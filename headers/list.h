@@ -5,6 +5,17 @@
  * @version 0.2
  * @date 2025-05-22
  * 
+ * Two backends share the List ops table and are chosen at create_list()
+ * time:
+ * - LIST_BACKEND_LINKED: doubly linked list guarded by a mutex and two
+ *   semaphores; full API, blocking add/pop, LIFO pop from the head
+ * - LIST_BACKEND_GROWABLE: the same list without a hard capacity; when
+ *   every node is used, add() allocates another block of capacity nodes
+ *   instead of blocking. Nodes never move once allocated
+ * - LIST_BACKEND_MPMC_QUEUE: bounded lock-free multi-producer
+ *   multi-consumer ring queue; add/pop/peek/destroy only, never blocks,
+ *   FIFO pop
+ * 
  * @copyright Copyright (c) 2024
  */
 #ifndef LIST_H
@@ -13,6 +24,23 @@
 #include <time.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <stddef.h>
+
+/**
+ * @enum ListBackend
+ * @brief Storage and synchronization scheme of a list
+ */
+typedef enum {
+    LIST_BACKEND_LINKED = 0,     /**< Mutex and semaphore protected doubly linked list */
+    LIST_BACKEND_MPMC_QUEUE = 1, /**< Lock-free bounded ring queue (Vyukov MPMC) */
+    LIST_BACKEND_GROWABLE = 2    /**< Linked list whose arena grows in blocks on demand */
+} ListBackend;
+
+/**
+ * @struct mpmc_queue
+ * @brief Ring state of a LIST_BACKEND_MPMC_QUEUE list (private to list.c)
+ */
+struct mpmc_queue;
 
 /**
  * @struct node
@@ -22,25 +50,36 @@ typedef struct node {
     struct node *prev; /**< Pointer to previous node */
     struct node *next; /**< Pointer to next node */
     char occupied;     /**< Flag indicating if the node is used (1) or free (0) */
-    char data[];       /**< Flexible array member for storing data */
+    _Alignas(max_align_t) char data[]; /**< Flexible array member for storing data, aligned for any type */
 } Node;
 
 /**
  * @struct list
  * @brief Thread-safe doubly linked list with synchronized access
+ * 
+ * With LIST_BACKEND_MPMC_QUEUE only add, pop, peek and destroy are
+ * available; head, tail, number_of_elements, lock and the semaphores are
+ * not used, and the remaining ops report an error.
  */
 typedef struct list {
     //clang-format off
     Node *head;             /**< Pointer to the first node in the list */
     Node *tail;             /**< Pointer to the last node in the list */
     int number_of_elements; /**< Current number of elements in the list */
-    int capacity;           /**< Maximum number of elements the list can hold */
+    int capacity;           /**< Number of nodes currently allocated */
     int datasize;           /**< Size of each data element in bytes */
     int nodesize;           /**< Total size of node including header and data */
     char *startaddress;     /**< Start address of allocated memory block */
     char *endaddress;       /**< End address of allocated memory block */
     Node *lastprocessed;    /**< Last node that was processed */
-    Node *free_list;        /**< List of free nodes available for reuse */
+    Node *free_list;        /**< Stack of every free node, linked through next */
+    char *extra_blocks;     /**< Blocks added by a growable list, newest first */
+    size_t keysize;         /**< Key size in bytes, 0 if the list has no key */
+    const void *(*key_of)(const void *data); /**< Key inside an element (list_set_key()) */
+    Node **index_slots;     /**< Open-addressing hash index of nodes by key, NULL if none */
+    int index_size;         /**< Slots in index_slots (power of two) */
+    ListBackend backend;    /**< Backend chosen at creation */
+    struct mpmc_queue *queue; /**< Ring state, LIST_BACKEND_MPMC_QUEUE only */
 
     pthread_mutex_t lock; /**< Mutex for thread-safe access */
     sem_t elements_sem;   /**< Semaphore counting available elements */
@@ -49,6 +88,7 @@ typedef struct list {
     /**< Function pointers for list operations */
     Node *(*add)(struct list *list, void *data);
     int (*removedata)(struct list *list, void *data);
+    int (*removekey)(struct list *list, const void *key);
     int (*removenode)(struct list *list, Node *node);
     void *(*pop)(struct list *list, void *dest);
     void *(*peek)(struct list *list);
@@ -61,13 +101,39 @@ typedef struct list {
 } List;
 
 /**
- * @brief Create a new thread-safe linked list
+ * @brief Create a new thread-safe list
  * @param datasize Size of each data element in bytes
- * @param capacity Maximum number of elements the list can hold
+ * @param capacity Maximum number of elements the list can hold; the MPMC
+ *                 queue rounds it up to a power of two, and a growable
+ *                 list uses it as the size of each block it adds
+ * @param backend Storage and synchronization scheme
  * @return Pointer to the new list or NULL on failure
  */
 // clang-format off
-List *create_list(size_t datasize, int capacity);
+List *create_list(size_t datasize, int capacity, ListBackend backend);
+
+/**
+ * @brief Key a list by a field of its elements and index it by that key
+ * 
+ * Afterwards removedata() compares only keys and, like removekey(), finds
+ * the node through an open-addressing hash index instead of scanning.
+ * Keys are compared bytewise over keysize bytes, so string keys must be
+ * zero padded (as strncpy() and copies of the same element are).
+ * 
+ * @param list A LIST_BACKEND_LINKED or LIST_BACKEND_GROWABLE list
+ * @param keysize Size of the key in bytes
+ * @param key_of Returns the address of the key inside an element
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ */
+int list_set_key(List *list, size_t keysize, const void *(*key_of)(const void *data));
+
+/**
+ * @brief Remove the element with the given key from a keyed list
+ * @param list List keyed with list_set_key()
+ * @param key Pointer to keysize bytes of key
+ * @return 0 on success, 1 if no element has this key or the list has no key
+ */
+int removekey(List *list, const void *key);
 
 /**
  * @brief Remove a node from the list
@@ -88,7 +154,8 @@ Node *add(List *list, void *data);
 /**
  * @brief Remove a data element from the list
  * @param list List to remove from
- * @param data Pointer to data to match and remove
+ * @param data Pointer to data to match and remove (only its key is
+ *             compared if the list is keyed)
  * @return 0 on success, 1 if data not found
  */
 int removedata(List *list, void *data);
@@ -6,14 +6,11 @@
  * @date 2025-05-22
  * 
  * This header defines the spatial organization system for the emergency
- * drone coordination application. It provides a 2D grid structure where
- * each cell can contain survivors and supports efficient spatial queries
- * for mission planning and visualization.
+ * drone coordination application. It provides the 2D grid that survivors,
+ * drones and the spatial indexes (see spatial_index.h) are laid out on.
  * 
  * **Key Features:**
  * - Dynamic 2D grid allocation with configurable dimensions
- * - Per-cell survivor lists for efficient spatial queries
- * - Thread-safe access to map data structures
  * - Memory-efficient organization with contiguous allocation
  * - Coordinate validation and bounds checking
  * 
@@ -24,6 +21,10 @@
  * - Origin (0,0) is at the top-left corner
  * - Each cell can contain multiple survivors
  * 
+ * Survivors are not stored in the cells: waiting_survivor_index and
+ * idle_drone_index bucket them by cell, so a cell carries no list of its
+ * own and a large map costs only its coordinates.
+ * 
  * @copyright Copyright (c) 2024
  * 
  * @ingroup core_modules
@@ -54,29 +55,15 @@
  * @struct mapcell
  * @brief Structure representing a single cell in the spatial grid
  * 
- * Each map cell represents a discrete location in the 2D coordinate system
- * and maintains a list of survivors currently located within that cell.
- * This design enables efficient spatial queries by organizing entities
- * according to their geographic location.
- * 
- * **Cell Organization:**
- * - Each cell has fixed coordinate boundaries
- * - Survivors are tracked in a thread-safe list
- * - Multiple survivors can occupy the same cell
- * - Empty cells consume minimal memory overhead
- * 
- * **Thread Safety:**
- * Each cell's survivor list has its own mutex protection, allowing
- * concurrent access to different cells while maintaining data integrity.
+ * Each map cell represents a discrete location in the 2D coordinate system.
+ * What occupies a cell is found through the spatial indexes, which bucket
+ * survivors and idle drones by cell.
  * 
  * @note Cell coordinates are immutable once initialized
  * @warning Always validate coordinates before cell access
  */
 typedef struct mapcell {
     Coord coord; /**< Immutable coordinates of this cell (x=row, y=column) */
-    // clang-format off
-    List *survivors;  /**< Thread-safe list of survivors currently in this cell */
-    // clang-format on
 } MapCell;
 
 /**
@@ -156,20 +143,19 @@ extern Map map;
 /**
  * @brief Initialize the spatial grid with specified dimensions
  * 
- * Creates and initializes the complete 2D spatial grid system including
- * all cells and their associated survivor lists. This function performs
- * all necessary memory allocation and data structure setup.
+ * Creates and initializes the complete 2D spatial grid system. This
+ * function performs all necessary memory allocation and data structure
+ * setup.
  * 
  * **Allocation Process:**
  * 1. Validate input dimensions (must be positive)
  * 2. Allocate array of row pointers (height elements)
  * 3. For each row, allocate array of MapCell structures (width elements)
- * 4. Initialize each cell with coordinates and empty survivor list
+ * 4. Initialize each cell with its coordinates
  * 5. Handle allocation failures with proper cleanup
  * 
  * **Memory Organization:**
  * - Row-major layout for cache efficiency
- * - Each cell gets thread-safe survivor list (capacity 10)
  * - Contiguous allocation within rows
  * - Clean failure handling with partial cleanup
  * 
@@ -183,7 +169,6 @@ extern Map map;
  * @pre height > 0 && width > 0
  * @post Global map is fully initialized and ready for use
  * @post map.cells[i][j] is valid for all 0 <= i < height, 0 <= j < width
- * @post Each cell has an initialized, empty survivor list
  * 
  * @note Will call exit(EXIT_FAILURE) on allocation failure
  * @warning Must be called before any other map operations
@@ -202,9 +187,7 @@ void init_map(int height, int width);
  * 
  * **Cleanup Process:**
  * 1. Check for valid map structure
- * 2. For each row:
- *    a. Destroy survivor list in each cell
- *    b. Free the row array
+ * 2. Free each row array
  * 3. Free the main pointer array
  * 4. Reset dimensions to zero
  * 5. Set pointers to NULL for safety
@@ -217,7 +200,6 @@ void init_map(int height, int width);
  * @pre Map may or may not be initialized (function handles both cases)
  * @post All map memory is freed and pointers are invalid
  * @post Global map dimensions are reset to zero
- * @post All survivor lists are properly destroyed
  * 
  * @note Safe to call multiple times or on uninitialized map
  * @note Handles NULL pointers gracefully
@@ -286,32 +268,6 @@ int is_valid_coordinate(int x, int y);
 // clang-format off
 MapCell* get_cell(int x, int y);
 // clang-format on
-/**
- * @brief Calculate total number of survivors across all map cells
- * 
- * Iterates through the entire map and sums the number of survivors
- * in all cell lists. This provides a global count for statistics
- * and monitoring purposes, though it can be expensive for large maps.
- * 
- * **Performance Characteristics:**
- * - O(height * width) complexity
- * - Locks each cell briefly for thread safety
- * - May be slow for large maps with many cells
- * 
- * **Thread Safety:**
- * Locks each cell's survivor list individually during counting,
- * ensuring accurate counts even with concurrent modifications.
- * 
- * @return Total number of survivors currently on the map
- * 
- * @pre Map must be initialized
- * @post Returns accurate survivor count at time of call
- * 
- * @note Thread-safe but potentially expensive operation
- * @note Consider caching result if called frequently
- * @warning Count may change immediately after function returns
- */
-int get_total_survivor_count();
 
 /** @} */ // end of map_utilities group
 
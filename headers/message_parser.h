@@ -0,0 +1,127 @@
+/**
+ * @file message_parser.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Allocation-free parser for the known drone → server JSON messages
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Status updates are the bulk of server traffic, and building a json-c
+ * object tree for each one only to read three fields costs several heap
+ * allocations per message. This parser walks a frame once and writes the
+ * fields the server uses straight into a caller-provided DroneMessage,
+ * without allocating.
+ *
+ * **Scope:**
+ * - HANDSHAKE, STATUS_UPDATE, MISSION_COMPLETE and HEARTBEAT_RESPONSE
+ * - Unknown keys are skipped, whatever their value type
+ * - Anything outside the fast path (escaped strings, fractional numbers
+ *   for integer fields, unknown message types, malformed input) is
+ *   rejected so the caller can fall back to json-c
+ *
+ * **Thread Safety:**
+ * Stateless and reentrant; safe to call from any number of threads.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#ifndef MESSAGE_PARSER_H
+#define MESSAGE_PARSER_H
+
+#include "coord.h"
+#include <stddef.h>
+
+/**
+ * @defgroup message_parser Drone Message Parsing
+ * @brief Decoding of drone messages into a flat structure
+ * @ingroup networking
+ * @{
+ */
+
+/**
+ * @enum DroneMessageType
+ * @brief Message types a drone may send to the server
+ */
+typedef enum {
+    DRONE_MSG_UNKNOWN = 0,           /**< Unrecognized or missing "type" */
+    DRONE_MSG_HANDSHAKE = 1,         /**< Registration on connect */
+    DRONE_MSG_STATUS_UPDATE = 2,     /**< Periodic position and status */
+    DRONE_MSG_MISSION_COMPLETE = 3,  /**< Rescue finished at target_location */
+    DRONE_MSG_HEARTBEAT_RESPONSE = 4 /**< Keep-alive acknowledgment */
+} DroneMessageType;
+
+/** @name Field presence flags for DroneMessage::fields
+ * @{ */
+#define DRONE_FIELD_LOCATION 0x01  /**< location (STATUS_UPDATE) or coord (HANDSHAKE) */
+#define DRONE_FIELD_TARGET 0x02    /**< target_location (MISSION_COMPLETE) */
+#define DRONE_FIELD_STATUS 0x04    /**< status mapped to a DroneStatus value */
+#define DRONE_FIELD_BATTERY 0x08   /**< battery */
+#define DRONE_FIELD_TIMESTAMP 0x10 /**< timestamp */
+#define DRONE_FIELD_SUCCESS 0x20   /**< success */
+#define DRONE_FIELD_ENCODINGS 0x40 /**< encodings (HANDSHAKE) */
+/** @} */
+
+/**
+ * @struct drone_message
+ * @brief Flat decoded form of a drone message
+ *
+ * Only fields whose flag is set in @c fields carry meaningful values.
+ * Status strings are mapped to DroneStatus values: "idle"/"IDLE" → IDLE,
+ * "busy"/"ON_MISSION" → ON_MISSION; any other status leaves the flag
+ * unset. The HANDSHAKE "encodings" array becomes a mask of WireEncoding
+ * bits (see wire.h); unknown encoding names are ignored.
+ */
+typedef struct drone_message {
+    DroneMessageType type;  /**< Message type */
+    unsigned int fields;    /**< Bitmask of DRONE_FIELD_* present */
+    Coord location;         /**< Reported drone position */
+    Coord target;           /**< Completed mission target */
+    int status;             /**< Reported DroneStatus */
+    int battery;            /**< Battery level (percent) */
+    long timestamp;         /**< Sender timestamp (seconds since epoch) */
+    int success;            /**< Mission outcome (MISSION_COMPLETE) */
+    unsigned int encodings; /**< WireEncoding bits offered (HANDSHAKE) */
+} DroneMessage;
+
+/**
+ * @brief Decode a drone message without allocating
+ *
+ * @param data Start of one JSON object (need not be NUL-terminated)
+ * @param length Length of the object in bytes
+ * @param message Receives the decoded fields
+ * @return 0 on success, -1 if the input is outside the fast path and
+ *         should be parsed with json-c instead
+ */
+int parse_drone_message(const char *data, size_t length, DroneMessage *message);
+
+/**
+ * @brief Map a message type name to its DroneMessageType
+ *
+ * @param name Type string, e.g. "STATUS_UPDATE"
+ * @param length Length of the string
+ * @return The matching type, or DRONE_MSG_UNKNOWN
+ */
+DroneMessageType drone_message_type_from_name(const char *name, size_t length);
+
+/**
+ * @brief Map an encoding name from HANDSHAKE to its WireEncoding bit
+ *
+ * @param name Encoding string, e.g. "binary"
+ * @param length Length of the string
+ * @return The WireEncoding value, or 0 if the name is unknown
+ */
+unsigned int drone_encoding_from_name(const char *name, size_t length);
+
+/**
+ * @brief Map a drone status string to a DroneStatus value
+ *
+ * @param name Status string, e.g. "idle" or "ON_MISSION"
+ * @param length Length of the string
+ * @return IDLE or ON_MISSION, or -1 if the status is not one the server tracks
+ */
+int drone_status_from_name(const char *name, size_t length);
+
+/** @} */ // end of message_parser group
+
+#endif // MESSAGE_PARSER_H
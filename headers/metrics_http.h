@@ -0,0 +1,84 @@
+/**
+ * @file metrics_http.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Prometheus scrape endpoint for live server metrics
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Optional HTTP listener, started with --metrics-port=N, that answers
+ * `GET /metrics` with the performance metrics (see
+ * perf_format_prometheus()) and the simulation counters in Prometheus
+ * text format.
+ *
+ * **Design:**
+ * - One dedicated thread and one loopback-only listening socket, separate
+ *   from the drone port
+ * - Non-blocking sockets driven by poll() with timeouts, so a slow or
+ *   stalled scraper costs at most METRICS_HTTP_IO_TIMEOUT_MS and never
+ *   blocks drone handling
+ * - One request per connection (`Connection: close`)
+ *
+ * **Thread Safety:**
+ * Scrapes hold metrics_lock only while perf_format_prometheus() copies
+ * the metrics; simulation counters are read with atomic loads. Client
+ * threads record metrics without taking any lock, so a scrape never
+ * stalls them.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup monitoring
+ * @ingroup networking
+ */
+
+#ifndef METRICS_HTTP_H
+#define METRICS_HTTP_H
+
+/**
+ * @defgroup metrics_http Metrics HTTP Endpoint
+ * @brief Prometheus text format scrape endpoint
+ * @ingroup monitoring
+ * @{
+ */
+
+/** @brief poll() timeout on the listening socket so the thread notices shutdown (milliseconds) */
+#define METRICS_HTTP_POLL_TIMEOUT_MS 500
+
+/** @brief Longest a scraper may take to send its request or read the response (milliseconds) */
+#define METRICS_HTTP_IO_TIMEOUT_MS 1000
+
+/** @brief Largest request header accepted, in bytes */
+#define METRICS_HTTP_REQUEST_SIZE 2048
+
+/** @brief Size of the response body buffer, in bytes */
+#define METRICS_HTTP_BODY_SIZE 32768
+
+/**
+ * @brief TCP port of the metrics endpoint
+ *
+ * 0 (the default) disables the endpoint.
+ */
+extern int metrics_http_port;
+
+/**
+ * @brief Thread function serving the metrics endpoint
+ *
+ * Listens on 127.0.0.1:metrics_http_port and serves scrapes one at a time
+ * until the global running flag is cleared.
+ *
+ * **Responses:**
+ * - `GET /metrics` (or `/`): 200 with the metrics in text format 0.0.4
+ * - Any other path: 404
+ * - Any other method: 405
+ *
+ * @param arg Unused thread parameter (required for pthread compatibility)
+ * @return NULL when the server stops or the port cannot be bound
+ *
+ * @note A bind failure is reported and leaves the rest of the server running
+ */
+// clang-format off
+void *metrics_http_server(void *arg);
+// clang-format on
+
+/** @} */ // end of metrics_http group
+
+#endif // METRICS_HTTP_H
@@ -0,0 +1,179 @@
+/**
+ * @file mission_trace.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Per-mission time-to-rescue traces and their stage latencies
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Every rescued survivor produces one MissionTrace: monotonic timestamps
+ * of its spawn, of the AI choosing a drone for it, of ASSIGN_MISSION
+ * leaving the server and of the MISSION_COMPLETE that rescued it. The
+ * stamps are kept in SurvivorTimes while the mission runs; the finished
+ * trace is pushed into a bounded ring and later folded into one latency
+ * histogram per stage, so the time to rescue can be split into the part
+ * spent waiting for the AI, dispatching and flying.
+ *
+ * **Stages:**
+ * - waiting: spawn to assignment (AI cycle interval and drone availability)
+ * - dispatch: assignment to ASSIGN_MISSION sent (encoding and send(),
+ *   including any wait for socket buffer space)
+ * - travel: ASSIGN_MISSION sent to MISSION_COMPLETE handled (both network
+ *   legs and the drone's flight)
+ * - total: spawn to rescue
+ *
+ * **Ring:**
+ * A bounded multi-producer, single-consumer queue with a sequence number
+ * per slot. Producers claim a slot with one compare-and-swap on the head
+ * and publish it with a release store of its sequence, so recording never
+ * blocks and never takes a lock. When the ring is full the trace is
+ * dropped and counted; the consumer drains it often enough that this only
+ * happens if it stalls.
+ *
+ * **Thread Safety:**
+ * mission_trace_record() may be called from any number of threads.
+ * mission_trace_pop(), mission_trace_aggregate() and
+ * mission_trace_export_json() must be called from one consumer thread at
+ * a time (the controller's main thread).
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup monitoring
+ */
+
+#ifndef MISSION_TRACE_H
+#define MISSION_TRACE_H
+
+#include "latency_histogram.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @defgroup mission_trace Mission Tracing
+ * @brief Spawn-to-rescue traces with lock-free recording
+ * @ingroup monitoring
+ * @{
+ */
+
+/** @brief Traces the ring holds before producers drop (power of two) */
+#define MISSION_TRACE_CAPACITY 4096
+
+/**
+ * @enum MissionStage
+ * @brief Stages of a mission with a latency histogram of their own
+ */
+typedef enum {
+    MISSION_STAGE_WAITING,  /**< Spawn to assignment */
+    MISSION_STAGE_DISPATCH, /**< Assignment to ASSIGN_MISSION sent */
+    MISSION_STAGE_TRAVEL,   /**< ASSIGN_MISSION sent to MISSION_COMPLETE handled */
+    MISSION_STAGE_TOTAL,    /**< Spawn to rescue */
+    MISSION_STAGE_COUNT     /**< Number of stages (not a stage) */
+} MissionStage;
+
+/**
+ * @struct mission_trace
+ * @brief Timestamps of one finished mission
+ *
+ * Times are CLOCK_MONOTONIC nanoseconds from mission_trace_now().
+ */
+typedef struct mission_trace {
+    int survivor;          /**< Index of the rescued survivor in survivor_store */
+    int drone;             /**< Id of the drone that rescued it */
+    uint64_t spawned_ns;   /**< Survivor added or recycled as waiting */
+    uint64_t assigned_ns;  /**< AI chose the drone */
+    uint64_t sent_ns;      /**< ASSIGN_MISSION send completed (assigned_ns for local drones, 0 if rescued first) */
+    uint64_t completed_ns; /**< Rescue recorded */
+} MissionTrace;
+
+/**
+ * @struct mission_trace_slot
+ * @brief One ring entry and its sequence number
+ *
+ * A slot at ring position p is free for writing when its sequence is p
+ * and holds a published trace when its sequence is p + 1.
+ */
+typedef struct mission_trace_slot {
+    atomic_ulong sequence; /**< Position the slot is ready for, see above */
+    MissionTrace trace;    /**< The trace */
+} MissionTraceSlot;
+
+/**
+ * @struct mission_trace_buffer
+ * @brief Trace ring and the stage histograms it is drained into
+ */
+typedef struct mission_trace_buffer {
+    MissionTraceSlot slots[MISSION_TRACE_CAPACITY];  /**< The ring */
+    atomic_ulong head;                               /**< Next position to claim (producers) */
+    unsigned long tail;                              /**< Next position to read (consumer) */
+    atomic_ulong dropped;                            /**< Traces lost because the ring was full */
+    unsigned long aggregated;                        /**< Traces folded into the histograms */
+    LatencyHistogram stages[MISSION_STAGE_COUNT];    /**< Latency of each MissionStage */
+} MissionTraceBuffer;
+
+/**
+ * @brief Global trace buffer of the server
+ *
+ * Filled on every rescue and drained by the controller's main loop.
+ */
+extern MissionTraceBuffer mission_traces;
+
+/**
+ * @brief Initialize an empty buffer
+ *
+ * @param buffer Buffer to initialize; no thread may use it meanwhile
+ */
+void mission_trace_init(MissionTraceBuffer *buffer);
+
+/**
+ * @brief Current CLOCK_MONOTONIC time in nanoseconds
+ */
+uint64_t mission_trace_now(void);
+
+/**
+ * @brief Push a finished mission without blocking
+ *
+ * @param buffer Buffer to record into
+ * @param trace Trace to copy
+ * @return 0 on success, -1 if the ring was full (counted in dropped)
+ */
+int mission_trace_record(MissionTraceBuffer *buffer, const MissionTrace *trace);
+
+/**
+ * @brief Take the oldest published trace
+ *
+ * @param buffer Buffer to read (consumer thread only)
+ * @param trace Receives the trace
+ * @return 1 if a trace was taken, 0 if none is published
+ */
+int mission_trace_pop(MissionTraceBuffer *buffer, MissionTrace *trace);
+
+/**
+ * @brief Drain the ring into the stage histograms
+ *
+ * A stage whose start was not stamped (for example a survivor assigned
+ * before tracing started) is left out of that stage and of the total.
+ *
+ * @param buffer Buffer to drain (consumer thread only)
+ * @return Number of traces drained
+ */
+int mission_trace_aggregate(MissionTraceBuffer *buffer);
+
+/**
+ * @brief Name of a stage as used in the exported JSON
+ */
+const char *mission_stage_name(MissionStage stage);
+
+/**
+ * @brief Drain the ring and write the stage latencies as JSON
+ *
+ * Writes count, mean and p50/p95/p99/p99.9 in milliseconds for each
+ * stage, plus each stage's share of the mean time to rescue.
+ *
+ * @param buffer Buffer to export (consumer thread only)
+ * @param filename Path of the JSON file to create
+ * @return 0 on success, -1 if the file could not be written
+ */
+int mission_trace_export_json(MissionTraceBuffer *buffer, const char *filename);
+
+/** @} */ // end of mission_trace group
+
+#endif // MISSION_TRACE_H
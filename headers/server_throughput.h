@@ -13,6 +13,7 @@
  * **Key Features:**
  * - Real-time message throughput monitoring
  * - Response time tracking with min/max/average calculations
+ * - Latency percentiles (p50/p95/p99/p99.9) per operation type
  * - Connection lifecycle monitoring
  * - Data transfer volume tracking (bytes sent/received)
  * - Peak performance detection and recording
@@ -56,6 +57,45 @@
  * @{
  */
 
+/** @brief Seconds of history kept for windowed message rates */
+#define PERF_RATE_BUCKETS 60
+
+/**
+ * @struct PerfRateBucket
+ * @brief Messages processed during one tick of the monitor thread
+ */
+typedef struct {
+    unsigned long messages; /**< Messages processed during the tick */
+    double seconds;         /**< Measured length of the tick (about one second) */
+} PerfRateBucket;
+
+/**
+ * @enum PerfOperation
+ * @brief Operations whose latency is tracked in a histogram of its own
+ */
+typedef enum {
+    PERF_OP_HANDSHAKE,        /**< Handshake received until acknowledgment sent */
+    PERF_OP_STATUS_UPDATE,    /**< Processing or sending a status update */
+    PERF_OP_MISSION_COMPLETE, /**< Processing or sending a mission completion */
+    PERF_OP_HEARTBEAT,        /**< Processing or sending a heartbeat response */
+    PERF_OP_ASSIGN_MISSION,   /**< Assigning and sending one mission */
+    PERF_OP_AI_CYCLE,         /**< One AI controller assignment cycle */
+    PERF_OP_COUNT             /**< Number of tracked operations */
+} PerfOperation;
+
+/**
+ * @struct PerfLatency
+ * @brief Latency percentiles of one operation, from its histogram
+ */
+typedef struct {
+    unsigned long count; /**< Samples recorded */
+    double p50_ms;       /**< Median latency */
+    double p95_ms;       /**< 95th percentile latency */
+    double p99_ms;       /**< 99th percentile latency */
+    double p999_ms;      /**< 99.9th percentile latency */
+    double sum_ms;       /**< Approximate sum of all samples */
+} PerfLatency;
+
 /**
  * @struct PerfMetrics
  * @brief Comprehensive structure for tracking all system performance metrics
@@ -70,6 +110,10 @@
  * acquire this lock before accessing or modifying any metric values
  * to prevent race conditions in multi-threaded environments.
  * 
+ * Message, byte, error and response time fields are not written by the
+ * recording functions: those count into per-thread shards, and the fields
+ * only hold their totals after perf_aggregate() has run.
+ * 
  * **Data Categories:**
  * - Message Counts: Different types of messages processed
  * - Throughput: Bytes transferred in both directions
@@ -117,6 +161,7 @@ typedef struct {
     unsigned long response_count;  /**< Number of response time measurements taken */
     double max_response_time_ms;   /**< Maximum response time observed */
     double min_response_time_ms;   /**< Minimum response time observed */
+    PerfLatency latency[PERF_OP_COUNT]; /**< Percentiles per operation type */
     /** @} */
 
     /** @name Timing Infrastructure
@@ -131,10 +176,24 @@ typedef struct {
      *  Recording maximum performance levels achieved
      *  @{
      */
-    unsigned long peak_messages_per_second; /**< Highest message processing rate observed */
+    unsigned long peak_messages_per_second; /**< Highest rate over any one-second bucket */
     unsigned long peak_connections;         /**< Maximum number of simultaneous connections */
     /** @} */
 
+    /** @name Windowed Message Rates
+     *  Ring of per-second buckets filled by the monitor thread
+     *  @{
+     */
+    PerfRateBucket rate_buckets[PERF_RATE_BUCKETS]; /**< Most recent seconds, oldest overwritten first */
+    int rate_head;                                  /**< Bucket written by the next tick */
+    int rate_bucket_count;                          /**< Buckets filled so far (up to PERF_RATE_BUCKETS) */
+    unsigned long rate_last_total;                  /**< messages_processed at the last tick */
+    double rate_last_elapsed;                       /**< Elapsed seconds at the last tick */
+    double messages_per_second_1s;                  /**< Rate over the last bucket */
+    double messages_per_second_10s;                 /**< Rate over the last 10 buckets */
+    double messages_per_second_60s;                 /**< Rate over the last 60 buckets */
+    /** @} */
+
     /** @name Synchronization and Control
      *  Thread safety and monitoring control
      *  @{
@@ -206,7 +265,9 @@ extern PerfMetrics metrics;
  * 
  * **CSV Log Format:**
  * The CSV file includes timestamp, elapsed time, message counts,
- * throughput rates, connection statistics, and response time metrics.
+ * throughput rates, connection statistics, and response time metrics,
+ * followed by p50/p95/p99/p999 columns for each PerfOperation
+ * (e.g. handshake_p99_ms).
  * 
  * @param log_filename Path to CSV log file (can be NULL to disable file logging)
  * 
@@ -246,7 +307,7 @@ void init_perf_monitor(const char* log_filename);
  * @pre Performance monitoring must be initialized
  * @post Status update metrics are incremented atomically
  * 
- * @note Thread-safe through internal mutex locking
+ * @note Lock-free: counts into the calling thread's shard with relaxed atomics
  * @see perf_record_mission_assigned() for outbound messages
  */
 void perf_record_status_update(size_t bytes_received);
@@ -268,7 +329,7 @@ void perf_record_status_update(size_t bytes_received);
  * @pre Performance monitoring must be initialized
  * @post Mission assignment metrics are incremented atomically
  * 
- * @note Thread-safe through internal mutex locking
+ * @note Lock-free: counts into the calling thread's shard with relaxed atomics
  * @see perf_record_status_update() for inbound messages
  */
 void perf_record_mission_assigned(size_t bytes_sent);
@@ -290,7 +351,7 @@ void perf_record_mission_assigned(size_t bytes_sent);
  * @pre Performance monitoring must be initialized
  * @post Heartbeat metrics are incremented atomically
  * 
- * @note Thread-safe through internal mutex locking
+ * @note Lock-free: counts into the calling thread's shard with relaxed atomics
  * @note Heartbeats typically generate consistent, small message sizes
  */
 void perf_record_heartbeat(size_t bytes_sent);
@@ -308,7 +369,7 @@ void perf_record_heartbeat(size_t bytes_sent);
  * @pre Performance monitoring must be initialized
  * @post Error count is incremented atomically
  * 
- * @note Thread-safe through internal mutex locking
+ * @note Lock-free: counts into the calling thread's shard with relaxed atomics
  * @note Should be called for all significant error conditions
  */
 void perf_record_error(void);
@@ -358,13 +419,57 @@ void perf_record_connection(int is_new);
  * @pre response_time_ms should be positive
  * @post Response time statistics are updated atomically
  * 
- * @note Thread-safe through internal mutex locking
+ * @note Lock-free: counts into the calling thread's shard with relaxed atomics
  * @note Used for measuring end-to-end message processing latency
  * 
  * @see Mission assignment, status processing, and heartbeat response times
+ * @see perf_record_latency() to also record which operation was timed
  */
 void perf_record_response_time(double response_time_ms);
 
+/**
+ * @brief Record the latency of one operation
+ * 
+ * Counts the sample in the operation's log-linear histogram and in the
+ * overall response time statistics (as perf_record_response_time()).
+ * 
+ * **Metrics Updated:**
+ * - latency[operation] percentiles, after the next perf_aggregate()
+ * - Every field updated by perf_record_response_time()
+ * 
+ * @param operation Operation that was timed
+ * @param response_time_ms Its latency in milliseconds
+ * 
+ * @pre Performance monitoring must be initialized
+ * 
+ * @note Lock-free: one relaxed atomic increment in the histogram
+ * @note Percentiles are within about 1.6% of the true value
+ */
+void perf_record_latency(PerfOperation operation, double response_time_ms);
+
+/**
+ * @brief Short name of an operation, as used in the CSV and JSON output
+ * 
+ * @param operation Operation to name
+ * @return Static string such as "status_update", or "unknown"
+ */
+const char *perf_operation_name(PerfOperation operation);
+
+/**
+ * @brief Fold the per-thread counter shards into the global metrics
+ * 
+ * Recomputes the message, byte, error and response time fields of
+ * metrics from the shards written by the recording functions, and the
+ * latency percentiles from the operation histograms. The reporting
+ * functions call it before reading those fields.
+ * 
+ * @pre Caller holds metrics.metrics_lock
+ * @post metrics holds every count recorded before the call
+ * 
+ * @note Counts recorded during the call may appear in this or the next one
+ */
+void perf_aggregate(void);
+
 /** @} */ // end of metrics_recording group
 
 /**
@@ -403,6 +508,7 @@ double get_elapsed_seconds(void);
  * - Connection statistics and peak usage
  * - Data transfer volume in KB
  * - Response time statistics (min/avg/max)
+ * - Latency percentiles of each operation with samples
  * 
  * @pre Performance monitoring must be initialized
  * @post Formatted metrics displayed on console
@@ -425,7 +531,11 @@ void log_perf_metrics(void);
  * timestamp, elapsed_seconds, total_messages, msg_per_sec,
  * status_updates, missions, heartbeats, errors, active_connections,
  * total_bytes_rx, total_bytes_tx, avg_response_ms, max_response_ms,
- * peak_msg_per_sec
+ * peak_msg_per_sec, msg_per_sec_1s, msg_per_sec_10s, msg_per_sec_60s,
+ * then <operation>_p50_ms .. <operation>_p999_ms for each PerfOperation
+ * 
+ * msg_per_sec is the lifetime average; the _1s/_10s/_60s columns are
+ * moving rates over the most recent per-second buckets.
  * 
  * @pre Performance monitoring must be initialized
  * @pre CSV log file must be open (log_filename provided to init)
@@ -453,6 +563,8 @@ void log_perf_metrics_to_file(void);
  * intervals to both console and CSV file.
  * 
  * **Operation:**
+ * - Every second, closes a rate bucket with the messages processed in it
+ *   and updates the 1s/10s/60s rates and the peak rate
  * - Logs metrics every 5 seconds while monitoring is active
  * - Calls both console and file logging functions
  * - Continues until is_monitoring flag is cleared
@@ -465,7 +577,7 @@ void log_perf_metrics_to_file(void);
  * @post Continuous metrics logging until termination
  * 
  * @note Runs in separate thread for non-blocking operation
- * @note Sleep interval is fixed at 5 seconds
+ * @note Ticks every second; logs every PERF_LOG_INTERVAL ticks
  * 
  * @see start_perf_monitor() for thread creation
  * @see stop_perf_monitor() for thread termination
@@ -545,6 +657,9 @@ void stop_perf_monitor(pthread_t monitor_thread);
  *     "total_messages": int,
  *     "messages_per_second": float,
  *     "peak_messages_per_second": int,
+ *     "messages_per_second_1s": float,
+ *     "messages_per_second_10s": float,
+ *     "messages_per_second_60s": float,
  *     "status_updates": int,
  *     "missions_assigned": int,
  *     "heartbeats_sent": int,
@@ -556,7 +671,11 @@ void stop_perf_monitor(pthread_t monitor_thread);
  *     "bytes_sent": int,
  *     "avg_response_time_ms": float,
  *     "max_response_time_ms": float,
- *     "min_response_time_ms": float
+ *     "min_response_time_ms": float,
+ *     "latency_ms": {
+ *       "handshake": { "count": int, "p50": float, "p95": float, "p99": float, "p999": float },
+ *       ... one object per PerfOperation
+ *     }
  *   }
  * }
  * ```
@@ -576,6 +695,32 @@ void stop_perf_monitor(pthread_t monitor_thread);
 void export_metrics_json(const char* filename);
 // clang-format on
 
+/**
+ * @brief Write the current metrics in Prometheus text exposition format
+ * 
+ * Renders every counter, gauge and latency summary of PerfMetrics as
+ * `drone_*` metrics (format version 0.0.4), for a scrape endpoint.
+ * 
+ * **Metric Families:**
+ * - Counters: messages, status updates, missions, heartbeats, errors,
+ *   bytes in each direction, connections and disconnections
+ * - Gauges: uptime, active and peak connections, windowed and peak
+ *   message rates
+ * - Summaries: overall response time, and latency per operation with
+ *   quantiles 0.5, 0.95, 0.99 and 0.999
+ * 
+ * @param buffer Output buffer
+ * @param size Size of the buffer in bytes
+ * @return Length of the text written (excluding the terminator), or -1 if
+ *         it did not fit
+ * 
+ * @pre Performance monitoring must be initialized
+ * 
+ * @note Holds metrics_lock only to aggregate and copy the metrics; the
+ *       text is formatted from the copy after the lock is released
+ */
+int perf_format_prometheus(char *buffer, size_t size);
+
 /** @} */ // end of metrics_export group
 
 /** @} */ // end of monitoring group
@@ -0,0 +1,157 @@
+/**
+ * @file spatial_index.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Grid-bucketed spatial index for nearest-neighbour queries on the map
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Keeps a set of points (drones, survivors) bucketed on the map cell grid
+ * so that "closest X to this coordinate" only looks at nearby buckets
+ * instead of every entity in the system.
+ *
+ * **Layout:**
+ * - The map is covered by buckets of bucket_span x bucket_span cells; a
+ *   span of 1 gives one bucket per map cell
+ * - Entries are addressed by a small non-negative integer key (drone id,
+ *   survivor index) and stored in a table indexed by that key, which grows
+ *   on demand; each bucket is an intrusive doubly linked list through it
+ * - Insert, move and remove are O(1)
+ *
+ * **Nearest Query:**
+ * Buckets are visited in rings of increasing Manhattan distance around the
+ * query's bucket (a diamond-shaped spiral). The search stops as soon as the
+ * best distance found is no larger than the smallest distance any point in
+ * the next ring could have, so the result is exact and the cost depends on
+ * how far away the nearest entry is, not on how many entries there are.
+ *
+ * **Coordinates:**
+ * Points outside the map are stored in the nearest edge bucket. Distances
+ * are always computed from the exact coordinates, so results stay exact.
+ *
+ * **Thread Safety:**
+ * Every function takes the index's own mutex. That mutex is a leaf lock:
+ * callers may hold drone or survivor locks while calling in, but no other
+ * lock is taken while it is held.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup spatial_system
+ */
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "coord.h"
+#include <pthread.h>
+
+/**
+ * @defgroup spatial_index Spatial Index
+ * @brief Bucketed nearest-neighbour search over the map grid
+ * @ingroup spatial_system
+ * @{
+ */
+
+/**
+ * @struct spatial_entry
+ * @brief Slot of one key in the index table
+ */
+typedef struct spatial_entry {
+    Coord coord; /**< Exact position of the entry */
+    // clang-format off
+    void *item;  /**< Caller data returned by queries (may be NULL) */
+    // clang-format on
+    int bucket;  /**< Bucket holding the entry, -1 if the key is not indexed */
+    int prev;    /**< Previous key in the bucket list, -1 at the head */
+    int next;    /**< Next key in the bucket list, -1 at the tail */
+} SpatialEntry;
+
+/**
+ * @struct spatial_index
+ * @brief Bucket grid plus the key-indexed entry table
+ */
+typedef struct spatial_index {
+    int rows;           /**< Bucket rows (covers map x) */
+    int cols;           /**< Bucket columns (covers map y) */
+    int bucket_span;    /**< Map cells per bucket side */
+    int count;          /**< Number of indexed entries */
+    int capacity;       /**< Number of slots in entries */
+    // clang-format off
+    int *heads;             /**< First key of each bucket list, -1 if empty */
+    SpatialEntry *entries;  /**< Entry table indexed by key */
+    // clang-format on
+    pthread_mutex_t lock; /**< Protects every field above */
+} SpatialIndex;
+
+/**
+ * @brief Initialize an empty index covering a height x width map
+ *
+ * @param index Index to initialize
+ * @param height Map rows (x range)
+ * @param width Map columns (y range)
+ * @param bucket_span Map cells per bucket side (1 = one bucket per cell)
+ * @param capacity Initial number of key slots; grows when a larger key is inserted
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ */
+int spatial_index_init(SpatialIndex *index, int height, int width, int bucket_span, int capacity);
+
+/**
+ * @brief Release the memory held by an index
+ *
+ * @param index Index initialized with spatial_index_init()
+ */
+void spatial_index_destroy(SpatialIndex *index);
+
+/**
+ * @brief Add a key at a position, or move it there if already indexed
+ *
+ * @param index Index to update
+ * @param key Non-negative key
+ * @param coord Position of the entry
+ * @param item Caller data returned by queries for this key
+ * @return 0 on success, -1 on a negative key or allocation failure
+ */
+int spatial_index_insert(SpatialIndex *index, int key, Coord coord, void *item);
+
+/**
+ * @brief Remove a key; does nothing if it is not indexed
+ *
+ * @param index Index to update
+ * @param key Key to remove
+ */
+void spatial_index_remove(SpatialIndex *index, int key);
+
+/**
+ * @brief Find the indexed entry closest to a position (Manhattan distance)
+ *
+ * @param index Index to search
+ * @param origin Query position
+ * @param item If not NULL, receives the item of the entry found
+ * @return Key of the closest entry, or -1 if the index is empty
+ */
+// clang-format off
+int spatial_index_nearest(SpatialIndex *index, Coord origin, void **item);
+// clang-format on
+
+/**
+ * @brief Find the @p k indexed entries closest to a position
+ *
+ * Same ring search as spatial_index_nearest(), stopping once @p k entries
+ * are known and no bucket further out can hold a closer one.
+ *
+ * @param index Index to search
+ * @param origin Query position
+ * @param k Maximum number of entries to return
+ * @param keys Receives up to @p k keys, closest first
+ * @param distances Receives the Manhattan distance of each key
+ * @return Number of entries written (less than @p k if the index holds fewer)
+ */
+int spatial_index_nearest_k(SpatialIndex *index, Coord origin, int k, int *keys, int *distances);
+
+/**
+ * @brief Number of entries currently indexed
+ */
+int spatial_index_count(SpatialIndex *index);
+
+/** @} */ // end of spatial_index group
+
+#endif // SPATIAL_INDEX_H
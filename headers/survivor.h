@@ -11,7 +11,7 @@
  * for use by the AI controller and visualization systems.
  * 
  * **Key Features:**
- * - Thread-safe survivor array with mutex protection
+ * - Thread-safe structure-of-arrays survivor store with mutex protection
  * - Status-based lifecycle management (waiting → being helped → rescued)
  * - Continuous survivor generation simulation
  * - Spatial organization through map cell integration
@@ -34,6 +34,8 @@
 #include "coord.h"
 #include <time.h>
 #include "list.h"
+#include "spatial_index.h"
+#include "survivor_store.h"
 #include <pthread.h>
 
 /**
@@ -50,14 +52,18 @@
  */
 
 /** 
- * @def MAX_SURVIVORS
- * @brief Maximum number of survivors that can be tracked simultaneously
+ * @def SURVIVOR_STORE_INITIAL
+ * @brief Survivor keys waiting_survivor_index has room for before its first growth
+ */
+#define SURVIVOR_STORE_INITIAL 1024
+
+/** 
+ * @def SURVIVOR_CAPACITY_DEFAULT
+ * @brief Default size of survivor_store (see survivor_capacity)
  * 
- * This limit prevents unbounded memory growth and ensures predictable
- * performance characteristics. When the limit is reached, rescued
- * survivors may be recycled to make space for new arrivals.
+ * About 18 hours of the generator's output before it starts recycling.
  */
-// Removed MAX_SURVIVORS definition to avoid conflict with globals.h
+#define SURVIVOR_CAPACITY_DEFAULT 65536
 
 /** @} */ // end of survivor_constants group
 
@@ -72,14 +78,15 @@
  * @brief Structure representing a person requiring emergency assistance
  * 
  * Contains all information necessary to track a survivor's status,
- * location, and rescue timeline. The structure supports the complete
- * survivor lifecycle from initial discovery through successful rescue.
+ * location, and rescue timeline. This is the element type of the survivor
+ * lists; the simulation itself keeps survivors in survivor_store, whose
+ * arrays hold the same fields.
  * 
  * **Status Values:**
  * - 0: Waiting for rescue (displayed in red)
  * - 1: Being helped by a drone (displayed in red)
- * - 2: Successfully rescued (not displayed)
- * - 3: Archived rescued (available for recycling)
+ * - 2: Successfully rescued (not displayed, available for recycling)
+ * - 3: Archived rescued (no longer set; recycled like 2)
  * 
  * **Thread Safety:**
  * Access to survivor structures is protected by the global survivors_mutex.
@@ -93,7 +100,7 @@ typedef struct survivor {
     Coord coord;              /**< Current location on the map grid */
     struct tm discovery_time; /**< Timestamp when survivor was first detected */
     struct tm helped_time;    /**< Timestamp when rescue was completed */
-    char info[25];            /**< Identifier string for tracking purposes */
+    char info[SURVIVOR_INFO_SIZE]; /**< Identifier string for tracking purposes */
 } Survivor;
 
 /** @} */ // end of survivor_structures group
@@ -105,65 +112,79 @@ typedef struct survivor {
  */
 
 /** 
- * @brief Global array containing all tracked survivors
+ * @brief Store holding every tracked survivor
  * 
- * Fixed-size array that holds all survivors currently in the system.
- * Access must be synchronized using survivors_mutex to prevent race
- * conditions between the generator thread, AI controller, and visualization.
+ * Survivors are addressed by their index in the store, which never
+ * changes. Access must be synchronized using survivors_mutex to prevent
+ * race conditions between the generator thread, AI controller, and
+ * visualization. The one exception is survivor_claim() and
+ * survivor_release(), which change a status by compare-and-swap.
  * 
  * **Memory Layout:**
- * - Contiguous allocation for cache efficiency
- * - Fixed size determined by MAX_SURVIVORS
- * - Zero-initialized on system startup
- * 
- * @note Array size is static for performance predictability
- * @warning Always use survivors_mutex when accessing this array
+ * - Coordinates and status in packed parallel arrays for hot scans
+ * - Per-status bitsets and counters for counting and filtering by status
+ * - Identifier and timestamps in cold side arrays
+ * - Allocated for survivor_capacity survivors; the arrays never move
+ * 
+ * @warning Always use survivors_mutex when accessing the store, and expect
+ *          waiting survivors to be claimed even while holding it
+ * @see survivor_store.h
  */
 // clang-format off
-extern Survivor *survivor_array;
+extern SurvivorStore survivor_store;
 
 /** 
- * @brief Current number of active survivors in the array
- * 
- * Tracks how many array slots are currently occupied by valid survivors.
- * This value increases as new survivors are generated and may decrease
- * during recycling operations when the array becomes full.
- * 
- * **Update Patterns:**
- * - Incremented by survivor_generator thread
- * - Read by AI controller for mission planning
- * - Read by visualization for display purposes
- * 
- * @note Must be accessed under survivors_mutex protection
- */
-extern int num_survivors;
-
-/** 
- * @brief Mutex protecting access to the survivor array
+ * @brief Mutex protecting access to the survivor store
  * 
  * Critical synchronization primitive that ensures thread-safe access
  * to all survivor-related data structures. Must be acquired before
  * any read or write operations on survivor data.
  * 
  * **Protected Resources:**
- * - survivor_array contents
- * - num_survivors counter
- * - Individual survivor status changes
+ * - survivor_store contents and count
+ * - Individual survivor status changes, except claims and releases
  * 
  * **Locking Order:**
  * When multiple mutexes are needed, acquire survivors_mutex before
- * any drone-specific mutexes to prevent deadlock.
+ * any drone-specific mutexes to prevent deadlock. Mission assignment
+ * takes neither it nor any lock while sending.
  * 
  * @warning Failure to use this mutex can cause data corruption
  */
 extern pthread_mutex_t survivors_mutex;
 
+/** 
+ * @brief Spatial index of every waiting survivor (status 0)
+ * 
+ * Keyed by survivor_store index and bucketed on the map cell grid, so the
+ * AI can find the closest waiting survivor by looking at nearby cells only
+ * instead of scanning the whole store under survivors_mutex.
+ * 
+ * **Maintenance:**
+ * survivor_index_update() is called whenever a survivor is added
+ * (add_survivor()) or changes status (survivor_set_status(),
+ * survivor_claim(), survivor_release()).
+ * 
+ * @note The index has its own lock; queries do not take survivors_mutex
+ */
+extern SpatialIndex waiting_survivor_index;
+
+/** 
+ * @brief Survivors survivor_store is allocated for (--max-survivors)
+ * 
+ * The store does not grow, since survivors are claimed without a lock. Once
+ * it is full, add_survivor() fails and the generator recycles rescued
+ * survivors instead. Read by initialize_survivors(); 1 .. SURVIVOR_STORE_MAX,
+ * SURVIVOR_CAPACITY_DEFAULT unless configured.
+ */
+extern int survivor_capacity;
+
 /** 
  * @brief Global list of survivors awaiting rescue assistance
  * 
  * Thread-safe list containing survivors with status 0 (waiting).
  * Used by the AI controller for efficient mission assignment
- * without scanning the entire survivor array.
+ * without scanning the entire survivor store.
  * 
  * @note This list has its own internal mutex protection
  * @see List structure for thread-safety details
@@ -177,7 +198,7 @@ extern List *survivors;
  * or status 2 (rescued). Used for tracking rescue progress and
  * generating completion statistics.
  * 
- * @note Separate from main array for performance optimization
+ * @note Separate from survivor_store for performance optimization
  */
 extern List *helpedsurvivors;
 
@@ -197,12 +218,13 @@ extern List *helpedsurvivors;
  * Must be called before any other survivor-related operations.
  * 
  * **Initialization Steps:**
- * 1. Allocate survivor array memory (MAX_SURVIVORS * sizeof(Survivor))
- * 2. Zero-initialize all array contents
+ * 1. Allocate survivor_store (survivor_capacity survivors)
+ * 2. Zero-initialize all store contents
  * 3. Initialize survivors_mutex for thread synchronization
  * 4. Set initial survivor count to zero
+ * 5. Create waiting_survivor_index over the map grid
  * 
- * @pre None - can be called on uninitialized system
+ * @pre init_map() has been called (the index takes its dimensions)
  * @post Survivor system is ready for operation
  * 
  * @note Will call exit(EXIT_FAILURE) if memory allocation fails
@@ -220,8 +242,8 @@ void initialize_survivors();
  * called during system shutdown to prevent resource leaks.
  * 
  * **Cleanup Operations:**
- * 1. Destroy survivors_mutex
- * 2. Free survivor_array memory
+ * 1. Destroy survivors_mutex and waiting_survivor_index
+ * 2. Free survivor_store memory
  * 3. Reset survivor count to zero
  * 4. Null out pointer references
  * 
@@ -233,6 +255,104 @@ void initialize_survivors();
  */
 void cleanup_survivors();
 
+/**
+ * @brief Reflect a survivor's current status and coord in waiting_survivor_index
+ * 
+ * Indexes the survivor at its coord if its status is 0 (waiting) and
+ * removes it otherwise. Must be called after every change that moves a
+ * survivor into or out of status 0, or moves a waiting survivor.
+ * 
+ * @param index Index of the survivor in survivor_store
+ * 
+ * **Thread Safety:** Safe to call concurrently for the same survivor: the
+ * status is read again after the update, and the update repeated if a
+ * claim or release changed it meanwhile.
+ */
+void survivor_index_update(int index);
+
+/**
+ * @brief Change a survivor's status
+ * 
+ * With survivor_claim() and survivor_release(), the only place survivor
+ * statuses change outside of tests: updates survivor_store,
+ * waiting_survivor_index and the waiting_count, helped_count and
+ * rescued_count statistics together.
+ * 
+ * @param index Index of the survivor in survivor_store
+ * @param status New status (0-3)
+ * 
+ * **Thread Safety:** The caller must hold survivors_mutex.
+ */
+void survivor_set_status(int index, int status);
+
+/**
+ * @brief Claim a waiting survivor for a mission
+ * 
+ * Moves the survivor from status 0 to 1 with a compare-and-swap, so of
+ * several threads claiming the same survivor exactly one succeeds. The
+ * winner updates waiting_survivor_index and the statistics like
+ * survivor_set_status().
+ * 
+ * @param index Index of the survivor in survivor_store (0 .. count - 1)
+ * @return 1 if the survivor was claimed, 0 if it was no longer waiting
+ * 
+ * **Thread Safety:** Needs no lock; survivors_mutex may be held or not.
+ */
+int survivor_claim(int index);
+
+/**
+ * @brief Give back a survivor claimed with survivor_claim()
+ * 
+ * Moves it from status 1 back to 0 with a compare-and-swap, for a mission
+ * that could not be sent. Does nothing if the survivor is not being helped.
+ * 
+ * @param index Index of the survivor in survivor_store
+ * 
+ * **Thread Safety:** Needs no lock; only the claiming thread may call it.
+ */
+void survivor_release(int index);
+
+/**
+ * @brief Record the spawn-to-rescue trace of a rescued survivor
+ * 
+ * Copies the mission stamps from survivor_store.times into a MissionTrace
+ * completed now and pushes it to mission_traces without blocking. Called
+ * right after the survivor's status is set to rescued.
+ * 
+ * @param index Index of the survivor in survivor_store
+ * @param drone_id Id of the drone that rescued it
+ * 
+ * **Thread Safety:** The caller must hold survivors_mutex.
+ */
+void survivor_trace_rescue(int index, int drone_id);
+
+/**
+ * @brief Add a waiting survivor to survivor_store
+ * 
+ * Names it after its index, stamps its discovery and spawn times, indexes
+ * it, counts it in waiting_count and wakes the AI (AI_EVENT_SURVIVOR_WAITING).
+ * 
+ * @param coord Location of the survivor
+ * @return Index of the new survivor, or -1 if the store already holds
+ *         survivor_capacity survivors
+ * 
+ * **Thread Safety:** The caller must hold survivors_mutex.
+ */
+int add_survivor(Coord coord);
+
+/**
+ * @brief Cross-check the survivor statistics against a full recount
+ * 
+ * Scans every status in survivor_store under survivors_mutex, retrying
+ * until no survivor_claim() or survivor_release() overlaps the scan. Used
+ * by the controller's --verify-stats mode.
+ * 
+ * @return 0 if waiting_count, helped_count and rescued_count match the
+ *         recount or claims never paused long enough to recount, -1
+ *         (after logging the difference) otherwise
+ */
+int survivor_stats_verify(void);
+
 /** @} */ // end of survivor_management group
 
 /**
@@ -290,17 +410,17 @@ Survivor* create_survivor(Coord *coord, char *info, struct tm *discovery_time);
  * **Generation Pattern:**
  * 1. Initial burst: 10 survivors at 0.1 second intervals
  * 2. Continuous generation: 1 survivor every 0.5-1.5 seconds
- * 3. Array full handling: Recycle rescued survivors (status >= 2)
+ * 3. Store full handling: Recycle rescued survivors (status >= 2)
  * 
  * **Thread Safety:**
- * - Acquires survivors_mutex before array modifications
+ * - Acquires survivors_mutex before store modifications
  * - Uses random number generation for location variety
- * - Handles array bounds and capacity limits
+ * - Handles store capacity limits
  * 
  * **Recycling Logic:**
- * When MAX_SURVIVORS is reached, up to 5 rescued survivors are
- * recycled by moving them to new random locations and resetting
- * their status to 0 (waiting).
+ * When survivor_store holds survivor_capacity survivors, up to 5
+ * rescued survivors are recycled by moving them to new random locations
+ * and resetting their status to 0 (waiting).
  * 
  * @param args Unused thread parameter (required for pthread compatibility)
  * @return NULL when thread terminates
@@ -329,32 +449,40 @@ void *survivor_generator(void *args);
  * @brief Clean up all resources associated with a specific survivor
  * 
  * Performs comprehensive cleanup for an individual survivor including
- * removal from map cells, global lists, and memory deallocation.
+ * removal from the global lists and memory deallocation.
  * This function handles the complete cleanup lifecycle for survivors
  * that are being removed from the system.
  * 
  * **Cleanup Operations:**
- * 1. Remove from appropriate map cell survivor list
- * 2. Remove from global survivors list
- * 3. Remove from helpedsurvivors list
- * 4. Free allocated memory
+ * 1. Remove from global survivors list
+ * 2. Remove from helpedsurvivors list
+ * 3. Free allocated memory
  * 
  * **Thread Safety:**
- * - Performs bounds checking on coordinates
- * - Acquires appropriate mutexes for list operations
+ * - Removes by info through each list's key index (removekey()), which
+ *   takes the list's own mutex
  * - Handles cases where survivor may not be in all lists
  * 
  * @param s Pointer to the survivor to clean up
  * 
  * @pre s must be a valid pointer to an allocated survivor
- * @pre Global map and lists must be initialized
+ * @pre Global lists must be initialized
  * @post Survivor is removed from all data structures and freed
  * 
  * @note Handles survivors that may not be in all expected lists
  * @warning Survivor pointer becomes invalid after this call
- * @warning Coordinate bounds are checked to prevent segmentation faults
  */
 void survivor_cleanup(Survivor *s);
+
+/**
+ * @brief Key extractor for lists of Survivor (see list_set_key())
+ * 
+ * Survivor lists are keyed on the zero-padded info string.
+ * 
+ * @param data Survivor element
+ * @return Address of its info field
+ */
+const void *survivor_list_key(const void *data);
 // clang-format off
 /** @} */ // end of survivor_cleanup group
 
@@ -0,0 +1,202 @@
+/**
+ * @file survivor_store.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Structure-of-arrays storage for every survivor in the simulation
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Survivors are addressed by a dense index (0 .. count - 1) and their
+ * fields are split by how often they are read:
+ *
+ * **Hot Arrays:**
+ * - x and y: coordinates, one packed int array each
+ * - status: one byte per survivor
+ * - status_bits: one bitset per status value, bit i set when survivor i
+ *   has that status, plus a counter per status kept equal to the bitset's
+ *   popcount
+ *
+ * Counting survivors by status is a counter read, and visiting every
+ * survivor of one status walks 64 survivors per bitset word without
+ * touching the others.
+ *
+ * **Cold Arrays:**
+ * - info: identifier string
+ * - times: discovery and rescue timestamps (two struct tm), and the
+ *   monotonic stamps of the running mission (see mission_trace.h)
+ *
+ * **Capacity:**
+ * Every array is allocated once, for the capacity given to
+ * survivor_store_init() (at most SURVIVOR_STORE_MAX survivors), and never
+ * moves: survivor_store_claim() reads the arrays without a lock, so they
+ * cannot be reallocated under it. Once the store holds capacity survivors,
+ * survivor_store_add() fails and the owner reuses rescued survivors
+ * instead. Indexes never change once assigned, so they can be used as
+ * keys elsewhere (waiting_survivor_index, mission ids).
+ *
+ * **Thread Safety:**
+ * The store has no lock of its own. The global survivor_store is guarded
+ * by survivors_mutex, with one exception: status, the bitsets, the
+ * counters and count are atomic, so survivor_store_claim() can move a
+ * survivor from one status to another with a compare-and-swap and no lock.
+ * Only one thread may change a given survivor's status at a time (the
+ * claim's winner, or a survivors_mutex holder); between the swap and the
+ * bitset update a reader may briefly see the survivor in neither bitset
+ * or in both.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup simulation
+ */
+
+#ifndef SURVIVOR_STORE_H
+#define SURVIVOR_STORE_H
+
+#include "coord.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @defgroup survivor_store Survivor Store
+ * @brief Structure-of-arrays survivor storage with status bitsets
+ * @ingroup simulation
+ * @{
+ */
+
+/** @brief Number of survivor status values (0 waiting .. 3 archived) */
+#define SURVIVOR_STATUS_COUNT 4
+
+/** @brief Most survivors a store can hold */
+#define SURVIVOR_STORE_MAX (1 << 20)
+
+/** @brief Size of a survivor identifier string, including the terminator */
+#define SURVIVOR_INFO_SIZE 25
+
+/**
+ * @struct survivor_times
+ * @brief Cold per-survivor timestamps, only read when reporting
+ */
+typedef struct survivor_times {
+    struct tm discovery_time; /**< Timestamp when survivor was first detected */
+    struct tm helped_time;    /**< Timestamp when rescue was completed */
+    uint64_t spawned_ns;      /**< Monotonic time the survivor started waiting, 0 if unknown */
+    uint64_t assigned_ns;     /**< Monotonic time a drone was assigned, 0 if none yet */
+    uint64_t sent_ns;         /**< Monotonic time the ASSIGN_MISSION send completed, 0 if not yet */
+} SurvivorTimes;
+
+/**
+ * @struct survivor_store
+ * @brief Survivor fields split into parallel arrays indexed by survivor
+ */
+typedef struct survivor_store {
+    atomic_int count; /**< Survivors in the store, indexes 0 .. count - 1 */
+    int capacity;     /**< Survivors the arrays have room for */
+    // clang-format off
+    int *x;                 /**< Row of each survivor */
+    int *y;                 /**< Column of each survivor */
+    _Atomic uint8_t *status; /**< Status of each survivor (0-3) */
+    _Atomic uint64_t *status_bits[SURVIVOR_STATUS_COUNT]; /**< Survivors of each status, one bit per survivor */
+    char (*info)[SURVIVOR_INFO_SIZE]; /**< Identifier of each survivor (cold) */
+    SurvivorTimes *times;   /**< Timestamps of each survivor (cold) */
+    // clang-format on
+    atomic_int status_count[SURVIVOR_STATUS_COUNT]; /**< Popcount of each status bitset */
+} SurvivorStore;
+
+/**
+ * @brief Initialize an empty store
+ *
+ * @param store Store to initialize
+ * @param capacity Most survivors the store will hold (1 .. SURVIVOR_STORE_MAX)
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ */
+int survivor_store_init(SurvivorStore *store, int capacity);
+
+/**
+ * @brief Release the memory held by a store; safe to call twice
+ *
+ * @param store Store initialized with survivor_store_init()
+ */
+void survivor_store_destroy(SurvivorStore *store);
+
+/**
+ * @brief Forget every survivor but keep the memory
+ *
+ * @param store Store to empty
+ */
+void survivor_store_clear(SurvivorStore *store);
+
+/**
+ * @brief Append a survivor
+ *
+ * The info and timestamps of the new survivor are zeroed. count is raised
+ * last, so a thread that reads count without the lock only sees indexes
+ * whose status is set.
+ *
+ * @param store Store to add to
+ * @param coord Location of the survivor
+ * @param status Initial status (0-3)
+ * @return Index of the new survivor, or -1 if the store already holds the
+ *         capacity given to survivor_store_init() (it never grows)
+ */
+int survivor_store_add(SurvivorStore *store, Coord coord, int status);
+
+/**
+ * @brief Change the status of a survivor and keep the bitsets in step
+ *
+ * @param store Store holding the survivor
+ * @param index Index of the survivor (0 .. count - 1)
+ * @param status New status (0-3)
+ * @return The status the survivor had before
+ */
+int survivor_store_set_status(SurvivorStore *store, int index, int status);
+
+/**
+ * @brief Change a survivor's status only if it still has the expected one
+ *
+ * The compare-and-swap on the status byte decides between threads racing
+ * for the same survivor: exactly one of them sees it succeed, and that
+ * one then updates the bitsets and counters. Needs no lock.
+ *
+ * @param store Store holding the survivor
+ * @param index Index of the survivor (0 .. count - 1)
+ * @param from Status the survivor must have (0-3)
+ * @param to New status (0-3)
+ * @return 1 if the status was changed, 0 if the survivor did not have @p from
+ */
+int survivor_store_claim(SurvivorStore *store, int index, int from, int to);
+
+/**
+ * @brief Move a survivor
+ *
+ * @param store Store holding the survivor
+ * @param index Index of the survivor (0 .. count - 1)
+ * @param coord New location
+ */
+void survivor_store_set_coord(SurvivorStore *store, int index, Coord coord);
+
+/**
+ * @brief Location of a survivor
+ *
+ * @param store Store holding the survivor
+ * @param index Index of the survivor (0 .. count - 1)
+ * @return Its coordinates
+ */
+Coord survivor_store_coord(const SurvivorStore *store, int index);
+
+/**
+ * @brief Find the next survivor with a given status
+ *
+ * Visit every survivor of one status with
+ * `for (int i = survivor_store_next(s, st, 0); i >= 0; i = survivor_store_next(s, st, i + 1))`.
+ * Changing the status of survivor i inside such a loop is allowed.
+ *
+ * @param store Store to search
+ * @param status Status to look for (0-3)
+ * @param from First index to consider
+ * @return Smallest index >= from with that status, or -1 if there is none
+ */
+int survivor_store_next(const SurvivorStore *store, int status, int from);
+
+/** @} */ // end of survivor_store group
+
+#endif // SURVIVOR_STORE_H
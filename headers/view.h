@@ -32,6 +32,7 @@
 #ifndef VIEW_H
 #define VIEW_H
 
+#include "world_snapshot.h"
 #include <SDL2/SDL.h>
 #include <stdbool.h>
 
@@ -106,9 +107,12 @@ extern const SDL_Color DARK_GRAY;
  * creates the window and renderer, and loads fonts for text display.
  * 
  * **Window Layout:**
- * - Left side: Map visualization (map_width * CELL_SIZE pixels)
+ * - Left side: Map viewport (map_width * CELL_SIZE pixels, at most
+ *   VIEW_MAX_WIDTH)
  * - Right side: Information panel (PANEL_WIDTH pixels)
- * - Height: map_height * CELL_SIZE pixels
+ * - Height: map_height * CELL_SIZE pixels, at most VIEW_MAX_HEIGHT
+ * 
+ * The view starts zoomed out to show the whole map.
  * 
  * **Initialization Steps:**
  * 1. Calculate window dimensions from map size
@@ -140,9 +144,10 @@ extern int init_sdl_window();
 /**
  * @brief Draw a colored cell at specified map coordinates
  * 
- * Fills a single grid cell with the specified color. Performs bounds
- * checking to prevent invalid memory access and maintains grid line
- * visibility by making cells slightly smaller than their allocated space.
+ * Fills a single grid cell with the specified color at the current zoom
+ * and pan. Performs bounds checking to prevent invalid memory access and
+ * maintains grid line visibility by making cells slightly smaller than
+ * their allocated space. Cells outside the viewport are not drawn.
  * 
  * **Coordinate System:**
  * - x: Map row (0 to map.height-1)
@@ -157,7 +162,7 @@ extern int init_sdl_window();
  * @pre Coordinates must be within map bounds
  * @post Cell is drawn with specified color
  * 
- * @note Cells are drawn 1 pixel smaller than CELL_SIZE to show grid lines
+ * @note Cells are drawn 1 pixel smaller than the zoom when grid lines are shown
  * @warning Invalid coordinates are silently ignored
  */
 extern void draw_cell(int x, int y, SDL_Color color);
@@ -173,48 +178,55 @@ extern void draw_cell(int x, int y, SDL_Color color);
 /**
  * @brief Draw all drones with status-based color coding
  * 
- * Iterates through the global drones list and renders each drone
- * with appropriate colors based on their current status. Also draws
- * mission paths for drones that are actively pursuing targets.
+ * Renders each connected drone of a world snapshot with appropriate
+ * colors based on its status. Also draws mission paths for drones that
+ * are actively pursuing targets.
  * 
  * **Color Scheme:**
  * - Blue: IDLE drones (available for missions)
  * - Green: ON_MISSION drones (actively rescuing)
  * - Green lines: Mission paths from drone to target
  * 
+ * Zoomed out below 4 pixels per cell, drones are drawn instead as a blue
+ * heatmap of the snapshot's per-tile drone counts, without mission paths.
+ * 
  * **Thread Safety:**
- * - Locks global drones list during iteration
- * - Locks individual drone mutexes for status reading
- * - Prevents race conditions with AI controller
+ * Reads only the snapshot and takes no lock, so drawing never delays
+ * the AI controller or drone handlers.
+ * 
+ * @param snapshot Snapshot to draw, from world_snapshot_acquire()
  * 
- * @pre Global drones list must be initialized
  * @pre SDL renderer must be ready
  * @post All active drones are visually represented
  * 
- * @note Disconnected drones are not drawn
- * @warning Concurrent access protected by mutex locking
+ * @note Disconnected drones are not in the snapshot
  */
-extern void draw_drones();
+extern void draw_drones(const WorldSnapshot *snapshot);
 
 /**
  * @brief Draw all active survivors on the map
  * 
- * Renders survivors from the global survivor array using red color.
- * Only draws survivors with status 0 (waiting) or 1 (being helped).
- * Rescued survivors (status 2+) are not displayed.
+ * Renders the survivors of a world snapshot using red color. The
+ * snapshot only holds survivors with status 0 (waiting) or 1 (being
+ * helped); rescued survivors (status 2+) are not displayed.
  * 
  * **Status Mapping:**
  * - Status 0: Waiting for rescue (red)
  * - Status 1: Being helped (red)
  * - Status 2+: Rescued (not drawn)
  * 
- * @pre Global survivor array must be initialized
+ * Zoomed out below 4 pixels per cell, survivors are drawn instead as a
+ * red heatmap of the snapshot's per-tile survivor counts, so the cost
+ * depends on the visible tiles, not on the number of survivors.
+ * 
+ * @param snapshot Snapshot to draw, from world_snapshot_acquire()
+ * 
  * @pre SDL renderer must be ready
  * @post All active survivors are visually represented
  * 
- * @note Thread-safe access to survivor array
+ * @note Takes no lock; survivors_mutex is only held by the snapshot capture
  */
-extern void draw_survivors();
+extern void draw_survivors(const WorldSnapshot *snapshot);
 
 /** @} */ // end of entity_rendering group
 
@@ -231,14 +243,22 @@ extern void draw_survivors();
  * Grid lines are drawn in white color to provide clear visual separation
  * between cells while maintaining readability.
  * 
+ * **Static Layer:**
+ * The black background, the info panel background and labels, and the
+ * legend are drawn once into a cached texture that covers the whole
+ * window; each call copies that texture. Call it first in a frame.
+ * Without render target support the same elements are drawn directly
+ * every call.
+ * 
  * **Grid Layout:**
- * - Horizontal lines: map.height + 1 lines
- * - Vertical lines: map.width + 1 lines
+ * - Only lines around visible cells, and only when cells are at least
+ *   8 pixels wide
  * - Line color: White for maximum contrast
  * 
  * @pre Global map structure must be initialized
  * @pre SDL renderer must be ready
- * @post Grid overlay is drawn on the map area
+ * @post Static panel is drawn over the whole window, grid lines over the
+ *       map viewport
  * 
  * @note Grid extends exactly to map boundaries
  */
@@ -260,7 +280,7 @@ extern void draw_grid();
  * of system state without requiring detailed panel examination.
  * 
  * **Title Format:**
- * "Drone Simulator | Waiting: X | Being Helped: Y | Rescued: Z | Drones: N"
+ * "Drone Simulator | Waiting: X | Being Helped: Y | Rescued: Z | Drones: N | Cells|Heatmap Z px/cell"
  * 
  * @pre Global statistics variables must be updated
  * @post Window title reflects current system state
@@ -276,6 +296,9 @@ extern void update_window_title();
  * showing real-time system metrics, drone status, and a visual legend.
  * The panel provides complete system oversight for operators.
  * 
+ * Only the values are drawn here, from cached digit textures; the rest of
+ * the panel is part of the static layer drawn by draw_grid().
+ * 
  * **Panel Sections:**
  * 1. Title header with system name
  * 2. Survivor statistics (waiting, helped, rescued)
@@ -287,13 +310,15 @@ extern void update_window_title();
  * - Text: White on dark gray backgrounds
  * - Icons: Colored squares matching entity colors
  * 
+ * @param snapshot Snapshot the total drone count is taken from
+ * 
  * @pre Global statistics must be current
  * @pre SDL renderer and fonts must be initialized
  * @post Complete information panel is rendered
  * 
  * @note Panel width is fixed at PANEL_WIDTH pixels
  */
-extern void draw_info_panel();
+extern void draw_info_panel(const WorldSnapshot *snapshot);
 
 /**
  * @brief Render text with SDL_ttf at specified position
@@ -302,6 +327,9 @@ extern void draw_info_panel();
  * surface creation, texture conversion, and cleanup. Supports both
  * regular and bold font styles with automatic fallback handling.
  * 
+ * Strings shorter than 32 characters are rasterized once and kept in a
+ * texture cache of 64 entries; later calls only copy the texture.
+ * 
  * **Font Handling:**
  * - Attempts to use loaded TTF fonts
  * - Falls back to simple rectangle if fonts unavailable
@@ -359,23 +387,25 @@ extern void render_text_line(const char *text, int y, SDL_Color color, int value
 /**
  * @brief Draw the complete scene including all elements
  * 
- * Main rendering function that composes the entire application view.
- * Clears the screen and draws all elements in the correct order to
- * create the complete visualization.
+ * Main rendering function that composes the entire application view
+ * from the latest world snapshot. Clears the screen and draws all
+ * elements in the correct order to create the complete visualization.
  * 
  * **Rendering Order:**
  * 1. Clear screen to black
- * 2. Draw survivors (red cells)
- * 3. Draw drones (blue/green cells and mission lines)
- * 4. Draw grid overlay (white lines)
- * 5. Update window title
- * 6. Draw information panel
- * 7. Present final frame
+ * 2. Clamp zoom and pan, find the visible cells
+ * 3. Copy the static layer (panel, legend), draw visible grid lines
+ * 4. Draw survivors (red cells, one batch; or a red heatmap)
+ * 5. Draw drones (blue/green cell batches and mission lines; or a blue
+ *    heatmap)
+ * 6. Update window title
+ * 7. Draw information panel values
+ * 8. Present final frame
  * 
  * @return 0 on success, 1 on failure
  * 
  * @pre All subsystems must be initialized
- * @pre Global data structures must be accessible
+ * @pre world_snapshots is being published (world_snapshot_publisher())
  * @post Complete frame is rendered and presented
  * 
  * @note This is the main entry point for frame rendering
@@ -449,6 +479,10 @@ extern void draw_diagnostic();
  * **Handled Events:**
  * - SDL_QUIT: Window close button clicked
  * - SDLK_ESCAPE: Escape key pressed
+ * - Mouse wheel: Zoom around the cursor
+ * - +/= and - (also keypad): Zoom around the viewport center
+ * - Arrow keys, left-button drag: Pan
+ * - 0, Home: Show the whole map
  * 
  * @return 1 if quit requested, 0 to continue execution
  * 
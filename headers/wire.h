@@ -0,0 +1,160 @@
+/**
+ * @file wire.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Compact binary encoding of the drone protocol
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * An optional fixed-layout alternative to JSON for the messages exchanged
+ * after the handshake. A JSON STATUS_UPDATE is about 120 bytes; the binary
+ * form is 14. The handshake itself is always JSON, so a client and server
+ * that do not both offer the binary encoding keep talking JSON.
+ *
+ * **Negotiation:**
+ * - The client lists the encodings it accepts in HANDSHAKE:
+ *   `"encodings": ["binary", "json"]`
+ * - The server picks one and reports it in HANDSHAKE_ACK together with the
+ *   binary protocol version: `"encoding": "binary", "protocol_version": 1`
+ * - Both sides switch their framer to FRAME_BINARY right after the ACK.
+ *   A client that sends no "encodings" (or an ACK without "encoding")
+ *   means JSON.
+ *
+ * **Message Layout (all integers big-endian):**
+ * ```
+ * header   0: version (u8)  1: type (u8)  2-3: payload length (u16)
+ * STATUS_UPDATE       x (i32) y (i32) status (u8) battery (u8)     10 bytes
+ * MISSION_COMPLETE    target x (i32) target y (i32) success (u8)    9 bytes
+ * HEARTBEAT_RESPONSE  (empty)                                       0 bytes
+ * ASSIGN_MISSION      mission id (u32) target x (i32) target y (i32)
+ *                     expiry (u32, Unix time)                      16 bytes
+ * HEARTBEAT           (empty)                                       0 bytes
+ * ```
+ * Receivers skip messages of unknown type using the length field, so new
+ * types can be added without bumping the version. A version mismatch is a
+ * protocol error.
+ *
+ * **Thread Safety:**
+ * All functions are stateless and reentrant.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include "coord.h"
+#include "framer.h"
+#include "message_parser.h"
+#include <stddef.h>
+
+/**
+ * @defgroup wire Binary Wire Encoding
+ * @brief Fixed-layout binary messages negotiated at HANDSHAKE
+ * @ingroup networking
+ * @{
+ */
+
+/** @brief Binary protocol version carried in every header */
+#define WIRE_PROTOCOL_VERSION 1
+
+/** @brief Size of the binary message header */
+#define WIRE_HEADER_SIZE FRAME_BINARY_HEADER_SIZE
+
+/** @brief Buffer size sufficient for any message produced by the encoders */
+#define WIRE_MAX_MESSAGE_SIZE 32
+
+/** @brief Name of the JSON encoding in HANDSHAKE / HANDSHAKE_ACK */
+#define WIRE_ENCODING_NAME_JSON "json"
+
+/** @brief Name of the binary encoding in HANDSHAKE / HANDSHAKE_ACK */
+#define WIRE_ENCODING_NAME_BINARY "binary"
+
+/**
+ * @enum WireEncoding
+ * @brief Message encodings; also used as bits in an "accepted" mask
+ */
+typedef enum {
+    WIRE_ENCODING_JSON = 0x01,  /**< Text JSON, one object per message */
+    WIRE_ENCODING_BINARY = 0x02 /**< Fixed-layout binary messages */
+} WireEncoding;
+
+/**
+ * @enum WireMessageType
+ * @brief Type byte of a binary message header
+ *
+ * Drone → server types have the high bit clear, server → drone types set.
+ */
+typedef enum {
+    WIRE_STATUS_UPDATE = 0x01,      /**< Position, status and battery */
+    WIRE_MISSION_COMPLETE = 0x02,   /**< Mission target reached */
+    WIRE_HEARTBEAT_RESPONSE = 0x03, /**< Keep-alive acknowledgment */
+    WIRE_ASSIGN_MISSION = 0x81,     /**< Mission assignment */
+    WIRE_HEARTBEAT = 0x82           /**< Liveness check */
+} WireMessageType;
+
+/**
+ * @struct wire_assignment
+ * @brief Decoded form of an ASSIGN_MISSION message
+ */
+typedef struct wire_assignment {
+    unsigned int mission_id; /**< Mission number (the JSON form is "M<id>") */
+    Coord target;            /**< Survivor location */
+    long expiry;             /**< Expiry time (seconds since epoch) */
+} WireAssignment;
+
+/**
+ * @brief Encode a drone → server message
+ *
+ * @param buffer Destination, at least WIRE_MAX_MESSAGE_SIZE bytes
+ * @param message Message to encode; only the fields of its type are used
+ * @return Encoded length in bytes, or 0 if the type has no binary form
+ *         (HANDSHAKE is always sent as JSON)
+ */
+size_t wire_encode_drone_message(char *buffer, const DroneMessage *message);
+
+/**
+ * @brief Decode a drone → server message into the same structure the
+ *        JSON parser fills
+ *
+ * @param data Complete frame including the header
+ * @param length Frame length in bytes
+ * @param message Receives the decoded fields; type is DRONE_MSG_UNKNOWN
+ *                for types this version does not know
+ * @return 0 on success, -1 on a version mismatch or truncated payload
+ */
+int wire_decode_drone_message(const char *data, size_t length, DroneMessage *message);
+
+/**
+ * @brief Encode an ASSIGN_MISSION message
+ *
+ * @param buffer Destination, at least WIRE_MAX_MESSAGE_SIZE bytes
+ * @param assignment Mission to encode
+ * @return Encoded length in bytes
+ */
+size_t wire_encode_assignment(char *buffer, const WireAssignment *assignment);
+
+/**
+ * @brief Decode an ASSIGN_MISSION message
+ *
+ * @param data Complete frame including the header
+ * @param length Frame length in bytes
+ * @param assignment Receives the mission
+ * @return 0 on success, -1 if the frame is not a valid ASSIGN_MISSION
+ */
+int wire_decode_assignment(const char *data, size_t length, WireAssignment *assignment);
+
+/**
+ * @brief Validate a frame header and return its message type
+ *
+ * @param data Complete frame including the header
+ * @param length Frame length in bytes
+ * @return The header's type byte, or -1 on a version mismatch or a length
+ *         that disagrees with the header
+ */
+int wire_frame_type(const char *data, size_t length);
+
+/** @} */ // end of wire group
+
+#endif // WIRE_H
@@ -0,0 +1,234 @@
+/**
+ * @file world_snapshot.h
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Triple-buffered copies of the world for lock-free rendering
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * The renderer draws from a WorldSnapshot instead of the live drone list
+ * and survivor store, so drawing a frame never holds drones->lock, a
+ * drone's lock or survivors_mutex.
+ *
+ * **Triple Buffer:**
+ * A WorldSnapshotBuffer holds three snapshots. The publisher owns one
+ * (back), the renderer owns one (front) and the third is shared (middle).
+ * Publishing swaps back and middle with one atomic exchange; acquiring
+ * swaps middle and front with another when middle holds a newer
+ * snapshot. Neither side ever waits for the other, and the renderer
+ * always gets the most recent complete snapshot.
+ *
+ * **Capture:**
+ * world_snapshot_capture() copies what the renderer needs: position,
+ * target and status of each connected drone, and the position of each
+ * waiting or helped survivor. The locks are held only for those copies.
+ *
+ * **Tile Aggregates:**
+ * After the locks are released, the capture also counts survivors and
+ * drones per tile, in a pyramid of levels: level 0 tiles are
+ * WORLD_TILE_SPAN cells wide and each level above merges 2x2 tiles of
+ * the one below, up to one tile for the whole map. A zoomed-out view
+ * draws the level whose tiles are a few pixels wide, so its cost depends
+ * on the window size, not on the number of survivors.
+ *
+ * **Thread Safety:**
+ * One publisher thread and one renderer thread per buffer. Each side only
+ * touches the snapshot it owns; ownership moves through the atomic
+ * middle index.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup visualization
+ */
+
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include "coord.h"
+#include <stdatomic.h>
+
+/**
+ * @defgroup world_snapshot World Snapshot
+ * @brief Triple-buffered world copies published for the renderer
+ * @ingroup visualization
+ * @{
+ */
+
+/** @brief Milliseconds between snapshots taken by world_snapshot_publisher() */
+#define WORLD_SNAPSHOT_INTERVAL_MS 50
+
+/** @brief Number of snapshots in a buffer */
+#define WORLD_SNAPSHOT_SLOTS 3
+
+/** @brief Map cells per side of a level 0 tile */
+#define WORLD_TILE_SPAN 4
+
+/** @brief Most tile levels kept (enough for maps up to WORLD_TILE_SPAN << 15 cells wide) */
+#define WORLD_TILE_LEVELS 16
+
+/**
+ * @struct snapshot_drone
+ * @brief The fields of one drone the renderer draws
+ */
+typedef struct snapshot_drone {
+    Coord coord;    /**< Current position */
+    Coord target;   /**< Mission target (meaningful when on_mission) */
+    int on_mission; /**< Non-zero if the drone is ON_MISSION, zero if IDLE */
+} SnapshotDrone;
+
+/**
+ * @struct tile_level
+ * @brief Survivor and drone counts per tile at one level of detail
+ */
+typedef struct tile_level {
+    int span;                /**< Map cells per side of a tile */
+    int rows;                /**< Tiles down the map */
+    int cols;                /**< Tiles across the map */
+    unsigned int *survivors; /**< Waiting and helped survivors per tile, row-major */
+    unsigned int *drones;    /**< Connected drones per tile, row-major */
+} TileLevel;
+
+/**
+ * @struct world_snapshot
+ * @brief Copy of the drawable world at one moment
+ *
+ * The arrays grow by doubling as needed and are reused by later
+ * snapshots.
+ */
+typedef struct world_snapshot {
+    unsigned long sequence; /**< Number of the publication, starting at 1 (0: nothing published yet) */
+    int total_drones;       /**< Drones in the list, including disconnected ones */
+    SnapshotDrone *drones;  /**< Connected drones */
+    int drone_count;        /**< Entries used in drones */
+    int drone_capacity;     /**< Entries allocated in drones */
+    Coord *survivors;       /**< Waiting and helped survivors */
+    int survivor_count;     /**< Entries used in survivors */
+    int survivor_capacity;  /**< Entries allocated in survivors */
+    TileLevel tiles[WORLD_TILE_LEVELS]; /**< Tile counts, level 0 (finest) first */
+    int tile_level_count;   /**< Levels in tiles; the last is a single tile */
+} WorldSnapshot;
+
+/** @brief Flag in WorldSnapshotBuffer.middle marking an unread snapshot */
+#define WORLD_SNAPSHOT_FRESH 4u
+
+/**
+ * @struct world_snapshot_buffer
+ * @brief Three snapshots handed between one publisher and one renderer
+ */
+typedef struct world_snapshot_buffer {
+    WorldSnapshot slots[WORLD_SNAPSHOT_SLOTS]; /**< The snapshots */
+    atomic_uint middle;                        /**< Shared slot, plus WORLD_SNAPSHOT_FRESH while unread */
+    unsigned int back;                         /**< Slot owned by the publisher */
+    unsigned int front;                        /**< Slot owned by the renderer */
+    unsigned long published;                   /**< Publications so far (publisher side) */
+} WorldSnapshotBuffer;
+
+/**
+ * @brief Global snapshot buffer drawn by the view
+ *
+ * Filled by world_snapshot_publisher() and read by the main thread.
+ */
+extern WorldSnapshotBuffer world_snapshots;
+
+/**
+ * @brief Initialize an empty buffer
+ *
+ * Until the first publication world_snapshot_acquire() returns an empty
+ * snapshot with sequence 0.
+ *
+ * @param buffer Buffer to initialize
+ */
+void world_snapshot_init(WorldSnapshotBuffer *buffer);
+
+/**
+ * @brief Free the arrays of every snapshot in a buffer
+ *
+ * @param buffer Buffer to free; neither side may use it any more
+ */
+void world_snapshot_destroy(WorldSnapshotBuffer *buffer);
+
+/**
+ * @brief Snapshot the publisher fills next
+ *
+ * @param buffer Buffer to publish into (publisher thread only)
+ * @return The back snapshot; its previous contents are stale
+ */
+WorldSnapshot *world_snapshot_back(WorldSnapshotBuffer *buffer);
+
+/**
+ * @brief Make the back snapshot the latest one
+ *
+ * Sets its sequence number and hands it to the renderer side. The
+ * publisher gets a new back snapshot, which may be the previous middle if
+ * the renderer did not acquire it.
+ *
+ * @param buffer Buffer to publish into (publisher thread only)
+ */
+void world_snapshot_publish(WorldSnapshotBuffer *buffer);
+
+/**
+ * @brief Latest published snapshot
+ *
+ * Takes the middle snapshot if one was published since the last call,
+ * otherwise returns the same snapshot as last time. The snapshot stays
+ * valid and unchanged until the next call.
+ *
+ * @param buffer Buffer to read (renderer thread only)
+ * @return The front snapshot
+ */
+const WorldSnapshot *world_snapshot_acquire(WorldSnapshotBuffer *buffer);
+
+/**
+ * @brief Grow the arrays of a snapshot
+ *
+ * @param snapshot Snapshot to grow
+ * @param drones Drone entries needed
+ * @param survivors Survivor entries needed
+ * @return 0 on success, -1 on allocation failure (arrays left as they were)
+ */
+int world_snapshot_reserve(WorldSnapshot *snapshot, int drones, int survivors);
+
+/**
+ * @brief Count the survivors and drones of a snapshot per tile
+ *
+ * Fills every level of snapshot->tiles from the drones and survivors
+ * arrays, allocating the levels on first use. Entities outside the map
+ * are not counted.
+ *
+ * @param snapshot Snapshot whose arrays are filled
+ * @param height Rows of the map
+ * @param width Columns of the map
+ * @return 0 on success, -1 on allocation failure (tile_level_count is 0)
+ */
+int world_snapshot_build_tiles(WorldSnapshot *snapshot, int height, int width);
+
+/**
+ * @brief Copy the drawable world into a snapshot
+ *
+ * Locks drones->lock and each drone's lock to copy the connected drones,
+ * then survivors_mutex to copy waiting and helped survivors. Nothing else
+ * is done while a lock is held, apart from growing the arrays when the
+ * world outgrew them. The tile counts are built after the locks are
+ * released.
+ *
+ * @param snapshot Snapshot to overwrite
+ * @return 0 on success, -1 if the arrays could not grow (the snapshot
+ *         then holds as many entries as fit)
+ */
+int world_snapshot_capture(WorldSnapshot *snapshot);
+
+/**
+ * @brief Thread function publishing world_snapshots
+ *
+ * Captures and publishes a snapshot every WORLD_SNAPSHOT_INTERVAL_MS
+ * until the global running flag is cleared.
+ *
+ * @param arg Unused thread parameter (required for pthread compatibility)
+ * @return NULL
+ */
+// clang-format off
+void *world_snapshot_publisher(void *arg);
+// clang-format on
+
+/** @} */ // end of world_snapshot group
+
+#endif // WORLD_SNAPSHOT_H
@@ -0,0 +1,109 @@
+/**
+ * @file latency_histogram.c
+ * @brief Lock-free log-linear histogram of latencies
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the histogram declared in latency_histogram.h. A
+ * value below 2 * LATENCY_SUB_BUCKETS is its own bucket index; above
+ * that, the value is shifted right until LATENCY_SUB_BUCKET_BITS + 1
+ * significant bits remain and the shift selects the bucket group.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup monitoring
+ */
+
+#include "headers/latency_histogram.h"
+
+/**
+ * @brief Bucket counting @p value
+ */
+static int bucket_index(uint64_t value)
+{
+    if (value < 2 * LATENCY_SUB_BUCKETS)
+        return (int)value;
+
+    int shift = (63 - __builtin_clzll(value)) - LATENCY_SUB_BUCKET_BITS;
+    int index = shift * LATENCY_SUB_BUCKETS + (int)(value >> shift);
+    return index < LATENCY_BUCKETS ? index : LATENCY_BUCKETS - 1;
+}
+
+/**
+ * @brief Middle of the values counted in bucket @p index, in nanoseconds
+ */
+static double bucket_value(int index)
+{
+    if (index < 2 * LATENCY_SUB_BUCKETS)
+        return index;
+
+    int shift = index / LATENCY_SUB_BUCKETS - 1;
+    uint64_t lowest = (uint64_t)(index - shift * LATENCY_SUB_BUCKETS) << shift;
+    return lowest + ((UINT64_C(1) << shift) - 1) / 2.0;
+}
+
+void latency_histogram_reset(LatencyHistogram *histogram)
+{
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        atomic_store_explicit(&histogram->counts[i], 0, memory_order_relaxed);
+    }
+}
+
+void latency_histogram_record(LatencyHistogram *histogram, uint64_t latency_ns)
+{
+    atomic_fetch_add_explicit(&histogram->counts[bucket_index(latency_ns)], 1, memory_order_relaxed);
+}
+
+unsigned long latency_histogram_percentiles(const LatencyHistogram *histogram,
+                                            const double *percentiles,
+                                            int count,
+                                            double *values_ms)
+{
+    // Every percentile comes from the same counts, so p50 <= p99 always holds
+    unsigned long snapshot[LATENCY_BUCKETS];
+    unsigned long total = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        snapshot[i] = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+        total += snapshot[i];
+    }
+
+    for (int p = 0; p < count; p++)
+    {
+        values_ms[p] = 0.0;
+        if (total == 0)
+            continue;
+
+        // Smallest sample with at least this share of samples at or below it
+        double exact_rank = percentiles[p] / 100.0 * total;
+        unsigned long rank = (unsigned long)exact_rank;
+        if (rank < exact_rank || rank < 1)
+            rank++;
+
+        unsigned long seen = 0;
+        for (int i = 0; i < LATENCY_BUCKETS; i++)
+        {
+            seen += snapshot[i];
+            if (seen >= rank)
+            {
+                values_ms[p] = bucket_value(i) / 1e6;
+                break;
+            }
+        }
+    }
+    return total;
+}
+
+double latency_histogram_sum_ms(const LatencyHistogram *histogram)
+{
+    double sum_ns = 0.0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        unsigned long count = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+        if (count)
+            sum_ns += count * bucket_value(i);
+    }
+    return sum_ns / 1e6;
+}
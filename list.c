@@ -14,13 +14,19 @@
  * - Contiguous memory allocation for cache efficiency
  * - Thread-safe operations with mutex and semaphore protection
  * - Semaphore-based overflow/underflow prevention
- * - Free list management for efficient node reuse
+ * - Intrusive free stack for O(1) node allocation and release
+ * - Optional key with an open-addressing hash index (list_set_key()) for
+ *   O(1) removedata()/removekey()
  * - Function pointer interface for object-oriented usage
  * - Support for arbitrary data types through flexible array members
  * 
  * **Memory Management:**
  * - Pre-allocated contiguous memory block for all nodes
- * - Free list for efficient node recycling
+ * - Every free node is on the free stack (linked through node->next), so
+ *   allocation pops it and never scans the arena
+ * - LIST_BACKEND_GROWABLE adds further blocks of the initial capacity
+ *   when the stack runs dry; nodes never move, so Node and data pointers
+ *   stay valid until the node is removed
  * - Zero-copy operations where possible
  * - Predictable memory usage with fixed capacity
  * 
@@ -36,6 +42,13 @@
  * - Cache-friendly memory layout for iteration
  * - Minimal dynamic allocation during runtime
  * 
+ * **MPMC Queue Backend:**
+ * create_list() with LIST_BACKEND_MPMC_QUEUE builds a bounded lock-free
+ * queue instead (Dmitry Vyukov's MPMC ring). Each cell carries a sequence
+ * number on its own cache line; producers and consumers claim positions
+ * with one compare-and-swap on separate cache lines and publish through
+ * the cell's sequence, so add and pop touch no mutex or semaphore.
+ * 
  * @copyright Copyright (c) 2024
  * 
  * @ingroup core_modules
@@ -43,38 +56,99 @@
  */
 
 #include "headers/list.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <semaphore.h>
 
-// Forward declarations for internal functions
+/** @brief Cache line size assumed for padding the MPMC queue */
+#define CACHE_LINE_SIZE 64
+
 /**
- * @brief Finds an unoccupied memory cell in the list's memory area
- * @param list The list to search in
- * @return Pointer to an unoccupied node or NULL if none available
+ * @struct mpmc_queue
+ * @brief Ring state of a LIST_BACKEND_MPMC_QUEUE list
+ * 
+ * Cell i of the ring starts at cells + i * stride with its sequence
+ * number, followed by a Node holding the data. stride is a multiple of
+ * the cache line size, so no two sequence numbers share a line.
  */
-// clang-format off
-static Node *find_memcell_fornode(List *list);
+struct mpmc_queue {
+    atomic_size_t enqueue_pos; /**< Next position producers claim */
+    char pad0[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+    atomic_size_t dequeue_pos; /**< Next position consumers claim */
+    char pad1[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+    size_t mask;        /**< Ring size - 1 (ring size is a power of two) */
+    size_t stride;      /**< Bytes per cell */
+    size_t node_offset; /**< Offset of the Node within a cell */
+    // clang-format off
+    char *cells;        /**< Cache-line aligned cell array */
+    // clang-format on
+};
 
+// Forward declarations for internal functions
 /**
- * @brief Gets a node from the free list or finds one in memory
+ * @brief Pops a node from the free stack, growing the arena if allowed
  * @param list The list to get a node from
  * @return Pointer to a free node or NULL if none available
  */
+// clang-format off
 static Node *get_free_node(List *list);
 
+/**
+ * @brief Pushes a removed node onto the free stack
+ * @param list The list the node belongs to
+ * @param node The node to release
+ */
+static void release_node(List *list, Node *node);
+
+/**
+ * @brief Posts spaces_sem after a node is freed (fixed-capacity lists only)
+ * @param list The list that gained a free node
+ */
+static void signal_space(List *list);
+
+/**
+ * @brief Allocates a block of nodes and pushes them all on the free stack
+ * @param list The list to add nodes to
+ * @param nodes Number of nodes in the block
+ * @return Address of the first node or NULL on allocation failure
+ */
+static char *add_block(List *list, int nodes);
+
+/**
+ * @brief Create a list backed by a lock-free MPMC ring queue
+ * @param datasize Size of data in each node
+ * @param capacity Minimum number of elements; rounded up to a power of two
+ * @return Pointer to the new list or NULL on failure
+ */
+static List *create_queue_list(size_t datasize, int capacity);
+
 /**
  * @brief Create a list object, allocates new memory for list, and
  * sets its data members
  *
  * @param datasize Size of data in each node
  * @param capacity Maximum number of nodes can be stored in this list
+ * @param backend Storage and synchronization scheme
  * @return Pointer to the new list or NULL on failure
  */
-List *create_list(size_t datasize, int capacity)
+List *create_list(size_t datasize, int capacity, ListBackend backend)
 // clang-format on
 {
+    if (backend == LIST_BACKEND_MPMC_QUEUE)
+    {
+        return create_queue_list(datasize, capacity);
+    }
+
+    if (capacity <= 0)
+    {
+        fprintf(stderr, "Invalid list capacity: %d\n", capacity);
+        return NULL;
+    }
+
     // clang-format off
     List *list = malloc(sizeof(List));
     // clang-format on
@@ -86,51 +160,37 @@ List *create_list(size_t datasize, int capacity)
 
     memset(list, 0, sizeof(List));
 
-    // Initialize mutex
-    pthread_mutex_init(&list->lock, NULL);
-
-    // Initialize semaphores for overflow/underflow protection
-    sem_init(&list->elements_sem, 0, 0);      // Initially empty
-    sem_init(&list->spaces_sem, 0, capacity); // Initially all spaces available
-
     list->datasize = datasize;
-    list->nodesize = sizeof(Node) + datasize;
+    // Nodes sit back to back in a block, so each is rounded up to keep the next one's data aligned
+    list->nodesize = (sizeof(Node) + datasize + _Alignof(Node) - 1) / _Alignof(Node) * _Alignof(Node);
+    list->number_of_elements = 0;
+    list->capacity = 0;
+    list->free_list = NULL;
 
-    list->startaddress = malloc(list->nodesize * capacity);
+    list->startaddress = add_block(list, capacity);
     if (!list->startaddress)
     {
         perror("Failed to allocate memory for list nodes");
         free(list);
         return NULL;
     }
-
     list->endaddress = list->startaddress + (list->nodesize * capacity);
-    memset(list->startaddress, 0, list->nodesize * capacity);
-
     list->lastprocessed = (Node *)list->startaddress;
-    list->free_list = NULL; // Initialize the free list to NULL
 
-    list->number_of_elements = 0;
-    list->capacity = capacity;
+    // Initialize mutex
+    pthread_mutex_init(&list->lock, NULL);
 
-    // Initialize all nodes as free and add them to the free list
-    for (int i = 0; i < capacity; i++)
-    {
-        // clang-format off
-        Node *node = (Node *)(list->startaddress + (i * list->nodesize));
-        // clang-format on
-        node->occupied = 0;
-        node->next = list->free_list;
-        node->prev = NULL;
-        if (list->free_list)
-            list->free_list->prev = node;
-        list->free_list = node;
-    }
+    // Initialize semaphores for overflow/underflow protection; a growable
+    // list has no fixed number of spaces and does not use spaces_sem
+    sem_init(&list->elements_sem, 0, 0); // Initially empty
+    sem_init(&list->spaces_sem, 0, backend == LIST_BACKEND_GROWABLE ? 0 : capacity);
 
     /*ops*/
+    list->backend = backend;
     list->self = list;
     list->add = add;
     list->removedata = removedata;
+    list->removekey = removekey;
     list->removenode = removenode;
     list->pop = pop;
     list->peek = peek;
@@ -141,65 +201,91 @@ List *create_list(size_t datasize, int capacity)
 }
 
 /**
- * @brief Finds a memory cell in the mem area of list
+ * @brief Allocates a block of nodes and pushes them on the free stack
  * 
- * Searches through the list's memory area for an unoccupied node
+ * Blocks after the first one are chained through a pointer stored in
+ * front of their nodes (list->extra_blocks) so destroy() can free them
  * 
- * @param list The list to search in
- * @return Pointer to an unoccupied node or NULL if none available
+ * @param list The list to add nodes to
+ * @param nodes Number of nodes in the block
+ * @return Address of the first node or NULL on allocation failure
  */
 // clang-format off
-static Node *find_memcell_fornode(List *list)
+static char *add_block(List *list, int nodes)
 // clang-format on
 {
+    // The first block is the list's own arena; later ones carry a link
+    size_t header = list->startaddress ? sizeof(max_align_t) : 0;
     // clang-format off
-    Node *node = NULL;
-    /*search lastprocessed---end*/
-    Node *temp = list->lastprocessed;
-    while ((char *)temp < list->endaddress)
+    char *block = malloc(header + (size_t)list->nodesize * nodes);
     // clang-format on
+    if (!block)
     {
-        if (temp->occupied == 0)
-        {
-            node = temp;
-            break;
-        }
-        else
-        {
-            // clang-format off
-            temp = (Node *)((char *)temp + list->nodesize);
-            // clang-format on
-        }
+        return NULL;
     }
-    if (node == NULL)
+
+    if (header)
+    {
+        *(char **)block = list->extra_blocks;
+        list->extra_blocks = block;
+    }
+
+    // clang-format off
+    char *first = block + header;
+    // clang-format on
+    memset(first, 0, (size_t)list->nodesize * nodes);
+
+    // Push in reverse so the lowest address is allocated first
+    for (int i = nodes - 1; i >= 0; i--)
     {
-        /*search startaddress--lastprocessed*/
         // clang-format off
-        temp = (Node *)list->startaddress;
+        Node *node = (Node *)(first + ((size_t)i * list->nodesize));
         // clang-format on
-        while (temp < list->lastprocessed)
-        {
-            if (temp->occupied == 0)
-            {
-                node = temp;
-                break;
-            }
-            else
-            {
-                // clang-format off
-                temp = (Node *)((char *)temp + list->nodesize);
-                // clang-format on
-            }
-        }
+        release_node(list, node);
+    }
+    list->capacity += nodes;
+    return first;
+}
+
+/**
+ * @brief Pushes a removed node onto the free stack
+ * 
+ * @param list The list the node belongs to
+ * @param node The node to release
+ */
+// clang-format off
+static void release_node(List *list, Node *node)
+// clang-format on
+{
+    node->occupied = 0;
+    node->prev = NULL;
+    node->next = list->free_list;
+    list->free_list = node;
+}
+
+/**
+ * @brief Posts spaces_sem after a node is freed
+ * 
+ * A growable list never waits on spaces_sem, so posting it would only
+ * let the count grow without bound
+ * 
+ * @param list The list that gained a free node
+ */
+// clang-format off
+static void signal_space(List *list)
+// clang-format on
+{
+    if (list->backend != LIST_BACKEND_GROWABLE)
+    {
+        sem_post(&list->spaces_sem);
     }
-    return node;
 }
 
 /**
- * @brief Gets a node from the free list or finds one in memory
+ * @brief Pops a node from the free stack
  * 
- * First tries to retrieve a node from the free list, and if that fails,
- * searches for an unoccupied memory cell in the list's memory area
+ * Every free node is on the stack, so this is O(1). When the stack is
+ * empty a growable list adds a block as large as its initial capacity
  * 
  * @param list The list to get a node from
  * @return Pointer to a free node or NULL if none available
@@ -208,22 +294,207 @@ static Node *find_memcell_fornode(List *list)
 static Node *get_free_node(List *list)
 // clang-format on
 {
-    // First try to get a node from the free list
-    if (list->free_list)
+    if (!list->free_list && list->backend == LIST_BACKEND_GROWABLE)
+    {
+        int block_nodes = (int)((list->endaddress - list->startaddress) / list->nodesize);
+        if (!add_block(list, block_nodes))
+        {
+            perror("Failed to grow list");
+        }
+    }
+
+    // clang-format off
+    Node *node = list->free_list;
+    // clang-format on
+    if (node)
     {
-        // clang-format off
-        Node *node = list->free_list;
-        // clang-format on
         list->free_list = node->next;
-        if (list->free_list)
-            list->free_list->prev = NULL;
         node->next = NULL;
-        node->prev = NULL;
-        return node;
     }
+    return node;
+}
+
+/**
+ * @brief FNV-1a hash of a key
+ */
+static size_t hash_key(const void *key, size_t keysize)
+{
+    // clang-format off
+    const unsigned char *bytes = key;
+    // clang-format on
+    size_t hash = 2166136261u;
+    for (size_t i = 0; i < keysize; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Home slot of a node in the hash index
+ */
+// clang-format off
+static size_t index_home(const List *list, const Node *node)
+// clang-format on
+{
+    return hash_key(list->key_of(node->data), list->keysize) & (list->index_size - 1);
+}
+
+/**
+ * @brief Replaces the hash index with an empty one of size slots and
+ * re-inserts every node of the list
+ * 
+ * @return 0 on success, -1 on allocation failure (old index kept)
+ */
+static int index_rebuild(List *list, int size)
+{
+    // clang-format off
+    Node **slots = calloc(size, sizeof(Node *));
+    // clang-format on
+    if (!slots)
+    {
+        return -1;
+    }
+
+    free(list->index_slots);
+    list->index_slots = slots;
+    list->index_size = size;
 
-    // If free list is empty, use the original approach
-    return find_memcell_fornode(list);
+    // clang-format off
+    for (Node *node = list->head; node != NULL; node = node->next)
+    // clang-format on
+    {
+        size_t slot = index_home(list, node);
+        while (slots[slot])
+        {
+            slot = (slot + 1) & (size - 1);
+        }
+        slots[slot] = node;
+    }
+    return 0;
+}
+
+/**
+ * @brief Adds a node to the hash index (no-op for a list without key)
+ * 
+ * Called with list->lock held, after the node's data is written and
+ * before it is linked, so number_of_elements does not count it yet.
+ * The table doubles once it would become more than half full.
+ */
+// clang-format off
+static void index_insert(List *list, Node *node)
+// clang-format on
+{
+    if (!list->index_slots)
+        return;
+
+    if ((list->number_of_elements + 1) * 2 > list->index_size &&
+        index_rebuild(list, list->index_size * 2) != 0)
+    {
+        perror("Failed to grow list index");
+    }
+
+    size_t slot = index_home(list, node);
+    while (list->index_slots[slot])
+    {
+        slot = (slot + 1) & (list->index_size - 1);
+    }
+    list->index_slots[slot] = node;
+}
+
+/**
+ * @brief Removes a node from the hash index (no-op for a list without key)
+ * 
+ * Uses backward-shift deletion, so lookups never meet tombstones
+ */
+// clang-format off
+static void index_remove(List *list, Node *node)
+// clang-format on
+{
+    if (!list->index_slots)
+        return;
+
+    size_t mask = list->index_size - 1;
+    size_t slot = index_home(list, node);
+    while (list->index_slots[slot] != node)
+    {
+        if (!list->index_slots[slot])
+            return; // Not indexed
+        slot = (slot + 1) & mask;
+    }
+
+    // Pull later entries of the probe run back into the hole
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; list->index_slots[next]; next = (next + 1) & mask)
+    {
+        size_t home = index_home(list, list->index_slots[next]);
+        // Move it unless its home lies cyclically in (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            list->index_slots[hole] = list->index_slots[next];
+            hole = next;
+        }
+    }
+    list->index_slots[hole] = NULL;
+}
+
+/**
+ * @brief Finds a node by key through the hash index
+ * 
+ * @return The node, or NULL if no node has this key
+ */
+// clang-format off
+static Node *index_find(List *list, const void *key)
+// clang-format on
+{
+    size_t mask = list->index_size - 1;
+    for (size_t slot = hash_key(key, list->keysize) & mask; list->index_slots[slot]; slot = (slot + 1) & mask)
+    {
+        // clang-format off
+        Node *node = list->index_slots[slot];
+        // clang-format on
+        if (memcmp(list->key_of(node->data), key, list->keysize) == 0)
+            return node;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Keys a list and builds its hash index
+ * 
+ * Indexes the elements already in the list; add, pop and the remove
+ * operations keep the index current from then on
+ * 
+ * @param list A LIST_BACKEND_LINKED or LIST_BACKEND_GROWABLE list
+ * @param keysize Size of the key in bytes
+ * @param key_of Returns the address of the key inside an element
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ */
+int list_set_key(List *list, size_t keysize, const void *(*key_of)(const void *data))
+{
+    if (list->backend == LIST_BACKEND_MPMC_QUEUE || keysize == 0 || !key_of)
+    {
+        fprintf(stderr, "Error: Invalid list key\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&list->lock);
+    list->keysize = keysize;
+    list->key_of = key_of;
+
+    // At most half full at the current capacity
+    int size = 8;
+    while (size < list->capacity * 2)
+    {
+        size <<= 1;
+    }
+    int result = index_rebuild(list, size);
+    if (result != 0)
+    {
+        perror("Failed to allocate list index");
+    }
+    pthread_mutex_unlock(&list->lock);
+    return result;
 }
 
 /**
@@ -244,8 +515,8 @@ Node *add(List *list, void *data)
     Node *node = NULL;
     // clang-format on
 
-    // Wait for an available space (semaphore)
-    if (sem_wait(&list->spaces_sem) != 0)
+    // Wait for an available space (semaphore); a growable list makes room instead
+    if (list->backend != LIST_BACKEND_GROWABLE && sem_wait(&list->spaces_sem) != 0)
     {
         perror("sem_wait failed in add");
         return NULL;
@@ -255,15 +526,15 @@ Node *add(List *list, void *data)
     pthread_mutex_lock(&list->lock);
 
     /*Check capacity (redundant with semaphore but kept for safety)*/
-    if (list->number_of_elements >= list->capacity)
+    if (list->backend != LIST_BACKEND_GROWABLE && list->number_of_elements >= list->capacity)
     {
         pthread_mutex_unlock(&list->lock);
-        sem_post(&list->spaces_sem); // Release the space we waited for
+        signal_space(list); // Release the space we waited for
         perror("list is full!");
         return NULL;
     }
 
-    /*Get a free node from the free list or memory*/
+    /*Pop a free node, growing the arena if the list allows it*/
     node = get_free_node(list);
 
     if (node != NULL)
@@ -271,6 +542,7 @@ Node *add(List *list, void *data)
         /*create_node*/
         node->occupied = 1;
         memcpy(node->data, data, list->datasize);
+        index_insert(list, node);
 
         /*change new node into head*/
         if (list->head != NULL)
@@ -297,7 +569,7 @@ Node *add(List *list, void *data)
     else
     {
         pthread_mutex_unlock(&list->lock);
-        sem_post(&list->spaces_sem); // Release the space we waited for
+        signal_space(list); // Release the space we waited for
         perror("Failed to find free node!");
         return NULL;
     }
@@ -306,11 +578,59 @@ Node *add(List *list, void *data)
     return node;
 }
 
+/**
+ * @brief Unlinks a node found by removedata() or removekey()
+ * 
+ * Caller holds list->lock
+ * 
+ * @param list The list to remove from
+ * @param temp The node to remove
+ */
+// clang-format off
+static void remove_found_node(List *list, Node *temp)
+// clang-format on
+{
+    // clang-format off
+    Node *prevnode = temp->prev;
+    Node *nextnode = temp->next;
+    // clang-format on
+    if (prevnode != NULL)
+    {
+        prevnode->next = nextnode;
+    }
+    if (nextnode != NULL)
+    {
+        nextnode->prev = prevnode;
+    }
+
+    if (temp == list->head)
+    {
+        list->head = nextnode;
+    }
+
+    if (temp == list->tail)
+    {
+        list->tail = prevnode;
+    }
+
+    index_remove(list, temp);
+
+    // Push the node on the free stack
+    release_node(list, temp);
+    list->number_of_elements--;
+    list->lastprocessed = temp;
+
+    // Signal that we have a space
+    signal_space(list);
+}
+
 /**
  * @brief Finds the node with the value same as the mem pointed by
  * data and removes that node
  * 
- * Thread-safe implementation that safely removes a node matching the provided data
+ * Thread-safe implementation that safely removes a node matching the
+ * provided data. A keyed list (see list_set_key()) matches on the key
+ * only, through its hash index
  * 
  * @param list The list to remove from
  * @param data Pointer to data to match and remove
@@ -320,55 +640,56 @@ int removedata(List *list, void *data)
 {
     // Lock the list during operation
     pthread_mutex_lock(&list->lock);
+
     // clang-format off
-    Node *temp = list->head;
+    Node *temp;
     // clang-format on
-    while (temp != NULL && memcmp(temp->data, data, list->datasize) != 0)
+    if (list->index_slots)
     {
-        temp = temp->next;
+        temp = index_find(list, list->key_of(data));
+    }
+    else
+    {
+        temp = list->head;
+        while (temp != NULL && memcmp(temp->data, data, list->datasize) != 0)
+        {
+            temp = temp->next;
+        }
     }
 
     int result = 1; // Default: not found
 
     if (temp != NULL)
     {
-        // clang-format off
-        Node *prevnode = temp->prev;
-        Node *nextnode = temp->next;
-        // clang-format on
-        if (prevnode != NULL)
-        {
-            prevnode->next = nextnode;
-        }
-        if (nextnode != NULL)
-        {
-            nextnode->prev = prevnode;
-        }
-
-        if (temp == list->head)
-        {
-            list->head = nextnode;
-        }
+        remove_found_node(list, temp);
+        result = 0; // Success
+    }
 
-        if (temp == list->tail)
-        {
-            list->tail = prevnode;
-        }
+    pthread_mutex_unlock(&list->lock);
+    return result;
+}
 
-        // Add the node to the free list
-        temp->next = list->free_list;
-        temp->prev = NULL;
-        if (list->free_list)
-            list->free_list->prev = temp;
-        list->free_list = temp;
+/**
+ * @brief Removes the node whose key equals key
+ * 
+ * O(1) expected through the hash index; only keys are compared
+ * 
+ * @param list A keyed list (see list_set_key())
+ * @param key Pointer to keysize bytes of key
+ * @return 0 on success, 1 if no node has this key or the list has no key
+ */
+int removekey(List *list, const void *key)
+{
+    pthread_mutex_lock(&list->lock);
 
-        temp->occupied = 0;
-        list->number_of_elements--;
-        list->lastprocessed = temp;
+    int result = 1; // Default: not found
+    // clang-format off
+    Node *temp = list->index_slots ? index_find(list, key) : NULL;
+    // clang-format on
+    if (temp != NULL)
+    {
+        remove_found_node(list, temp);
         result = 0; // Success
-
-        // Signal that we have a space
-        sem_post(&list->spaces_sem);
     }
 
     pthread_mutex_unlock(&list->lock);
@@ -418,14 +739,10 @@ void *pop(List *list, void *dest)
             list->tail = NULL;
         }
 
-        // Add the node to the free list
-        node->next = list->free_list;
-        node->prev = NULL;
-        if (list->free_list)
-            list->free_list->prev = node;
-        list->free_list = node;
+        index_remove(list, node);
 
-        node->occupied = 0;
+        // Push the node on the free stack
+        release_node(list, node);
         list->number_of_elements--;
         list->lastprocessed = node;
 
@@ -437,7 +754,7 @@ void *pop(List *list, void *dest)
         }
 
         // Signal that we have a space
-        sem_post(&list->spaces_sem);
+        signal_space(list);
     }
     else
     {
@@ -508,14 +825,10 @@ int removenode(List *list, Node *node)
             nextnode->prev = prevnode;
         }
 
-        // Add the node to the free list
-        node->next = list->free_list;
-        node->prev = NULL;
-        if (list->free_list)
-            list->free_list->prev = node;
-        list->free_list = node;
+        index_remove(list, node);
 
-        node->occupied = 0;
+        // Push the node on the free stack
+        release_node(list, node);
 
         list->number_of_elements--;
 
@@ -534,7 +847,7 @@ int removenode(List *list, Node *node)
         result = 0; // Success
 
         // Signal that we have a space
-        sem_post(&list->spaces_sem);
+        signal_space(list);
     }
 
     pthread_mutex_unlock(&list->lock);
@@ -555,6 +868,7 @@ void destroy(List *list)
     pthread_mutex_destroy(&list->lock);
     sem_destroy(&list->elements_sem);
     sem_destroy(&list->spaces_sem);
+    free(list->index_slots);
 
     if (list->startaddress)
     {
@@ -562,6 +876,16 @@ void destroy(List *list)
         list->startaddress = NULL;
     }
 
+    // Blocks added by a growable list, chained through their first bytes
+    while (list->extra_blocks)
+    {
+        // clang-format off
+        char *next = *(char **)list->extra_blocks;
+        // clang-format on
+        free(list->extra_blocks);
+        list->extra_blocks = next;
+    }
+
     free(list);
 }
 
@@ -610,4 +934,292 @@ void printlistfromtail(List *list, void (*print)(void *))
     }
 
     pthread_mutex_unlock(&list->lock);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Address of the Node in the cell at a ring position
+ */
+// clang-format off
+static Node *queue_node(struct mpmc_queue *queue, size_t pos)
+// clang-format on
+{
+    return (Node *)(queue->cells + (pos & queue->mask) * queue->stride + queue->node_offset);
+}
+
+/**
+ * @brief Sequence number of the cell at a ring position
+ */
+// clang-format off
+static atomic_size_t *queue_sequence(struct mpmc_queue *queue, size_t pos)
+// clang-format on
+{
+    return (atomic_size_t *)(queue->cells + (pos & queue->mask) * queue->stride);
+}
+
+/**
+ * @brief Copies data into the next free cell of the ring
+ * 
+ * Lock-free; never blocks
+ * 
+ * @param list The queue list to add to
+ * @param data A data address, its size is determined from list->datasize
+ * @return Node holding the copy (valid until it is popped), or NULL if full
+ */
+// clang-format off
+static Node *queue_add(List *list, void *data)
+// clang-format on
+{
+    // clang-format off
+    struct mpmc_queue *queue = list->queue;
+    // clang-format on
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+
+    for (;;)
+    {
+        size_t sequence = atomic_load_explicit(queue_sequence(queue, pos), memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+        if (diff == 0)
+        {
+            // The cell is free for this lap: try to claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // The consumer of the previous lap has not freed the cell yet
+            return NULL;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    // clang-format off
+    Node *node = queue_node(queue, pos);
+    // clang-format on
+    memcpy(node->data, data, list->datasize);
+    node->occupied = 1;
+    atomic_store_explicit(queue_sequence(queue, pos), pos + 1, memory_order_release);
+    return node;
+}
+
+/**
+ * @brief Removes the oldest element of the ring and copies it into dest
+ * 
+ * Lock-free; never blocks
+ * 
+ * @param list The queue list to pop from
+ * @param dest Address to copy data to (can be NULL)
+ * @return dest if an element was removed and dest is not NULL; else NULL
+ */
+// clang-format off
+static void *queue_pop(List *list, void *dest)
+// clang-format on
+{
+    // clang-format off
+    struct mpmc_queue *queue = list->queue;
+    // clang-format on
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+
+    for (;;)
+    {
+        size_t sequence = atomic_load_explicit(queue_sequence(queue, pos), memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+        if (diff == 0)
+        {
+            // The cell holds data for this lap: try to claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Nothing published at this position yet
+            return NULL;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    // clang-format off
+    Node *node = queue_node(queue, pos);
+    // clang-format on
+    if (dest != NULL)
+    {
+        memcpy(dest, node->data, list->datasize);
+    }
+    node->occupied = 0;
+
+    // Hand the cell to the producer of the next lap
+    atomic_store_explicit(queue_sequence(queue, pos), pos + queue->mask + 1, memory_order_release);
+    return dest;
+}
+
+/**
+ * @brief Returns the data of the oldest element without removing it
+ * 
+ * The data stays valid only while no other thread pops; with several
+ * consumers it is a hint, not a reservation
+ * 
+ * @param list The queue list to peek at
+ * @return Address of the oldest element's data or NULL if empty
+ */
+// clang-format off
+static void *queue_peek(List *list)
+// clang-format on
+{
+    // clang-format off
+    struct mpmc_queue *queue = list->queue;
+    // clang-format on
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_acquire);
+
+    if (atomic_load_explicit(queue_sequence(queue, pos), memory_order_acquire) != pos + 1)
+    {
+        return NULL;
+    }
+    return queue_node(queue, pos)->data;
+}
+
+/**
+ * @brief Frees the ring and the list
+ *
+ * @param list The queue list to destroy
+ */
+// clang-format off
+static void queue_destroy(List *list)
+// clang-format on
+{
+    free(list->queue->cells);
+    free(list->queue);
+    free(list);
+}
+
+/**
+ * @brief Rejects removal of arbitrary data, which a ring cannot do
+ * @return Always 1
+ */
+static int queue_removedata(List *list, void *data)
+{
+    (void)list;
+    (void)data;
+    fprintf(stderr, "removedata is not supported by the MPMC queue backend\n");
+    return 1;
+}
+
+/**
+ * @brief Rejects removal by key, which a ring cannot do
+ * @return Always 1
+ */
+static int queue_removekey(List *list, const void *key)
+{
+    (void)list;
+    (void)key;
+    fprintf(stderr, "removekey is not supported by the MPMC queue backend\n");
+    return 1;
+}
+
+/**
+ * @brief Rejects removal of arbitrary nodes, which a ring cannot do
+ * @return Always 1
+ */
+// clang-format off
+static int queue_removenode(List *list, Node *node)
+// clang-format on
+{
+    (void)list;
+    (void)node;
+    fprintf(stderr, "removenode is not supported by the MPMC queue backend\n");
+    return 1;
+}
+
+/**
+ * @brief Rejects traversal, which is not safe while other threads pop
+ */
+// clang-format off
+static void queue_printlist(List *list, void (*print)(void *))
+// clang-format on
+{
+    (void)list;
+    (void)print;
+    fprintf(stderr, "printlist is not supported by the MPMC queue backend\n");
+}
+
+// clang-format off
+static List *create_queue_list(size_t datasize, int capacity)
+// clang-format on
+{
+    if (capacity <= 0)
+    {
+        fprintf(stderr, "Invalid queue capacity: %d\n", capacity);
+        return NULL;
+    }
+
+    // Ring size must be a power of two so positions map to cells with a mask
+    size_t size = 2;
+    while (size < (size_t)capacity)
+    {
+        size <<= 1;
+    }
+
+    // clang-format off
+    List *list = malloc(sizeof(List));
+    struct mpmc_queue *queue = aligned_alloc(CACHE_LINE_SIZE, (sizeof(struct mpmc_queue) + CACHE_LINE_SIZE - 1) /
+                                                                  CACHE_LINE_SIZE * CACHE_LINE_SIZE);
+    // clang-format on
+    if (!list || !queue)
+    {
+        perror("Failed to allocate memory for queue");
+        free(list);
+        free(queue);
+        return NULL;
+    }
+
+    memset(list, 0, sizeof(List));
+    memset(queue, 0, sizeof(struct mpmc_queue));
+
+    list->datasize = datasize;
+    list->nodesize = (sizeof(Node) + datasize + _Alignof(Node) - 1) / _Alignof(Node) * _Alignof(Node);
+    list->capacity = (int)size;
+
+    queue->mask = size - 1;
+    queue->node_offset = (sizeof(atomic_size_t) + _Alignof(Node) - 1) / _Alignof(Node) * _Alignof(Node);
+    queue->stride = (queue->node_offset + list->nodesize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    queue->cells = aligned_alloc(CACHE_LINE_SIZE, size * queue->stride);
+    if (!queue->cells)
+    {
+        perror("Failed to allocate memory for queue cells");
+        free(queue);
+        free(list);
+        return NULL;
+    }
+    memset(queue->cells, 0, size * queue->stride);
+
+    // Cell i is free for the producer that claims position i
+    for (size_t i = 0; i < size; i++)
+    {
+        atomic_init(queue_sequence(queue, i), i);
+    }
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+
+    /*ops*/
+    list->backend = LIST_BACKEND_MPMC_QUEUE;
+    list->queue = queue;
+    list->self = list;
+    list->add = queue_add;
+    list->removedata = queue_removedata;
+    list->removekey = queue_removekey;
+    list->removenode = queue_removenode;
+    list->pop = queue_pop;
+    list->peek = queue_peek;
+    list->destroy = queue_destroy;
+    list->printlist = queue_printlist;
+    list->printlistfromtail = queue_printlist;
+    return list;
+}
@@ -6,20 +6,18 @@
  * @date 2025-05-22
  * 
  * This module implements the core spatial organization system for the emergency
- * drone coordination application. It provides a 2D grid structure where each
- * cell can contain survivors, enabling efficient spatial queries and optimal
- * mission assignment algorithms.
+ * drone coordination application. It provides the 2D grid that survivors,
+ * drones and the spatial indexes are laid out on.
  * 
  * **Spatial Organization:**
  * - Dynamic 2D grid allocation with configurable dimensions
  * - Row-major memory layout for cache efficiency
- * - Per-cell survivor lists with thread-safe access
  * - Coordinate validation and bounds checking
  * - Memory-efficient design with proper cleanup
  * 
  * **Grid Structure:**
- * - Each cell maintains its own survivor list (capacity 10)
- * - Thread-safe operations through per-cell list mutexes
+ * - Cells hold only their coordinates; survivors and idle drones are
+ *   bucketed by cell in the spatial indexes
  * - Coordinates use (x,y) = (row,column) convention
  * - Origin (0,0) at top-left corner of grid
  * - Supports arbitrary grid dimensions within memory limits
@@ -28,13 +26,9 @@
  * - Contiguous memory allocation for spatial locality
  * - Efficient bounds checking for all operations
  * - Minimal overhead for empty cells
- * - Fast spatial queries through direct cell access
  * 
  * **Thread Safety:**
- * - Individual cell lists have independent mutex protection
- * - Concurrent access to different cells is fully supported
- * - Proper initialization and cleanup with error handling
- * - Safe multi-threaded access patterns throughout
+ * - The grid is immutable between init_map() and freemap()
  * 
  * @copyright Copyright (c) 2024
  * 
@@ -43,7 +37,6 @@
  */
 
 #include "headers/map.h"
-#include "headers/list.h"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -53,14 +46,13 @@ Map map;
 /**
  * @brief Initialize the map with given dimensions
  * 
- * Creates a 2D grid of MapCell structures, each containing coordinates
- * and a thread-safe list for tracking survivors in that cell. This allows
- * for efficient spatial queries and reduces lock contention by providing
- * per-cell synchronization.
+ * Creates a 2D grid of MapCell structures, each containing its
+ * coordinates. Cells carry no survivor list: the spatial indexes bucket
+ * survivors by cell, and a list per cell cost hundreds of megabytes on
+ * large maps without ever holding an element.
  * 
  * Memory layout:
  * - Allocates height * width MapCell structures
- * - Each cell gets its own survivor list with capacity of 10
  * - Uses row-major ordering for memory locality
  * 
  * @param height Map height (number of rows) - must be > 0
@@ -68,7 +60,6 @@ Map map;
  * 
  * @pre height > 0 && width > 0
  * @post map.cells[i][j] is valid for 0 <= i < height, 0 <= j < width
- * @post Each cell has an initialized survivor list
  * 
  * @warning This function will call exit(EXIT_FAILURE) if memory allocation fails
  * 
@@ -106,13 +97,6 @@ void init_map(int height, int width)
             // Clean up any previously allocated rows before exiting
             for (int cleanup_row = 0; cleanup_row < i; cleanup_row++)
             {
-                for (int j = 0; j < width; j++)
-                {
-                    if (map.cells[cleanup_row][j].survivors)
-                    {
-                        map.cells[cleanup_row][j].survivors->destroy(map.cells[cleanup_row][j].survivors);
-                    }
-                }
                 free(map.cells[cleanup_row]);
             }
             free(map.cells);
@@ -126,31 +110,6 @@ void init_map(int height, int width)
             // Set cell coordinates
             map.cells[i][j].coord.x = i;
             map.cells[i][j].coord.y = j;
-
-            // Create a thread-safe survivor list for this cell
-            // Capacity of 10 should handle typical survivor density
-            map.cells[i][j].survivors = create_list(sizeof(Survivor), 10);
-
-            if (!map.cells[i][j].survivors)
-            {
-                fprintf(stderr, "Failed to create survivor list for cell (%d, %d)\n", i, j);
-                // Clean up all previously created structures
-                for (int cleanup_row = 0; cleanup_row <= i; cleanup_row++)
-                {
-                    int cleanup_cols = (cleanup_row == i) ? j : width;
-                    for (int cleanup_col = 0; cleanup_col < cleanup_cols; cleanup_col++)
-                    {
-                        if (map.cells[cleanup_row][cleanup_col].survivors)
-                        {
-                            map.cells[cleanup_row][cleanup_col].survivors->destroy(
-                                map.cells[cleanup_row][cleanup_col].survivors);
-                        }
-                    }
-                    free(map.cells[cleanup_row]);
-                }
-                free(map.cells);
-                exit(EXIT_FAILURE);
-            }
         }
     }
 
@@ -161,16 +120,11 @@ void init_map(int height, int width)
  * @brief Free all map resources and clean up memory
  * 
  * Performs a complete cleanup of the map structure, including:
- * - Destroying all survivor lists in each cell
  * - Freeing all row arrays
  * - Freeing the main cell pointer array
  * 
- * This function ensures no memory leaks by carefully destroying
- * all thread-safe lists before freeing their container structures.
- * 
  * @pre map must have been initialized with init_map()
  * @post All map memory is freed and pointers are invalid
- * @post All survivor lists are properly destroyed
  * 
  * @note This function is safe to call multiple times
  * @note After calling this function, map.cells becomes invalid
@@ -187,26 +141,11 @@ void freemap()
 
     printf("Freeing map resources...\n");
 
-    // Free each row and its cells
+    // Free each row of cells
     for (int i = 0; i < map.height; i++)
     {
-        if (map.cells[i])
-        {
-            // Destroy survivor lists in each cell of this row
-            for (int j = 0; j < map.width; j++)
-            {
-                if (map.cells[i][j].survivors)
-                {
-                    // Properly destroy the thread-safe list
-                    map.cells[i][j].survivors->destroy(map.cells[i][j].survivors);
-                    map.cells[i][j].survivors = NULL;
-                }
-            }
-
-            // Free the row array
-            free(map.cells[i]);
-            map.cells[i] = NULL;
-        }
+        free(map.cells[i]);
+        map.cells[i] = NULL;
     }
 
     // Free the main pointer array
@@ -258,34 +197,3 @@ MapCell* get_cell(int x, int y)
     }
     return &map.cells[x][y];
 }
-
-/**
- * @brief Get the total number of survivors across all map cells
- * 
- * Iterates through all cells and sums up the survivor counts.
- * This is a relatively expensive operation for large maps.
- * 
- * @return Total number of survivors on the map
- * 
- * @note This function locks each cell briefly, so it's thread-safe
- * @note Consider caching this value if called frequently
- */
-int get_total_survivor_count()
-{
-    int total = 0;
-
-    for (int i = 0; i < map.height; i++)
-    {
-        for (int j = 0; j < map.width; j++)
-        {
-            if (map.cells[i][j].survivors)
-            {
-                pthread_mutex_lock(&map.cells[i][j].survivors->lock);
-                total += map.cells[i][j].survivors->number_of_elements;
-                pthread_mutex_unlock(&map.cells[i][j].survivors->lock);
-            }
-        }
-    }
-
-    return total;
-}
\ No newline at end of file
@@ -0,0 +1,507 @@
+/**
+ * @file message_parser.c
+ * @brief Allocation-free parser for the known drone → server JSON messages
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of parse_drone_message() declared in message_parser.h. A
+ * single forward pass over the frame decodes the fields the server uses;
+ * values of other keys are skipped without being materialized. Nothing is
+ * copied and nothing is allocated, and the input is never modified.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#include "headers/message_parser.h"
+#include "headers/drone.h"
+#include "headers/wire.h"
+
+#include <limits.h>
+#include <string.h>
+
+/** @brief Deepest nesting accepted inside skipped values */
+#define PARSER_MAX_DEPTH 16
+
+/**
+ * @struct scanner
+ * @brief Read position within the frame being parsed
+ */
+typedef struct scanner {
+    const char *pos; /**< Next byte to examine */
+    const char *end; /**< One past the last byte of the frame */
+} Scanner;
+
+/**
+ * @brief Compare a length-delimited token with a string literal
+ */
+#define TOKEN_IS(start, length, literal) \
+    ((length) == sizeof(literal) - 1 && memcmp((start), (literal), sizeof(literal) - 1) == 0)
+
+/**
+ * @brief Advance past JSON whitespace
+ */
+static void skip_whitespace(Scanner *s)
+{
+    while (s->pos < s->end && (*s->pos == ' ' || *s->pos == '\t' || *s->pos == '\n' || *s->pos == '\r'))
+    {
+        s->pos++;
+    }
+}
+
+/**
+ * @brief Consume an expected structural character, skipping whitespace first
+ *
+ * @return 0 if the character was found, -1 otherwise
+ */
+static int expect_char(Scanner *s, char c)
+{
+    skip_whitespace(s);
+    if (s->pos >= s->end || *s->pos != c)
+    {
+        return -1;
+    }
+    s->pos++;
+    return 0;
+}
+
+/**
+ * @brief Scan a string literal without escape sequences
+ *
+ * @param s Scanner positioned at the opening quote
+ * @param start Receives the first byte of the contents
+ * @param length Receives the length of the contents
+ * @return 0 on success, -1 on escapes or an unterminated string
+ */
+static int scan_string(Scanner *s, const char **start, size_t *length)
+{
+    if (expect_char(s, '"') != 0)
+    {
+        return -1;
+    }
+
+    const char *begin = s->pos;
+    while (s->pos < s->end && *s->pos != '"')
+    {
+        if (*s->pos == '\\')
+        {
+            return -1; // Needs unescaping; leave it to json-c
+        }
+        s->pos++;
+    }
+    if (s->pos >= s->end)
+    {
+        return -1;
+    }
+
+    *start = begin;
+    *length = (size_t)(s->pos - begin);
+    s->pos++; // Closing quote
+    return 0;
+}
+
+/**
+ * @brief Scan an integer literal
+ *
+ * @param s Scanner positioned at the number
+ * @param value Receives the value
+ * @return 0 on success, -1 for fractions, exponents, overflow or non-numbers
+ */
+static int scan_integer(Scanner *s, long *value)
+{
+    skip_whitespace(s);
+
+    int negative = 0;
+    if (s->pos < s->end && *s->pos == '-')
+    {
+        negative = 1;
+        s->pos++;
+    }
+
+    const char *digits = s->pos;
+    long result = 0;
+    while (s->pos < s->end && *s->pos >= '0' && *s->pos <= '9')
+    {
+        if (result > (LONG_MAX - 9) / 10)
+        {
+            return -1;
+        }
+        result = result * 10 + (*s->pos - '0');
+        s->pos++;
+    }
+
+    if (s->pos == digits)
+    {
+        return -1;
+    }
+    if (s->pos < s->end && (*s->pos == '.' || *s->pos == 'e' || *s->pos == 'E'))
+    {
+        return -1; // json-c truncates these; let it
+    }
+
+    *value = negative ? -result : result;
+    return 0;
+}
+
+/**
+ * @brief Scan an integer that must fit in an int
+ */
+static int scan_int(Scanner *s, int *value)
+{
+    long result;
+    if (scan_integer(s, &result) != 0 || result < INT_MIN || result > INT_MAX)
+    {
+        return -1;
+    }
+    *value = (int)result;
+    return 0;
+}
+
+/**
+ * @brief Consume a bare literal such as true, false or null
+ */
+static int scan_literal(Scanner *s, const char *literal)
+{
+    size_t length = strlen(literal);
+    if ((size_t)(s->end - s->pos) < length || memcmp(s->pos, literal, length) != 0)
+    {
+        return -1;
+    }
+    s->pos += length;
+    return 0;
+}
+
+/**
+ * @brief Skip over any JSON value without decoding it
+ *
+ * @param s Scanner positioned at the value
+ * @param depth Current nesting depth
+ * @return 0 on success, -1 on malformed input or excessive nesting
+ */
+static int skip_value(Scanner *s, int depth)
+{
+    skip_whitespace(s);
+    if (s->pos >= s->end || depth > PARSER_MAX_DEPTH)
+    {
+        return -1;
+    }
+
+    char c = *s->pos;
+    if (c == '"')
+    {
+        // Escapes are fine here since the contents are never used
+        for (s->pos++; s->pos < s->end && *s->pos != '"'; s->pos++)
+        {
+            if (*s->pos == '\\')
+                s->pos++;
+        }
+        if (s->pos >= s->end)
+        {
+            return -1;
+        }
+        s->pos++;
+        return 0;
+    }
+
+    if (c == '{' || c == '[')
+    {
+        char close = c == '{' ? '}' : ']';
+        s->pos++;
+        skip_whitespace(s);
+        if (s->pos < s->end && *s->pos == close)
+        {
+            s->pos++;
+            return 0;
+        }
+
+        while (1)
+        {
+            if (c == '{')
+            {
+                // Keys are skipped like string values, escapes included
+                skip_whitespace(s);
+                if (s->pos >= s->end || *s->pos != '"' || skip_value(s, depth + 1) != 0 ||
+                    expect_char(s, ':') != 0)
+                {
+                    return -1;
+                }
+            }
+            if (skip_value(s, depth + 1) != 0)
+            {
+                return -1;
+            }
+
+            skip_whitespace(s);
+            if (s->pos < s->end && *s->pos == ',')
+            {
+                s->pos++;
+                continue;
+            }
+            return expect_char(s, close);
+        }
+    }
+
+    if (c == 't')
+        return scan_literal(s, "true");
+    if (c == 'f')
+        return scan_literal(s, "false");
+    if (c == 'n')
+        return scan_literal(s, "null");
+
+    // Number: accept the JSON number alphabet; the value is not needed
+    const char *start = s->pos;
+    while (s->pos < s->end && ((*s->pos >= '0' && *s->pos <= '9') || *s->pos == '-' || *s->pos == '+' ||
+                               *s->pos == '.' || *s->pos == 'e' || *s->pos == 'E'))
+    {
+        s->pos++;
+    }
+    return s->pos > start ? 0 : -1;
+}
+
+/**
+ * @brief Scan an array of encoding names into a WireEncoding mask
+ *
+ * @return 0 on success, -1 otherwise
+ */
+static int scan_encodings(Scanner *s, unsigned int *encodings)
+{
+    if (expect_char(s, '[') != 0)
+    {
+        return -1;
+    }
+    skip_whitespace(s);
+    if (s->pos < s->end && *s->pos == ']')
+    {
+        s->pos++;
+        return 0;
+    }
+
+    while (1)
+    {
+        const char *name;
+        size_t name_length;
+        if (scan_string(s, &name, &name_length) != 0)
+        {
+            return -1;
+        }
+        *encodings |= drone_encoding_from_name(name, name_length);
+
+        skip_whitespace(s);
+        if (s->pos < s->end && *s->pos == ',')
+        {
+            s->pos++;
+            continue;
+        }
+        return expect_char(s, ']');
+    }
+}
+
+/**
+ * @brief Scan a {"x": int, "y": int} object
+ *
+ * Other keys are skipped. Both x and y must be present.
+ *
+ * @return 0 on success, -1 otherwise
+ */
+static int scan_coord(Scanner *s, Coord *coord)
+{
+    int have_x = 0, have_y = 0;
+
+    if (expect_char(s, '{') != 0)
+    {
+        return -1;
+    }
+    skip_whitespace(s);
+    if (s->pos < s->end && *s->pos == '}')
+    {
+        return -1;
+    }
+
+    while (1)
+    {
+        const char *key;
+        size_t key_length;
+        if (scan_string(s, &key, &key_length) != 0 || expect_char(s, ':') != 0)
+        {
+            return -1;
+        }
+
+        if (TOKEN_IS(key, key_length, "x"))
+        {
+            if (scan_int(s, &coord->x) != 0)
+                return -1;
+            have_x = 1;
+        }
+        else if (TOKEN_IS(key, key_length, "y"))
+        {
+            if (scan_int(s, &coord->y) != 0)
+                return -1;
+            have_y = 1;
+        }
+        else if (skip_value(s, 1) != 0)
+        {
+            return -1;
+        }
+
+        skip_whitespace(s);
+        if (s->pos < s->end && *s->pos == ',')
+        {
+            s->pos++;
+            continue;
+        }
+        if (expect_char(s, '}') != 0)
+        {
+            return -1;
+        }
+        return have_x && have_y ? 0 : -1;
+    }
+}
+
+DroneMessageType drone_message_type_from_name(const char *name, size_t length)
+{
+    if (TOKEN_IS(name, length, "STATUS_UPDATE"))
+        return DRONE_MSG_STATUS_UPDATE;
+    if (TOKEN_IS(name, length, "HEARTBEAT_RESPONSE"))
+        return DRONE_MSG_HEARTBEAT_RESPONSE;
+    if (TOKEN_IS(name, length, "MISSION_COMPLETE"))
+        return DRONE_MSG_MISSION_COMPLETE;
+    if (TOKEN_IS(name, length, "HANDSHAKE"))
+        return DRONE_MSG_HANDSHAKE;
+    return DRONE_MSG_UNKNOWN;
+}
+
+unsigned int drone_encoding_from_name(const char *name, size_t length)
+{
+    if (TOKEN_IS(name, length, WIRE_ENCODING_NAME_BINARY))
+        return WIRE_ENCODING_BINARY;
+    if (TOKEN_IS(name, length, WIRE_ENCODING_NAME_JSON))
+        return WIRE_ENCODING_JSON;
+    return 0;
+}
+
+int drone_status_from_name(const char *name, size_t length)
+{
+    // Status updates use lowercase names, the handshake uses enum names
+    if (TOKEN_IS(name, length, "idle") || TOKEN_IS(name, length, "IDLE"))
+        return IDLE;
+    if (TOKEN_IS(name, length, "busy") || TOKEN_IS(name, length, "ON_MISSION"))
+        return ON_MISSION;
+    return -1;
+}
+
+int parse_drone_message(const char *data, size_t length, DroneMessage *message)
+{
+    Scanner s = {data, data + length};
+
+    memset(message, 0, sizeof(DroneMessage));
+
+    if (expect_char(&s, '{') != 0)
+    {
+        return -1;
+    }
+    skip_whitespace(&s);
+    if (s.pos < s.end && *s.pos == '}')
+    {
+        return -1; // No type
+    }
+
+    while (1)
+    {
+        const char *key;
+        size_t key_length;
+        if (scan_string(&s, &key, &key_length) != 0 || expect_char(&s, ':') != 0)
+        {
+            return -1;
+        }
+
+        int result = 0;
+        if (TOKEN_IS(key, key_length, "type"))
+        {
+            const char *value;
+            size_t value_length;
+            result = scan_string(&s, &value, &value_length);
+            if (result == 0)
+                message->type = drone_message_type_from_name(value, value_length);
+        }
+        else if (TOKEN_IS(key, key_length, "location") || TOKEN_IS(key, key_length, "coord"))
+        {
+            result = scan_coord(&s, &message->location);
+            message->fields |= DRONE_FIELD_LOCATION;
+        }
+        else if (TOKEN_IS(key, key_length, "target_location"))
+        {
+            result = scan_coord(&s, &message->target);
+            message->fields |= DRONE_FIELD_TARGET;
+        }
+        else if (TOKEN_IS(key, key_length, "status"))
+        {
+            const char *value;
+            size_t value_length;
+            result = scan_string(&s, &value, &value_length);
+            if (result == 0)
+            {
+                int status = drone_status_from_name(value, value_length);
+                if (status >= 0)
+                {
+                    message->status = status;
+                    message->fields |= DRONE_FIELD_STATUS;
+                }
+            }
+        }
+        else if (TOKEN_IS(key, key_length, "battery"))
+        {
+            result = scan_int(&s, &message->battery);
+            message->fields |= DRONE_FIELD_BATTERY;
+        }
+        else if (TOKEN_IS(key, key_length, "timestamp"))
+        {
+            result = scan_integer(&s, &message->timestamp);
+            message->fields |= DRONE_FIELD_TIMESTAMP;
+        }
+        else if (TOKEN_IS(key, key_length, "success"))
+        {
+            skip_whitespace(&s);
+            if (scan_literal(&s, "true") == 0)
+                message->success = 1;
+            else
+                result = scan_literal(&s, "false");
+            message->fields |= DRONE_FIELD_SUCCESS;
+        }
+        else if (TOKEN_IS(key, key_length, "encodings"))
+        {
+            result = scan_encodings(&s, &message->encodings);
+            message->fields |= DRONE_FIELD_ENCODINGS;
+        }
+        else
+        {
+            result = skip_value(&s, 1);
+        }
+
+        if (result != 0)
+        {
+            return -1;
+        }
+
+        skip_whitespace(&s);
+        if (s.pos < s.end && *s.pos == ',')
+        {
+            s.pos++;
+            continue;
+        }
+        if (expect_char(&s, '}') != 0)
+        {
+            return -1;
+        }
+        break;
+    }
+
+    // Nothing but whitespace may follow the object
+    skip_whitespace(&s);
+    if (s.pos != s.end || message->type == DRONE_MSG_UNKNOWN)
+    {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file metrics_http.c
+ * @brief Prometheus scrape endpoint for live server metrics
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implements the endpoint declared in metrics_http.h. The listening
+ * socket and every accepted connection are non-blocking; the thread
+ * waits in poll() and gives each scrape a fixed time budget for reading
+ * the request and writing the response.
+ *
+ * **Response Body:**
+ * - perf_format_prometheus(): message, byte, connection, rate and latency
+ *   metrics
+ * - Simulation counters: survivors by status, rescued survivors and drones
+ *   by status, read from the atomic counters in globals.h
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup monitoring
+ * @ingroup networking
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "headers/metrics_http.h"
+#include "headers/globals.h"
+#include "headers/server_throughput.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+int metrics_http_port = 0;
+
+/** @brief Response body, reused by every scrape (only this thread uses it) */
+static char body[METRICS_HTTP_BODY_SIZE];
+
+/**
+ * @brief Put a descriptor into non-blocking mode
+ *
+ * @param fd Descriptor to modify
+ * @return 0 on success, -1 on failure
+ */
+static int set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Milliseconds left until a monotonic deadline, 0 once it passed
+ */
+static int remaining_ms(const struct timespec *deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long ms = (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+    return ms > 0 ? (int)ms : 0;
+}
+
+/**
+ * @brief Wait until a socket is ready or the deadline passes
+ *
+ * @return 1 if ready, 0 on timeout or error
+ */
+static int wait_ready(int fd, short events, const struct timespec *deadline)
+{
+    struct pollfd pfd = { .fd = fd, .events = events };
+    int timeout = remaining_ms(deadline);
+    return timeout > 0 && poll(&pfd, 1, timeout) > 0 && (pfd.revents & events);
+}
+
+/**
+ * @brief Read a request header, up to the blank line ending it
+ *
+ * @param request Out: NUL-terminated request text
+ * @return 0 on success, -1 on timeout, disconnect or oversized request
+ */
+static int read_request(int fd, char *request, size_t size, const struct timespec *deadline)
+{
+    size_t used = 0;
+    request[0] = '\0';
+    while (strstr(request, "\r\n\r\n") == NULL && strstr(request, "\n\n") == NULL)
+    {
+        if (used == size - 1)
+            return -1;
+
+        ssize_t received = recv(fd, request + used, size - 1 - used, 0);
+        if (received > 0)
+        {
+            used += (size_t)received;
+            request[used] = '\0';
+        }
+        else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            if (!wait_ready(fd, POLLIN, deadline))
+                return -1;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Send a whole buffer on a non-blocking socket
+ *
+ * @return 0 on success, -1 on timeout or error
+ */
+static int send_all(int fd, const char *data, size_t length, const struct timespec *deadline)
+{
+    while (length > 0)
+    {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent > 0)
+        {
+            data += sent;
+            length -= (size_t)sent;
+        }
+        else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            if (!wait_ready(fd, POLLOUT, deadline))
+                return -1;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Send a status line, headers and body
+ */
+static void send_response(int fd, const char *status, const char *content_type, const char *content, size_t length,
+                          const struct timespec *deadline)
+{
+    char header[256];
+    int header_length = snprintf(header,
+                                 sizeof(header),
+                                 "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                                 status,
+                                 content_type,
+                                 length);
+
+    if (send_all(fd, header, (size_t)header_length, deadline) == 0)
+        send_all(fd, content, length, deadline);
+}
+
+/**
+ * @brief Render the full scrape body into body[]
+ *
+ * @return Length of the body, or -1 if it did not fit
+ */
+static int render_metrics(void)
+{
+    int used = perf_format_prometheus(body, sizeof(body));
+    if (used < 0)
+        return -1;
+
+    int written = snprintf(body + used,
+                           sizeof(body) - used,
+                           "# HELP drone_survivors Survivors by rescue status\n"
+                           "# TYPE drone_survivors gauge\n"
+                           "drone_survivors{status=\"waiting\"} %d\n"
+                           "drone_survivors{status=\"helped\"} %d\n"
+                           "# HELP drone_survivors_rescued_total Survivors rescued\n"
+                           "# TYPE drone_survivors_rescued_total counter\n"
+                           "drone_survivors_rescued_total %d\n"
+                           "# HELP drone_drones Connected drones by status\n"
+                           "# TYPE drone_drones gauge\n"
+                           "drone_drones{status=\"idle\"} %d\n"
+                           "drone_drones{status=\"on_mission\"} %d\n",
+                           atomic_load(&waiting_count),
+                           atomic_load(&helped_count),
+                           atomic_load(&rescued_count),
+                           atomic_load(&idle_drones),
+                           atomic_load(&mission_drones));
+    if (written < 0 || (size_t)written >= sizeof(body) - used)
+        return -1;
+    return used + written;
+}
+
+/**
+ * @brief Check whether a request target is /metrics (with or without a
+ *        query string) or /
+ *
+ * @param target Request line text following the method
+ */
+static int is_metrics_path(const char *target)
+{
+    if (strncmp(target, "/metrics", 8) == 0 && (target[8] == ' ' || target[8] == '?'))
+        return 1;
+    return strncmp(target, "/ ", 2) == 0;
+}
+
+/**
+ * @brief Serve one scrape on an accepted connection and close it
+ */
+static void serve_connection(int fd)
+{
+    char request[METRICS_HTTP_REQUEST_SIZE];
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += METRICS_HTTP_IO_TIMEOUT_MS / 1000;
+    deadline.tv_nsec += (METRICS_HTTP_IO_TIMEOUT_MS % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    if (set_nonblocking(fd) != 0 || read_request(fd, request, sizeof(request), &deadline) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    if (strncmp(request, "GET ", 4) != 0)
+    {
+        const char *message = "Method not allowed\n";
+        send_response(fd, "405 Method Not Allowed", "text/plain", message, strlen(message), &deadline);
+    }
+    else if (is_metrics_path(request + 4))
+    {
+        int length = render_metrics();
+        if (length < 0)
+        {
+            const char *message = "Metrics do not fit the response buffer\n";
+            perf_record_error();
+            send_response(fd, "500 Internal Server Error", "text/plain", message, strlen(message), &deadline);
+        }
+        else
+        {
+            send_response(fd, "200 OK", "text/plain; version=0.0.4; charset=utf-8", body, (size_t)length, &deadline);
+        }
+    }
+    else
+    {
+        const char *message = "Not found; metrics are served at /metrics\n";
+        send_response(fd, "404 Not Found", "text/plain", message, strlen(message), &deadline);
+    }
+
+    close(fd);
+}
+
+/**
+ * @brief Create the loopback listening socket of the endpoint
+ *
+ * @return Non-blocking listening socket, or -1 on failure
+ */
+static int create_metrics_listener(int port)
+{
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        perror("Metrics socket creation failed");
+        perf_record_error();
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    int opt = 1;
+    // clang-format off
+    if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+        bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 16) < 0 ||
+        set_nonblocking(listen_fd) != 0)
+    // clang-format on
+    {
+        perror("Metrics endpoint setup failed");
+        perf_record_error();
+        close(listen_fd);
+        return -1;
+    }
+    return listen_fd;
+}
+
+// clang-format off
+void *metrics_http_server(void *arg)
+// clang-format on
+{
+    (void)arg;
+
+    int listen_fd = create_metrics_listener(metrics_http_port);
+    if (listen_fd < 0)
+        return NULL;
+
+    printf("Metrics endpoint listening on http://127.0.0.1:%d/metrics\n", metrics_http_port);
+
+    while (running)
+    {
+        struct pollfd pfd = { .fd = listen_fd, .events = POLLIN };
+        if (poll(&pfd, 1, METRICS_HTTP_POLL_TIMEOUT_MS) <= 0)
+            continue;
+
+        // Drain every pending connection; each is served before the next
+        int client_fd;
+        while ((client_fd = accept(listen_fd, NULL, NULL)) >= 0)
+        {
+            serve_connection(client_fd);
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            perror("Metrics accept failed");
+            perf_record_error();
+        }
+    }
+
+    close(listen_fd);
+    return NULL;
+}
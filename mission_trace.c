@@ -0,0 +1,190 @@
+/**
+ * @file mission_trace.c
+ * @brief Per-mission time-to-rescue traces and their stage latencies
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the trace ring declared in mission_trace.h: a
+ * bounded queue with one sequence number per slot (after D. Vyukov's
+ * bounded MPMC queue), used here with a single consumer.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup monitoring
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "headers/mission_trace.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+MissionTraceBuffer mission_traces;
+
+/** @brief Mask of a ring position */
+#define SLOT_MASK (MISSION_TRACE_CAPACITY - 1)
+
+/** @brief Stage names used in the exported JSON, indexed by MissionStage */
+static const char *stage_names[MISSION_STAGE_COUNT] = { "waiting", "dispatch", "travel", "total" };
+
+void mission_trace_init(MissionTraceBuffer *buffer)
+{
+    memset(buffer, 0, sizeof(*buffer));
+    for (unsigned long i = 0; i < MISSION_TRACE_CAPACITY; i++)
+    {
+        atomic_init(&buffer->slots[i].sequence, i);
+    }
+}
+
+uint64_t mission_trace_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+int mission_trace_record(MissionTraceBuffer *buffer, const MissionTrace *trace)
+{
+    unsigned long position = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    // clang-format off
+    MissionTraceSlot *slot;
+    // clang-format on
+
+    while (1)
+    {
+        slot = &buffer->slots[position & SLOT_MASK];
+        unsigned long sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        long difference = (long)(sequence - position);
+
+        if (difference == 0)
+        {
+            // Free for this position: claim it (position is reloaded on failure)
+            if (atomic_compare_exchange_weak_explicit(
+                    &buffer->head, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // Still holds the trace from one lap ago: the ring is full
+            atomic_fetch_add_explicit(&buffer->dropped, 1, memory_order_relaxed);
+            return -1;
+        }
+        else
+        {
+            // Another producer claimed it first
+            position = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+        }
+    }
+
+    slot->trace = *trace;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    return 0;
+}
+
+int mission_trace_pop(MissionTraceBuffer *buffer, MissionTrace *trace)
+{
+    // clang-format off
+    MissionTraceSlot *slot = &buffer->slots[buffer->tail & SLOT_MASK];
+    // clang-format on
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != buffer->tail + 1)
+        return 0;
+
+    *trace = slot->trace;
+    // Hand the slot to the producer of the next lap
+    atomic_store_explicit(&slot->sequence, buffer->tail + MISSION_TRACE_CAPACITY, memory_order_release);
+    buffer->tail++;
+    return 1;
+}
+
+/**
+ * @brief Record the time from @p start to @p end if both are stamped (non-zero) and ordered
+ */
+static void record_stage(MissionTraceBuffer *buffer, MissionStage stage, uint64_t start, uint64_t end)
+{
+    if (start != 0 && end != 0 && end >= start)
+        latency_histogram_record(&buffer->stages[stage], end - start);
+}
+
+int mission_trace_aggregate(MissionTraceBuffer *buffer)
+{
+    MissionTrace trace;
+    int drained = 0;
+
+    while (mission_trace_pop(buffer, &trace))
+    {
+        record_stage(buffer, MISSION_STAGE_WAITING, trace.spawned_ns, trace.assigned_ns);
+        record_stage(buffer, MISSION_STAGE_DISPATCH, trace.assigned_ns, trace.sent_ns);
+        record_stage(buffer, MISSION_STAGE_TRAVEL, trace.sent_ns, trace.completed_ns);
+        record_stage(buffer, MISSION_STAGE_TOTAL, trace.spawned_ns, trace.completed_ns);
+        drained++;
+    }
+    buffer->aggregated += drained;
+    return drained;
+}
+
+const char *mission_stage_name(MissionStage stage)
+{
+    return (unsigned int)stage < MISSION_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+int mission_trace_export_json(MissionTraceBuffer *buffer, const char *filename)
+{
+    // clang-format off
+    FILE *json_file = fopen(filename, "w");
+    // clang-format on
+    if (!json_file)
+    {
+        fprintf(stderr, "Error: Could not create JSON file %s\n", filename);
+        return -1;
+    }
+
+    mission_trace_aggregate(buffer);
+
+    static const double percentiles[] = { 50.0, 95.0, 99.0, 99.9 };
+    double values[MISSION_STAGE_COUNT][4];
+    double means[MISSION_STAGE_COUNT];
+    unsigned long counts[MISSION_STAGE_COUNT];
+    for (int stage = 0; stage < MISSION_STAGE_COUNT; stage++)
+    {
+        counts[stage] = latency_histogram_percentiles(&buffer->stages[stage], percentiles, 4, values[stage]);
+        means[stage] = counts[stage] > 0 ? latency_histogram_sum_ms(&buffer->stages[stage]) / counts[stage] : 0;
+    }
+
+    fprintf(json_file, "{\n");
+    fprintf(json_file, "  \"mission_traces\": {\n");
+    fprintf(json_file, "    \"missions\": %lu,\n", buffer->aggregated);
+    fprintf(json_file,
+            "    \"dropped\": %lu,\n",
+            (unsigned long)atomic_load_explicit(&buffer->dropped, memory_order_relaxed));
+    fprintf(json_file, "    \"stages_ms\": {\n");
+    for (int stage = 0; stage < MISSION_STAGE_COUNT; stage++)
+    {
+        // Share of the mean time to rescue, so the dominant stage stands out
+        double share = means[MISSION_STAGE_TOTAL] > 0 ? means[stage] / means[MISSION_STAGE_TOTAL] : 0;
+        fprintf(json_file,
+                "      \"%s\": { \"count\": %lu, \"mean\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, "
+                "\"p999\": %.3f, \"share_of_total\": %.3f }%s\n",
+                stage_names[stage],
+                counts[stage],
+                means[stage],
+                values[stage][0],
+                values[stage][1],
+                values[stage][2],
+                values[stage][3],
+                share,
+                stage < MISSION_STAGE_COUNT - 1 ? "," : "");
+    }
+    fprintf(json_file, "    }\n");
+    fprintf(json_file, "  }\n");
+    fprintf(json_file, "}\n");
+
+    int failed = ferror(json_file);
+    if (fclose(json_file) != 0 || failed)
+    {
+        fprintf(stderr, "Error: Could not write JSON file %s\n", filename);
+        return -1;
+    }
+    printf("Mission traces exported to %s\n", filename);
+    return 0;
+}
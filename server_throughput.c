@@ -12,7 +12,9 @@
  * 
  * **Monitoring Capabilities:**
  * - Real-time message throughput tracking (messages per second)
+ * - Moving 1s/10s/60s message rates from a ring of per-second buckets
  * - Response time analysis with min/max/average calculations
+ * - Per-operation latency histograms with p50/p95/p99/p99.9
  * - Connection lifecycle monitoring (connects, disconnects, peak)
  * - Data transfer volume tracking (bytes sent/received)
  * - Error rate monitoring and peak performance detection
@@ -25,14 +27,17 @@
  * - Configurable logging intervals and detail levels
  * 
  * **Thread Safety:**
- * - Mutex-protected metrics structure for concurrent access
- * - Atomic counter updates from multiple threads
+ * - Message, byte, error and response time counters live in per-thread
+ *   shards, one cache line apart, updated with relaxed atomics
+ * - Readers fold the shards into the metrics structure under metrics_lock
+ * - Connection events (rare, and peak tracking needs a consistent active
+ *   count) still take metrics_lock
  * - Background monitoring thread for continuous logging
  * - Safe initialization and cleanup procedures
  * 
  * **Performance Impact:**
- * - Minimal overhead through efficient data structures
- * - Lock-free increments where possible
+ * - Per-message recording takes no lock and writes only the calling
+ *   thread's own cache lines
  * - Background logging to avoid blocking main operations
  * - Configurable monitoring granularity
  * 
@@ -44,10 +49,233 @@
 
 #define _POSIX_C_SOURCE 199309L
 #include "headers/server_throughput.h"
+#include "headers/latency_histogram.h"
+#include <limits.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+
+/** @brief Size of a cache line; each shard starts on its own */
+#define CACHE_LINE_SIZE 64
+
+/** @brief Number of counter shards; threads beyond this share shards */
+#define PERF_SHARD_COUNT 64
+
+/** @brief Monitor thread ticks (seconds) between two console/CSV reports */
+#define PERF_LOG_INTERVAL 5
+
+/**
+ * @struct perf_shard
+ * @brief Hot counters recorded by the threads assigned to one shard
+ * 
+ * Response times are kept in nanoseconds so they can be added atomically.
+ * The minimum is stored as ULONG_MAX minus the value, which turns it into
+ * a maximum and lets a zeroed shard mean "no sample yet".
+ */
+typedef struct perf_shard {
+    _Alignas(CACHE_LINE_SIZE) atomic_ulong status_updates_received;
+    atomic_ulong missions_assigned;
+    atomic_ulong heartbeats_sent;
+    atomic_ulong messages_processed;
+    atomic_ulong error_count;
+    atomic_ulong total_bytes_received;
+    atomic_ulong total_bytes_sent;
+    atomic_ulong response_count;
+    atomic_ulong total_response_time_ns;
+    atomic_ulong max_response_time_ns;
+    atomic_ulong min_response_time_inverted;
+} PerfShard;
 
 // Global metrics instance definition
 PerfMetrics metrics = { 0 };
 
+/** @brief Counter shards, folded into metrics by perf_aggregate() */
+static PerfShard shards[PERF_SHARD_COUNT];
+
+/** @brief Latency histogram of each operation, read by perf_aggregate() */
+static LatencyHistogram latency_histograms[PERF_OP_COUNT];
+
+/** @brief Names of the operations, in PerfOperation order */
+static const char *operation_names[PERF_OP_COUNT] = {
+    "handshake", "status_update", "mission_complete", "heartbeat", "assign_mission", "ai_cycle",
+};
+
+/** @brief Percentiles reported for each operation, in PerfLatency order */
+static const double reported_percentiles[] = { 50.0, 95.0, 99.0, 99.9 };
+
+/** @brief Next shard handed to a thread that records for the first time */
+static atomic_uint next_shard = 0;
+
+/** @brief Shard of the calling thread, NULL until it first records */
+// clang-format off
+static _Thread_local PerfShard *thread_shard = NULL;
+// clang-format on
+
+/**
+ * @brief Shard of the calling thread, assigned round-robin on first use
+ */
+// clang-format off
+static PerfShard *local_shard(void)
+// clang-format on
+{
+    if (!thread_shard)
+    {
+        unsigned int shard = atomic_fetch_add_explicit(&next_shard, 1, memory_order_relaxed);
+        thread_shard = &shards[shard % PERF_SHARD_COUNT];
+    }
+    return thread_shard;
+}
+
+/**
+ * @brief Add to a shard counter
+ */
+static void shard_add(atomic_ulong *counter, unsigned long value)
+{
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+/**
+ * @brief Raise a shard counter to @p value if it is lower
+ */
+static void shard_max(atomic_ulong *counter, unsigned long value)
+{
+    unsigned long current = atomic_load_explicit(counter, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(counter, &current, value, memory_order_relaxed,
+                                                  memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * @brief Sum one counter over all shards
+ */
+static unsigned long shard_sum(size_t offset)
+{
+    unsigned long total = 0;
+    for (int i = 0; i < PERF_SHARD_COUNT; i++)
+    {
+        total += atomic_load_explicit((atomic_ulong *)((char *)&shards[i] + offset), memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Largest value of one counter over all shards
+ */
+static unsigned long shard_highest(size_t offset)
+{
+    unsigned long highest = 0;
+    for (int i = 0; i < PERF_SHARD_COUNT; i++)
+    {
+        unsigned long value =
+            atomic_load_explicit((atomic_ulong *)((char *)&shards[i] + offset), memory_order_relaxed);
+        if (value > highest)
+            highest = value;
+    }
+    return highest;
+}
+
+/**
+ * @brief Fold the counter shards into metrics
+ * 
+ * The caller holds metrics.metrics_lock. Counters recorded concurrently
+ * may or may not be included yet; each one is exact once recording stops.
+ */
+void perf_aggregate(void)
+{
+    metrics.status_updates_received = shard_sum(offsetof(PerfShard, status_updates_received));
+    metrics.missions_assigned = shard_sum(offsetof(PerfShard, missions_assigned));
+    metrics.heartbeats_sent = shard_sum(offsetof(PerfShard, heartbeats_sent));
+    metrics.messages_processed = shard_sum(offsetof(PerfShard, messages_processed));
+    metrics.error_count = shard_sum(offsetof(PerfShard, error_count));
+    metrics.total_bytes_received = shard_sum(offsetof(PerfShard, total_bytes_received));
+    metrics.total_bytes_sent = shard_sum(offsetof(PerfShard, total_bytes_sent));
+    metrics.response_count = shard_sum(offsetof(PerfShard, response_count));
+    metrics.total_response_time_ms = shard_sum(offsetof(PerfShard, total_response_time_ns)) / 1e6;
+    metrics.max_response_time_ms = shard_highest(offsetof(PerfShard, max_response_time_ns)) / 1e6;
+
+    // Keep the 999999.0 "no sample" marker until a response time is recorded
+    unsigned long min_inverted = shard_highest(offsetof(PerfShard, min_response_time_inverted));
+    if (min_inverted > 0)
+        metrics.min_response_time_ms = (ULONG_MAX - min_inverted) / 1e6;
+
+    for (int op = 0; op < PERF_OP_COUNT; op++)
+    {
+        double values[4];
+        // clang-format off
+        PerfLatency *latency = &metrics.latency[op];
+        // clang-format on
+        latency->count = latency_histogram_percentiles(&latency_histograms[op], reported_percentiles, 4, values);
+        latency->p50_ms = values[0];
+        latency->p95_ms = values[1];
+        latency->p99_ms = values[2];
+        latency->p999_ms = values[3];
+        latency->sum_ms = latency_histogram_sum_ms(&latency_histograms[op]);
+    }
+}
+
+/**
+ * @brief Message rate over the most recent @p buckets rate buckets
+ * 
+ * Uses the buckets filled so far when fewer exist. The caller holds
+ * metrics.metrics_lock.
+ */
+static double windowed_rate(int buckets)
+{
+    if (buckets > metrics.rate_bucket_count)
+        buckets = metrics.rate_bucket_count;
+
+    unsigned long messages = 0;
+    double seconds = 0;
+    for (int i = 1; i <= buckets; i++)
+    {
+        // clang-format off
+        const PerfRateBucket *bucket =
+            &metrics.rate_buckets[(metrics.rate_head - i + PERF_RATE_BUCKETS) % PERF_RATE_BUCKETS];
+        // clang-format on
+        messages += bucket->messages;
+        seconds += bucket->seconds;
+    }
+    return seconds > 0 ? messages / seconds : 0;
+}
+
+/**
+ * @brief Close the current rate bucket and update the windowed rates
+ * 
+ * Called once a second by perf_monitor_thread(). The caller holds
+ * metrics.metrics_lock and has just run perf_aggregate().
+ */
+static void advance_rate_window(void)
+{
+    double elapsed = get_elapsed_seconds();
+    // clang-format off
+    PerfRateBucket *bucket = &metrics.rate_buckets[metrics.rate_head];
+    // clang-format on
+    bucket->messages = metrics.messages_processed - metrics.rate_last_total;
+    bucket->seconds = elapsed - metrics.rate_last_elapsed;
+    metrics.rate_last_total = metrics.messages_processed;
+    metrics.rate_last_elapsed = elapsed;
+
+    metrics.rate_head = (metrics.rate_head + 1) % PERF_RATE_BUCKETS;
+    if (metrics.rate_bucket_count < PERF_RATE_BUCKETS)
+        metrics.rate_bucket_count++;
+
+    metrics.messages_per_second_1s = windowed_rate(1);
+    metrics.messages_per_second_10s = windowed_rate(10);
+    metrics.messages_per_second_60s = windowed_rate(60);
+
+    // The peak is the busiest single bucket, not a lifetime average
+    if ((unsigned long)metrics.messages_per_second_1s > metrics.peak_messages_per_second)
+        metrics.peak_messages_per_second = (unsigned long)metrics.messages_per_second_1s;
+}
+
+const char *perf_operation_name(PerfOperation operation)
+{
+    if ((unsigned int)operation >= PERF_OP_COUNT)
+        return "unknown";
+    return operation_names[operation];
+}
+
 /**
  * @brief Initialize performance monitoring with optional log file
  * 
@@ -72,7 +300,18 @@ void init_perf_monitor(const char *log_filename)
             fprintf(
                 metrics.log_file,
                 "timestamp,elapsed_seconds,total_messages,msg_per_sec,status_updates,missions,heartbeats,errors,active_"
-                "connections,total_bytes_rx,total_bytes_tx,avg_response_ms,max_response_ms,peak_msg_per_sec\n");
+                "connections,total_bytes_rx,total_bytes_tx,avg_response_ms,max_response_ms,peak_msg_per_sec,msg_per_sec_1s,"
+                "msg_per_sec_10s,msg_per_sec_60s");
+            for (int op = 0; op < PERF_OP_COUNT; op++)
+            {
+                fprintf(metrics.log_file,
+                        ",%s_p50_ms,%s_p95_ms,%s_p99_ms,%s_p999_ms",
+                        operation_names[op],
+                        operation_names[op],
+                        operation_names[op],
+                        operation_names[op]);
+            }
+            fprintf(metrics.log_file, "\n");
             fflush(metrics.log_file);
         }
     }
@@ -87,11 +326,12 @@ void init_perf_monitor(const char *log_filename)
  */
 void perf_record_status_update(size_t bytes_received)
 {
-    pthread_mutex_lock(&metrics.metrics_lock);
-    metrics.status_updates_received++;
-    metrics.messages_processed++;
-    metrics.total_bytes_received += bytes_received;
-    pthread_mutex_unlock(&metrics.metrics_lock);
+    // clang-format off
+    PerfShard *shard = local_shard();
+    // clang-format on
+    shard_add(&shard->status_updates_received, 1);
+    shard_add(&shard->messages_processed, 1);
+    shard_add(&shard->total_bytes_received, bytes_received);
 }
 
 /**
@@ -103,11 +343,12 @@ void perf_record_status_update(size_t bytes_received)
  */
 void perf_record_mission_assigned(size_t bytes_sent)
 {
-    pthread_mutex_lock(&metrics.metrics_lock);
-    metrics.missions_assigned++;
-    metrics.messages_processed++;
-    metrics.total_bytes_sent += bytes_sent;
-    pthread_mutex_unlock(&metrics.metrics_lock);
+    // clang-format off
+    PerfShard *shard = local_shard();
+    // clang-format on
+    shard_add(&shard->missions_assigned, 1);
+    shard_add(&shard->messages_processed, 1);
+    shard_add(&shard->total_bytes_sent, bytes_sent);
 }
 
 /**
@@ -119,11 +360,12 @@ void perf_record_mission_assigned(size_t bytes_sent)
  */
 void perf_record_heartbeat(size_t bytes_sent)
 {
-    pthread_mutex_lock(&metrics.metrics_lock);
-    metrics.heartbeats_sent++;
-    metrics.messages_processed++;
-    metrics.total_bytes_sent += bytes_sent;
-    pthread_mutex_unlock(&metrics.metrics_lock);
+    // clang-format off
+    PerfShard *shard = local_shard();
+    // clang-format on
+    shard_add(&shard->heartbeats_sent, 1);
+    shard_add(&shard->messages_processed, 1);
+    shard_add(&shard->total_bytes_sent, bytes_sent);
 }
 
 /**
@@ -133,9 +375,7 @@ void perf_record_heartbeat(size_t bytes_sent)
  */
 void perf_record_error(void)
 {
-    pthread_mutex_lock(&metrics.metrics_lock);
-    metrics.error_count++;
-    pthread_mutex_unlock(&metrics.metrics_lock);
+    shard_add(&local_shard()->error_count, 1);
 }
 
 /**
@@ -177,19 +417,34 @@ void perf_record_connection(int is_new)
  */
 void perf_record_response_time(double response_time_ms)
 {
-    pthread_mutex_lock(&metrics.metrics_lock);
-    metrics.total_response_time_ms += response_time_ms;
-    metrics.response_count++;
+    unsigned long response_time_ns = response_time_ms > 0 ? (unsigned long)(response_time_ms * 1e6) : 0;
 
-    if (response_time_ms > metrics.max_response_time_ms)
-    {
-        metrics.max_response_time_ms = response_time_ms;
-    }
-    if (response_time_ms < metrics.min_response_time_ms)
+    // clang-format off
+    PerfShard *shard = local_shard();
+    // clang-format on
+    shard_add(&shard->total_response_time_ns, response_time_ns);
+    shard_add(&shard->response_count, 1);
+    shard_max(&shard->max_response_time_ns, response_time_ns);
+    shard_max(&shard->min_response_time_inverted, ULONG_MAX - response_time_ns);
+}
+
+/**
+ * @brief Record the latency of one operation
+ * 
+ * Lock-free function feeding the operation's histogram and the overall
+ * response time statistics
+ * 
+ * @param operation Operation that was timed
+ * @param response_time_ms Its latency in milliseconds
+ */
+void perf_record_latency(PerfOperation operation, double response_time_ms)
+{
+    if ((unsigned int)operation < PERF_OP_COUNT)
     {
-        metrics.min_response_time_ms = response_time_ms;
+        uint64_t latency_ns = response_time_ms > 0 ? (uint64_t)(response_time_ms * 1e6) : 0;
+        latency_histogram_record(&latency_histograms[operation], latency_ns);
     }
-    pthread_mutex_unlock(&metrics.metrics_lock);
+    perf_record_response_time(response_time_ms);
 }
 
 /**
@@ -212,24 +467,22 @@ double get_elapsed_seconds(void)
 void log_perf_metrics(void)
 {
     pthread_mutex_lock(&metrics.metrics_lock);
+    perf_aggregate();
 
     double elapsed = get_elapsed_seconds();
     double msg_rate = elapsed > 0 ? metrics.messages_processed / elapsed : 0;
     double avg_response = metrics.response_count > 0 ? metrics.total_response_time_ms / metrics.response_count : 0;
 
-    // Update peak message rate
-    unsigned long current_rate = (unsigned long)msg_rate;
-    if (current_rate > metrics.peak_messages_per_second)
-    {
-        metrics.peak_messages_per_second = current_rate;
-    }
-
     printf("\n===== SERVER THROUGHPUT METRICS =====\n");
     printf("Duration: %.2f seconds\n", elapsed);
     printf("Messages: %lu total (%.2f msgs/sec, peak: %lu msgs/sec)\n",
            metrics.messages_processed,
            msg_rate,
            metrics.peak_messages_per_second);
+    printf("  - Recent rates: %.2f/sec (1s), %.2f/sec (10s), %.2f/sec (60s)\n",
+           metrics.messages_per_second_1s,
+           metrics.messages_per_second_10s,
+           metrics.messages_per_second_60s);
     printf("  - Status updates: %lu (%.2f/sec)\n",
            metrics.status_updates_received,
            elapsed > 0 ? metrics.status_updates_received / elapsed : 0);
@@ -259,6 +512,22 @@ void log_perf_metrics(void)
                metrics.max_response_time_ms);
     }
 
+    for (int op = 0; op < PERF_OP_COUNT; op++)
+    {
+        // clang-format off
+        const PerfLatency *latency = &metrics.latency[op];
+        // clang-format on
+        if (latency->count == 0)
+            continue;
+        printf("  - %s latency: p50 %.3fms, p95 %.3fms, p99 %.3fms, p99.9 %.3fms (%lu samples)\n",
+               operation_names[op],
+               latency->p50_ms,
+               latency->p95_ms,
+               latency->p99_ms,
+               latency->p999_ms,
+               latency->count);
+    }
+
     printf("======================================\n\n");
 
     pthread_mutex_unlock(&metrics.metrics_lock);
@@ -275,6 +544,7 @@ void log_perf_metrics_to_file(void)
         return;
 
     pthread_mutex_lock(&metrics.metrics_lock);
+    perf_aggregate();
 
     double elapsed = get_elapsed_seconds();
     double msg_rate = elapsed > 0 ? metrics.messages_processed / elapsed : 0;
@@ -285,7 +555,7 @@ void log_perf_metrics_to_file(void)
     strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
 
     fprintf(metrics.log_file,
-            "%s,%.2f,%lu,%.2f,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.2f,%.2f,%lu\n",
+            "%s,%.2f,%lu,%.2f,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.2f,%.2f,%lu,%.2f,%.2f,%.2f",
             timestamp,
             elapsed,
             metrics.messages_processed,
@@ -299,7 +569,20 @@ void log_perf_metrics_to_file(void)
             metrics.total_bytes_sent,
             avg_response,
             metrics.max_response_time_ms,
-            metrics.peak_messages_per_second);
+            metrics.peak_messages_per_second,
+            metrics.messages_per_second_1s,
+            metrics.messages_per_second_10s,
+            metrics.messages_per_second_60s);
+    for (int op = 0; op < PERF_OP_COUNT; op++)
+    {
+        fprintf(metrics.log_file,
+                ",%.3f,%.3f,%.3f,%.3f",
+                metrics.latency[op].p50_ms,
+                metrics.latency[op].p95_ms,
+                metrics.latency[op].p99_ms,
+                metrics.latency[op].p999_ms);
+    }
+    fprintf(metrics.log_file, "\n");
 
     fflush(metrics.log_file);
 
@@ -309,7 +592,8 @@ void log_perf_metrics_to_file(void)
 /**
  * @brief Performance monitor thread function
  * 
- * Periodically logs metrics to both console and CSV file
+ * Closes a rate bucket every second and periodically logs metrics to
+ * both console and CSV file
  * 
  * @param arg Unused thread parameter
  * @return NULL when thread terminates
@@ -319,12 +603,22 @@ void* perf_monitor_thread(void* arg)
 // clang-format on
 {
     (void)arg; // Suppress unused parameter warning
+    int ticks = 0;
 
     while (metrics.is_monitoring)
     {
-        sleep(5); // Log every 5 seconds
-        log_perf_metrics();
-        log_perf_metrics_to_file();
+        sleep(1);
+
+        pthread_mutex_lock(&metrics.metrics_lock);
+        perf_aggregate();
+        advance_rate_window();
+        pthread_mutex_unlock(&metrics.metrics_lock);
+
+        if (++ticks % PERF_LOG_INTERVAL == 0)
+        {
+            log_perf_metrics();
+            log_perf_metrics_to_file();
+        }
     }
     return NULL;
 }
@@ -401,6 +695,7 @@ void export_metrics_json(const char *filename)
     }
 
     pthread_mutex_lock(&metrics.metrics_lock);
+    perf_aggregate();
 
     double elapsed = get_elapsed_seconds();
     double avg_response = metrics.response_count > 0 ? metrics.total_response_time_ms / metrics.response_count : 0;
@@ -411,6 +706,9 @@ void export_metrics_json(const char *filename)
     fprintf(json_file, "    \"total_messages\": %lu,\n", metrics.messages_processed);
     fprintf(json_file, "    \"messages_per_second\": %.2f,\n", elapsed > 0 ? metrics.messages_processed / elapsed : 0);
     fprintf(json_file, "    \"peak_messages_per_second\": %lu,\n", metrics.peak_messages_per_second);
+    fprintf(json_file, "    \"messages_per_second_1s\": %.2f,\n", metrics.messages_per_second_1s);
+    fprintf(json_file, "    \"messages_per_second_10s\": %.2f,\n", metrics.messages_per_second_10s);
+    fprintf(json_file, "    \"messages_per_second_60s\": %.2f,\n", metrics.messages_per_second_60s);
     fprintf(json_file, "    \"status_updates\": %lu,\n", metrics.status_updates_received);
     fprintf(json_file, "    \"missions_assigned\": %lu,\n", metrics.missions_assigned);
     fprintf(json_file, "    \"heartbeats_sent\": %lu,\n", metrics.heartbeats_sent);
@@ -423,8 +721,22 @@ void export_metrics_json(const char *filename)
     fprintf(json_file, "    \"avg_response_time_ms\": %.2f,\n", avg_response);
     fprintf(json_file, "    \"max_response_time_ms\": %.2f,\n", metrics.max_response_time_ms);
     fprintf(json_file,
-            "    \"min_response_time_ms\": %.2f\n",
+            "    \"min_response_time_ms\": %.2f,\n",
             metrics.min_response_time_ms == 999999.0 ? 0.0 : metrics.min_response_time_ms);
+    fprintf(json_file, "    \"latency_ms\": {\n");
+    for (int op = 0; op < PERF_OP_COUNT; op++)
+    {
+        fprintf(json_file,
+                "      \"%s\": { \"count\": %lu, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"p999\": %.3f }%s\n",
+                operation_names[op],
+                metrics.latency[op].count,
+                metrics.latency[op].p50_ms,
+                metrics.latency[op].p95_ms,
+                metrics.latency[op].p99_ms,
+                metrics.latency[op].p999_ms,
+                op < PERF_OP_COUNT - 1 ? "," : "");
+    }
+    fprintf(json_file, "    }\n");
     fprintf(json_file, "  }\n");
     fprintf(json_file, "}\n");
 
@@ -432,4 +744,123 @@ void export_metrics_json(const char *filename)
 
     fclose(json_file);
     printf("Metrics exported to %s\n", filename);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Append formatted text to a buffer
+ * 
+ * @param used In/out: bytes written so far, or -1 once the buffer is full
+ */
+static void append_text(char *buffer, size_t size, int *used, const char *format, ...)
+{
+    if (*used < 0)
+        return;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer + *used, size - *used, format, args);
+    va_end(args);
+
+    if (written < 0 || (size_t)written >= size - *used)
+        *used = -1;
+    else
+        *used += written;
+}
+
+/**
+ * @brief Append a metric family with a single unlabelled sample
+ */
+static void append_metric(char *buffer, size_t size, int *used, const char *name, const char *type,
+                          const char *help, double value)
+{
+    append_text(buffer, size, used, "# HELP %s %s\n# TYPE %s %s\n%s %.17g\n", name, help, name, type, name, value);
+}
+
+/**
+ * @brief Write the current metrics in Prometheus text exposition format
+ * 
+ * Copies the aggregated metrics under the lock and formats the copy
+ * 
+ * @param buffer Output buffer
+ * @param size Size of the buffer in bytes
+ * @return Length of the text written, or -1 if it did not fit
+ */
+int perf_format_prometheus(char *buffer, size_t size)
+{
+    PerfMetrics snapshot;
+
+    pthread_mutex_lock(&metrics.metrics_lock);
+    perf_aggregate();
+    memcpy(&snapshot, &metrics, sizeof(PerfMetrics));
+    pthread_mutex_unlock(&metrics.metrics_lock);
+
+    int used = size > 0 ? 0 : -1;
+    append_metric(buffer, size, &used, "drone_uptime_seconds", "gauge", "Seconds since monitoring started",
+                  get_elapsed_seconds());
+    append_metric(buffer, size, &used, "drone_messages_processed_total", "counter", "Messages processed",
+                  snapshot.messages_processed);
+    append_metric(buffer, size, &used, "drone_status_updates_received_total", "counter", "Status updates received",
+                  snapshot.status_updates_received);
+    append_metric(buffer, size, &used, "drone_missions_assigned_total", "counter", "Mission assignments sent",
+                  snapshot.missions_assigned);
+    append_metric(buffer, size, &used, "drone_heartbeats_sent_total", "counter", "Heartbeats sent",
+                  snapshot.heartbeats_sent);
+    append_metric(buffer, size, &used, "drone_errors_total", "counter", "Errors recorded", snapshot.error_count);
+    append_metric(buffer, size, &used, "drone_received_bytes_total", "counter", "Bytes received from drones",
+                  snapshot.total_bytes_received);
+    append_metric(buffer, size, &used, "drone_sent_bytes_total", "counter", "Bytes sent to drones",
+                  snapshot.total_bytes_sent);
+    append_metric(buffer, size, &used, "drone_connections_total", "counter", "Drone connections accepted",
+                  snapshot.total_connections);
+    append_metric(buffer, size, &used, "drone_disconnections_total", "counter", "Drone connections closed",
+                  snapshot.disconnections);
+    append_metric(buffer, size, &used, "drone_active_connections", "gauge", "Drone connections open now",
+                  snapshot.active_connections);
+    append_metric(buffer, size, &used, "drone_peak_connections", "gauge", "Most drone connections open at once",
+                  snapshot.peak_connections);
+    append_metric(buffer, size, &used, "drone_peak_messages_per_second", "gauge",
+                  "Most messages processed in one second", snapshot.peak_messages_per_second);
+
+    append_text(buffer, size, &used,
+                "# HELP drone_messages_per_second Messages processed per second over a moving window\n"
+                "# TYPE drone_messages_per_second gauge\n"
+                "drone_messages_per_second{window=\"1s\"} %.9g\n"
+                "drone_messages_per_second{window=\"10s\"} %.9g\n"
+                "drone_messages_per_second{window=\"60s\"} %.9g\n",
+                snapshot.messages_per_second_1s,
+                snapshot.messages_per_second_10s,
+                snapshot.messages_per_second_60s);
+
+    append_text(buffer, size, &used,
+                "# HELP drone_response_time_seconds Response time of every timed operation\n"
+                "# TYPE drone_response_time_seconds summary\n"
+                "drone_response_time_seconds_sum %.9g\n"
+                "drone_response_time_seconds_count %lu\n",
+                snapshot.total_response_time_ms / 1000.0,
+                snapshot.response_count);
+
+    append_text(buffer, size, &used,
+                "# HELP drone_operation_latency_seconds Latency of each operation type\n"
+                "# TYPE drone_operation_latency_seconds summary\n");
+    for (int op = 0; op < PERF_OP_COUNT; op++)
+    {
+        // clang-format off
+        const PerfLatency *latency = &snapshot.latency[op];
+        const char *name = operation_names[op];
+        // clang-format on
+        append_text(buffer, size, &used,
+                    "drone_operation_latency_seconds{operation=\"%s\",quantile=\"0.5\"} %.9g\n"
+                    "drone_operation_latency_seconds{operation=\"%s\",quantile=\"0.95\"} %.9g\n"
+                    "drone_operation_latency_seconds{operation=\"%s\",quantile=\"0.99\"} %.9g\n"
+                    "drone_operation_latency_seconds{operation=\"%s\",quantile=\"0.999\"} %.9g\n"
+                    "drone_operation_latency_seconds_sum{operation=\"%s\"} %.9g\n"
+                    "drone_operation_latency_seconds_count{operation=\"%s\"} %lu\n",
+                    name, latency->p50_ms / 1000.0,
+                    name, latency->p95_ms / 1000.0,
+                    name, latency->p99_ms / 1000.0,
+                    name, latency->p999_ms / 1000.0,
+                    name, latency->sum_ms / 1000.0,
+                    name, latency->count);
+    }
+    return used;
+}
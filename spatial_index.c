@@ -0,0 +1,318 @@
+/**
+ * @file spatial_index.c
+ * @brief Grid-bucketed spatial index for nearest-neighbour queries on the map
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the index declared in spatial_index.h. Bucket lists
+ * are linked through the entry table by key, so moving an entry between
+ * buckets never allocates; the only allocation after initialization is
+ * the table growing when a key beyond its capacity is inserted.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup spatial_system
+ */
+
+#include "headers/spatial_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Clamp a value into [0, limit - 1]
+ */
+static int clamp_index(int value, int limit)
+{
+    return value < 0 ? 0 : value >= limit ? limit - 1 : value;
+}
+
+/**
+ * @brief Bucket row of a map coordinate
+ */
+static int bucket_row(const SpatialIndex *index, Coord coord)
+{
+    return clamp_index(coord.x < 0 ? 0 : coord.x / index->bucket_span, index->rows);
+}
+
+/**
+ * @brief Bucket column of a map coordinate
+ */
+static int bucket_col(const SpatialIndex *index, Coord coord)
+{
+    return clamp_index(coord.y < 0 ? 0 : coord.y / index->bucket_span, index->cols);
+}
+
+/**
+ * @brief Smallest distance a point in a bucket @p ring rings away can have
+ *
+ * A bucket d rows away is at least (d - 1) * span + 1 cells away along
+ * that axis. Over all buckets of the ring the minimum is reached when the
+ * offset is split across both axes.
+ */
+static int ring_lower_bound(const SpatialIndex *index, int ring)
+{
+    if (ring <= 1)
+        return ring;
+    return (ring - 2) * index->bucket_span + 2;
+}
+
+/**
+ * @brief Make room for @p key in the entry table
+ *
+ * @return 0 on success, -1 on allocation failure
+ */
+static int ensure_capacity(SpatialIndex *index, int key)
+{
+    if (key < index->capacity)
+        return 0;
+
+    int capacity = index->capacity * 2;
+    if (capacity <= key)
+        capacity = key + 1;
+
+    // clang-format off
+    SpatialEntry *entries = realloc(index->entries, capacity * sizeof(SpatialEntry));
+    // clang-format on
+    if (!entries)
+    {
+        perror("Failed to grow spatial index");
+        return -1;
+    }
+
+    for (int i = index->capacity; i < capacity; i++)
+    {
+        entries[i].bucket = -1;
+    }
+    index->entries = entries;
+    index->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Take a key out of its bucket list (index lock held, key indexed)
+ */
+static void unlink_entry(SpatialIndex *index, int key)
+{
+    // clang-format off
+    SpatialEntry *entry = &index->entries[key];
+    // clang-format on
+
+    if (entry->prev >= 0)
+        index->entries[entry->prev].next = entry->next;
+    else
+        index->heads[entry->bucket] = entry->next;
+
+    if (entry->next >= 0)
+        index->entries[entry->next].prev = entry->prev;
+
+    entry->bucket = -1;
+    index->count--;
+}
+
+/**
+ * @brief Scan one bucket, keeping the @p k closest entries in sorted order
+ *
+ * @param found In/out: number of entries held in keys/distances
+ */
+static void scan_bucket_k(const SpatialIndex *index, int bucket, Coord origin, int k, int *keys, int *distances,
+                          int *found)
+{
+    for (int key = index->heads[bucket]; key >= 0; key = index->entries[key].next)
+    {
+        Coord c = index->entries[key].coord;
+        int distance = abs(c.x - origin.x) + abs(c.y - origin.y);
+        if (*found == k && distance >= distances[k - 1])
+            continue;
+
+        // Insertion into the sorted result, dropping the farthest if full
+        int i = *found < k ? (*found)++ : k - 1;
+        while (i > 0 && distances[i - 1] > distance)
+        {
+            keys[i] = keys[i - 1];
+            distances[i] = distances[i - 1];
+            i--;
+        }
+        keys[i] = key;
+        distances[i] = distance;
+    }
+}
+
+/**
+ * @brief Visit buckets ring by ring around @p origin
+ *
+ * Calls scan_bucket_k() on every bucket of each ring and stops once
+ * @p k entries are held and the next ring cannot improve on them.
+ *
+ * @return Number of entries found
+ */
+static int ring_search(const SpatialIndex *index, Coord origin, int k, int *keys, int *distances)
+{
+    int found = 0;
+    int row = bucket_row(index, origin);
+    int col = bucket_col(index, origin);
+    int max_ring = (row > index->rows - 1 - row ? row : index->rows - 1 - row) +
+                   (col > index->cols - 1 - col ? col : index->cols - 1 - col);
+
+    for (int ring = 0; ring <= max_ring; ring++)
+    {
+        int first_row = row - ring < 0 ? -row : -ring;
+        int last_row = row + ring >= index->rows ? index->rows - 1 - row : ring;
+
+        for (int dr = first_row; dr <= last_row; dr++)
+        {
+            int dc = ring - abs(dr);
+            int bucket_base = (row + dr) * index->cols;
+
+            if (col + dc < index->cols)
+                scan_bucket_k(index, bucket_base + col + dc, origin, k, keys, distances, &found);
+            if (dc != 0 && col - dc >= 0)
+                scan_bucket_k(index, bucket_base + col - dc, origin, k, keys, distances, &found);
+        }
+
+        // Nothing further out can beat what we already have
+        if (found == k && distances[k - 1] <= ring_lower_bound(index, ring + 1))
+            break;
+    }
+
+    return found;
+}
+
+int spatial_index_init(SpatialIndex *index, int height, int width, int bucket_span, int capacity)
+{
+    if (height <= 0 || width <= 0 || bucket_span <= 0 || capacity <= 0)
+    {
+        fprintf(stderr, "Error: Invalid spatial index dimensions: %dx%d / %d\n", height, width, bucket_span);
+        return -1;
+    }
+
+    memset(index, 0, sizeof(SpatialIndex));
+    index->bucket_span = bucket_span;
+    index->rows = (height + bucket_span - 1) / bucket_span;
+    index->cols = (width + bucket_span - 1) / bucket_span;
+
+    index->heads = malloc(index->rows * index->cols * sizeof(int));
+    index->entries = malloc(capacity * sizeof(SpatialEntry));
+    if (!index->heads || !index->entries)
+    {
+        perror("Failed to allocate spatial index");
+        free(index->heads);
+        free(index->entries);
+        return -1;
+    }
+
+    for (int i = 0; i < index->rows * index->cols; i++)
+    {
+        index->heads[i] = -1;
+    }
+    for (int i = 0; i < capacity; i++)
+    {
+        index->entries[i].bucket = -1;
+    }
+    index->capacity = capacity;
+
+    pthread_mutex_init(&index->lock, NULL);
+    return 0;
+}
+
+void spatial_index_destroy(SpatialIndex *index)
+{
+    if (!index->heads)
+        return;
+
+    pthread_mutex_destroy(&index->lock);
+    free(index->heads);
+    free(index->entries);
+    index->heads = NULL;
+    index->entries = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+int spatial_index_insert(SpatialIndex *index, int key, Coord coord, void *item)
+{
+    if (key < 0)
+        return -1;
+
+    pthread_mutex_lock(&index->lock);
+
+    if (ensure_capacity(index, key) != 0)
+    {
+        pthread_mutex_unlock(&index->lock);
+        return -1;
+    }
+
+    // clang-format off
+    SpatialEntry *entry = &index->entries[key];
+    // clang-format on
+    int bucket = bucket_row(index, coord) * index->cols + bucket_col(index, coord);
+
+    entry->coord = coord;
+    entry->item = item;
+
+    // A move within the same bucket only updates the coordinates
+    if (entry->bucket != bucket)
+    {
+        if (entry->bucket >= 0)
+            unlink_entry(index, key);
+
+        entry->bucket = bucket;
+        entry->prev = -1;
+        entry->next = index->heads[bucket];
+        if (entry->next >= 0)
+            index->entries[entry->next].prev = key;
+        index->heads[bucket] = key;
+        index->count++;
+    }
+
+    pthread_mutex_unlock(&index->lock);
+    return 0;
+}
+
+void spatial_index_remove(SpatialIndex *index, int key)
+{
+    pthread_mutex_lock(&index->lock);
+    if (key >= 0 && key < index->capacity && index->entries[key].bucket >= 0)
+    {
+        unlink_entry(index, key);
+    }
+    pthread_mutex_unlock(&index->lock);
+}
+
+// clang-format off
+int spatial_index_nearest(SpatialIndex *index, Coord origin, void **item)
+// clang-format on
+{
+    int key = -1;
+    int distance;
+
+    pthread_mutex_lock(&index->lock);
+    if (index->count > 0 && ring_search(index, origin, 1, &key, &distance) == 1 && item)
+    {
+        *item = index->entries[key].item;
+    }
+    pthread_mutex_unlock(&index->lock);
+
+    return key;
+}
+
+int spatial_index_nearest_k(SpatialIndex *index, Coord origin, int k, int *keys, int *distances)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&index->lock);
+    if (index->count > 0 && k > 0)
+        found = ring_search(index, origin, k, keys, distances);
+    pthread_mutex_unlock(&index->lock);
+
+    return found;
+}
+
+int spatial_index_count(SpatialIndex *index)
+{
+    pthread_mutex_lock(&index->lock);
+    int count = index->count;
+    pthread_mutex_unlock(&index->lock);
+    return count;
+}
@@ -13,7 +13,7 @@
  * **Survivor Lifecycle Management:**
  * - Continuous generation of new survivors at random locations
  * - Status tracking: waiting → being helped → rescued
- * - Thread-safe array management with mutex protection
+ * - Thread-safe store management with mutex protection
  * - Automatic recycling when maximum capacity is reached
  * - Timestamp tracking for response time analysis
  * 
@@ -21,18 +21,18 @@
  * - Initial burst: 10 survivors at system startup
  * - Continuous generation: 1 survivor every 0.5-1.5 seconds
  * - Random location selection within map boundaries
- * - Intelligent recycling of rescued survivors when array is full
+ * - Intelligent recycling of rescued survivors when the store is full
  * - Configurable generation rates and patterns
  * 
  * **Data Management:**
- * - Fixed-size array for predictable memory usage
+ * - Structure-of-arrays store sized once from survivor_capacity
  * - Thread-safe access through global mutex protection
  * - Integration with spatial map system for location tracking
  * - Efficient status updates and query operations
  * 
  * **Thread Safety:**
- * - Global survivor mutex protects all array operations
- * - Coordination with drone system for mission assignment
+ * - Global survivor mutex protects all store operations but claims
+ * - Survivors are claimed for a mission by compare-and-swap, lock-free
  * - Safe concurrent access from AI controller and visualization
  * - Proper cleanup and resource management
  * 
@@ -45,20 +45,46 @@
 #include "headers/survivor.h"
 
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
 
+#include "headers/ai_events.h"
 #include "headers/globals.h"
 #include "headers/map.h"
+#include "headers/mission_trace.h"
 
-// Global survivor array
+// Global survivor store
 // clang-format off
-Survivor *survivor_array = NULL;
-int num_survivors = 0;
+SurvivorStore survivor_store;
 pthread_mutex_t survivors_mutex;
+SpatialIndex waiting_survivor_index;
+// clang-format on
+
+/** @brief Size of survivor_store, set by --max-survivors */
+int survivor_capacity = SURVIVOR_CAPACITY_DEFAULT;
+
+// Survivor statistics, changed only by survivor_set_status() and add_survivor()
+atomic_int waiting_count = 0;
+atomic_int helped_count = 0;
+atomic_int rescued_count = 0;
+
+/** @brief Rescued survivors moved back to waiting, so rescued_count can be checked */
+static int survivors_recycled = 0;
+
+/** @brief Lock-free claims and releases started, so a recount can tell if one slipped in */
+static atomic_uint survivor_claims_started = 0;
+
+/** @brief Lock-free claims and releases still updating the statistics */
+static atomic_int survivor_claims_active = 0;
+
+/** @brief Attempts survivor_stats_verify() makes at finding no claim in flight */
+#define SURVIVOR_VERIFY_ATTEMPTS 1000
+// clang-format off
 
 /**
  * @brief Create a new survivor with the given attributes
@@ -93,24 +119,33 @@ Survivor *create_survivor(Coord *coord, char *info,
  */
 void initialize_survivors()
 {
-    // Allocate memory for survivor array
-    // clang-format off
-    survivor_array = (Survivor*)malloc(sizeof(Survivor) * MAX_SURVIVORS);
-    // clang-format on
-    if (!survivor_array)
+    // Allocate the survivor store once; it cannot grow while claims read it without a lock
+    if (survivor_store_init(&survivor_store, survivor_capacity) != 0)
     {
-        fprintf(stderr, "Failed to allocate memory for survivor array\n");
+        fprintf(stderr, "Failed to allocate memory for survivor store\n");
         exit(EXIT_FAILURE);
     }
 
-    // Initialize values
-    // clang-format off
-    memset(survivor_array, 0, sizeof(Survivor) * MAX_SURVIVORS);
-    // clang-format on
-    num_survivors = 0;
-
     // Initialize mutex
     pthread_mutex_init(&survivors_mutex, NULL);
+
+    // Index waiting survivors on the map grid, one bucket per cell
+    if (spatial_index_init(&waiting_survivor_index, map.height, map.width, 1, SURVIVOR_STORE_INITIAL) != 0)
+    {
+        fprintf(stderr, "Failed to create waiting survivor index\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Key of a Survivor stored in a List
+ * 
+ * @param data Survivor element
+ * @return Address of its info string
+ */
+const void *survivor_list_key(const void *data)
+{
+    return ((const Survivor *)data)->info;
 }
 
 /**
@@ -121,12 +156,258 @@ void initialize_survivors()
 void cleanup_survivors()
 {
     pthread_mutex_destroy(&survivors_mutex);
-    if (survivor_array)
+    spatial_index_destroy(&waiting_survivor_index);
+    survivor_store_destroy(&survivor_store);
+}
+
+/**
+ * @brief Reflect a survivor's status and coord in waiting_survivor_index
+ * 
+ * A claim or release can change the status while another thread updates
+ * the entry, so the status is read again afterwards and the update
+ * repeated until the entry matches it.
+ * 
+ * @param index Index into survivor_store
+ */
+void survivor_index_update(int index)
+{
+    int waiting;
+    do
+    {
+        waiting = survivor_store.status[index] == 0;
+        if (waiting)
+        {
+            Coord coord = survivor_store_coord(&survivor_store, index);
+            if (spatial_index_insert(&waiting_survivor_index, index, coord, NULL) != 0)
+            {
+                fprintf(stderr, "Failed to index waiting survivor %d\n", index);
+                return;
+            }
+        }
+        else
+        {
+            spatial_index_remove(&waiting_survivor_index, index);
+        }
+    } while ((survivor_store.status[index] == 0) != waiting);
+}
+
+/**
+ * @brief Add @p delta to the statistics counter of a survivor status
+ * 
+ * rescued_count counts every rescue, so it only ever grows.
+ */
+static void count_survivor_status(int status, int delta)
+{
+    if (status == 0)
+        atomic_fetch_add_explicit(&waiting_count, delta, memory_order_relaxed);
+    else if (status == 1)
+        atomic_fetch_add_explicit(&helped_count, delta, memory_order_relaxed);
+    else if (status == 2 && delta > 0)
+        atomic_fetch_add_explicit(&rescued_count, delta, memory_order_relaxed);
+}
+
+/**
+ * @brief Change a survivor's status, its index entry and the statistics
+ * 
+ * @param index Index into survivor_store; the caller holds survivors_mutex
+ * @param status New status (0-3)
+ */
+void survivor_set_status(int index, int status)
+{
+    // The old status comes from the exchange, in case a claim just changed it
+    int old = survivor_store_set_status(&survivor_store, index, status);
+    if (old == status)
+        return;
+
+    if (old >= 2 && status == 0)
+        survivors_recycled++;
+    count_survivor_status(old, -1);
+    count_survivor_status(status, 1);
+    survivor_index_update(index);
+}
+
+/**
+ * @brief Move a survivor from one status to another if it still has the first
+ * 
+ * @param index Index into survivor_store
+ * @param from Status the survivor must have
+ * @param to New status
+ * @return 1 if this call changed the status, 0 otherwise
+ */
+static int survivor_swap_status(int index, int from, int to)
+{
+    // Raised in this order, a recount that saw no claim active sees started move
+    atomic_fetch_add(&survivor_claims_active, 1);
+    atomic_fetch_add(&survivor_claims_started, 1);
+
+    int changed = survivor_store_claim(&survivor_store, index, from, to);
+    if (changed)
+    {
+        count_survivor_status(from, -1);
+        count_survivor_status(to, 1);
+        survivor_index_update(index);
+    }
+
+    atomic_fetch_sub(&survivor_claims_active, 1);
+    return changed;
+}
+
+/**
+ * @brief Claim a waiting survivor without taking survivors_mutex
+ * 
+ * @param index Index into survivor_store
+ * @return 1 if the survivor went from waiting to being helped, 0 if it was not waiting
+ */
+int survivor_claim(int index)
+{
+    return survivor_swap_status(index, 0, 1);
+}
+
+/**
+ * @brief Give back a claimed survivor whose mission could not be sent
+ * 
+ * @param index Index into survivor_store
+ */
+void survivor_release(int index)
+{
+    survivor_swap_status(index, 1, 0);
+}
+
+/**
+ * @brief Record the mission trace of a survivor that was just rescued
+ * 
+ * @param index Index into survivor_store; the caller holds survivors_mutex
+ * @param drone_id Id of the rescuing drone
+ */
+void survivor_trace_rescue(int index, int drone_id)
+{
+    // clang-format off
+    const SurvivorTimes *times = &survivor_store.times[index];
+    // clang-format on
+    MissionTrace trace = {
+        .survivor = index,
+        .drone = drone_id,
+        .spawned_ns = times->spawned_ns,
+        .assigned_ns = times->assigned_ns,
+        .sent_ns = times->sent_ns,
+        .completed_ns = mission_trace_now(),
+    };
+    mission_trace_record(&mission_traces, &trace);
+}
+
+/**
+ * @brief Add a waiting survivor
+ * 
+ * @param coord Location of the survivor; the caller holds survivors_mutex
+ * @return Index of the new survivor, or -1 if the store is full
+ */
+int add_survivor(Coord coord)
+{
+    int index = survivor_store_add(&survivor_store, coord, 0); // Waiting for help
+    if (index < 0)
+        return -1;
+
+    snprintf(survivor_store.info[index], SURVIVOR_INFO_SIZE, "SURV-%d", index);
+
+    // Set time
+    time_t t;
+    time(&t);
+    localtime_r(&t, &survivor_store.times[index].discovery_time);
+    survivor_store.times[index].spawned_ns = mission_trace_now();
+    count_survivor_status(0, 1);
+    survivor_index_update(index);
+    ai_events_post(&ai_events, AI_EVENT_SURVIVOR_WAITING, coord);
+    return index;
+}
+
+/**
+ * @brief Recount survivors by status and compare with the statistics
+ * 
+ * @return 0 if the counters match, -1 otherwise
+ */
+int survivor_stats_verify(void)
+{
+    int counts[SURVIVOR_STATUS_COUNT];
+    int waiting = 0, helped = 0, rescued = 0;
+    int quiet = 0;
+
+    // Claims do not take survivors_mutex, so only trust a recount no claim overlapped
+    for (int attempt = 0; attempt < SURVIVOR_VERIFY_ATTEMPTS && !quiet; attempt++)
+    {
+        memset(counts, 0, sizeof(counts));
+
+        pthread_mutex_lock(&survivors_mutex);
+        unsigned int started = atomic_load(&survivor_claims_started);
+        if (atomic_load(&survivor_claims_active) == 0)
+        {
+            for (int i = 0; i < survivor_store.count; i++)
+            {
+                counts[survivor_store.status[i]]++;
+            }
+            waiting = atomic_load_explicit(&waiting_count, memory_order_relaxed);
+            helped = atomic_load_explicit(&helped_count, memory_order_relaxed);
+            rescued = atomic_load_explicit(&rescued_count, memory_order_relaxed) - survivors_recycled;
+            quiet = atomic_load(&survivor_claims_active) == 0 && atomic_load(&survivor_claims_started) == started;
+        }
+        pthread_mutex_unlock(&survivors_mutex);
+
+        if (!quiet)
+            sched_yield();
+    }
+
+    if (!quiet)
     {
-        free(survivor_array);
-        survivor_array = NULL;
+        printf("Survivor counters not checked: claims never paused\n");
+        return 0;
     }
-    num_survivors = 0;
+
+    if (waiting != counts[0] || helped != counts[1] || rescued != counts[2] + counts[3])
+    {
+        fprintf(stderr,
+                "Survivor counters out of step: waiting %d (recount %d), helped %d (recount %d), "
+                "rescued %d (recount %d)\n",
+                waiting, counts[0], helped, counts[1], rescued, counts[2] + counts[3]);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Move up to @p limit rescued survivors to new random locations
+ * 
+ * Archived survivors (status 3) are reused first, then rescued ones not
+ * yet counted (status 2). Each one wakes the AI like a new survivor. The
+ * caller holds survivors_mutex.
+ * 
+ * @return Number of survivors recycled
+ */
+static int recycle_survivors(int limit)
+{
+    int recycled = 0;
+    for (int status = 3; status >= 2 && recycled < limit; status--)
+    {
+        int i = survivor_store_next(&survivor_store, status, 0);
+        while (i >= 0 && recycled < limit)
+        {
+            // Reset this survivor to a new location and start a new mission trace;
+            // the times come first, since a claim may stamp them as soon as it waits
+            survivor_store_set_coord(&survivor_store, i, MAKE_COORD(rand() % map.height, rand() % map.width));
+            time_t t;
+            time(&t);
+            localtime_r(&t, &survivor_store.times[i].discovery_time);
+            survivor_store.times[i].spawned_ns = mission_trace_now();
+            survivor_store.times[i].assigned_ns = 0;
+            survivor_store.times[i].sent_ns = 0;
+
+            // Waiting for help again
+            survivor_set_status(i, 0);
+            ai_events_post(&ai_events, AI_EVENT_SURVIVOR_WAITING, survivor_store_coord(&survivor_store, i));
+
+            recycled++;
+            i = survivor_store_next(&survivor_store, status, i + 1);
+        }
+    }
+    return recycled;
 }
 
 /**
@@ -153,28 +434,7 @@ void *survivor_generator(void *args)
     for (int i = 0; i < 10; i++)
     {
         pthread_mutex_lock(&survivors_mutex);
-
-        if (num_survivors < MAX_SURVIVORS)
-        {
-            // Generate random coordinates
-            int x = rand() % map.height;
-            int y = rand() % map.width;
-
-            // Initialize new survivor
-            survivor_array[num_survivors].coord.x = x;
-            survivor_array[num_survivors].coord.y = y;
-            sprintf(survivor_array[num_survivors].info, "SURV-%d", num_survivors);
-            survivor_array[num_survivors].status = 0; // Waiting for help
-
-            // Set time
-            time_t t;
-            time(&t);
-            localtime_r(&t, &survivor_array[num_survivors].discovery_time);
-
-            // Move to next array slot
-            num_survivors++;
-        }
-
+        add_survivor(MAKE_COORD(rand() % map.height, rand() % map.width));
         pthread_mutex_unlock(&survivors_mutex);
 
         // Very small delay between initial survivors
@@ -188,59 +448,16 @@ void *survivor_generator(void *args)
         int delay_ms = (rand() % 1000) + 500;
         usleep(delay_ms * 1000);
 
-        // Lock the mutex before checking/modifying the array
+        // Lock the mutex before checking/modifying the store
         pthread_mutex_lock(&survivors_mutex);
 
-        // Only generate a new survivor if there's space in the array
-        if (num_survivors < MAX_SURVIVORS)
-        {
-            // Generate random coordinates
-            int x = rand() % map.height;
-            int y = rand() % map.width;
-
-            // Initialize new survivor
-            survivor_array[num_survivors].coord.x = x;
-            survivor_array[num_survivors].coord.y = y;
-            sprintf(survivor_array[num_survivors].info, "SURV-%d", num_survivors);
-            survivor_array[num_survivors].status = 0; // Waiting for help
-
-            // Set time
-            time_t t;
-            time(&t);
-            localtime_r(&t, &survivor_array[num_survivors].discovery_time);
-
-            // Move to next array slot
-            num_survivors++;
-        }
-        else
+        // If the store is full, recycle some rescued survivors to make space
+        if (add_survivor(MAKE_COORD(rand() % map.height, rand() % map.width)) < 0)
         {
-            //printf("Survivor array is full, recycling survivors...\n");
-            // If the array is full, recycle some rescued survivors to make space
-            int recycled = 0;
-            for (int i = 0; i < num_survivors && recycled < 5; i++)
-            {
-                if (survivor_array[i].status >= 2)
-                { // If rescued
-                    // Generate new coordinates
-                    int x = rand() % map.height;
-                    int y = rand() % map.width;
-
-                    // Reset this survivor to a new location
-                    survivor_array[i].coord.x = x;
-                    survivor_array[i].coord.y = y;
-                    survivor_array[i].status = 0; // Waiting for help again
-
-                    // Update time
-                    time_t t;
-                    time(&t);
-                    localtime_r(&t, &survivor_array[i].discovery_time);
-
-                    recycled++;
-                }
-            }
+            recycle_survivors(5);
         }
 
-        // Unlock after modifying the array
+        // Unlock after modifying the store
         pthread_mutex_unlock(&survivors_mutex);
     }
 
@@ -256,24 +473,9 @@ void *survivor_generator(void *args)
 void survivor_cleanup(Survivor *s)
 // clang-format on
 {
-    // Make sure coordinates are within bounds to avoid segfault
-    if (s->coord.x >= 0 && s->coord.x < map.height && s->coord.y >= 0 && s->coord.y < map.width)
-    {
-
-        // Remove from map cell
-        pthread_mutex_lock(&map.cells[s->coord.x][s->coord.y].survivors->lock);
-        map.cells[s->coord.x][s->coord.y].survivors->removedata(map.cells[s->coord.x][s->coord.y].survivors, s);
-        pthread_mutex_unlock(&map.cells[s->coord.x][s->coord.y].survivors->lock);
-    }
-
-    // Remove from global lists
-    pthread_mutex_lock(&survivors->lock);
-    survivors->removedata(survivors, s);
-    pthread_mutex_unlock(&survivors->lock);
-
-    pthread_mutex_lock(&helpedsurvivors->lock);
-    helpedsurvivors->removedata(helpedsurvivors, s);
-    pthread_mutex_unlock(&helpedsurvivors->lock);
+    // Remove from global lists; removekey() locks each list itself
+    survivors->removekey(survivors, s->info);
+    helpedsurvivors->removekey(helpedsurvivors, s->info);
 
     free(s);
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+/**
+ * @file survivor_store.c
+ * @brief Structure-of-arrays storage for every survivor in the simulation
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the store declared in survivor_store.h. Status
+ * changes flip one bit in the old and new status bitsets and adjust both
+ * counters, so the counters always equal the bitsets' popcounts. The
+ * bitset words are shared by 64 survivors, so they are updated with
+ * atomic read-modify-writes even under survivors_mutex: a lock-free claim
+ * may be flipping a neighbouring bit.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup simulation
+ */
+
+#include "headers/survivor_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of 64-bit words covering @p survivors bits
+ */
+static size_t bitset_words(int survivors)
+{
+    return ((size_t)survivors + 63) / 64;
+}
+
+/**
+ * @brief Move a survivor's bit and count from one status to another
+ *
+ * Called by the one thread that just changed the survivor's status byte.
+ */
+static void move_status_bit(SurvivorStore *store, int index, int from, int to)
+{
+    uint64_t bit = UINT64_C(1) << (index % 64);
+    atomic_fetch_and_explicit(&store->status_bits[from][index / 64], ~bit, memory_order_relaxed);
+    atomic_fetch_or_explicit(&store->status_bits[to][index / 64], bit, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&store->status_count[from], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&store->status_count[to], 1, memory_order_relaxed);
+}
+
+int survivor_store_init(SurvivorStore *store, int capacity)
+{
+    if (capacity <= 0 || capacity > SURVIVOR_STORE_MAX)
+    {
+        fprintf(stderr, "Error: Invalid survivor store capacity: %d\n", capacity);
+        return -1;
+    }
+
+    // Allocated once, so lock-free claims never see an array move
+    memset(store, 0, sizeof(SurvivorStore));
+    store->x = calloc(capacity, sizeof(int));
+    store->y = calloc(capacity, sizeof(int));
+    store->status = calloc(capacity, sizeof(uint8_t));
+    store->info = calloc(capacity, SURVIVOR_INFO_SIZE);
+    store->times = calloc(capacity, sizeof(SurvivorTimes));
+    int allocated = store->x && store->y && store->status && store->info && store->times;
+    for (int s = 0; s < SURVIVOR_STATUS_COUNT; s++)
+    {
+        store->status_bits[s] = calloc(bitset_words(capacity), sizeof(uint64_t));
+        allocated = allocated && store->status_bits[s];
+    }
+    if (!allocated)
+    {
+        perror("Failed to allocate survivor store");
+        survivor_store_destroy(store);
+        return -1;
+    }
+
+    store->capacity = capacity;
+    return 0;
+}
+
+void survivor_store_destroy(SurvivorStore *store)
+{
+    free(store->x);
+    free(store->y);
+    free(store->status);
+    free(store->info);
+    free(store->times);
+    for (int s = 0; s < SURVIVOR_STATUS_COUNT; s++)
+    {
+        free(store->status_bits[s]);
+    }
+    memset(store, 0, sizeof(SurvivorStore));
+}
+
+void survivor_store_clear(SurvivorStore *store)
+{
+    for (int s = 0; s < SURVIVOR_STATUS_COUNT; s++)
+    {
+        memset((void *)store->status_bits[s], 0, bitset_words(store->count) * sizeof(uint64_t));
+        store->status_count[s] = 0;
+    }
+    store->count = 0;
+}
+
+int survivor_store_add(SurvivorStore *store, Coord coord, int status)
+{
+    int index = store->count;
+    if (index == store->capacity)
+        return -1;
+
+    store->x[index] = coord.x;
+    store->y[index] = coord.y;
+    memset(store->info[index], 0, SURVIVOR_INFO_SIZE);
+    memset(&store->times[index], 0, sizeof(SurvivorTimes));
+
+    // A cleared store leaves stale bytes behind, so set the bit directly
+    store->status[index] = (uint8_t)status;
+    atomic_fetch_or_explicit(&store->status_bits[status][index / 64], UINT64_C(1) << (index % 64),
+                             memory_order_relaxed);
+    atomic_fetch_add_explicit(&store->status_count[status], 1, memory_order_relaxed);
+
+    // Publish the survivor only once it is complete
+    store->count = index + 1;
+    return index;
+}
+
+int survivor_store_set_status(SurvivorStore *store, int index, int status)
+{
+    int old = atomic_exchange(&store->status[index], (uint8_t)status);
+    if (old != status)
+        move_status_bit(store, index, old, status);
+    return old;
+}
+
+int survivor_store_claim(SurvivorStore *store, int index, int from, int to)
+{
+    uint8_t expected = (uint8_t)from;
+    if (from == to || !atomic_compare_exchange_strong(&store->status[index], &expected, (uint8_t)to))
+        return 0;
+
+    move_status_bit(store, index, from, to);
+    return 1;
+}
+
+void survivor_store_set_coord(SurvivorStore *store, int index, Coord coord)
+{
+    store->x[index] = coord.x;
+    store->y[index] = coord.y;
+}
+
+Coord survivor_store_coord(const SurvivorStore *store, int index)
+{
+    return MAKE_COORD(store->x[index], store->y[index]);
+}
+
+int survivor_store_next(const SurvivorStore *store, int status, int from)
+{
+    if (from < 0)
+        from = 0;
+    int count = store->count;
+    if (from >= count)
+        return -1;
+
+    // clang-format off
+    _Atomic uint64_t *bits = store->status_bits[status];
+    // clang-format on
+    size_t words = bitset_words(count);
+    size_t word = from / 64;
+
+    // Drop the bits below from in its word, then skip empty words
+    uint64_t pending = atomic_load_explicit(&bits[word], memory_order_relaxed) & (~UINT64_C(0) << (from % 64));
+    while (pending == 0)
+    {
+        if (++word == words)
+            return -1;
+        pending = atomic_load_explicit(&bits[word], memory_order_relaxed);
+    }
+
+    // A survivor being added has its bit set just before count is raised
+    int index = (int)(word * 64 + __builtin_ctzll(pending));
+    return index < count ? index : -1;
+}
@@ -0,0 +1,269 @@
+/**
+ * @file ai_events_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the AI wake-up event queue
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Checks that events reach the AI thread in order and promptly, that a
+ * full queue degrades to a full pass instead of losing work silently, and
+ * that no event is ever left in the queue without a pending wake-up.
+ *
+ * **Test Coverage:**
+ * - Posting before ai_events_init() or after ai_events_destroy() is ignored
+ * - Events are taken oldest first, several per wake-up
+ * - Overflow is reported once and cleared by the take
+ * - A blocked consumer wakes within milliseconds of a post and can be
+ *   cancelled while it waits
+ * - Concurrent producers never strand events without a wake-up
+ *
+ * **Usage:**
+ * Run with `make test_ai_events`. The program exits non-zero if any
+ * check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#define _DEFAULT_SOURCE // usleep
+#include "../headers/ai_events.h"
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @defgroup ai_events_testing AI Event Testing
+ * @brief Test program for the AI wake-up event queue
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Producer threads in the concurrency test */
+#define PRODUCERS 4
+
+/** @brief Events posted by each producer in the concurrency test */
+#define EVENTS_PER_PRODUCER 50000
+
+/** @brief Events a producer posts back to back before pausing */
+#define PRODUCER_BURST 32
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/** @brief Queue shared by the test threads */
+static AiEventQueue queue = { .lock = PTHREAD_MUTEX_INITIALIZER, .fd = -1 };
+
+/** @brief Events received by the consumers */
+static AiEvent taken[AI_EVENT_CAPACITY];
+
+/** @brief Producers that have posted their last event */
+static atomic_int producers_done = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief Milliseconds on the monotonic clock
+ */
+static double now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief Whether a wake-up is pending on the queue's eventfd
+ */
+static int wake_pending(void)
+{
+    struct pollfd pfd = { .fd = queue.fd, .events = POLLIN };
+    return poll(&pfd, 1, 0) == 1;
+}
+
+/**
+ * @brief Consumer that takes one batch and reports when it got it
+ *
+ * @param arg Receives the time the batch was taken, in milliseconds
+ */
+static void *take_once(void *arg)
+{
+    // clang-format off
+    double *woke_at = (double *)arg;
+    // clang-format on
+    int overflowed;
+    int count = ai_events_take(&queue, taken, &overflowed);
+    *woke_at = count == 1 ? now_ms() : -1;
+    return NULL;
+}
+
+/**
+ * @brief Consumer that waits forever, to be cancelled
+ */
+static void *take_forever(void *arg)
+{
+    (void)arg;
+    int overflowed;
+    while (1)
+    {
+        ai_events_take(&queue, taken, &overflowed);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Producer of the concurrency test
+ *
+ * Posts in short bursts, like drone threads do, so that the consumer
+ * takes many batches while producers are still posting.
+ */
+static void *producer(void *arg)
+{
+    int id = (int)(long)arg;
+    for (int n = 0; n < EVENTS_PER_PRODUCER; n++)
+    {
+        ai_events_post(&queue, AI_EVENT_DRONE_IDLE, MAKE_COORD(id, n));
+        if (n % PRODUCER_BURST == PRODUCER_BURST - 1)
+            usleep(1);
+    }
+    atomic_fetch_add(&producers_done, 1);
+    return NULL;
+}
+
+/**
+ * @brief Run all event queue checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    int overflowed;
+
+    printf("=== PHASE 1: Posting and taking ===\n");
+    ai_events_post(&queue, AI_EVENT_SURVIVOR_WAITING, MAKE_COORD(1, 1));
+    check(queue.count == 0, "posting before ai_events_init() is ignored");
+
+    if (ai_events_init(&queue) != 0)
+    {
+        perror("ai_events_init");
+        return 1;
+    }
+    check(!wake_pending(), "a new queue has no wake-up pending");
+
+    ai_events_post(&queue, AI_EVENT_SURVIVOR_WAITING, MAKE_COORD(1, 2));
+    ai_events_post(&queue, AI_EVENT_DRONE_IDLE, MAKE_COORD(3, 4));
+    ai_events_post(&queue, AI_EVENT_SURVIVOR_WAITING, MAKE_COORD(5, 6));
+    check(wake_pending(), "posting wakes the consumer");
+
+    int count = ai_events_take(&queue, taken, &overflowed);
+    check(count == 3 && !overflowed, "one take returns every pending event");
+    check(taken[0].type == AI_EVENT_SURVIVOR_WAITING && taken[0].coord.x == 1 && taken[0].coord.y == 2 &&
+              taken[1].type == AI_EVENT_DRONE_IDLE && taken[1].coord.x == 3 && taken[2].coord.y == 6,
+          "events are taken oldest first with their type and cell");
+    check(!wake_pending(), "three posts leave no second wake-up behind");
+
+    printf("\n=== PHASE 2: Overflow ===\n");
+    for (int i = 0; i < AI_EVENT_CAPACITY + 5; i++)
+    {
+        ai_events_post(&queue, AI_EVENT_DRONE_IDLE, MAKE_COORD(i, 0));
+    }
+    count = ai_events_take(&queue, taken, &overflowed);
+    check(count == AI_EVENT_CAPACITY && overflowed, "a full queue keeps the oldest events and reports the overflow");
+    check(taken[AI_EVENT_CAPACITY - 1].coord.x == AI_EVENT_CAPACITY - 1, "the kept events are the first ones posted");
+
+    ai_events_post(&queue, AI_EVENT_DRONE_IDLE, MAKE_COORD(0, 0));
+    count = ai_events_take(&queue, taken, &overflowed);
+    check(count == 1 && !overflowed, "the overflow is cleared by the take that reports it");
+
+    printf("\n=== PHASE 3: Blocking consumer ===\n");
+    pthread_t thread;
+    double woke_at = 0;
+    pthread_create(&thread, NULL, take_once, &woke_at);
+    usleep(50000);
+    double posted_at = now_ms();
+    ai_events_post(&queue, AI_EVENT_SURVIVOR_WAITING, MAKE_COORD(7, 7));
+    pthread_join(thread, NULL);
+    printf("  consumer woke %.3f ms after the post\n", woke_at - posted_at);
+    check(woke_at >= posted_at && woke_at - posted_at < 100.0, "a blocked consumer wakes right after a post");
+
+    pthread_create(&thread, NULL, take_forever, NULL);
+    usleep(20000);
+    pthread_cancel(thread);
+    check(pthread_join(thread, NULL) == 0, "a consumer waiting for events can be cancelled");
+
+    printf("\n=== PHASE 4: Concurrent producers ===\n");
+    pthread_t producer_threads[PRODUCERS];
+    for (long p = 0; p < PRODUCERS; p++)
+    {
+        pthread_create(&producer_threads[p], NULL, producer, (void *)p);
+    }
+
+    long events = 0;
+    int wakes = 0;
+    int overflows = 0;
+    int stranded = 0;
+    while (1)
+    {
+        int finished = atomic_load(&producers_done) == PRODUCERS;
+        if (!wake_pending())
+        {
+            // Without a wake-up pending, nothing may be waiting in the queue
+            pthread_mutex_lock(&queue.lock);
+            stranded |= (queue.count > 0 || queue.overflowed) && !wake_pending();
+            pthread_mutex_unlock(&queue.lock);
+            if (finished)
+                break;
+            continue;
+        }
+        count = ai_events_take(&queue, taken, &overflowed);
+        events += count;
+        overflows += overflowed;
+        wakes++;
+    }
+    for (int p = 0; p < PRODUCERS; p++)
+    {
+        pthread_join(producer_threads[p], NULL);
+    }
+
+    printf("  %ld events in %d wake-ups, %d overflow(s)\n", events, wakes, overflows);
+    check(!stranded, "events are never left in the queue without a wake-up");
+    check(events == (long)PRODUCERS * EVENTS_PER_PRODUCER || overflows > 0,
+          "every event is taken unless an overflow was reported");
+    check(wakes < PRODUCERS * EVENTS_PER_PRODUCER, "wake-ups are shared by several events");
+
+    printf("\n=== PHASE 5: Destroy ===\n");
+    ai_events_destroy(&queue);
+    ai_events_post(&queue, AI_EVENT_DRONE_IDLE, MAKE_COORD(0, 0));
+    check(queue.fd == -1 && queue.count == 0, "posting after ai_events_destroy() is ignored");
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All AI event checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of ai_events_testing group
@@ -0,0 +1,366 @@
+/**
+ * @file ai_scaling_benchmark.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Thread scaling of the partitioned AI assignment cycle
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Builds a large fleet of local drones and a field of waiting survivors,
+ * then times run_partitioned_assignment_cycle() with 1, 4, 16 and 64
+ * worker threads against the single-threaded run_drone_centric_cycle().
+ * For each thread count it prints the cycle time, the time of each phase
+ * (serial snapshot, parallel regions, serial reconciliation), how many
+ * claims were lost across region borders and how many drones the
+ * reconciliation pass placed, and the total travel distance compared
+ * with the drone-centric cycle.
+ *
+ * Wall-clock speedup cannot exceed the number of CPUs the benchmark runs
+ * on, so the phase times of the 1-thread run are also turned into an
+ * Amdahl projection: serial + parallel / threads. Claims take no global
+ * mutex, but they still serialize on the waiting_survivor_index and
+ * idle_drone_index locks and on stdout inside the parallel phase, so the
+ * projection is an upper bound.
+ *
+ * Every run must assign as many missions as the drone-centric cycle, no
+ * survivor may be claimed by two drones, and the statistics counters must
+ * match a full recount at the end.
+ *
+ * **Usage:**
+ * `make bench_ai_scaling` or
+ * `./tests/ai_scaling_benchmark [drones] [survivors] [map size] [cycles]`
+ * (defaults: 20000 drones, 40000 survivors, a 400x400 map, 3 cycles).
+ * Mission log lines printed by claim_mission() are discarded while a
+ * cycle is timed.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ * @ingroup performance_testing
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "../headers/ai.h"
+#include "../headers/ai_partition.h"
+#include "../headers/drone.h"
+#include "../headers/globals.h"
+#include "../headers/list.h"
+#include "../headers/map.h"
+#include "../headers/spatial_index.h"
+#include "../headers/survivor.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @defgroup ai_scaling_benchmark AI Scaling Benchmark
+ * @brief Thread scaling of the partitioned assignment cycle
+ * @ingroup performance_testing
+ * @{
+ */
+
+/** @brief Default fleet size */
+#define DEFAULT_DRONES 20000
+
+/** @brief Default number of waiting survivors */
+#define DEFAULT_SURVIVORS 40000
+
+/** @brief Default map rows and columns */
+#define DEFAULT_MAP_SIZE 400
+
+/** @brief Default number of timed cycles per thread count */
+#define DEFAULT_CYCLES 3
+
+// Globals normally defined by controller.c
+// clang-format off
+List *survivors = NULL;
+List *helpedsurvivors = NULL;
+List *drones = NULL;
+// clang-format on
+
+/** @brief Thread counts to time */
+static const int thread_counts[] = { 1, 4, 16, 64 };
+
+/** @brief Number of entries in thread_counts */
+#define THREAD_COUNTS (int)(sizeof(thread_counts) / sizeof(thread_counts[0]))
+
+/** @brief Starting position of every benchmark drone, indexed by drone id */
+static Coord *drone_home = NULL;
+
+/**
+ * @brief Timing and outcome of one strategy
+ */
+typedef struct scaling_result {
+    double ms;              /**< Best cycle time */
+    int missions;           /**< Missions assigned by the best cycle */
+    long distance;          /**< Total mission distance of the best cycle */
+    int double_claims;      /**< Drones on a mission beyond the survivors being helped */
+    AiPartitionStats stats; /**< Phase breakdown of the best cycle (partitioned only) */
+} ScalingResult;
+
+/**
+ * @brief Put every drone back home and idle, and every survivor waiting
+ */
+static void reset_world(void)
+{
+    // clang-format off
+    for (Node *current = drones->head; current != NULL; current = current->next)
+    {
+        Drone *d = (Drone *)current->data;
+        // clang-format on
+        pthread_mutex_lock(&d->lock);
+        d->coord = drone_home[d->id];
+        d->target = d->coord;
+        drone_set_status(d, IDLE);
+        pthread_mutex_unlock(&d->lock);
+    }
+
+    pthread_mutex_lock(&survivors_mutex);
+    for (int i = 0; i < survivor_store.count; i++)
+    {
+        survivor_set_status(i, 0);
+    }
+    pthread_mutex_unlock(&survivors_mutex);
+}
+
+/**
+ * @brief Sum of distances from every drone to its mission target
+ *
+ * @param on_mission Receives the number of drones on a mission
+ */
+static long total_mission_distance(int *on_mission)
+{
+    long total = 0;
+    *on_mission = 0;
+    // clang-format off
+    for (Node *current = drones->head; current != NULL; current = current->next)
+    {
+        Drone *d = (Drone *)current->data;
+        // clang-format on
+        if (d->status == ON_MISSION)
+        {
+            total += calculate_distance(d->coord, d->target);
+            (*on_mission)++;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Send stdout to /dev/null, keeping claim_mission() logs out of a timing
+ *
+ * @return Saved stdout descriptor for restore_stdout()
+ */
+static int silence_stdout(void)
+{
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+    close(devnull);
+    return saved_stdout;
+}
+
+/**
+ * @brief Undo silence_stdout()
+ */
+static void restore_stdout(int saved_stdout)
+{
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+}
+
+/**
+ * @brief Time a cycle several times from the same starting state
+ *
+ * @param cycle Assignment pass to time
+ * @param cycles Number of timed cycles
+ * @return Best cycle, with the phase breakdown of that cycle
+ */
+static ScalingResult time_cycle(int (*cycle)(void), int cycles)
+{
+    ScalingResult best = { 0 };
+
+    for (int c = 0; c < cycles; c++)
+    {
+        reset_world();
+        int saved_stdout = silence_stdout();
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int missions = cycle();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        restore_stdout(saved_stdout);
+
+        double ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+        if (c == 0 || ms < best.ms)
+        {
+            int on_mission;
+            best.ms = ms;
+            best.missions = missions;
+            best.distance = total_mission_distance(&on_mission);
+            best.double_claims = on_mission - survivor_store.status_count[1];
+            best.stats = ai_partition_stats;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Check that a run assigned the expected missions, each survivor once
+ *
+ * @return 0 if it did, 1 otherwise
+ */
+static int verify_run(const char *name, const ScalingResult *result, int expected)
+{
+    if (result->missions != expected)
+    {
+        fprintf(stderr, "✗ %s assigned %d missions, expected %d\n", name, result->missions, expected);
+        return 1;
+    }
+    if (result->double_claims != 0)
+    {
+        fprintf(stderr, "✗ %s sent %d drones to survivors already being helped\n", name, result->double_claims);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Build the fleet and survivors and time every thread count
+ *
+ * @param argc Argument count
+ * @param argv Optional drone count, survivor count, map size and cycle count
+ * @return 0 on success, 1 on setup failure or if a run assigned the wrong missions
+ */
+int main(int argc, char *argv[])
+{
+    int drone_count = argc > 1 ? atoi(argv[1]) : DEFAULT_DRONES;
+    int survivor_count = argc > 2 ? atoi(argv[2]) : DEFAULT_SURVIVORS;
+    int map_size = argc > 3 ? atoi(argv[3]) : DEFAULT_MAP_SIZE;
+    int cycles = argc > 4 ? atoi(argv[4]) : DEFAULT_CYCLES;
+    if (drone_count <= 0 || survivor_count <= 0 || map_size <= 0 || cycles <= 0)
+    {
+        fprintf(stderr, "Usage: %s [drones] [survivors] [map size] [cycles]\n", argv[0]);
+        return 1;
+    }
+
+    srand(42);
+    int saved_stdout = silence_stdout();
+    init_map(map_size, map_size);
+    initialize_survivors();
+    restore_stdout(saved_stdout);
+
+    drones = create_list(sizeof(Drone), drone_count, LIST_BACKEND_LINKED);
+    drone_home = calloc(drone_count, sizeof(Coord));
+    if (survivor_count > SURVIVOR_STORE_MAX || !drones || !drone_home ||
+        spatial_index_init(&idle_drone_index, map.height, map.width, 1, drone_count) != 0)
+    {
+        fprintf(stderr, "Benchmark setup failed\n");
+        return 1;
+    }
+
+    for (int i = 0; i < survivor_count; i++)
+    {
+        if (add_survivor(MAKE_COORD(rand() % map.height, rand() % map.width)) < 0)
+        {
+            fprintf(stderr, "Benchmark setup failed\n");
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < drone_count; i++)
+    {
+        Drone drone;
+        memset(&drone, 0, sizeof(Drone));
+        drone.id = i;
+        drone.socket = -1; // Local drone: claim_mission() sends nothing
+        drone.status = DISCONNECTED; // reset_world() makes it IDLE and counts it
+        drone_home[i] = MAKE_COORD(rand() % map.height, rand() % map.width);
+        pthread_mutex_init(&drone.lock, NULL);
+        if (!drones->add(drones, &drone))
+        {
+            fprintf(stderr, "Failed to add drone %d\n", i);
+            return 1;
+        }
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("=== AI Scaling Benchmark ===\n");
+    printf("%d drones, %d waiting survivors, %dx%d map, best of %d cycles, %ld CPU(s) online\n\n", drone_count,
+           survivor_count, map.height, map.width, cycles, cpus);
+
+    int expected = drone_count < survivor_count ? drone_count : survivor_count;
+    int status = 0;
+
+    ScalingResult baseline = time_cycle(run_drone_centric_cycle, cycles);
+    printf("  %-16s %10.2f ms/cycle  %6d missions  total distance %ld\n", "drone-centric", baseline.ms,
+           baseline.missions, baseline.distance);
+    status |= verify_run("drone-centric", &baseline, expected);
+
+    printf("\n  %7s %7s %10s %8s %10s %10s %10s %9s %10s %9s\n", "threads", "regions", "ms/cycle", "speedup",
+           "snapshot", "regions", "reconcile", "conflicts", "reconciled", "distance");
+    ScalingResult results[THREAD_COUNTS];
+    for (int t = 0; t < THREAD_COUNTS; t++)
+    {
+        ai_partition_workers = thread_counts[t];
+        results[t] = time_cycle(run_partitioned_assignment_cycle, cycles);
+
+        char name[32];
+        snprintf(name, sizeof(name), "%d thread(s)", thread_counts[t]);
+        status |= verify_run(name, &results[t], expected);
+
+        const AiPartitionStats *stats = &results[t].stats;
+        printf("  %7d %7d %10.2f %7.2fx %10.2f %10.2f %10.2f %9d %10d %+8.1f%%\n", stats->workers, stats->regions,
+               results[t].ms, results[0].ms / results[t].ms, stats->snapshot_ms, stats->regions_ms, stats->reconcile_ms,
+               stats->conflicts, stats->reconciled,
+               baseline.distance > 0 ? (results[t].distance - baseline.distance) * 100.0 / baseline.distance : 0.0);
+    }
+    ai_partition_shutdown();
+
+    // Amdahl's law from the 1-thread phases; the claims make it an upper bound
+    double serial_ms = results[0].stats.snapshot_ms + results[0].stats.reconcile_ms;
+    double parallel_ms = results[0].stats.regions_ms;
+    printf("\n  Projection with one CPU per thread (serial %.2f ms + parallel %.2f ms / threads):\n", serial_ms,
+           parallel_ms);
+    for (int t = 0; t < THREAD_COUNTS; t++)
+    {
+        double projected_ms = serial_ms + parallel_ms / thread_counts[t];
+        printf("  %7d %10.2f ms/cycle %7.2fx\n", thread_counts[t], projected_ms,
+               (serial_ms + parallel_ms) / projected_ms);
+    }
+    printf("  Serial fraction %.1f%%, speedup bound %.1fx\n", serial_ms * 100.0 / (serial_ms + parallel_ms),
+           serial_ms > 0 ? (serial_ms + parallel_ms) / serial_ms : 0.0);
+
+    if (status == 0)
+        printf("\n✓ Every run assigned %d missions, each survivor at most once\n", expected);
+
+    printf("\nStatistics counters:\n");
+    if (survivor_stats_verify() == 0 && drone_stats_verify() == 0)
+    {
+        printf("✓ Counters match a full recount after every run\n");
+    }
+    else
+    {
+        status = 1;
+    }
+
+    // clang-format off
+    for (Node *current = drones->head; current != NULL; current = current->next)
+    {
+        pthread_mutex_destroy(&((Drone *)current->data)->lock);
+    }
+    // clang-format on
+    drones->destroy(drones);
+    spatial_index_destroy(&idle_drone_index);
+    cleanup_survivors();
+    freemap();
+    free(drone_home);
+    return status;
+}
+
+/** @} */ // end of ai_scaling_benchmark group
@@ -0,0 +1,513 @@
+/**
+ * @file assign_mission_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of lock-free survivor claims in mission assignment
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Checks that assign_mission() claims survivors by compare-and-swap and
+ * that assignment passes send missions with no lock held, drones->lock
+ * included, so a drone whose socket is full stalls only the AI thread.
+ *
+ * **Test Coverage:**
+ * - While run_drone_centric_cycle() is blocked sending to a full socket,
+ *   drones->lock, survivors_mutex and the drone's lock are free and
+ *   survivors can be added; the failed mission is not counted
+ * - A send that fails releases the survivor (waiting and indexed again)
+ *   and puts the drone back to idle
+ * - A send that succeeds delivers the ASSIGN_MISSION message
+ * - try_unregister_drone() leaves a drone being sent a mission listed
+ *   without waiting; unregister_drone() fails the send at once and waits
+ *   for it before freeing the drone
+ * - drone_send_all() finishes messages larger than a non-blocking socket's
+ *   buffer, and shuts the connection down when one cannot be finished
+ *   within DRONE_SEND_TIMEOUT_MS
+ * - Threads claiming the same survivors concurrently: each survivor goes
+ *   to exactly one drone and the statistics match a recount
+ *
+ * **Usage:**
+ * Run with `make test_assign_mission`. The program exits non-zero if any
+ * check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#define _DEFAULT_SOURCE // usleep
+#include "../headers/ai.h"
+#include "../headers/drone.h"
+#include "../headers/globals.h"
+#include "../headers/list.h"
+#include "../headers/map.h"
+#include "../headers/spatial_index.h"
+#include "../headers/survivor.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @defgroup assign_mission_testing Mission Assignment Testing
+ * @brief Test program for lock-free survivor claims
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Threads claiming survivors at the same time */
+#define CLAIM_THREADS 4
+
+/** @brief Local drones owned by each claiming thread */
+#define DRONES_PER_THREAD 100
+
+/** @brief Survivors the claiming threads race for, one per drone */
+#define CLAIM_SURVIVORS (CLAIM_THREADS * DRONES_PER_THREAD)
+
+/** @brief Size of the message sent in pieces, far larger than a socket buffer */
+#define LARGE_MESSAGE_SIZE (4 << 20)
+
+// Globals normally defined by controller.c
+// clang-format off
+List *survivors = NULL;
+List *helpedsurvivors = NULL;
+List *drones = NULL;
+// clang-format on
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief Milliseconds elapsed since a monotonic timestamp
+ */
+static double ms_since(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * @brief Add an idle drone to the drones list
+ *
+ * @param id Drone id
+ * @param coord Position of the drone
+ * @param socket Socket of a networked drone, or -1 for a local one
+ * @return The drone as stored in the list
+ */
+// clang-format off
+static Drone *add_idle_drone(int id, Coord coord, int socket)
+// clang-format on
+{
+    Drone drone;
+    memset(&drone, 0, sizeof(Drone));
+    drone.id = id;
+    drone.socket = socket;
+    drone.encoding = WIRE_ENCODING_JSON;
+    drone.coord = coord;
+    drone.target = coord;
+    drone.status = DISCONNECTED; // drone_set_status() counts it as idle
+    pthread_mutex_init(&drone.lock, NULL);
+    pthread_cond_init(&drone.unpinned, NULL);
+
+    // clang-format off
+    Drone *d = (Drone *)drones->add(drones, &drone)->data;
+    // clang-format on
+    pthread_mutex_lock(&d->lock);
+    drone_set_status(d, IDLE);
+    pthread_mutex_unlock(&d->lock);
+    return d;
+}
+
+/**
+ * @brief Fill a socket's send buffer so the next send() blocks
+ *
+ * @param sock Connected socket to fill
+ */
+static void fill_socket(int sock)
+{
+    char chunk[4096];
+    memset(chunk, 'x', sizeof(chunk));
+
+    int flags = fcntl(sock, F_GETFL);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+    while (send(sock, chunk, sizeof(chunk), 0) > 0)
+        ;
+    // Single bytes too, so no room is left for even a partial send
+    while (send(sock, chunk, 1, 0) > 0)
+        ;
+    fcntl(sock, F_SETFL, flags);
+}
+
+/**
+ * @brief Discard everything waiting on a socket
+ *
+ * @param sock Socket to read from
+ */
+static void drain_socket(int sock)
+{
+    char chunk[4096];
+    while (recv(sock, chunk, sizeof(chunk), MSG_DONTWAIT) > 0)
+        ;
+}
+
+/** @brief Set by cycle_in_background() once its assignment pass has returned */
+static atomic_int assignment_done = 0;
+
+/** @brief Missions counted by the last cycle_in_background() pass */
+static atomic_int cycle_missions = -1;
+
+/**
+ * @brief Run one drone-centric assignment pass from another thread
+ *
+ * @param arg Unused
+ * @return NULL
+ */
+static void *cycle_in_background(void *arg)
+{
+    (void)arg;
+    atomic_store(&cycle_missions, run_drone_centric_cycle());
+    atomic_store(&assignment_done, 1);
+    return NULL;
+}
+
+/**
+ * @brief List node holding a drone
+ *
+ * @param drone Drone added with add_idle_drone()
+ * @return Its node in the drones list, or NULL
+ */
+// clang-format off
+static Node *find_drone_node(const Drone *drone)
+{
+    for (Node *current = drones->head; current != NULL; current = current->next)
+    {
+        // clang-format on
+        if ((const Drone *)current->data == drone)
+            return current;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Arguments of a reading thread
+ */
+typedef struct reader_args {
+    int sock;        /**< Socket to read from until end of stream */
+    size_t received; /**< Bytes read */
+    int intact;      /**< Non-zero if every byte matched the pattern sent */
+} ReaderArgs;
+
+/**
+ * @brief Read a socket slowly until the peer shuts it down
+ *
+ * @param arg ReaderArgs of this thread
+ * @return NULL
+ */
+static void *read_slowly(void *arg)
+{
+    // clang-format off
+    ReaderArgs *args = arg;
+    // clang-format on
+    char chunk[65536];
+    ssize_t length;
+    args->intact = 1;
+    while ((length = recv(args->sock, chunk, sizeof(chunk), 0)) > 0)
+    {
+        for (ssize_t i = 0; i < length; i++)
+            args->intact &= chunk[i] == (char)((args->received + i) % 251);
+        args->received += (size_t)length;
+        usleep(100);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Arguments of a claiming thread
+ */
+typedef struct claim_args {
+    // clang-format off
+    Drone **drones;  /**< DRONES_PER_THREAD drones owned by this thread */
+    // clang-format on
+    int base;        /**< Index of the first survivor raced for */
+    int first;       /**< Offset the thread starts at, so threads collide everywhere */
+    int claimed;     /**< Survivors this thread claimed */
+} ClaimArgs;
+
+/**
+ * @brief Offer every survivor to this thread's next idle drone
+ *
+ * @param arg ClaimArgs of this thread
+ * @return NULL
+ */
+static void *claim_all(void *arg)
+{
+    // clang-format off
+    ClaimArgs *args = arg;
+    // clang-format on
+    for (int n = 0; n < CLAIM_SURVIVORS && args->claimed < DRONES_PER_THREAD; n++)
+    {
+        int i = args->base + (args->first + n) % CLAIM_SURVIVORS;
+        if (claim_mission(args->drones[args->claimed], i) == 1)
+            args->claimed++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run all assignment checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    init_map(30, 40);
+    initialize_survivors();
+    drones = create_list(sizeof(Drone), CLAIM_SURVIVORS + 1, LIST_BACKEND_LINKED);
+    if (!drones || spatial_index_init(&idle_drone_index, map.height, map.width, 1, CLAIM_SURVIVORS + 1) != 0)
+    {
+        fprintf(stderr, "Test setup failed\n");
+        return 1;
+    }
+
+    printf("=== PHASE 1: Send outside locks ===\n");
+    int pair[2];
+    check(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0, "socket pair is created");
+    fill_socket(pair[0]);
+
+    pthread_mutex_lock(&survivors_mutex);
+    int target = add_survivor(MAKE_COORD(5, 5));
+    pthread_mutex_unlock(&survivors_mutex);
+    // clang-format off
+    Drone *networked = add_idle_drone(0, MAKE_COORD(0, 0), pair[0]);
+    // clang-format on
+
+    pthread_t assigner;
+    pthread_create(&assigner, NULL, cycle_in_background, NULL);
+
+    // Wait for the claim, then give the assigner time to block in send()
+    while (survivor_store.status[target] != 1 && !atomic_load(&assignment_done))
+        usleep(1000);
+    usleep(DRONE_SEND_TIMEOUT_MS * 1000 / 4);
+    check(!atomic_load(&assignment_done), "send to the full socket blocks the assignment pass");
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int list_free = pthread_mutex_trylock(&drones->lock) == 0;
+    if (list_free)
+        pthread_mutex_unlock(&drones->lock);
+    int survivors_free = pthread_mutex_trylock(&survivors_mutex) == 0;
+    int late_survivor = survivors_free ? add_survivor(MAKE_COORD(20, 30)) : -1;
+    if (survivors_free)
+        pthread_mutex_unlock(&survivors_mutex);
+    int drone_free = pthread_mutex_trylock(&networked->lock) == 0;
+    int drone_on_mission = drone_free && networked->status == ON_MISSION;
+    if (drone_free)
+        pthread_mutex_unlock(&networked->lock);
+    double locked_ms = ms_since(&start);
+    int still_blocked = !atomic_load(&assignment_done);
+
+    check(list_free, "drones->lock is free during the send");
+    check(survivors_free && late_survivor >= 0, "survivors_mutex is free and survivors can be added during the send");
+    check(drone_free && drone_on_mission, "the drone's lock is free and it is already on its mission");
+    printf("  survivor added in %.3f ms while the send was blocked\n", locked_ms);
+    check(still_blocked, "the send was still blocked throughout");
+
+    pthread_join(assigner, NULL);
+    check(atomic_load(&cycle_missions) == 0, "the mission whose send failed is not counted");
+    check(survivor_store.status[target] == 0 && networked->status == IDLE,
+          "failed send puts the survivor back to waiting and the drone to idle");
+    check(find_closest_waiting_survivor(networked) == target,
+          "released survivor is back in waiting_survivor_index");
+    check(spatial_index_count(&waiting_survivor_index) == waiting_count && waiting_count == 2 && helped_count == 0,
+          "statistics match after the rollback");
+
+    printf("\n=== PHASE 2: Successful send ===\n");
+    drain_socket(pair[1]);
+    assign_mission(networked, target);
+    char message[512];
+    ssize_t received = recv(pair[1], message, sizeof(message) - 1, MSG_DONTWAIT);
+    message[received > 0 ? received : 0] = '\0';
+    check(received > 0 && strstr(message, "ASSIGN_MISSION") && strstr(message, "\"M0\""),
+          "ASSIGN_MISSION message is delivered");
+    check(survivor_store.status[target] == 1 && networked->status == ON_MISSION &&
+              networked->target.x == 5 && networked->target.y == 5,
+          "drone is on its mission to the survivor");
+    check(survivor_store.times[target].sent_ns >= survivor_store.times[target].assigned_ns &&
+              survivor_store.times[target].assigned_ns > 0,
+          "assignment and send are stamped in order");
+    close(pair[0]);
+    close(pair[1]);
+
+    printf("\n=== PHASE 3: Disconnect during a send ===\n");
+    // The only idle drone, next to the only waiting survivor
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    fill_socket(pair[0]);
+    // clang-format off
+    Drone *leaving = add_idle_drone(CLAIM_SURVIVORS + 1, MAKE_COORD(20, 29), pair[0]);
+    // clang-format on
+    atomic_store(&assignment_done, 0);
+    pthread_create(&assigner, NULL, cycle_in_background, NULL);
+    while (survivor_store.status[late_survivor] != 1 && !atomic_load(&assignment_done))
+        usleep(1000);
+    usleep(DRONE_SEND_TIMEOUT_MS * 1000 / 4);
+    int blocked = !atomic_load(&assignment_done);
+
+    int listed = drones->number_of_elements;
+    // clang-format off
+    Node *leaving_node = find_drone_node(leaving);
+    // clang-format on
+    int pinned = try_unregister_drone(leaving_node) == 1 && drones->number_of_elements == listed;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unregister_drone(leaving_node);
+    double unregister_ms = ms_since(&start);
+    pthread_join(assigner, NULL);
+
+    check(blocked, "the send to the leaving drone was blocked");
+    check(pinned, "try_unregister_drone() leaves a pinned drone listed");
+    check(unregister_ms < DRONE_SEND_TIMEOUT_MS / 2, "unregistering the drone cuts the send short");
+    printf("  drone unregistered in %.3f ms\n", unregister_ms);
+    check(atomic_load(&cycle_missions) == 0 && survivor_store.status[late_survivor] == 0,
+          "the interrupted mission is rolled back and not counted");
+    check(drones->number_of_elements == listed - 1 && drone_stats_verify() == 0,
+          "the drone is removed once the send let go of it");
+    close(pair[0]);
+    close(pair[1]);
+
+    printf("\n=== PHASE 4: Partial writes ===\n");
+    // clang-format off
+    char *large = malloc(LARGE_MESSAGE_SIZE);
+    // clang-format on
+    for (size_t i = 0; i < LARGE_MESSAGE_SIZE; i++)
+        large[i] = (char)(i % 251);
+
+    // Non-blocking like a reactor connection, so send() only takes what fits
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    fcntl(pair[0], F_SETFL, fcntl(pair[0], F_GETFL) | O_NONBLOCK);
+    pthread_t reader;
+    ReaderArgs read_args = { pair[1], 0, 0 };
+    pthread_create(&reader, NULL, read_slowly, &read_args);
+    ssize_t sent = drone_send_all(pair[0], large, LARGE_MESSAGE_SIZE);
+    shutdown(pair[0], SHUT_WR);
+    pthread_join(reader, NULL);
+    check(sent == LARGE_MESSAGE_SIZE && read_args.received == LARGE_MESSAGE_SIZE && read_args.intact,
+          "a message larger than the socket buffer arrives whole and in order");
+    close(pair[0]);
+    close(pair[1]);
+
+    // Nobody reads: the start of the message fits, the rest never does
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    fcntl(pair[0], F_SETFL, fcntl(pair[0], F_GETFL) | O_NONBLOCK);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sent = drone_send_all(pair[0], large, LARGE_MESSAGE_SIZE);
+    double waited_ms = ms_since(&start);
+    check(sent == -1 && errno == ETIMEDOUT, "a message that cannot be finished fails");
+    check(waited_ms >= DRONE_SEND_TIMEOUT_MS * 0.9 && waited_ms < DRONE_SEND_TIMEOUT_MS * 3,
+          "the send gives up after DRONE_SEND_TIMEOUT_MS");
+    read_args = (ReaderArgs){ pair[1], 0, 0 };
+    read_slowly(&read_args);
+    check(read_args.received > 0 && read_args.received < LARGE_MESSAGE_SIZE && read_args.intact,
+          "the truncated message is followed by end of stream, not by the next message");
+    close(pair[0]);
+    close(pair[1]);
+    free(large);
+
+    printf("\n=== PHASE 5: Concurrent claims ===\n");
+    // One survivor per map cell at most, away from the first two, so targets name survivors
+    pthread_mutex_lock(&survivors_mutex);
+    int first_survivor = survivor_store.count;
+    for (int i = 0; i < CLAIM_SURVIVORS; i++)
+    {
+        add_survivor(MAKE_COORD(i % map.height, 6 + i / map.height));
+    }
+    pthread_mutex_unlock(&survivors_mutex);
+
+    // clang-format off
+    Drone **claim_drones = calloc(CLAIM_SURVIVORS, sizeof(Drone *));
+    // clang-format on
+    for (int i = 0; i < CLAIM_SURVIVORS; i++)
+    {
+        claim_drones[i] = add_idle_drone(1 + i, MAKE_COORD(rand() % map.height, rand() % map.width), -1);
+    }
+
+    // Keep the per-mission log lines out of the output
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+    close(devnull);
+
+    pthread_t threads[CLAIM_THREADS];
+    ClaimArgs args[CLAIM_THREADS];
+    for (int t = 0; t < CLAIM_THREADS; t++)
+    {
+        args[t] = (ClaimArgs){ &claim_drones[t * DRONES_PER_THREAD], first_survivor, t * DRONES_PER_THREAD / 2, 0 };
+        pthread_create(&threads[t], NULL, claim_all, &args[t]);
+    }
+    int claimed = 0;
+    for (int t = 0; t < CLAIM_THREADS; t++)
+    {
+        pthread_join(threads[t], NULL);
+        claimed += args[t].claimed;
+    }
+
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    // clang-format off
+    unsigned char *taken = calloc(map.height * map.width, 1);
+    // clang-format on
+    int unique = 1;
+    for (int i = 0; i < CLAIM_SURVIVORS; i++)
+    {
+        Coord t = claim_drones[i]->target;
+        unique &= claim_drones[i]->status == ON_MISSION && taken[t.x * map.width + t.y]++ == 0;
+    }
+    check(claimed == CLAIM_SURVIVORS, "every drone claimed a survivor");
+    check(unique, "no survivor went to two drones");
+    check(waiting_count == 1 && helped_count == CLAIM_SURVIVORS + 1 && spatial_index_count(&waiting_survivor_index) == 1,
+          "only the survivor added during the send is still waiting");
+    check(survivor_stats_verify() == 0, "survivor statistics match a recount");
+    check(drone_stats_verify() == 0, "drone statistics match a recount");
+    free(taken);
+    free(claim_drones);
+
+    spatial_index_destroy(&idle_drone_index);
+    drones->destroy(drones);
+    cleanup_survivors();
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All mission assignment checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of assign_mission_testing group
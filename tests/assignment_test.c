@@ -0,0 +1,234 @@
+/**
+ * @file assignment_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the batch assignment solver
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Checks solve_assignment() against exhaustive search on small instances.
+ *
+ * **Test Coverage:**
+ * - Empty input, a single pair, rows without pairs
+ * - A case where the greedy choice is not optimal
+ * - Re-matching earlier rows through augmenting paths
+ * - Random sparse instances: same matching size and total cost as an
+ *   exhaustive search, and every row gets a distinct allowed column
+ *
+ * **Usage:**
+ * Run with `make test_assignment`. The program exits non-zero if any
+ * check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/assignment.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @defgroup assignment_testing Assignment Solver Testing
+ * @brief Test program for the batch assignment solver
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Largest random instance (rows and columns) */
+#define MAX_SIZE 7
+
+/** @brief Number of random instances */
+#define RANDOM_INSTANCES 3000
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @struct instance
+ * @brief A small problem in both dense (for the search) and sparse form
+ */
+typedef struct instance {
+    int rows;
+    int cols;
+    int cost[MAX_SIZE][MAX_SIZE]; /**< Cost of each pair, -1 if not allowed */
+    int row_start[MAX_SIZE + 1];
+    AssignmentEdge edges[MAX_SIZE * MAX_SIZE];
+} Instance;
+
+/**
+ * @brief Build the sparse form from the dense cost table
+ */
+static void build_edges(Instance *in)
+{
+    int e = 0;
+    for (int r = 0; r < in->rows; r++)
+    {
+        in->row_start[r] = e;
+        for (int c = 0; c < in->cols; c++)
+        {
+            if (in->cost[r][c] >= 0)
+            {
+                in->edges[e].col = c;
+                in->edges[e].cost = in->cost[r][c];
+                e++;
+            }
+        }
+    }
+    in->row_start[in->rows] = e;
+}
+
+/**
+ * @brief Exhaustive search for the largest, then cheapest, matching
+ *
+ * @param best_size In/out: size of the best matching found so far
+ * @param best_cost In/out: its cost
+ */
+static void search(const Instance *in, int row, int used, int size, int cost, int *best_size, int *best_cost)
+{
+    if (row == in->rows)
+    {
+        if (size > *best_size || (size == *best_size && cost < *best_cost))
+        {
+            *best_size = size;
+            *best_cost = cost;
+        }
+        return;
+    }
+
+    search(in, row + 1, used, size, cost, best_size, best_cost);
+    for (int c = 0; c < in->cols; c++)
+    {
+        if (in->cost[row][c] >= 0 && !(used & (1 << c)))
+            search(in, row + 1, used | (1 << c), size + 1, cost + in->cost[row][c], best_size, best_cost);
+    }
+}
+
+/**
+ * @brief Solve an instance and compare it with the exhaustive search
+ *
+ * @return 1 if the solver's matching is valid, as large and as cheap
+ */
+static int solver_matches_search(Instance *in)
+{
+    int row_to_col[MAX_SIZE];
+    int best_size = 0, best_cost = 0;
+
+    build_edges(in);
+    search(in, 0, 0, 0, 0, &best_size, &best_cost);
+    int matched = solve_assignment(in->rows, in->cols, in->row_start, in->edges, row_to_col);
+
+    int size = 0, cost = 0, used = 0;
+    for (int r = 0; r < in->rows; r++)
+    {
+        int c = row_to_col[r];
+        if (c < 0)
+            continue;
+        if (c >= in->cols || in->cost[r][c] < 0 || (used & (1 << c)))
+            return 0;
+        used |= 1 << c;
+        size++;
+        cost += in->cost[r][c];
+    }
+
+    return matched == size && size == best_size && cost == best_cost;
+}
+
+/**
+ * @brief Run all solver checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    Instance in;
+    int row_start[1] = { 0 };
+    int row_to_col[MAX_SIZE];
+
+    printf("=== PHASE 1: Small cases ===\n");
+    check(solve_assignment(0, 0, row_start, NULL, row_to_col) == 0, "empty problem matches nothing");
+
+    memset(&in, -1, sizeof(in));
+    in.rows = 1;
+    in.cols = 1;
+    in.cost[0][0] = 5;
+    check(solver_matches_search(&in), "single pair is matched");
+
+    memset(&in, -1, sizeof(in));
+    in.rows = 2;
+    in.cols = 2;
+    in.cost[0][0] = 3;
+    check(solver_matches_search(&in) && in.row_start[2] == 1, "row without pairs stays unmatched");
+
+    // Greedy gives row 0 its cheapest column (0) and row 1 pays 10
+    memset(&in, -1, sizeof(in));
+    in.rows = 2;
+    in.cols = 2;
+    in.cost[0][0] = 1;
+    in.cost[0][1] = 2;
+    in.cost[1][0] = 1;
+    in.cost[1][1] = 10;
+    check(solver_matches_search(&in), "non-greedy optimum is found");
+
+    // Row 2 can only take column 0, which forces rows 0 and 1 to move
+    memset(&in, -1, sizeof(in));
+    in.rows = 3;
+    in.cols = 3;
+    in.cost[0][0] = 0;
+    in.cost[0][1] = 4;
+    in.cost[1][1] = 0;
+    in.cost[1][2] = 4;
+    in.cost[2][0] = 9;
+    check(solver_matches_search(&in), "earlier rows are re-matched along an augmenting path");
+
+    printf("\n=== PHASE 2: Random instances against exhaustive search ===\n");
+    srand(7);
+    int agree = 1;
+    for (int i = 0; i < RANDOM_INSTANCES && agree; i++)
+    {
+        memset(&in, -1, sizeof(in));
+        in.rows = 1 + rand() % MAX_SIZE;
+        in.cols = 1 + rand() % MAX_SIZE;
+        int density = 20 + rand() % 80;
+        for (int r = 0; r < in.rows; r++)
+        {
+            for (int c = 0; c < in.cols; c++)
+            {
+                if (rand() % 100 < density)
+                    in.cost[r][c] = rand() % 20;
+            }
+        }
+        agree = solver_matches_search(&in);
+    }
+    check(agree, "random sparse instances match exhaustive search");
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All assignment checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of assignment_testing group
@@ -0,0 +1,194 @@
+/**
+ * @file latency_histogram_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the log-linear latency histogram
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Compares the percentiles of LatencyHistogram with exact percentiles of
+ * the same samples.
+ *
+ * **Test Coverage:**
+ * - Empty histograms and reset
+ * - Exact values below 64 ns
+ * - Relative error of p50/p95/p99/p99.9 over six decades of latencies
+ * - Values past the largest bucket
+ * - Concurrent recording from several threads loses no sample
+ *
+ * **Usage:**
+ * Run with `make test_latency_histogram`. The program exits non-zero if
+ * any check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/latency_histogram.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @defgroup latency_histogram_testing Latency Histogram Testing
+ * @brief Test program for the latency histogram
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Samples in the accuracy test */
+#define RANDOM_SAMPLES 200000
+
+/** @brief Threads in the concurrency test */
+#define RECORD_THREADS 8
+
+/** @brief Samples recorded by each thread in the concurrency test */
+#define SAMPLES_PER_THREAD 100000
+
+/** @brief Largest relative error allowed: half a bucket plus rounding */
+#define MAX_RELATIVE_ERROR (1.0 / (2 * LATENCY_SUB_BUCKETS) + 1e-9)
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/** @brief Histogram shared by the concurrency test threads */
+static LatencyHistogram shared_histogram;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/** @brief qsort comparison of two uint64_t values */
+static int compare_samples(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Thread body of the concurrency test */
+static void *record_worker(void *arg)
+{
+    uint64_t base = (uint64_t)(size_t)arg;
+    for (int i = 0; i < SAMPLES_PER_THREAD; i++)
+    {
+        latency_histogram_record(&shared_histogram, base + (uint64_t)i * 977);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run all histogram checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    static const double percentiles[] = { 50.0, 95.0, 99.0, 99.9 };
+    static LatencyHistogram histogram;
+    double values[4];
+
+    printf("=== PHASE 1: Empty and exact buckets ===\n");
+    check(latency_histogram_percentiles(&histogram, percentiles, 4, values) == 0 && values[0] == 0.0 &&
+              values[3] == 0.0,
+          "empty histogram reports no samples and zero percentiles");
+
+    for (uint64_t ns = 0; ns < 2 * LATENCY_SUB_BUCKETS; ns++)
+    {
+        latency_histogram_record(&histogram, ns);
+    }
+    double median;
+    latency_histogram_percentiles(&histogram, percentiles, 1, &median);
+    check(median == 31 / 1e6, "values below 64 ns are exact");
+
+    latency_histogram_reset(&histogram);
+    check(latency_histogram_percentiles(&histogram, percentiles, 4, values) == 0, "reset empties the histogram");
+
+    printf("\n=== PHASE 2: Accuracy ===\n");
+    // clang-format off
+    uint64_t *samples = malloc(RANDOM_SAMPLES * sizeof(uint64_t));
+    // clang-format on
+    if (!samples)
+    {
+        perror("Failed to allocate samples");
+        return 1;
+    }
+
+    // Log-uniform from 64 ns to about 67 ms
+    srand(14);
+    for (int i = 0; i < RANDOM_SAMPLES; i++)
+    {
+        int magnitude = 7 + rand() % 20;
+        samples[i] = (UINT64_C(1) << (magnitude - 1)) + (uint64_t)rand() % (UINT64_C(1) << (magnitude - 1));
+        latency_histogram_record(&histogram, samples[i]);
+    }
+    qsort(samples, RANDOM_SAMPLES, sizeof(uint64_t), compare_samples);
+
+    unsigned long total = latency_histogram_percentiles(&histogram, percentiles, 4, values);
+    check(total == RANDOM_SAMPLES, "every sample is counted");
+
+    int accurate = 1;
+    for (int p = 0; p < 4; p++)
+    {
+        double exact_rank = percentiles[p] / 100.0 * RANDOM_SAMPLES;
+        int rank = (int)exact_rank;
+        if (rank < exact_rank)
+            rank++;
+        double exact_ms = samples[rank - 1] / 1e6;
+        double error = (values[p] - exact_ms) / exact_ms;
+        printf("  p%-5g exact %.6fms, histogram %.6fms (%+.2f%%)\n", percentiles[p], exact_ms, values[p],
+               error * 100);
+        accurate &= error <= MAX_RELATIVE_ERROR && error >= -MAX_RELATIVE_ERROR;
+    }
+    check(accurate, "percentiles are within half a bucket of the exact values");
+    check(values[0] <= values[1] && values[1] <= values[2] && values[2] <= values[3], "percentiles are ordered");
+    free(samples);
+
+    printf("\n=== PHASE 3: Range ===\n");
+    latency_histogram_reset(&histogram);
+    latency_histogram_record(&histogram, UINT64_C(1) << 40);
+    latency_histogram_record(&histogram, UINT64_MAX);
+    double highest;
+    latency_histogram_percentiles(&histogram, (const double[]){ 100.0 }, 1, &highest);
+    check(highest > 60000.0 && highest < 70000.0, "values past the last bucket are clamped to about 68 s");
+
+    printf("\n=== PHASE 4: Concurrent recording ===\n");
+    pthread_t threads[RECORD_THREADS];
+    for (int t = 0; t < RECORD_THREADS; t++)
+    {
+        pthread_create(&threads[t], NULL, record_worker, (void *)(size_t)(t * 1000));
+    }
+    for (int t = 0; t < RECORD_THREADS; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+    check(latency_histogram_percentiles(&shared_histogram, percentiles, 4, values) ==
+              (unsigned long)RECORD_THREADS * SAMPLES_PER_THREAD,
+          "no sample is lost when threads record at once");
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All latency histogram checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of latency_histogram_testing group
@@ -18,6 +18,12 @@
  * - Backward traversal from tail to head
  * - Element removal using pop() function
  * - Memory management and cleanup verification
+ * - MPMC queue backend: FIFO order, peek, full and empty behaviour
+ * - Growable backend: growth past the initial capacity, pointer
+ *   stability, and reuse of freed nodes without further growth
+ * - Keyed lists: removekey()/removedata() through the hash index while
+ *   add, pop and removenode keep it current and the index grows
+ * - Multi-producer/multi-consumer throughput of both backends
  * 
  * **Test Data:**
  * Uses Survivor structures as test data to simulate real-world usage
@@ -41,10 +47,14 @@
  * @ingroup data_structures
  */
 
+#define _POSIX_C_SOURCE 199309L
 #include "../headers/list.h"
 #include "../headers/survivor.h"
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 
 /**
  * @defgroup testing System Testing and Validation
@@ -83,6 +93,127 @@ void printsurvivor(Survivor *s) {
     printf("Location: (%d, %d)\n", s->coord.x, s->coord.y);
 }
 
+/**
+ * @struct keyed_item
+ * @brief Element of the key index test; only id is the key
+ */
+typedef struct keyed_item {
+    int id;            /**< Key */
+    char payload[60];  /**< Bytes that removedata() must not compare */
+} KeyedItem;
+
+/**
+ * @brief Key extractor for KeyedItem lists
+ */
+static const void *keyed_item_key(const void *data) {
+    return &((const KeyedItem *)data)->id;
+}
+
+/** @brief Producer and consumer threads per side in the throughput benchmark */
+#define BENCH_THREADS 4
+
+/** @brief Items pushed by each producer in the throughput benchmark */
+#define BENCH_ITEMS_PER_PRODUCER 200000
+
+/** @brief List capacity used by the throughput benchmark */
+#define BENCH_CAPACITY 1024
+
+/**
+ * @struct bench_worker
+ * @brief Work description of one benchmark producer or consumer
+ */
+typedef struct bench_worker {
+    List *list;      /**< List under test */
+    long first;      /**< Producer: first value to push */
+    long count;      /**< Number of items to push or pop */
+    long sum;        /**< Consumer: sum of the values popped */
+} BenchWorker;
+
+/**
+ * @brief Push count consecutive values, retrying while the list is full
+ *
+ * The linked backend blocks in add(); the queue backend returns NULL when
+ * full, so the producer yields and retries.
+ */
+static void *bench_producer(void *arg) {
+    BenchWorker *w = arg;
+    for (long i = 0; i < w->count; i++) {
+        long value = w->first + i;
+        while (w->list->add(w->list, &value) == NULL)
+            sched_yield();
+    }
+    return NULL;
+}
+
+/**
+ * @brief Pop count values, retrying while the list is empty
+ */
+static void *bench_consumer(void *arg) {
+    BenchWorker *w = arg;
+    long value;
+    for (long i = 0; i < w->count; i++) {
+        while (w->list->pop(w->list, &value) == NULL)
+            sched_yield();
+        w->sum += value;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run BENCH_THREADS producers against BENCH_THREADS consumers
+ *
+ * @param name Label for the result line
+ * @param backend Backend under test
+ * @param ops_per_sec Receives completed add+pop pairs per second
+ * @return 0 if every value pushed was popped exactly once, 1 otherwise
+ */
+static int bench_backend(const char *name, ListBackend backend, double *ops_per_sec) {
+    List *list = create_list(sizeof(long), BENCH_CAPACITY, backend);
+    if (!list) {
+        fprintf(stderr, "ERROR: Failed to create %s list\n", name);
+        return 1;
+    }
+
+    pthread_t producers[BENCH_THREADS], consumers[BENCH_THREADS];
+    BenchWorker producer_work[BENCH_THREADS], consumer_work[BENCH_THREADS];
+    long total = (long)BENCH_THREADS * BENCH_ITEMS_PER_PRODUCER;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < BENCH_THREADS; i++) {
+        consumer_work[i] = (BenchWorker){ list, 0, total / BENCH_THREADS, 0 };
+        pthread_create(&consumers[i], NULL, bench_consumer, &consumer_work[i]);
+    }
+    for (int i = 0; i < BENCH_THREADS; i++) {
+        producer_work[i] = (BenchWorker){ list, 1 + (long)i * BENCH_ITEMS_PER_PRODUCER, BENCH_ITEMS_PER_PRODUCER, 0 };
+        pthread_create(&producers[i], NULL, bench_producer, &producer_work[i]);
+    }
+
+    long sum = 0;
+    for (int i = 0; i < BENCH_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (int i = 0; i < BENCH_THREADS; i++) {
+        pthread_join(consumers[i], NULL);
+        sum += consumer_work[i].sum;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    *ops_per_sec = total / seconds;
+    list->destroy(list);
+
+    printf("  %-12s %8.3f s  %12.0f items/sec\n", name, seconds, *ops_per_sec);
+
+    // Values 1..total were each pushed once
+    if (sum != total * (total + 1) / 2) {
+        fprintf(stderr, "ERROR: %s checksum %ld, expected %ld\n", name, sum, total * (total + 1) / 2);
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * @brief Main test function that validates all core list operations
  * 
@@ -99,6 +230,10 @@ void printsurvivor(Survivor *s) {
  * 5. **Element Removal**: Remove 10 elements using pop() operation
  * 6. **Verification**: Print remaining elements to verify integrity
  * 7. **Cleanup**: Destroy list and free all resources
+ * 8. **MPMC Queue**: FIFO order, peek, full and empty queue behaviour
+ * 9. **Throughput**: Multi-producer/multi-consumer items/sec of both backends
+ * 10. **Growable Arena**: Growth, pointer stability and node reuse
+ * 11. **Key Index**: Removal by key on a growing keyed list
  * 
  * **Test Data Generation:**
  * - Survivors with sequential IDs (id:0-aname, id:1-aname, etc.)
@@ -121,8 +256,7 @@ void printsurvivor(Survivor *s) {
  * @return 0 on successful test completion
  * 
  * @note Test uses random number generation - results may vary between runs
- * @note Visual verification required - automated assertions not implemented
- * @warning Test does not validate thread safety - single-threaded execution only
+ * @note The list phases need visual verification; the MPMC phases check themselves
  * 
  * @see List structure for implementation details
  * @see create_list() for list initialization
@@ -139,7 +273,7 @@ int main() {
     printf("Adding %d elements, then removing %d elements\n\n", n, m);
     
     /*EXAMPLE USE OF list.c*/
-    List *list = create_list(sizeof(Survivor), capacity);
+    List *list = create_list(sizeof(Survivor), capacity, LIST_BACKEND_LINKED);
     
     if (!list) {
         fprintf(stderr, "ERROR: Failed to create list\n");
@@ -196,6 +330,138 @@ int main() {
     printf("\n=== PHASE 6: Cleanup and resource deallocation ===\n");
     list->destroy(list);
     printf("✓ List destroyed successfully\n");
+
+    printf("\n=== PHASE 7: MPMC queue backend ===\n");
+    List *queue = create_list(sizeof(int), 100, LIST_BACKEND_MPMC_QUEUE);
+    if (!queue) {
+        fprintf(stderr, "ERROR: Failed to create queue\n");
+        return 1;
+    }
+    printf("Queue capacity rounded up to %d\n", queue->capacity);
+
+    for (int i = 0; i < n; i++) {
+        if (!queue->add(queue, &i)) {
+            fprintf(stderr, "ERROR: Failed to add element %d to queue\n", i);
+            return 1;
+        }
+    }
+    if (queue->peek(queue) == NULL || *(int *)queue->peek(queue) != 0) {
+        fprintf(stderr, "ERROR: peek did not return the oldest element\n");
+        return 1;
+    }
+    for (int i = 0; i < n; i++) {
+        int value;
+        if (queue->pop(queue, &value) == NULL || value != i) {
+            fprintf(stderr, "ERROR: Queue pop %d out of order\n", i);
+            return 1;
+        }
+    }
+    int value = 0;
+    if (queue->pop(queue, &value) != NULL || queue->peek(queue) != NULL) {
+        fprintf(stderr, "ERROR: Empty queue returned an element\n");
+        return 1;
+    }
+    for (int i = 0; i < queue->capacity; i++) {
+        queue->add(queue, &i);
+    }
+    if (queue->add(queue, &value) != NULL) {
+        fprintf(stderr, "ERROR: Full queue accepted an element\n");
+        return 1;
+    }
+    queue->destroy(queue);
+    printf("✓ FIFO order, peek, empty and full behaviour correct\n");
+
+    printf("\n=== PHASE 8: MPMC throughput (%d producers, %d consumers, %d items each) ===\n", BENCH_THREADS,
+           BENCH_THREADS, BENCH_ITEMS_PER_PRODUCER);
+    double linked_rate = 0, queue_rate = 0;
+    if (bench_backend("linked", LIST_BACKEND_LINKED, &linked_rate) != 0 ||
+        bench_backend("mpmc queue", LIST_BACKEND_MPMC_QUEUE, &queue_rate) != 0) {
+        return 1;
+    }
+    printf("  Speedup: %.1fx\n", queue_rate / linked_rate);
+    printf("✓ Every item was delivered exactly once on both backends\n");
+
+    printf("\n=== PHASE 9: Growable arena ===\n");
+    const int grown = 100;
+    List *growable = create_list(sizeof(int), 4, LIST_BACKEND_GROWABLE);
+    Node *nodes[100];
+    if (!growable) {
+        fprintf(stderr, "ERROR: Failed to create growable list\n");
+        return 1;
+    }
+    for (int i = 0; i < grown; i++) {
+        nodes[i] = growable->add(growable, &i);
+        if (!nodes[i]) {
+            fprintf(stderr, "ERROR: Growable list refused element %d\n", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < grown; i++) {
+        if (*(int *)nodes[i]->data != i) {
+            fprintf(stderr, "ERROR: Node %d moved or was overwritten while growing\n", i);
+            return 1;
+        }
+    }
+    int grown_capacity = growable->capacity;
+    printf("✓ Added %d elements to a list created with capacity 4 (now %d nodes)\n", grown, grown_capacity);
+
+    for (int i = 0; i < grown; i += 2) {
+        growable->removenode(growable, nodes[i]);
+    }
+    for (int i = 0; i < grown; i += 2) {
+        if (!growable->add(growable, &i)) {
+            fprintf(stderr, "ERROR: Failed to re-add element %d\n", i);
+            return 1;
+        }
+    }
+    if (growable->capacity != grown_capacity || growable->number_of_elements != grown) {
+        fprintf(stderr, "ERROR: Freed nodes were not reused (capacity %d, elements %d)\n", growable->capacity,
+                growable->number_of_elements);
+        return 1;
+    }
+    growable->destroy(growable);
+    printf("✓ Freed nodes reused without growing\n");
+
+    printf("\n=== PHASE 10: Key index ===\n");
+    const int keyed_count = 1000;
+    List *keyed = create_list(sizeof(KeyedItem), 16, LIST_BACKEND_GROWABLE);
+    if (!keyed || list_set_key(keyed, sizeof(int), keyed_item_key) != 0) {
+        fprintf(stderr, "ERROR: Failed to create keyed list\n");
+        return 1;
+    }
+    for (int i = 0; i < keyed_count; i++) {
+        KeyedItem item = { .id = i * 7919 };
+        snprintf(item.payload, sizeof(item.payload), "item-%d", i);
+        keyed->add(keyed, &item);
+    }
+
+    // removedata() matches on the key alone, whatever the payload holds
+    KeyedItem probe = { .id = 0 };
+    snprintf(probe.payload, sizeof(probe.payload), "different payload");
+    int keyed_ok = keyed->removedata(keyed, &probe) == 0 && keyed->removedata(keyed, &probe) == 1;
+
+    // pop() and removenode() must drop their nodes from the index too
+    KeyedItem popped;
+    keyed->pop(keyed, &popped);
+    keyed_ok = keyed_ok && keyed->removekey(keyed, &popped.id) == 1;
+    int tail_id = ((KeyedItem *)keyed->tail->data)->id;
+    keyed->removenode(keyed, keyed->tail);
+    keyed_ok = keyed_ok && keyed->removekey(keyed, &tail_id) == 1;
+
+    // Remove the rest by key in an order unrelated to insertion
+    int removed = 0;
+    for (int i = 0; i < keyed_count; i++) {
+        int key = ((i * 389) % keyed_count) * 7919;
+        if (keyed->removekey(keyed, &key) == 0)
+            removed++;
+    }
+    keyed_ok = keyed_ok && removed == keyed_count - 3 && keyed->number_of_elements == 0 && keyed->head == NULL;
+    keyed->destroy(keyed);
+    if (!keyed_ok) {
+        fprintf(stderr, "ERROR: Key index lost or kept elements (removed %d of %d)\n", removed, keyed_count - 3);
+        return 1;
+    }
+    printf("✓ %d elements removed by key through the hash index\n", keyed_count);
     
     printf("\n=== TEST COMPLETED SUCCESSFULLY ===\n");
     printf("All list operations performed without errors\n");
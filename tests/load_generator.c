@@ -0,0 +1,1144 @@
+/**
+ * @file load_generator.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Closed-loop load generator driving thousands of virtual drones from one process
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Benchmarks drone_server with N virtual drones that speak the same
+ * protocol as clientDrone.c, without forking a drone_client per drone.
+ * Every drone is a non-blocking socket in one epoll loop on one thread,
+ * so ten thousand drones cost ten thousand sockets and a few megabytes,
+ * not ten thousand processes.
+ *
+ * **Virtual Drone Protocol:**
+ * - HANDSHAKE on connect, offering the binary and JSON encodings
+ *   (JSON only with --json); the encoding chosen in HANDSHAKE_ACK is used
+ *   for the rest of the session
+ * - STATUS_UPDATE at --rate per drone: in place while idle, one cell
+ *   closer to the target (in x and y, like drone_client) while on a mission
+ * - MISSION_COMPLETE in the slot after reaching the target, then idle
+ * - HEARTBEAT_RESPONSE to every HEARTBEAT
+ *
+ * The loop is closed: missions only complete when the server assigned
+ * them, so assignment and completion rates reflect the server.
+ *
+ * **Measurements:**
+ * - Client-observed latencies: TCP connect, HANDSHAKE to HANDSHAKE_ACK,
+ *   idle to ASSIGN_MISSION, and how late each message left compared to
+ *   its schedule (non-zero lag means the generator itself is saturated)
+ * - Server-side latencies and message count, scraped from the server's
+ *   /metrics endpoint (drone_server --metrics-port) before and after the
+ *   run with --server-metrics
+ *
+ * **Usage:**
+ * Run with `make bench_load`, which starts drone_server_headless with the
+ * epoll reactor and a metrics port, or run directly against a server:
+ * `tests/load_generator --drones=5000 --connect-rate=500 --duration=60`.
+ * The program exits non-zero if a drone failed to connect or handshake,
+ * or was disconnected by the server.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ * @ingroup load_testing
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "../headers/drone.h"
+#include "../headers/framer.h"
+#include "../headers/latency_histogram.h"
+#include "../headers/message_parser.h"
+#include "../headers/wire.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <json-c/json.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @addtogroup load_testing
+ * @{
+ */
+
+/** @brief Virtual drones started by default */
+#define DEFAULT_DRONES 1000
+
+/** @brief Connections opened per second by default */
+#define DEFAULT_CONNECT_RATE 200.0
+
+/** @brief Messages per second per drone by default: one step every 300 ms, like drone_client */
+#define DEFAULT_MESSAGE_RATE (1000.0 / 300.0)
+
+/** @brief Seconds of load by default, counted from the first connection */
+#define DEFAULT_DURATION 30.0
+
+/** @brief Server port by default */
+#define DEFAULT_PORT 8080
+
+/** @brief Receive ring of each virtual drone */
+#define RECEIVE_BUFFER_SIZE 1024
+
+/** @brief Unsent bytes buffered per drone before messages are dropped */
+#define SEND_BUFFER_SIZE 512
+
+/** @brief Largest message a virtual drone sends */
+#define MESSAGE_SIZE 256
+
+/** @brief Events taken from epoll per wait */
+#define MAX_EVENTS 512
+
+/** @brief Longest epoll wait, so SIGINT and the launch schedule are noticed */
+#define MAX_WAIT_MS 100
+
+/** @brief Size of a /metrics response buffer */
+#define SCRAPE_BUFFER_SIZE 65536
+
+/** @brief Nanoseconds per second */
+#define NS_PER_SEC 1000000000ULL
+
+/**
+ * @enum VirtualDroneState
+ * @brief Connection state of a virtual drone
+ */
+typedef enum {
+    VD_UNLAUNCHED = 0, /**< Not launched yet */
+    VD_CONNECTING,     /**< Non-blocking connect() in progress */
+    VD_HANDSHAKING,    /**< HANDSHAKE sent, waiting for HANDSHAKE_ACK */
+    VD_ACTIVE,         /**< Registered; sending on schedule */
+    VD_CLOSED          /**< Failed or disconnected */
+} VirtualDroneState;
+
+/**
+ * @struct virtual_drone
+ * @brief One simulated drone connection
+ */
+typedef struct virtual_drone {
+    int fd;                          /**< Connection socket, -1 once closed */
+    VirtualDroneState state;         /**< Connection state */
+    WireEncoding encoding;           /**< Encoding chosen by the server */
+    MessageFramer framer;            /**< Splits server messages */
+    Coord coord;                     /**< Current position */
+    Coord target;                    /**< Mission target (meaningful when on_mission) */
+    int on_mission;                  /**< Non-zero between ASSIGN_MISSION and MISSION_COMPLETE */
+    uint64_t started_ns;             /**< Start of the connect or the handshake in progress */
+    uint64_t idle_since_ns;          /**< When the drone last became idle, 0 while on a mission */
+    uint64_t next_send_ns;           /**< When the next message is due */
+    size_t pending_length;           /**< Bytes waiting in pending */
+    char pending[SEND_BUFFER_SIZE];  /**< Bytes the socket did not take yet */
+} VirtualDrone;
+
+/**
+ * @struct load_config
+ * @brief Command-line settings of a run
+ */
+typedef struct load_config {
+    const char *host;       /**< Server IPv4 address */
+    int port;               /**< Server drone port */
+    int drones;             /**< Virtual drones to start */
+    double connect_rate;    /**< Connections opened per second */
+    double message_rate;    /**< Messages per second per drone */
+    double duration;        /**< Seconds of load */
+    unsigned int encodings; /**< WireEncoding bits offered at HANDSHAKE */
+    int metrics_port;       /**< Server /metrics port, 0 to skip server-side figures */
+    int rows;               /**< Map rows, for start positions */
+    int cols;               /**< Map columns, for start positions */
+} LoadConfig;
+
+/**
+ * @struct load_stats
+ * @brief Counters of a run
+ */
+typedef struct load_stats {
+    int launched;               /**< Connections started */
+    int ready;                  /**< Drones that got HANDSHAKE_ACK */
+    int binary;                 /**< Drones on the binary encoding */
+    int connect_failures;       /**< connect() errors */
+    int handshake_failures;     /**< Closed or rejected before HANDSHAKE_ACK */
+    int disconnected;           /**< Closed by the server after HANDSHAKE_ACK */
+    unsigned long sent;         /**< Messages sent, including HANDSHAKE */
+    unsigned long sent_bytes;   /**< Bytes handed to the sockets */
+    unsigned long dropped;      /**< Messages dropped because a send buffer was full */
+    unsigned long received;     /**< Server messages received */
+    unsigned long assignments;  /**< ASSIGN_MISSION messages */
+    unsigned long completions;  /**< MISSION_COMPLETE messages sent */
+    unsigned long heartbeats;   /**< HEARTBEAT messages answered */
+    unsigned long unknown;      /**< Server messages not understood */
+} LoadStats;
+
+/** @brief Set by SIGINT or SIGTERM to end the run early */
+static volatile sig_atomic_t stop_requested = 0;
+
+/** @brief Every virtual drone, indexed by the epoll event data */
+// clang-format off
+static VirtualDrone *fleet = NULL;
+// clang-format on
+
+/** @brief Drones waiting for their next send, ordered by next_send_ns */
+// clang-format off
+static int *due_queue = NULL;
+// clang-format on
+
+/** @brief First entry of due_queue */
+static int due_head = 0;
+
+/** @brief Entries in due_queue */
+static int due_count = 0;
+
+/** @brief The epoll instance of the run */
+static int epoll_fd = -1;
+
+/** @brief Nanoseconds between two messages of one drone */
+static uint64_t send_interval_ns = 0;
+
+/** @brief Wall-clock seconds put in JSON timestamps, refreshed once per loop */
+static long wall_clock = 0;
+
+/** @brief Counters of the run */
+static LoadStats stats;
+
+/** @brief TCP connect() to writable */
+static LatencyHistogram connect_latency;
+
+/** @brief HANDSHAKE sent to HANDSHAKE_ACK received */
+static LatencyHistogram handshake_latency;
+
+/** @brief Drone idle (registered or mission done) to ASSIGN_MISSION received */
+static LatencyHistogram assignment_latency;
+
+/** @brief Due time to actual send time of each scheduled message */
+static LatencyHistogram schedule_lag;
+
+/** @brief Settings of the run */
+static LoadConfig config = {
+    .host = "127.0.0.1",
+    .port = DEFAULT_PORT,
+    .drones = DEFAULT_DRONES,
+    .connect_rate = DEFAULT_CONNECT_RATE,
+    .message_rate = DEFAULT_MESSAGE_RATE,
+    .duration = DEFAULT_DURATION,
+    .encodings = WIRE_ENCODING_JSON | WIRE_ENCODING_BINARY,
+    .metrics_port = 0,
+    .rows = 30,
+    .cols = 40,
+};
+
+/**
+ * @brief Signal handler ending the run
+ */
+static void handle_stop(int signal_number)
+{
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+/**
+ * @brief Monotonic time in nanoseconds
+ */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Put a descriptor into non-blocking mode
+ *
+ * @return 0 on success, -1 on failure
+ */
+static int set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Print command-line usage
+ */
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [options]\n", program);
+    printf("  --drones=N             Virtual drones to start (default: %d)\n", DEFAULT_DRONES);
+    printf("  --connect-rate=N       Connections opened per second (default: %.0f)\n", DEFAULT_CONNECT_RATE);
+    printf("  --rate=N               Messages per second per drone (default: %.2f)\n", DEFAULT_MESSAGE_RATE);
+    printf("  --duration=S           Seconds of load from the first connection (default: %.0f)\n", DEFAULT_DURATION);
+    printf("  --host=ADDR            Server IPv4 address (default: 127.0.0.1)\n");
+    printf("  --port=N               Server drone port (default: %d)\n", DEFAULT_PORT);
+    printf("  --server-metrics=N     Scrape server-side latencies from http://HOST:N/metrics\n");
+    printf("  --map=ROWSxCOLS        Map size the start positions are drawn from (default: 30x40)\n");
+    printf("  --json                 Only offer the JSON encoding at HANDSHAKE (default: offer binary too)\n");
+    printf("  --help                 Show this help\n");
+}
+
+/**
+ * @brief Parse the command line into config
+ *
+ * @return 0 to run, 1 if help was printed, -1 on an invalid option
+ */
+static int parse_arguments(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        char extra;
+        if (sscanf(arg, "--drones=%d%c", &config.drones, &extra) == 1 && config.drones > 0)
+            continue;
+        if (sscanf(arg, "--connect-rate=%lf%c", &config.connect_rate, &extra) == 1 && config.connect_rate > 0)
+            continue;
+        if (sscanf(arg, "--rate=%lf%c", &config.message_rate, &extra) == 1 && config.message_rate > 0)
+            continue;
+        if (sscanf(arg, "--duration=%lf%c", &config.duration, &extra) == 1 && config.duration > 0)
+            continue;
+        if (sscanf(arg, "--port=%d%c", &config.port, &extra) == 1 && config.port > 0 && config.port < 65536)
+            continue;
+        if (sscanf(arg, "--server-metrics=%d%c", &config.metrics_port, &extra) == 1 && config.metrics_port > 0 &&
+            config.metrics_port < 65536)
+            continue;
+        if (sscanf(arg, "--map=%dx%d%c", &config.rows, &config.cols, &extra) == 2 && config.rows > 0 &&
+            config.cols > 0)
+            continue;
+        if (strncmp(arg, "--host=", 7) == 0)
+        {
+            config.host = arg + 7;
+            continue;
+        }
+        if (strcmp(arg, "--json") == 0)
+        {
+            config.encodings = WIRE_ENCODING_JSON;
+            continue;
+        }
+        if (strcmp(arg, "--help") == 0)
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        fprintf(stderr, "Invalid option: %s\n", arg);
+        print_usage(argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Raise the open-file limit to fit every drone socket
+ */
+static void raise_fd_limit(int needed)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur >= (rlim_t)needed)
+        return;
+
+    limit.rlim_cur = limit.rlim_max == RLIM_INFINITY || limit.rlim_max >= (rlim_t)needed ? (rlim_t)needed
+                                                                                          : limit.rlim_max;
+    if (setrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur < (rlim_t)needed)
+    {
+        fprintf(stderr,
+                "Warning: open-file limit is %lu, below the %d descriptors needed; raise it with ulimit -n\n",
+                (unsigned long)limit.rlim_cur,
+                needed);
+    }
+}
+
+/**
+ * @brief Add a drone to the back of the send schedule
+ */
+static void schedule_drone(int index)
+{
+    due_queue[(due_head + due_count) % config.drones] = index;
+    due_count++;
+}
+
+/**
+ * @brief Change the events epoll reports for a drone
+ */
+static void watch_drone(VirtualDrone *drone, uint32_t events)
+{
+    struct epoll_event event = { .events = events, .data.u32 = (uint32_t)(drone - fleet) };
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, drone->fd, &event);
+}
+
+/**
+ * @brief Close a drone's connection and count why
+ *
+ * @param counter Counter in stats to increment, or NULL
+ */
+static void close_drone(VirtualDrone *drone, int *counter)
+{
+    if (drone->state == VD_CLOSED)
+        return;
+    if (counter)
+        (*counter)++;
+    close(drone->fd);
+    drone->fd = -1;
+    drone->state = VD_CLOSED;
+    drone->pending_length = 0;
+}
+
+/**
+ * @brief Send bytes on a drone's socket, buffering what it does not take
+ *
+ * A message that does not fit the pending buffer is dropped whole, so the
+ * stream never holds a partial message.
+ *
+ * @return 0 if the message was sent, buffered or dropped, -1 if the
+ *         connection failed
+ */
+static int send_bytes(VirtualDrone *drone, const char *data, size_t length)
+{
+    size_t sent = 0;
+    if (drone->pending_length == 0)
+    {
+        ssize_t result = send(drone->fd, data, length, MSG_NOSIGNAL);
+        if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            return -1;
+        sent = result > 0 ? (size_t)result : 0;
+    }
+    else if (drone->pending_length + length > SEND_BUFFER_SIZE)
+    {
+        stats.dropped++;
+        return 0;
+    }
+
+    stats.sent++;
+    stats.sent_bytes += length;
+    if (sent == length)
+        return 0;
+
+    if (drone->pending_length == 0)
+        watch_drone(drone, EPOLLIN | EPOLLOUT);
+    memcpy(drone->pending + drone->pending_length, data + sent, length - sent);
+    drone->pending_length += length - sent;
+    return 0;
+}
+
+/**
+ * @brief Write out buffered bytes once the socket is writable again
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int flush_pending(VirtualDrone *drone)
+{
+    ssize_t result = send(drone->fd, drone->pending, drone->pending_length, MSG_NOSIGNAL);
+    if (result < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+
+    drone->pending_length -= (size_t)result;
+    memmove(drone->pending, drone->pending + result, drone->pending_length);
+    if (drone->pending_length == 0)
+        watch_drone(drone, EPOLLIN);
+    return 0;
+}
+
+/**
+ * @brief Send a drone → server message in the drone's encoding
+ *
+ * Mirrors send_drone_message() in clientDrone.c; STATUS_UPDATE,
+ * MISSION_COMPLETE and HEARTBEAT_RESPONSE are supported.
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int send_message(VirtualDrone *drone, const DroneMessage *message)
+{
+    char buffer[MESSAGE_SIZE];
+    int length = 0;
+    int id = (int)(drone - fleet);
+
+    if (drone->encoding == WIRE_ENCODING_BINARY)
+        return send_bytes(drone, buffer, wire_encode_drone_message(buffer, message));
+
+    switch (message->type)
+    {
+        case DRONE_MSG_STATUS_UPDATE:
+            length = snprintf(buffer,
+                              sizeof(buffer),
+                              "{\"drone_id\":%d,\"timestamp\":%ld,\"type\":\"STATUS_UPDATE\",\"location\":{\"x\":%d,"
+                              "\"y\":%d},\"status\":\"%s\",\"battery\":%d}\n",
+                              id,
+                              wall_clock,
+                              message->location.x,
+                              message->location.y,
+                              message->status == IDLE ? "idle" : "busy",
+                              message->battery);
+            break;
+
+        case DRONE_MSG_MISSION_COMPLETE:
+            length = snprintf(buffer,
+                              sizeof(buffer),
+                              "{\"drone_id\":%d,\"timestamp\":%ld,\"type\":\"MISSION_COMPLETE\",\"success\":true,"
+                              "\"details\":\"Mission completed successfully.\",\"target_location\":{\"x\":%d,"
+                              "\"y\":%d}}\n",
+                              id,
+                              wall_clock,
+                              message->target.x,
+                              message->target.y);
+            break;
+
+        case DRONE_MSG_HEARTBEAT_RESPONSE:
+            length = snprintf(buffer,
+                              sizeof(buffer),
+                              "{\"drone_id\":%d,\"timestamp\":%ld,\"type\":\"HEARTBEAT_RESPONSE\"}\n",
+                              id,
+                              wall_clock);
+            break;
+
+        default:
+            return 0;
+    }
+    return send_bytes(drone, buffer, (size_t)length);
+}
+
+/**
+ * @brief Send the HANDSHAKE of a freshly connected drone
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int send_handshake(VirtualDrone *drone)
+{
+    char buffer[MESSAGE_SIZE];
+    int length = snprintf(buffer,
+                          sizeof(buffer),
+                          "{\"type\":\"HANDSHAKE\",\"drone_id\":%d,\"status\":\"IDLE\",\"coord\":{\"x\":%d,\"y\":%d},"
+                          "\"encodings\":[%s\"" WIRE_ENCODING_NAME_JSON "\"]}\n",
+                          (int)(drone - fleet),
+                          drone->coord.x,
+                          drone->coord.y,
+                          config.encodings & WIRE_ENCODING_BINARY ? "\"" WIRE_ENCODING_NAME_BINARY "\"," : "");
+    return send_bytes(drone, buffer, (size_t)length);
+}
+
+/**
+ * @brief Start connecting the next virtual drone
+ */
+static void launch_drone(int index, const struct sockaddr_in *server, uint64_t now)
+{
+    // clang-format off
+    VirtualDrone *drone = &fleet[index];
+    // clang-format on
+    stats.launched++;
+    drone->coord = (Coord){ rand() % config.rows, rand() % config.cols };
+    drone->target = drone->coord;
+    drone->encoding = WIRE_ENCODING_JSON;
+    drone->started_ns = now;
+    drone->state = VD_CONNECTING;
+
+    drone->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (drone->fd < 0)
+    {
+        perror("Socket creation failed");
+        drone->state = VD_CLOSED;
+        stats.connect_failures++;
+        return;
+    }
+
+    // Small messages at a steady rate: do not let Nagle hold them back
+    int one = 1;
+    setsockopt(drone->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    struct epoll_event event = { .events = EPOLLOUT, .data.u32 = (uint32_t)index };
+    // clang-format off
+    if (set_nonblocking(drone->fd) != 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, drone->fd, &event) != 0 ||
+        (connect(drone->fd, (const struct sockaddr *)server, sizeof(*server)) != 0 && errno != EINPROGRESS))
+    // clang-format on
+    {
+        if (stats.connect_failures == 0)
+            perror("Connection failed");
+        close_drone(drone, &stats.connect_failures);
+    }
+}
+
+/**
+ * @brief Finish a non-blocking connect and send HANDSHAKE
+ */
+static void complete_connect(VirtualDrone *drone, uint64_t now)
+{
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(drone->fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0)
+    {
+        if (stats.connect_failures == 0)
+            fprintf(stderr, "Connection failed: %s\n", strerror(error));
+        close_drone(drone, &stats.connect_failures);
+        return;
+    }
+
+    latency_histogram_record(&connect_latency, now - drone->started_ns);
+    if (framer_init(&drone->framer, RECEIVE_BUFFER_SIZE, FRAME_BRACE) != 0)
+    {
+        perror("Failed to allocate receive buffer");
+        close_drone(drone, &stats.handshake_failures);
+        return;
+    }
+
+    watch_drone(drone, EPOLLIN);
+    drone->state = VD_HANDSHAKING;
+    drone->started_ns = now;
+    if (send_handshake(drone) != 0)
+        close_drone(drone, &stats.handshake_failures);
+}
+
+/**
+ * @brief Make a drone active after its HANDSHAKE_ACK
+ */
+static void activate_drone(VirtualDrone *drone, WireEncoding encoding, uint64_t now)
+{
+    latency_histogram_record(&handshake_latency, now - drone->started_ns);
+    drone->state = VD_ACTIVE;
+    drone->encoding = encoding;
+    if (encoding == WIRE_ENCODING_BINARY)
+    {
+        framer_set_mode(&drone->framer, FRAME_BINARY);
+        stats.binary++;
+    }
+    stats.ready++;
+
+    // Launches are already spread by the connect rate, so one interval from
+    // now keeps the schedule ordered and the send times spread
+    drone->idle_since_ns = now;
+    drone->next_send_ns = now + send_interval_ns;
+    schedule_drone((int)(drone - fleet));
+}
+
+/**
+ * @brief Start flying toward a newly assigned mission target
+ */
+static void accept_mission(VirtualDrone *drone, Coord target, uint64_t now)
+{
+    stats.assignments++;
+    if (drone->idle_since_ns)
+        latency_histogram_record(&assignment_latency, now - drone->idle_since_ns);
+    drone->idle_since_ns = 0;
+    drone->target = target;
+    drone->on_mission = 1;
+}
+
+/**
+ * @brief Answer a HEARTBEAT from the server
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int respond_to_heartbeat(VirtualDrone *drone)
+{
+    DroneMessage response = { .type = DRONE_MSG_HEARTBEAT_RESPONSE };
+    stats.heartbeats++;
+    return send_message(drone, &response);
+}
+
+/**
+ * @brief Read a Coord from a {"x":..,"y":..} member of a JSON object
+ *
+ * @return 1 if both coordinates were present
+ */
+static int json_coord(struct json_object *parent, const char *key, Coord *coord)
+{
+    struct json_object *object, *x, *y;
+    if (!json_object_object_get_ex(parent, key, &object) || !json_object_object_get_ex(object, "x", &x) ||
+        !json_object_object_get_ex(object, "y", &y))
+        return 0;
+    coord->x = json_object_get_int(x);
+    coord->y = json_object_get_int(y);
+    return 1;
+}
+
+/**
+ * @brief Act on one JSON server message
+ *
+ * @return 0 to keep the connection, -1 to close it
+ */
+static int handle_json_frame(VirtualDrone *drone, Frame *frame, uint64_t now)
+{
+    char saved = frame->data[frame->length];
+    frame->data[frame->length] = '\0';
+    struct json_object *message = json_tokener_parse(frame->data);
+    frame->data[frame->length] = saved;
+
+    struct json_object *value;
+    const char *type = json_object_object_get_ex(message, "type", &value) ? json_object_get_string(value) : "";
+    int result = 0;
+    Coord target;
+
+    if (drone->state == VD_HANDSHAKING)
+    {
+        if (strcmp(type, "HANDSHAKE_ACK") == 0)
+        {
+            // Servers without binary support send no "encoding": stay on JSON
+            int binary = (config.encodings & WIRE_ENCODING_BINARY) &&
+                         json_object_object_get_ex(message, "encoding", &value) &&
+                         strcmp(json_object_get_string(value), WIRE_ENCODING_NAME_BINARY) == 0;
+            activate_drone(drone, binary ? WIRE_ENCODING_BINARY : WIRE_ENCODING_JSON, now);
+        }
+        else
+        {
+            fprintf(stderr, "Unexpected reply to HANDSHAKE: %.*s\n", (int)frame->length, frame->data);
+            result = -1;
+        }
+    }
+    else if (strcmp(type, "ASSIGN_MISSION") == 0 && json_coord(message, "target", &target))
+    {
+        accept_mission(drone, target, now);
+    }
+    else if (strcmp(type, "HEARTBEAT") == 0)
+    {
+        result = respond_to_heartbeat(drone);
+    }
+    else
+    {
+        stats.unknown++;
+    }
+
+    json_object_put(message);
+    return result;
+}
+
+/**
+ * @brief Act on one binary server message
+ *
+ * @return 0 to keep the connection, -1 to close it
+ */
+static int handle_binary_frame(VirtualDrone *drone, const Frame *frame, uint64_t now)
+{
+    WireAssignment assignment;
+    switch (wire_frame_type(frame->data, frame->length))
+    {
+        case WIRE_ASSIGN_MISSION:
+            if (wire_decode_assignment(frame->data, frame->length, &assignment) != 0)
+                break;
+            accept_mission(drone, assignment.target, now);
+            return 0;
+
+        case WIRE_HEARTBEAT:
+            return respond_to_heartbeat(drone);
+
+        default:
+            break;
+    }
+    stats.unknown++;
+    return 0;
+}
+
+/**
+ * @brief Receive everything readable on a drone's socket and act on it
+ */
+static void read_drone(VirtualDrone *drone, uint64_t now)
+{
+    // Closed by the server before or after registering
+    int *lost = drone->state == VD_ACTIVE ? &stats.disconnected : &stats.handshake_failures;
+
+    while (drone->state == VD_HANDSHAKING || drone->state == VD_ACTIVE)
+    {
+        size_t space;
+        char *dest = framer_write_space(&drone->framer, &space);
+        ssize_t received = recv(drone->fd, dest, space, 0);
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            return;
+        if (received <= 0)
+        {
+            close_drone(drone, lost);
+            return;
+        }
+        framer_commit(&drone->framer, (size_t)received);
+
+        Frame frame;
+        int result;
+        while (drone->state != VD_CLOSED && (result = framer_next(&drone->framer, &frame)) != 0)
+        {
+            stats.received++;
+            int handled = -1;
+            if (result > 0 && drone->encoding == WIRE_ENCODING_BINARY)
+                handled = handle_binary_frame(drone, &frame, now);
+            else if (result > 0)
+                handled = handle_json_frame(drone, &frame, now);
+            if (handled != 0)
+                close_drone(drone, drone->state == VD_ACTIVE ? &stats.disconnected : &stats.handshake_failures);
+        }
+        lost = drone->state == VD_ACTIVE ? &stats.disconnected : &stats.handshake_failures;
+    }
+}
+
+/**
+ * @brief Send the next scheduled message of an active drone
+ *
+ * Moves one cell toward the target in x and y, like drone_client, and
+ * reports the new position; once at the target the next slot carries
+ * MISSION_COMPLETE instead.
+ */
+static void send_scheduled(VirtualDrone *drone, uint64_t now)
+{
+    latency_histogram_record(&schedule_lag, now - drone->next_send_ns);
+
+    DroneMessage message;
+    memset(&message, 0, sizeof(message));
+    if (drone->on_mission && drone->coord.x == drone->target.x && drone->coord.y == drone->target.y)
+    {
+        message.type = DRONE_MSG_MISSION_COMPLETE;
+        message.target = drone->target;
+        message.success = 1;
+        drone->on_mission = 0;
+        drone->idle_since_ns = now;
+        stats.completions++;
+    }
+    else
+    {
+        if (drone->on_mission)
+        {
+            drone->coord.x += (drone->coord.x < drone->target.x) - (drone->coord.x > drone->target.x);
+            drone->coord.y += (drone->coord.y < drone->target.y) - (drone->coord.y > drone->target.y);
+        }
+        message.type = DRONE_MSG_STATUS_UPDATE;
+        message.location = drone->coord;
+        message.status = drone->on_mission ? ON_MISSION : IDLE;
+        message.battery = 100;
+    }
+
+    if (send_message(drone, &message) != 0)
+        close_drone(drone, &stats.disconnected);
+}
+
+/**
+ * @brief Send every message that is due
+ *
+ * All drones share one interval, so re-queueing a drone at the back keeps
+ * due_queue ordered by due time and only due drones are visited.
+ */
+static void run_schedule(uint64_t now)
+{
+    while (due_count > 0)
+    {
+        int index = due_queue[due_head];
+        // clang-format off
+        VirtualDrone *drone = &fleet[index];
+        // clang-format on
+        if (drone->state == VD_ACTIVE && drone->next_send_ns > now)
+            return;
+
+        due_head = (due_head + 1) % config.drones;
+        due_count--;
+        if (drone->state != VD_ACTIVE)
+            continue;
+
+        send_scheduled(drone, now);
+        if (drone->state == VD_ACTIVE)
+        {
+            drone->next_send_ns += send_interval_ns;
+            schedule_drone(index);
+        }
+    }
+}
+
+/**
+ * @brief Fetch the server's /metrics page
+ *
+ * @param buffer Receives the response, NUL-terminated
+ * @return Start of the body in buffer, or NULL on failure
+ */
+// clang-format off
+static const char *scrape_metrics(char *buffer, size_t size)
+// clang-format on
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return NULL;
+
+    struct timeval timeout = { .tv_sec = 2, .tv_usec = 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config.metrics_port);
+    inet_pton(AF_INET, config.host, &addr.sin_addr);
+
+    const char *request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+    size_t used = 0;
+    // clang-format off
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+        send(fd, request, strlen(request), MSG_NOSIGNAL) == (ssize_t)strlen(request))
+    // clang-format on
+    {
+        ssize_t received;
+        while (used < size - 1 && (received = recv(fd, buffer + used, size - 1 - used, 0)) > 0)
+            used += (size_t)received;
+    }
+    close(fd);
+    buffer[used] = '\0';
+
+    // clang-format off
+    const char *body = strstr(buffer, "\r\n\r\n");
+    // clang-format on
+    return strncmp(buffer, "HTTP/1.1 200", 12) == 0 && body ? body + 4 : NULL;
+}
+
+/**
+ * @brief Value of the first sample whose line starts with @p prefix
+ *
+ * @return The value, or -1 if no line matches
+ */
+static double sample_value(const char *text, const char *prefix)
+{
+    // clang-format off
+    const char *line = text;
+    // clang-format on
+    while (line && *line)
+    {
+        if (strncmp(line, prefix, strlen(prefix)) == 0)
+            return strtod(line + strlen(prefix), NULL);
+        line = strchr(line, '\n');
+        if (line)
+            line++;
+    }
+    return -1;
+}
+
+/**
+ * @brief Print one row of client-observed percentiles
+ */
+static void print_histogram_row(const char *name, const LatencyHistogram *histogram)
+{
+    static const double percentiles[] = { 50.0, 95.0, 99.0, 99.9 };
+    double values[4];
+    unsigned long samples = latency_histogram_percentiles(histogram, percentiles, 4, values);
+    printf("  %-24s %10lu %9.3f %9.3f %9.3f %9.3f\n", name, samples, values[0], values[1], values[2], values[3]);
+}
+
+/**
+ * @brief Print one row of server-side percentiles from a /metrics body
+ */
+static void print_server_row(const char *body, const char *operation)
+{
+    static const char *quantiles[] = { "0.5", "0.95", "0.99", "0.999" };
+    char prefix[128];
+
+    snprintf(prefix, sizeof(prefix), "drone_operation_latency_seconds_count{operation=\"%s\"}", operation);
+    double samples = sample_value(body, prefix);
+    printf("  %-24s %10.0f", operation, samples < 0 ? 0 : samples);
+    for (int i = 0; i < 4; i++)
+    {
+        snprintf(prefix,
+                 sizeof(prefix),
+                 "drone_operation_latency_seconds{operation=\"%s\",quantile=\"%s\"}",
+                 operation,
+                 quantiles[i]);
+        double seconds = sample_value(body, prefix);
+        printf(" %9.3f", seconds < 0 ? 0 : seconds * 1000.0);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Print the results of the run
+ *
+ * @param elapsed Seconds from the first connection to the end of the run
+ * @param processed_before Server messages processed before the run, -1 if unknown
+ * @param body Server /metrics body after the run, or NULL
+ */
+static void print_report(double elapsed, double processed_before, const char *body)
+{
+    printf("\n=== Load Generator Report ===\n");
+    printf("Drones: %d launched of %d, %d ready (%d binary), %d connect failures, %d handshake failures, "
+           "%d disconnected\n",
+           stats.launched,
+           config.drones,
+           stats.ready,
+           stats.binary,
+           stats.connect_failures,
+           stats.handshake_failures,
+           stats.disconnected);
+    printf("Run: %.1f s at %.0f connections/s and %.2f messages/s per drone\n",
+           elapsed,
+           config.connect_rate,
+           config.message_rate);
+    printf("Sent: %lu messages (%.0f/s), %lu bytes, %lu dropped on full send buffers\n",
+           stats.sent,
+           stats.sent / elapsed,
+           stats.sent_bytes,
+           stats.dropped);
+    printf("Received: %lu messages, %lu assignments, %lu heartbeats, %lu not understood; %lu missions completed\n",
+           stats.received,
+           stats.assignments,
+           stats.heartbeats,
+           stats.unknown,
+           stats.completions);
+
+    printf("\nClient-observed latency (ms)   samples       p50       p95       p99     p99.9\n");
+    print_histogram_row("connect", &connect_latency);
+    print_histogram_row("handshake round trip", &handshake_latency);
+    print_histogram_row("idle to assignment", &assignment_latency);
+    print_histogram_row("send schedule lag", &schedule_lag);
+
+    if (!body)
+        return;
+
+    double processed_after = sample_value(body, "drone_messages_processed_total ");
+    if (processed_before >= 0 && processed_after >= 0)
+    {
+        printf("\nServer processed: %.0f messages (%.0f/s)\n",
+               processed_after - processed_before,
+               (processed_after - processed_before) / elapsed);
+    }
+    printf("\nServer-side latency (ms)       samples       p50       p95       p99     p99.9\n");
+    print_server_row(body, "handshake");
+    print_server_row(body, "status_update");
+    print_server_row(body, "mission_complete");
+    print_server_row(body, "heartbeat");
+    print_server_row(body, "assign_mission");
+    print_server_row(body, "ai_cycle");
+}
+
+/**
+ * @brief Run the load and report it
+ *
+ * @return 0 if every launched drone registered and stayed connected,
+ *         1 otherwise
+ */
+int main(int argc, char *argv[])
+{
+    int parsed = parse_arguments(argc, argv);
+    if (parsed != 0)
+        return parsed > 0 ? 0 : 1;
+
+    struct sockaddr_in server;
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_port = htons(config.port);
+    if (inet_pton(AF_INET, config.host, &server.sin_addr) != 1)
+    {
+        fprintf(stderr, "Invalid server address: %s\n", config.host);
+        return 1;
+    }
+
+    signal(SIGINT, handle_stop);
+    signal(SIGTERM, handle_stop);
+    signal(SIGPIPE, SIG_IGN);
+    raise_fd_limit(config.drones + 64);
+    srand((unsigned int)time(NULL));
+
+    fleet = calloc((size_t)config.drones, sizeof(VirtualDrone));
+    due_queue = calloc((size_t)config.drones, sizeof(int));
+    epoll_fd = epoll_create1(0);
+    if (!fleet || !due_queue || epoll_fd < 0)
+    {
+        perror("Load generator setup failed");
+        free(fleet);
+        free(due_queue);
+        return 1;
+    }
+    send_interval_ns = (uint64_t)(NS_PER_SEC / config.message_rate);
+
+    // clang-format off
+    static char scrape[SCRAPE_BUFFER_SIZE];
+    const char *body = NULL;
+    // clang-format on
+    double processed_before = -1;
+    if (config.metrics_port)
+    {
+        body = scrape_metrics(scrape, sizeof(scrape));
+        if (!body)
+            fprintf(stderr, "Warning: no metrics at http://%s:%d/metrics\n", config.host, config.metrics_port);
+        else
+            processed_before = sample_value(body, "drone_messages_processed_total ");
+    }
+
+    printf("Load generator: %d drones at %s:%d, %.0f connections/s, %.2f messages/s per drone, %.0f s\n",
+           config.drones,
+           config.host,
+           config.port,
+           config.connect_rate,
+           config.message_rate,
+           config.duration);
+    if (config.drones / config.connect_rate > config.duration)
+        fprintf(stderr, "Warning: only part of the drones connect within the run at this connect rate\n");
+
+    uint64_t start = now_ns();
+    uint64_t end = start + (uint64_t)(config.duration * NS_PER_SEC);
+    uint64_t launch_interval = (uint64_t)(NS_PER_SEC / config.connect_rate);
+    struct epoll_event events[MAX_EVENTS];
+    uint64_t now = start;
+
+    while (!stop_requested && now < end)
+    {
+        wall_clock = (long)time(NULL);
+        while (stats.launched < config.drones && start + stats.launched * launch_interval <= now)
+            launch_drone(stats.launched, &server, now);
+
+        // Sleep until the next launch, the next due message or the end
+        uint64_t next = end;
+        if (stats.launched < config.drones && start + stats.launched * launch_interval < next)
+            next = start + stats.launched * launch_interval;
+        if (due_count > 0 && fleet[due_queue[due_head]].next_send_ns < next)
+            next = fleet[due_queue[due_head]].next_send_ns;
+        uint64_t wait_ms = next > now ? (next - now + 999999) / 1000000 : 0;
+
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, wait_ms > MAX_WAIT_MS ? MAX_WAIT_MS : (int)wait_ms);
+        now = now_ns();
+        for (int i = 0; i < ready; i++)
+        {
+            // clang-format off
+            VirtualDrone *drone = &fleet[events[i].data.u32];
+            // clang-format on
+            if (drone->state == VD_CONNECTING)
+            {
+                complete_connect(drone, now);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && drone->state != VD_CLOSED && flush_pending(drone) != 0)
+                close_drone(drone, drone->state == VD_ACTIVE ? &stats.disconnected : &stats.handshake_failures);
+            if ((events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) && drone->state != VD_CLOSED)
+                read_drone(drone, now);
+        }
+
+        run_schedule(now);
+    }
+
+    double elapsed = (now_ns() - start) / 1e9;
+    int unfinished = 0;
+    for (int i = 0; i < stats.launched; i++)
+    {
+        unfinished += fleet[i].state == VD_CONNECTING || fleet[i].state == VD_HANDSHAKING;
+        if (fleet[i].state != VD_CLOSED)
+            close(fleet[i].fd);
+        framer_destroy(&fleet[i].framer);
+    }
+    close(epoll_fd);
+
+    if (config.metrics_port)
+    {
+        // Let the server notice the closed connections before the last scrape
+        struct timespec settle = { .tv_sec = 0, .tv_nsec = 200000000L };
+        nanosleep(&settle, NULL);
+        body = scrape_metrics(scrape, sizeof(scrape));
+    }
+    print_report(elapsed, processed_before, body);
+    if (unfinished)
+        printf("\n%d drone(s) were still connecting or handshaking when the run ended\n", unfinished);
+
+    int failed = stats.connect_failures || stats.handshake_failures || stats.disconnected || unfinished;
+    free(fleet);
+    free(due_queue);
+    if (failed)
+    {
+        printf("\n=== Load run FAILED: not every drone registered and stayed connected ===\n");
+        return 1;
+    }
+
+    printf("\n=== Load run completed ===\n");
+    return 0;
+}
+
+/** @} */ // end of load_testing addtogroup
@@ -0,0 +1,207 @@
+/**
+ * @file metrics_benchmark.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Benchmark of sharded performance counters against a single mutex
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Calls a status update recorder from 1, 8 and 32 threads at once and
+ * reports the cost per call for two implementations:
+ *
+ * - mutex: the counters of one structure behind one mutex, the way
+ *   server_throughput.c recorded every message before counter shards
+ * - sharded: perf_record_status_update(), which counts into the calling
+ *   thread's cache-line-aligned shard with relaxed atomics
+ *
+ * After each sharded run the totals are folded with perf_aggregate() and
+ * checked against the number of calls made.
+ *
+ * **Usage:**
+ * `make bench_metrics` or `./tests/metrics_benchmark [calls_per_thread]`.
+ * The program exits non-zero if an aggregated total is wrong.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ * @ingroup performance_testing
+ */
+
+#define _POSIX_C_SOURCE 200112L
+#include "../headers/server_throughput.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @defgroup metrics_benchmark Metrics Counter Benchmark
+ * @brief Contention comparison of the metrics recording paths
+ * @ingroup performance_testing
+ * @{
+ */
+
+/** @brief Default number of status updates recorded by each thread */
+#define DEFAULT_CALLS 1000000
+
+/** @brief Bytes recorded per status update */
+#define MESSAGE_BYTES 120
+
+/** @brief Largest thread count measured */
+#define MAX_THREADS 32
+
+/**
+ * @struct mutex_counters
+ * @brief Counters updated by the mutex baseline
+ */
+typedef struct mutex_counters {
+    unsigned long status_updates_received;
+    unsigned long messages_processed;
+    unsigned long total_bytes_received;
+    pthread_mutex_t lock;
+} MutexCounters;
+
+/** @brief Counters of the mutex baseline */
+static MutexCounters baseline = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/** @brief Status updates recorded by each thread in the current run */
+static long calls_per_thread = DEFAULT_CALLS;
+
+/** @brief Releases every thread of a run at once */
+static pthread_barrier_t start_barrier;
+
+/**
+ * @brief Record a status update the way server_throughput.c used to
+ */
+static void mutex_record_status_update(size_t bytes_received)
+{
+    pthread_mutex_lock(&baseline.lock);
+    baseline.status_updates_received++;
+    baseline.messages_processed++;
+    baseline.total_bytes_received += bytes_received;
+    pthread_mutex_unlock(&baseline.lock);
+}
+
+/** @brief Thread body of the mutex runs */
+static void *mutex_worker(void *arg)
+{
+    (void)arg;
+    pthread_barrier_wait(&start_barrier);
+    for (long i = 0; i < calls_per_thread; i++)
+    {
+        mutex_record_status_update(MESSAGE_BYTES);
+    }
+    return NULL;
+}
+
+/** @brief Thread body of the sharded runs */
+static void *sharded_worker(void *arg)
+{
+    (void)arg;
+    pthread_barrier_wait(&start_barrier);
+    for (long i = 0; i < calls_per_thread; i++)
+    {
+        perf_record_status_update(MESSAGE_BYTES);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run @p worker on @p threads threads at once
+ *
+ * @return Wall-clock seconds from release to the last thread finishing;
+ *         exits if a thread cannot be created
+ */
+static double run_threads(int threads, void *(*worker)(void *))
+{
+    pthread_t ids[MAX_THREADS];
+    struct timespec start, end;
+
+    pthread_barrier_init(&start_barrier, NULL, threads + 1);
+    for (int i = 0; i < threads; i++)
+    {
+        if (pthread_create(&ids[i], NULL, worker, NULL) != 0)
+        {
+            perror("Failed to create benchmark thread");
+            exit(1);
+        }
+    }
+
+    pthread_barrier_wait(&start_barrier);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(ids[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_barrier_destroy(&start_barrier);
+
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/**
+ * @brief Print one result line
+ */
+static void report(const char *name, int threads, double seconds)
+{
+    double calls = (double)threads * calls_per_thread;
+    printf("  %-8s %2d threads  %8.1f ns/call  %12.0f calls/sec\n", name, threads, seconds * 1e9 * threads / calls,
+           calls / seconds);
+}
+
+/**
+ * @brief Measure both recorders at each thread count and check the totals
+ *
+ * @param argc Argument count
+ * @param argv Optional calls per thread in argv[1]
+ * @return 0 on success, 1 if an aggregated total is wrong
+ */
+int main(int argc, char *argv[])
+{
+    static const int thread_counts[] = { 1, 8, 32 };
+
+    calls_per_thread = argc > 1 ? atol(argv[1]) : DEFAULT_CALLS;
+    if (calls_per_thread <= 0)
+    {
+        fprintf(stderr, "Usage: %s [calls_per_thread]\n", argv[0]);
+        return 1;
+    }
+
+    init_perf_monitor(NULL);
+
+    printf("=== Metrics Counter Benchmark ===\n");
+    printf("%ld status updates per thread; ns/call is thread time per call\n\n", calls_per_thread);
+
+    int failures = 0;
+    unsigned long expected = 0;
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+    {
+        int threads = thread_counts[t];
+        double mutex_seconds = run_threads(threads, mutex_worker);
+        double sharded_seconds = run_threads(threads, sharded_worker);
+
+        report("mutex", threads, mutex_seconds);
+        report("sharded", threads, sharded_seconds);
+        printf("  speedup  %.1fx\n\n", mutex_seconds / sharded_seconds);
+
+        expected += (unsigned long)threads * calls_per_thread;
+        pthread_mutex_lock(&metrics.metrics_lock);
+        perf_aggregate();
+        int exact = metrics.status_updates_received == expected && metrics.messages_processed == expected &&
+                    metrics.total_bytes_received == expected * MESSAGE_BYTES;
+        pthread_mutex_unlock(&metrics.metrics_lock);
+        if (!exact)
+        {
+            fprintf(stderr, "✗ Aggregated totals after %d threads: %lu updates, expected %lu\n", threads,
+                    metrics.status_updates_received, expected);
+            failures++;
+        }
+    }
+
+    if (failures)
+        return 1;
+
+    printf("✓ Aggregated shard totals match every recorded call\n");
+    return 0;
+}
+
+/** @} */ // end of metrics_benchmark group
@@ -0,0 +1,196 @@
+/**
+ * @file metrics_export_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the Prometheus text output of the metrics
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Records known metrics and checks what perf_format_prometheus() renders
+ * from them.
+ *
+ * **Test Coverage:**
+ * - Every line is a comment or a `name{labels} value` sample
+ * - Every sample belongs to a family declared by a preceding # TYPE line
+ * - Recorded counters and latency counts appear with their values
+ * - Quantiles of one operation are ordered
+ * - A buffer too small for the output is reported, not overrun
+ *
+ * **Usage:**
+ * Run with `make test_metrics_export`. The program exits non-zero if any
+ * check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/server_throughput.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @defgroup metrics_export_testing Metrics Export Testing
+ * @brief Test program for the Prometheus metrics output
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Size of the output buffer */
+#define OUTPUT_SIZE 32768
+
+/** @brief Status updates recorded before rendering */
+#define STATUS_UPDATES 250
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief Check that the text is well-formed exposition format
+ *
+ * Samples must be `name value` or `name{labels} value`, with the name
+ * (minus a _sum or _count suffix) declared by the last # TYPE line.
+ *
+ * @return 1 if every line is valid
+ */
+static int exposition_valid(char *text)
+{
+    char family[128] = "";
+    for (char *line = strtok(text, "\n"); line; line = strtok(NULL, "\n"))
+    {
+        if (strncmp(line, "# HELP ", 7) == 0)
+            continue;
+        if (strncmp(line, "# TYPE ", 7) == 0)
+        {
+            if (sscanf(line + 7, "%127s", family) != 1)
+                return 0;
+            continue;
+        }
+
+        size_t name_length = 0;
+        while (isalnum((unsigned char)line[name_length]) || line[name_length] == '_')
+            name_length++;
+        if (name_length == 0 || strncmp(line, family, strlen(family)) != 0)
+            return 0;
+
+        const char *suffix = line + strlen(family);
+        if (suffix != line + name_length && strncmp(suffix, "_sum", 4) != 0 && strncmp(suffix, "_count", 6) != 0)
+            return 0;
+
+        // clang-format off
+        const char *value = line + name_length;
+        // clang-format on
+        if (*value == '{')
+        {
+            value = strchr(value, '}');
+            if (!value)
+                return 0;
+            value++;
+        }
+        char *end;
+        if (*value != ' ' || (strtod(value + 1, &end), *end != '\0') || end == value + 1)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Value of the first sample whose line starts with @p prefix
+ *
+ * @return The value, or -1 if no line matches
+ */
+static double sample_value(const char *text, const char *prefix)
+{
+    // clang-format off
+    const char *line = text;
+    // clang-format on
+    while (line && *line)
+    {
+        if (strncmp(line, prefix, strlen(prefix)) == 0)
+            return strtod(line + strlen(prefix), NULL);
+        line = strchr(line, '\n');
+        if (line)
+            line++;
+    }
+    return -1;
+}
+
+/**
+ * @brief Run all export checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    static char output[OUTPUT_SIZE];
+
+    init_perf_monitor(NULL);
+    for (int i = 0; i < STATUS_UPDATES; i++)
+    {
+        perf_record_status_update(100);
+        perf_record_latency(PERF_OP_STATUS_UPDATE, 0.05 + i * 0.001);
+    }
+    perf_record_heartbeat(40);
+    perf_record_error();
+    perf_record_connection(1);
+    perf_record_latency(PERF_OP_AI_CYCLE, 12.0);
+
+    printf("=== PHASE 1: Rendering ===\n");
+    int length = perf_format_prometheus(output, sizeof(output));
+    check(length > 0 && (size_t)length == strlen(output), "metrics are rendered and the length is returned");
+
+    printf("\n=== PHASE 2: Values ===\n");
+    check(sample_value(output, "drone_messages_processed_total ") == STATUS_UPDATES + 1, "messages counter");
+    check(sample_value(output, "drone_received_bytes_total ") == STATUS_UPDATES * 100, "received bytes counter");
+    check(sample_value(output, "drone_errors_total ") == 1 && sample_value(output, "drone_active_connections ") == 1,
+          "error counter and connection gauge");
+    check(sample_value(output, "drone_operation_latency_seconds_count{operation=\"status_update\"}") ==
+                  STATUS_UPDATES &&
+              sample_value(output, "drone_operation_latency_seconds_count{operation=\"heartbeat\"}") == 0,
+          "latency sample counts per operation");
+
+    double p50 = sample_value(output, "drone_operation_latency_seconds{operation=\"status_update\",quantile=\"0.5\"}");
+    double p99 =
+        sample_value(output, "drone_operation_latency_seconds{operation=\"status_update\",quantile=\"0.99\"}");
+    check(p50 > 0.00016 && p50 < 0.00018 && p99 >= p50, "status update quantiles are in seconds and ordered");
+
+    double ai_p999 = sample_value(output, "drone_operation_latency_seconds{operation=\"ai_cycle\",quantile=\"0.999\"}");
+    check(ai_p999 > 0.0118 && ai_p999 < 0.0122, "single AI cycle sample is reported within a bucket");
+
+    printf("\n=== PHASE 3: Format ===\n");
+    check(exposition_valid(output), "every line is a comment or a sample of the declared family");
+
+    char small[256];
+    check(perf_format_prometheus(small, sizeof(small)) == -1, "a buffer too small is reported");
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All metrics export checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of metrics_export_testing group
@@ -0,0 +1,292 @@
+/**
+ * @file mission_trace_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the mission trace ring and stage histograms
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Checks how finished missions are split into stages, what happens when
+ * the ring fills up, and that traces pushed from several threads while
+ * the consumer drains them arrive whole and exactly once.
+ *
+ * **Test Coverage:**
+ * - Each stage is measured between the right pair of timestamps
+ * - Unstamped or out-of-order stages are left out
+ * - A full ring drops and counts further traces, then accepts new ones
+ *   once drained
+ * - Traces pushed from several threads while the ring is drained are
+ *   popped whole, once each and in each producer's order
+ * - The JSON export contains every stage
+ *
+ * **Usage:**
+ * Run with `make test_mission_trace`. The program exits non-zero if any
+ * check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/mission_trace.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @defgroup mission_trace_testing Mission Trace Testing
+ * @brief Test program for the mission trace ring
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Producer threads in the concurrency test */
+#define PRODUCERS 4
+
+/** @brief Traces pushed by each producer in the concurrency test */
+#define TRACES_PER_PRODUCER 200000
+
+/** @brief File written by the export check */
+#define EXPORT_FILE "mission_trace_test.json"
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/** @brief Buffer shared by the concurrency test threads */
+static MissionTraceBuffer shared;
+
+/** @brief Producers that have pushed their last trace */
+static atomic_int producers_done = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief A trace whose stages last @p waiting, @p dispatch and @p travel milliseconds
+ */
+static MissionTrace make_trace(int survivor, int drone, uint64_t waiting, uint64_t dispatch, uint64_t travel)
+{
+    MissionTrace trace = { .survivor = survivor, .drone = drone, .spawned_ns = 1000000000ULL };
+    trace.assigned_ns = trace.spawned_ns + waiting * 1000000ULL;
+    trace.sent_ns = trace.assigned_ns + dispatch * 1000000ULL;
+    trace.completed_ns = trace.sent_ns + travel * 1000000ULL;
+    return trace;
+}
+
+/**
+ * @brief Samples recorded in a stage histogram
+ */
+static unsigned long stage_count(const MissionTraceBuffer *buffer, MissionStage stage)
+{
+    double p50;
+    return latency_histogram_percentiles(&buffer->stages[stage], (const double[]){ 50.0 }, 1, &p50);
+}
+
+/**
+ * @brief Mean of a stage histogram in milliseconds
+ */
+static double stage_mean(const MissionTraceBuffer *buffer, MissionStage stage)
+{
+    unsigned long count = stage_count(buffer, stage);
+    return count > 0 ? latency_histogram_sum_ms(&buffer->stages[stage]) / count : 0;
+}
+
+/**
+ * @brief Producer of the concurrency test
+ *
+ * Trace n of producer p has survivor n and drone p, and every timestamp
+ * derived from both, so the consumer can tell a torn copy from a whole one.
+ * A full ring is retried so that every trace eventually goes through it.
+ */
+static void *producer(void *arg)
+{
+    int id = (int)(long)arg;
+    for (int n = 0; n < TRACES_PER_PRODUCER; n++)
+    {
+        MissionTrace trace = { .survivor = n, .drone = id };
+        trace.spawned_ns = (uint64_t)n * PRODUCERS + id + 1;
+        trace.assigned_ns = trace.spawned_ns + 1;
+        trace.sent_ns = trace.spawned_ns + 2;
+        trace.completed_ns = trace.spawned_ns + 3;
+        while (mission_trace_record(&shared, &trace) != 0)
+            sched_yield();
+    }
+    atomic_fetch_add(&producers_done, 1);
+    return NULL;
+}
+
+/**
+ * @brief Run all mission trace checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    static MissionTraceBuffer buffer;
+    MissionTrace trace;
+
+    printf("=== PHASE 1: Stage split ===\n");
+    mission_trace_init(&buffer);
+    check(mission_trace_pop(&buffer, &trace) == 0, "an empty ring has nothing to pop");
+
+    for (int i = 0; i < 10; i++)
+    {
+        MissionTrace finished = make_trace(i, 7, 100, 2, 40);
+        mission_trace_record(&buffer, &finished);
+    }
+    check(mission_trace_aggregate(&buffer) == 10 && buffer.aggregated == 10, "every recorded trace is drained");
+    double waiting = stage_mean(&buffer, MISSION_STAGE_WAITING);
+    double dispatch = stage_mean(&buffer, MISSION_STAGE_DISPATCH);
+    double travel = stage_mean(&buffer, MISSION_STAGE_TRAVEL);
+    double total = stage_mean(&buffer, MISSION_STAGE_TOTAL);
+    printf("  waiting %.2f ms, dispatch %.2f ms, travel %.2f ms, total %.2f ms\n", waiting, dispatch, travel, total);
+    // Means come from histogram buckets, so allow a few percent
+    check(waiting > 97.0 && waiting < 103.0 && dispatch > 1.9 && dispatch < 2.1 && travel > 38.0 && travel < 42.0,
+          "each stage is measured between its own timestamps");
+    check(total > 137.0 && total < 147.0, "the total runs from spawn to rescue");
+
+    MissionTrace unstamped = make_trace(0, 0, 5, 5, 5);
+    unstamped.spawned_ns = 0;
+    MissionTrace reordered = make_trace(0, 0, 5, 5, 5);
+    reordered.completed_ns = reordered.spawned_ns - 1;
+    // Rescue handled before the send was stamped
+    MissionTrace unsent = make_trace(0, 0, 5, 5, 5);
+    unsent.sent_ns = 0;
+    mission_trace_record(&buffer, &unstamped);
+    mission_trace_record(&buffer, &reordered);
+    mission_trace_record(&buffer, &unsent);
+    mission_trace_aggregate(&buffer);
+    check(stage_count(&buffer, MISSION_STAGE_WAITING) == 12 && stage_count(&buffer, MISSION_STAGE_DISPATCH) == 12 &&
+              stage_count(&buffer, MISSION_STAGE_TRAVEL) == 11 && stage_count(&buffer, MISSION_STAGE_TOTAL) == 11,
+          "unstamped and out-of-order stages are left out");
+    check(strcmp(mission_stage_name(MISSION_STAGE_TRAVEL), "travel") == 0 &&
+              strcmp(mission_stage_name(MISSION_STAGE_COUNT), "unknown") == 0,
+          "stages are named as in the exported JSON");
+
+    printf("\n=== PHASE 2: Full ring ===\n");
+    mission_trace_init(&buffer);
+    int accepted = 0;
+    for (int i = 0; i < MISSION_TRACE_CAPACITY + 100; i++)
+    {
+        MissionTrace finished = make_trace(i, 1, 1, 1, 1);
+        accepted += mission_trace_record(&buffer, &finished) == 0;
+    }
+    check(accepted == MISSION_TRACE_CAPACITY && atomic_load(&buffer.dropped) == 100,
+          "traces beyond the capacity are dropped and counted");
+
+    int in_order = 1;
+    for (int i = 0; i < MISSION_TRACE_CAPACITY; i++)
+    {
+        in_order &= mission_trace_pop(&buffer, &trace) == 1 && trace.survivor == i;
+    }
+    check(in_order && mission_trace_pop(&buffer, &trace) == 0, "the kept traces come out oldest first");
+
+    MissionTrace later = make_trace(-1, 1, 1, 1, 1);
+    check(mission_trace_record(&buffer, &later) == 0 && mission_trace_pop(&buffer, &trace) == 1 &&
+              trace.survivor == -1,
+          "a drained ring accepts traces again");
+
+    printf("\n=== PHASE 3: Concurrent producers ===\n");
+    mission_trace_init(&shared);
+    pthread_t threads[PRODUCERS];
+    for (long p = 0; p < PRODUCERS; p++)
+    {
+        pthread_create(&threads[p], NULL, producer, (void *)p);
+    }
+
+    // clang-format off
+    int *next = calloc(PRODUCERS, sizeof(int));
+    // clang-format on
+    unsigned long popped = 0;
+    int intact = 1;
+    int ordered = 1;
+    int finished = 0;
+    while (!finished)
+    {
+        // Drain once more after the producers finished to catch their last traces
+        finished = atomic_load(&producers_done) == PRODUCERS;
+        while (mission_trace_pop(&shared, &trace))
+        {
+            popped++;
+            if (trace.drone < 0 || trace.drone >= PRODUCERS)
+            {
+                intact = 0;
+                continue;
+            }
+            uint64_t spawned = (uint64_t)trace.survivor * PRODUCERS + trace.drone + 1;
+            intact &= trace.spawned_ns == spawned && trace.assigned_ns == spawned + 1 &&
+                      trace.sent_ns == spawned + 2 && trace.completed_ns == spawned + 3;
+            ordered &= trace.survivor == next[trace.drone];
+            next[trace.drone] = trace.survivor + 1;
+        }
+    }
+    for (int p = 0; p < PRODUCERS; p++)
+    {
+        pthread_join(threads[p], NULL);
+    }
+    free(next);
+
+    printf("  %lu popped of %d pushed, %lu pushes retried on a full ring\n",
+           popped,
+           PRODUCERS * TRACES_PER_PRODUCER,
+           (unsigned long)atomic_load(&shared.dropped));
+    check(intact, "every popped trace is whole");
+    check(ordered, "each producer's traces are popped once each, in the order pushed");
+    check(popped == (unsigned long)PRODUCERS * TRACES_PER_PRODUCER, "every pushed trace is popped");
+
+    printf("\n=== PHASE 4: JSON export ===\n");
+    mission_trace_init(&buffer);
+    for (int i = 0; i < 5; i++)
+    {
+        MissionTrace exported = make_trace(i, 2, 10, 1, 20);
+        mission_trace_record(&buffer, &exported);
+    }
+    check(mission_trace_export_json(&buffer, EXPORT_FILE) == 0, "the export succeeds");
+
+    char contents[4096] = { 0 };
+    // clang-format off
+    FILE *file = fopen(EXPORT_FILE, "r");
+    // clang-format on
+    if (file)
+    {
+        size_t length = fread(contents, 1, sizeof(contents) - 1, file);
+        contents[length] = '\0';
+        fclose(file);
+    }
+    remove(EXPORT_FILE);
+    check(strstr(contents, "\"missions\": 5") && strstr(contents, "\"dropped\": 0"),
+          "the export counts the drained missions");
+    check(strstr(contents, "\"waiting\"") && strstr(contents, "\"dispatch\"") && strstr(contents, "\"travel\"") &&
+              strstr(contents, "\"total\"") && strstr(contents, "\"share_of_total\""),
+          "the export lists every stage");
+    check(mission_trace_export_json(&buffer, "/nonexistent/mission_traces.json") == -1,
+          "an unwritable file is reported");
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All mission trace checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of mission_trace_testing group
@@ -0,0 +1,279 @@
+/**
+ * @file parser_benchmark.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Benchmark of the allocation-free message parser against json-c
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Decodes a representative mix of drone messages (mostly STATUS_UPDATE)
+ * with two decoders and reports throughput and heap allocations for each:
+ *
+ * - json-c: json_tokener_parse() plus json_object_object_get_ex() lookups,
+ *   the way the server handled every message before message_parser.c
+ * - fast: parse_drone_message() into a DroneMessage on the stack
+ *
+ * **Allocation Counting:**
+ * The program defines malloc(), calloc(), realloc() and free() itself and
+ * forwards them to the glibc implementations, counting each call. Calls
+ * made from inside libc (e.g. strdup) are not seen, so the json-c figure
+ * is a lower bound.
+ *
+ * **Usage:**
+ * `make bench_parser` or `./tests/parser_benchmark [iterations]`. The
+ * program exits non-zero if the fast path allocates at all or if the two
+ * decoders disagree.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ * @ingroup performance_testing
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "../headers/message_parser.h"
+#include <json-c/json.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @defgroup parser_benchmark Message Parser Benchmark
+ * @brief Throughput and allocation comparison of the message decoders
+ * @ingroup performance_testing
+ * @{
+ */
+
+/** @brief Default number of messages decoded per decoder */
+#define DEFAULT_ITERATIONS 1000000
+
+/** @brief Heap allocations observed since the counter was last reset */
+static unsigned long allocation_count = 0;
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+/** @brief Counting wrapper around the glibc allocator */
+void *malloc(size_t size)
+{
+    allocation_count++;
+    return __libc_malloc(size);
+}
+
+/** @brief Counting wrapper around the glibc allocator */
+void *calloc(size_t count, size_t size)
+{
+    allocation_count++;
+    return __libc_calloc(count, size);
+}
+
+/** @brief Counting wrapper around the glibc allocator */
+void *realloc(void *ptr, size_t size)
+{
+    allocation_count++;
+    return __libc_realloc(ptr, size);
+}
+
+/** @brief Forwarding wrapper; frees are not counted */
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+/**
+ * @brief Traffic mix, weighted the way a drone fleet sends it
+ *
+ * Each drone sends a status update every second and a heartbeat response
+ * every ten; mission completions are rare.
+ */
+static const char *sample_messages[] = {
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D1\",\"timestamp\":1700000000,"
+    "\"location\":{\"x\":12,\"y\":30},\"status\":\"busy\",\"battery\":87,\"speed\":5}",
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D2\",\"timestamp\":1700000001,"
+    "\"location\":{\"x\":4,\"y\":7},\"status\":\"idle\",\"battery\":100,\"speed\":0}",
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D3\",\"timestamp\":1700000002,"
+    "\"location\":{\"x\":27,\"y\":1},\"status\":\"busy\",\"battery\":42,\"speed\":5}",
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D4\",\"timestamp\":1700000003,"
+    "\"location\":{\"x\":0,\"y\":39},\"status\":\"idle\",\"battery\":63,\"speed\":0}",
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D5\",\"timestamp\":1700000004,"
+    "\"location\":{\"x\":15,\"y\":22},\"status\":\"busy\",\"battery\":91,\"speed\":5}",
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D6\",\"timestamp\":1700000005,"
+    "\"location\":{\"x\":9,\"y\":18},\"status\":\"busy\",\"battery\":55,\"speed\":5}",
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D7\",\"timestamp\":1700000006,"
+    "\"location\":{\"x\":21,\"y\":11},\"status\":\"idle\",\"battery\":78,\"speed\":0}",
+    "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D8\",\"timestamp\":1700000007,"
+    "\"location\":{\"x\":3,\"y\":35},\"status\":\"busy\",\"battery\":24,\"speed\":5}",
+    "{\"type\":\"HEARTBEAT_RESPONSE\",\"drone_id\":\"D1\",\"timestamp\":1700000008}",
+    "{\"type\":\"MISSION_COMPLETE\",\"drone_id\":\"D2\",\"mission_id\":\"M17\",\"timestamp\":1700000009,"
+    "\"success\":true,\"details\":\"Delivered aid to survivor.\",\"target_location\":{\"x\":4,\"y\":7}}",
+};
+
+/** @brief Number of messages in the traffic mix */
+#define SAMPLE_COUNT ((int)(sizeof(sample_messages) / sizeof(sample_messages[0])))
+
+/**
+ * @brief Decode a message the way the server did with json-c
+ *
+ * Reads the same fields the fast parser reports and folds them into a
+ * checksum so the work cannot be optimized away.
+ *
+ * @param text NUL-terminated message
+ * @return Checksum of the decoded fields, or -1 on parse failure
+ */
+static long decode_with_json_c(const char *text)
+{
+    // clang-format off
+    struct json_object *parsed_json = json_tokener_parse(text);
+    struct json_object *value, *x_obj, *y_obj;
+    // clang-format on
+    if (parsed_json == NULL)
+    {
+        return -1;
+    }
+
+    long checksum = 0;
+    if (json_object_object_get_ex(parsed_json, "type", &value))
+    {
+        const char *type = json_object_get_string(value);
+        checksum += drone_message_type_from_name(type, strlen(type));
+    }
+    if ((json_object_object_get_ex(parsed_json, "location", &value) ||
+         json_object_object_get_ex(parsed_json, "target_location", &value)) &&
+        json_object_object_get_ex(value, "x", &x_obj) && json_object_object_get_ex(value, "y", &y_obj))
+    {
+        checksum += json_object_get_int(x_obj) * 100 + json_object_get_int(y_obj);
+    }
+    if (json_object_object_get_ex(parsed_json, "status", &value))
+    {
+        const char *status = json_object_get_string(value);
+        checksum += drone_status_from_name(status, strlen(status)) * 1000;
+    }
+
+    json_object_put(parsed_json);
+    return checksum;
+}
+
+/**
+ * @brief Decode a message with the allocation-free parser
+ *
+ * @param text Message
+ * @param length Message length
+ * @return Checksum of the decoded fields, or -1 on parse failure
+ */
+static long decode_with_fast_parser(const char *text, size_t length)
+{
+    DroneMessage message;
+    if (parse_drone_message(text, length, &message) != 0)
+    {
+        return -1;
+    }
+
+    long checksum = message.type;
+    if (message.fields & DRONE_FIELD_LOCATION)
+        checksum += message.location.x * 100 + message.location.y;
+    else if (message.fields & DRONE_FIELD_TARGET)
+        checksum += message.target.x * 100 + message.target.y;
+    if (message.fields & DRONE_FIELD_STATUS)
+        checksum += message.status * 1000;
+    return checksum;
+}
+
+/**
+ * @brief Seconds elapsed since a monotonic timestamp
+ */
+static double seconds_since(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * @brief Print one result line
+ */
+static void report(const char *name, long iterations, double seconds, unsigned long allocations)
+{
+    printf("  %-8s %12.0f msgs/sec  %8.1f ns/msg  %6.2f allocs/msg\n", name, iterations / seconds,
+           seconds * 1e9 / iterations, (double)allocations / iterations);
+}
+
+/**
+ * @brief Run both decoders over the traffic mix and compare them
+ *
+ * @param argc Argument count
+ * @param argv Optional iteration count in argv[1]
+ * @return 0 on success, 1 if the fast path allocated or the decoders disagree
+ */
+int main(int argc, char *argv[])
+{
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    size_t lengths[SAMPLE_COUNT];
+    size_t total_bytes = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        lengths[i] = strlen(sample_messages[i]);
+        total_bytes += lengths[i];
+    }
+
+    printf("=== Drone Message Parser Benchmark ===\n");
+    printf("%ld messages per decoder, %d-message mix, %.0f bytes average\n\n", iterations, SAMPLE_COUNT,
+           (double)total_bytes / SAMPLE_COUNT);
+
+    // Both decoders must agree before their speed means anything
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        long expected = decode_with_json_c(sample_messages[i]);
+        long actual = decode_with_fast_parser(sample_messages[i], lengths[i]);
+        if (expected < 0 || expected != actual)
+        {
+            fprintf(stderr, "Decoders disagree on message %d: json-c %ld, fast %ld\n", i, expected, actual);
+            return 1;
+        }
+    }
+
+    struct timespec start;
+    volatile long sink = 0;
+
+    allocation_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < iterations; i++)
+    {
+        sink += decode_with_json_c(sample_messages[i % SAMPLE_COUNT]);
+    }
+    double json_seconds = seconds_since(&start);
+    unsigned long json_allocations = allocation_count;
+
+    allocation_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < iterations; i++)
+    {
+        sink += decode_with_fast_parser(sample_messages[i % SAMPLE_COUNT], lengths[i % SAMPLE_COUNT]);
+    }
+    double fast_seconds = seconds_since(&start);
+    unsigned long fast_allocations = allocation_count;
+
+    printf("Results:\n");
+    report("json-c", iterations, json_seconds, json_allocations);
+    report("fast", iterations, fast_seconds, fast_allocations);
+    printf("\nSpeedup: %.1fx\n", json_seconds / fast_seconds);
+    (void)sink;
+
+    if (fast_allocations != 0)
+    {
+        fprintf(stderr, "✗ Fast parser performed %lu allocations\n", fast_allocations);
+        return 1;
+    }
+
+    printf("✓ Fast parser performed no allocations\n");
+    return 0;
+}
+
+/** @} */ // end of parser_benchmark group
@@ -0,0 +1,322 @@
+/**
+ * @file protocol_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the drone protocol stream handling
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * This test program exercises the message framing layer that sits between
+ * recv() and the protocol handlers. It feeds the framer byte streams the
+ * way TCP actually delivers them: split mid-message, coalesced, wrapped
+ * around the end of the ring, and oversized.
+ *
+ * **Test Coverage:**
+ * - Brace framing with messages split across several reads
+ * - Several messages coalesced into one read
+ * - Braces and escaped quotes inside JSON strings
+ * - Newline framing with CRLF and empty lines
+ * - Mode switches, including the separator after a JSON handshake when
+ *   the connection moves to binary
+ * - Frames that wrap around the end of the ring buffer
+ * - Messages larger than the ring are reported, not silently dropped
+ * - Allocation-free decoding of every drone message type, and rejection
+ *   of the shapes that must fall back to json-c
+ * - Binary wire encoding: round trips, length-prefixed framing and the
+ *   encodings offered at HANDSHAKE
+ *
+ * **Usage:**
+ * Run with `make test_protocol`. The program exits non-zero if any check
+ * fails, so it can run unattended in CI.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/framer.h"
+#include "../headers/message_parser.h"
+#include "../headers/wire.h"
+#include "../headers/drone.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @defgroup protocol_testing Protocol Testing
+ * @brief Test programs for the drone network protocol
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief Copy bytes into a framer the way recv() would
+ *
+ * @param framer Framer to feed
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * @return Number of bytes accepted (less than length if the ring filled up)
+ */
+static size_t feed(MessageFramer *framer, const char *data, size_t length)
+{
+    size_t written = 0;
+    while (written < length)
+    {
+        size_t space;
+        char *dest = framer_write_space(framer, &space);
+        if (space == 0)
+            break;
+        size_t chunk = length - written < space ? length - written : space;
+        memcpy(dest, data + written, chunk);
+        framer_commit(framer, chunk);
+        written += chunk;
+    }
+    return written;
+}
+
+/**
+ * @brief Check that the next frame exists and equals the expected text
+ *
+ * @param framer Framer to read from
+ * @param expected Expected frame contents
+ * @param frame Receives the frame that was read
+ * @return Non-zero if the frame matched
+ */
+static int next_frame_is(MessageFramer *framer, const char *expected, Frame *frame)
+{
+    if (framer_next(framer, frame) != 1)
+        return 0;
+    return frame->length == strlen(expected) && memcmp(frame->data, expected, frame->length) == 0;
+}
+
+/**
+ * @brief Decode a NUL-terminated message with the allocation-free parser
+ *
+ * @param text Message text
+ * @param message Receives the decoded fields
+ * @return Result of parse_drone_message()
+ */
+static int parse(const char *text, DroneMessage *message)
+{
+    return parse_drone_message(text, strlen(text), message);
+}
+
+/**
+ * @brief Main test function for the framing layer and message parser
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main()
+{
+    MessageFramer framer;
+    Frame frame;
+
+    printf("=== Drone Protocol Stream Test Suite ===\n");
+
+    printf("\n=== PHASE 1: Brace framing across split reads ===\n");
+    framer_init(&framer, 256, FRAME_BRACE);
+    feed(&framer, "{\"type\":\"STATUS_", 16);
+    check(framer_next(&framer, &frame) == 0, "partial message is held back");
+    feed(&framer, "UPDATE\",\"location\":{\"x\":1,", 26);
+    check(framer_next(&framer, &frame) == 0, "nested partial message is held back");
+    feed(&framer, "\"y\":2}}\n", 8);
+    check(next_frame_is(&framer, "{\"type\":\"STATUS_UPDATE\",\"location\":{\"x\":1,\"y\":2}}", &frame),
+          "message completed by a later read is delivered whole");
+    check(framer_next(&framer, &frame) == 0, "trailing newline produces no frame");
+
+    printf("\n=== PHASE 2: Coalesced messages and string contents ===\n");
+    const char *coalesced = "{\"a\":\"}{\"}{\"b\":\"\\\"}\"}\n\n{\"c\":1}";
+    feed(&framer, coalesced, strlen(coalesced));
+    check(next_frame_is(&framer, "{\"a\":\"}{\"}", &frame), "braces inside strings are ignored");
+    check(next_frame_is(&framer, "{\"b\":\"\\\"}\"}", &frame), "escaped quotes inside strings are handled");
+    check(next_frame_is(&framer, "{\"c\":1}", &frame), "third coalesced message is delivered");
+    check(framer_next(&framer, &frame) == 0, "no frames left after coalesced read");
+    framer_destroy(&framer);
+
+    printf("\n=== PHASE 3: Newline framing ===\n");
+    framer_init(&framer, 256, FRAME_NEWLINE);
+    feed(&framer, "{\"x\":1}\r\n\n{\"y\"", 14);
+    check(next_frame_is(&framer, "{\"x\":1}", &frame), "CRLF terminator is stripped");
+    check(framer_next(&framer, &frame) == 0, "empty line skipped, partial line held");
+    feed(&framer, ":2}\n", 4);
+    check(next_frame_is(&framer, "{\"y\":2}", &frame), "line completed by a later read");
+    framer_destroy(&framer);
+
+    printf("\n=== PHASE 4: Frames wrapping around the ring ===\n");
+    framer_init(&framer, 32, FRAME_BRACE);
+    int wrapped_ok = 1;
+    for (int i = 0; i < 50 && wrapped_ok; i++)
+    {
+        char message[32];
+        int length = snprintf(message, sizeof(message), "{\"seq\":%d,\"pad\":\"xx\"}", i);
+        // Split every message in two reads at a varying offset
+        int split = 1 + i % (length - 1);
+        feed(&framer, message, (size_t)split);
+        if (framer_next(&framer, &frame) != 0)
+            wrapped_ok = 0;
+        feed(&framer, message + split, (size_t)(length - split));
+        if (!next_frame_is(&framer, message, &frame))
+            wrapped_ok = 0;
+        // Frames must tolerate a temporary terminator after their last byte
+        frame.data[frame.length] = '\0';
+    }
+    check(wrapped_ok, "50 split messages delivered intact through a 32-byte ring");
+    framer_destroy(&framer);
+
+    printf("\n=== PHASE 5: Oversized messages ===\n");
+    framer_init(&framer, 16, FRAME_BRACE);
+    feed(&framer, "{\"too\":\"long for the ring\"}", 27);
+    check(framer_next(&framer, &frame) == -1, "message larger than the ring is reported");
+    framer_destroy(&framer);
+
+    printf("\n=== PHASE 6: Mode switch at a frame boundary ===\n");
+    framer_init(&framer, 64, FRAME_BRACE);
+    feed(&framer, "{\"h\":1}line one\n", 16);
+    check(next_frame_is(&framer, "{\"h\":1}", &frame), "first frame read in brace mode");
+    framer_set_mode(&framer, FRAME_NEWLINE);
+    check(next_frame_is(&framer, "line one", &frame), "buffered bytes rescanned in newline mode");
+    framer_destroy(&framer);
+
+    // A HANDSHAKE, its newline (split across reads) and a binary heartbeat response
+    const char binary_after_text[] = {'\n', WIRE_PROTOCOL_VERSION, WIRE_HEARTBEAT_RESPONSE, 0, 0};
+    framer_init(&framer, 64, FRAME_BRACE);
+    feed(&framer, "{\"h\":1}\r", 8);
+    check(next_frame_is(&framer, "{\"h\":1}", &frame), "handshake read in brace mode");
+    framer_set_mode(&framer, FRAME_BINARY);
+    check(framer_next(&framer, &frame) == 0, "separator alone is not a binary frame");
+    feed(&framer, binary_after_text, sizeof(binary_after_text));
+    check(framer_next(&framer, &frame) == 1 && frame.length == 4 &&
+              wire_frame_type(frame.data, frame.length) == WIRE_HEARTBEAT_RESPONSE,
+          "newline after the handshake is skipped in binary mode");
+    framer_destroy(&framer);
+
+    printf("\n=== PHASE 7: Allocation-free message parsing ===\n");
+    DroneMessage message;
+    check(parse("{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D1\",\"timestamp\":1700000000,"
+                "\"location\":{\"x\":12,\"y\":-3},\"status\":\"busy\",\"battery\":87,\"speed\":5,"
+                "\"extra\":[1,{\"a\":\"b\\\"c\"},null,true,2.5e3]}",
+                &message) == 0 &&
+              message.type == DRONE_MSG_STATUS_UPDATE && message.location.x == 12 && message.location.y == -3 &&
+              message.status == ON_MISSION && message.battery == 87 && message.timestamp == 1700000000L,
+          "STATUS_UPDATE fields decoded, unknown members skipped");
+    check(parse(" { \"status\" : \"IDLE\" , \"coord\" : { \"y\" : 4 , \"x\" : 9 } , \"type\" : \"HANDSHAKE\" } ",
+                &message) == 0 &&
+              message.type == DRONE_MSG_HANDSHAKE && message.location.x == 9 && message.location.y == 4 &&
+              message.status == IDLE,
+          "HANDSHAKE decoded with whitespace and any key order");
+    check(parse("{\"type\":\"MISSION_COMPLETE\",\"mission_id\":\"M1\",\"success\":true,"
+                "\"target_location\":{\"x\":3,\"y\":7}}",
+                &message) == 0 &&
+              message.type == DRONE_MSG_MISSION_COMPLETE && (message.fields & DRONE_FIELD_TARGET) &&
+              message.target.x == 3 && message.target.y == 7 && message.success == 1,
+          "MISSION_COMPLETE target and outcome decoded");
+    check(parse("{\"type\":\"HEARTBEAT_RESPONSE\",\"drone_id\":\"D1\",\"timestamp\":1}", &message) == 0 &&
+              message.type == DRONE_MSG_HEARTBEAT_RESPONSE && !(message.fields & DRONE_FIELD_LOCATION),
+          "HEARTBEAT_RESPONSE decoded");
+    check(parse("{\"type\":\"STATUS_UPDATE\",\"status\":\"charging\"}", &message) == 0 &&
+              !(message.fields & DRONE_FIELD_STATUS),
+          "unknown status leaves the status field unset");
+    check(parse("{\"type\":\"STATUS_\\u0055PDATE\"}", &message) == -1, "escaped type falls back to json-c");
+    check(parse("{\"type\":\"STATUS_UPDATE\",\"location\":{\"x\":1.5,\"y\":2}}", &message) == -1,
+          "fractional coordinate falls back to json-c");
+    check(parse("{\"type\":\"REGISTER\"}", &message) == -1, "unknown message type falls back to json-c");
+    check(parse("{\"type\":\"HEARTBEAT_RESPONSE\",}", &message) == -1 &&
+              parse("{\"type\":\"HEARTBEAT_RESPONSE\"", &message) == -1 &&
+              parse("{\"type\":\"HEARTBEAT_RESPONSE\"}x", &message) == -1,
+          "malformed objects are rejected");
+
+    printf("\n=== PHASE 8: Binary wire encoding ===\n");
+    check(parse("{\"type\":\"HANDSHAKE\",\"encodings\":[\"binary\",\"json\",\"zstd\"]}", &message) == 0 &&
+              message.encodings == (WIRE_ENCODING_BINARY | WIRE_ENCODING_JSON),
+          "HANDSHAKE encodings parsed, unknown names ignored");
+
+    char wire_message[WIRE_MAX_MESSAGE_SIZE];
+    DroneMessage sent, received;
+    memset(&sent, 0, sizeof(sent));
+    sent.type = DRONE_MSG_STATUS_UPDATE;
+    sent.location = MAKE_COORD(29, -7);
+    sent.status = ON_MISSION;
+    sent.battery = 87;
+    size_t wire_length = wire_encode_drone_message(wire_message, &sent);
+    check(wire_length == 14, "STATUS_UPDATE encodes to 14 bytes");
+
+    // Deliver it one byte at a time through a binary framer
+    framer_init(&framer, 64, FRAME_BINARY);
+    int partial_held = 1;
+    for (size_t i = 0; i + 1 < wire_length; i++)
+    {
+        feed(&framer, wire_message + i, 1);
+        if (framer_next(&framer, &frame) != 0)
+            partial_held = 0;
+    }
+    feed(&framer, wire_message + wire_length - 1, 1);
+    check(partial_held && framer_next(&framer, &frame) == 1 && frame.length == wire_length,
+          "length-prefixed frame delivered only once complete");
+    check(wire_decode_drone_message(frame.data, frame.length, &received) == 0 &&
+              received.type == DRONE_MSG_STATUS_UPDATE && received.location.x == 29 && received.location.y == -7 &&
+              received.status == ON_MISSION && received.battery == 87 && (received.fields & DRONE_FIELD_STATUS),
+          "STATUS_UPDATE round trip");
+
+    memset(&sent, 0, sizeof(sent));
+    sent.type = DRONE_MSG_MISSION_COMPLETE;
+    sent.target = MAKE_COORD(3, 38);
+    sent.success = 1;
+    wire_length = wire_encode_drone_message(wire_message, &sent);
+    check(wire_decode_drone_message(wire_message, wire_length, &received) == 0 &&
+              received.type == DRONE_MSG_MISSION_COMPLETE && COORD_EQUAL(received.target, sent.target) &&
+              received.success == 1,
+          "MISSION_COMPLETE round trip");
+
+    WireAssignment assignment = {42, MAKE_COORD(17, 5), 1700003600L}, decoded_assignment;
+    wire_length = wire_encode_assignment(wire_message, &assignment);
+    check(wire_frame_type(wire_message, wire_length) == WIRE_ASSIGN_MISSION &&
+              wire_decode_assignment(wire_message, wire_length, &decoded_assignment) == 0 &&
+              decoded_assignment.mission_id == 42 && COORD_EQUAL(decoded_assignment.target, assignment.target) &&
+              decoded_assignment.expiry == 1700003600L,
+          "ASSIGN_MISSION round trip");
+
+    wire_message[0] = WIRE_PROTOCOL_VERSION + 1;
+    check(wire_decode_assignment(wire_message, wire_length, &decoded_assignment) == -1,
+          "version mismatch is rejected");
+
+    const char future_type[] = {WIRE_PROTOCOL_VERSION, 0x7f, 0, 2, 'h', 'i'};
+    check(wire_decode_drone_message(future_type, sizeof(future_type), &received) == 0 &&
+              received.type == DRONE_MSG_UNKNOWN,
+          "unknown binary types are skipped, not rejected");
+
+    const char huge_header[] = {WIRE_PROTOCOL_VERSION, WIRE_STATUS_UPDATE, 0x10, 0x00};
+    feed(&framer, huge_header, sizeof(huge_header));
+    check(framer_next(&framer, &frame) == -1, "binary frame larger than the ring is reported");
+    framer_destroy(&framer);
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All protocol checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of protocol_testing group
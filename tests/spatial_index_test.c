@@ -0,0 +1,252 @@
+/**
+ * @file spatial_index_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the grid-bucketed spatial index
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Checks the spatial index used by the AI against a brute-force scan.
+ *
+ * **Test Coverage:**
+ * - Empty index, insert, move within and across buckets, remove
+ * - Points outside the map are still found at their exact distance
+ * - Key table growth beyond the initial capacity
+ * - Randomized inserts, moves, removes and nearest queries compared with
+ *   a linear scan, for bucket spans of 1 to 4 cells
+ * - k-nearest queries return the k smallest distances in order
+ *
+ * **Usage:**
+ * Run with `make test_spatial`. The program exits non-zero if any check
+ * fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/spatial_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @defgroup spatial_index_testing Spatial Index Testing
+ * @brief Test program for the spatial index
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Map rows used by the tests (the simulator's map) */
+#define TEST_HEIGHT 30
+
+/** @brief Map columns used by the tests */
+#define TEST_WIDTH 40
+
+/** @brief Keys used by the randomized phase */
+#define RANDOM_KEYS 500
+
+/** @brief Operations per bucket span in the randomized phase */
+#define RANDOM_OPERATIONS 50000
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief Random coordinate, sometimes slightly outside the map
+ */
+static Coord random_coord(void)
+{
+    return MAKE_COORD(rand() % (TEST_HEIGHT + 6) - 3, rand() % (TEST_WIDTH + 6) - 3);
+}
+
+/**
+ * @brief Compare the index with a linear scan under random updates
+ *
+ * @param bucket_span Map cells per bucket side
+ * @return 1 if every query matched the linear scan, 0 otherwise
+ */
+static int random_operations_match(int bucket_span)
+{
+    SpatialIndex index;
+    Coord points[RANDOM_KEYS];
+    int indexed[RANDOM_KEYS] = { 0 };
+
+    if (spatial_index_init(&index, TEST_HEIGHT, TEST_WIDTH, bucket_span, 8) != 0)
+        return 0;
+
+    srand(bucket_span);
+    int ok = 1;
+    for (int i = 0; i < RANDOM_OPERATIONS && ok; i++)
+    {
+        int key = rand() % RANDOM_KEYS;
+        if (rand() % 3 < 2)
+        {
+            points[key] = random_coord();
+            spatial_index_insert(&index, key, points[key], &points[key]);
+            indexed[key] = 1;
+        }
+        else
+        {
+            spatial_index_remove(&index, key);
+            indexed[key] = 0;
+        }
+
+        Coord origin = random_coord();
+        int best = -1;
+        for (int k = 0; k < RANDOM_KEYS; k++)
+        {
+            if (indexed[k] && (best < 0 || MANHATTAN_DISTANCE(points[k], origin) < best))
+                best = MANHATTAN_DISTANCE(points[k], origin);
+        }
+
+        void *item = NULL;
+        int found = spatial_index_nearest(&index, origin, &item);
+        if (found < 0)
+            ok = best < 0;
+        else
+            ok = indexed[found] && item == &points[found] && MANHATTAN_DISTANCE(points[found], origin) == best;
+    }
+
+    int count = 0;
+    for (int k = 0; k < RANDOM_KEYS; k++)
+        count += indexed[k];
+    ok = ok && spatial_index_count(&index) == count;
+
+    spatial_index_destroy(&index);
+    return ok;
+}
+
+/**
+ * @brief Compare k-nearest queries with a sorted linear scan
+ *
+ * @param bucket_span Map cells per bucket side
+ * @param k Number of entries requested per query
+ * @return 1 if every query returned the k smallest distances in order
+ */
+static int nearest_k_matches(int bucket_span, int k)
+{
+    SpatialIndex index;
+    Coord points[RANDOM_KEYS];
+    int keys[RANDOM_KEYS];
+    int distances[RANDOM_KEYS];
+
+    if (spatial_index_init(&index, TEST_HEIGHT, TEST_WIDTH, bucket_span, RANDOM_KEYS) != 0)
+        return 0;
+
+    srand(100 + bucket_span);
+    int present = RANDOM_KEYS / 4;
+    for (int key = 0; key < present; key++)
+    {
+        points[key] = random_coord();
+        spatial_index_insert(&index, key, points[key], NULL);
+    }
+
+    int ok = 1;
+    for (int q = 0; q < 1000 && ok; q++)
+    {
+        Coord origin = random_coord();
+        int found = spatial_index_nearest_k(&index, origin, k, keys, distances);
+        ok = found == (k < present ? k : present);
+
+        // Each result is exact and sorted, and every entry closer than the
+        // farthest result is among the results
+        int closer_returned = 0;
+        for (int i = 0; i < found && ok; i++)
+        {
+            ok = distances[i] == MANHATTAN_DISTANCE(points[keys[i]], origin) &&
+                 (i == 0 || distances[i - 1] <= distances[i]);
+            closer_returned += distances[i] < distances[found - 1];
+        }
+        int closer = 0;
+        for (int key = 0; key < present; key++)
+        {
+            closer += MANHATTAN_DISTANCE(points[key], origin) < distances[found - 1];
+        }
+        ok = ok && closer == closer_returned;
+    }
+
+    spatial_index_destroy(&index);
+    return ok;
+}
+
+/**
+ * @brief Run all spatial index checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    SpatialIndex index;
+    int item_a = 0, item_b = 0;
+    // clang-format off
+    void *item = NULL;
+    // clang-format on
+
+    printf("=== PHASE 1: Basic operations ===\n");
+    check(spatial_index_init(&index, TEST_HEIGHT, TEST_WIDTH, 1, 2) == 0, "index initializes");
+    check(spatial_index_nearest(&index, MAKE_COORD(5, 5), &item) == -1, "empty index has no nearest entry");
+
+    spatial_index_insert(&index, 0, MAKE_COORD(2, 2), &item_a);
+    spatial_index_insert(&index, 1, MAKE_COORD(20, 30), &item_b);
+    check(spatial_index_nearest(&index, MAKE_COORD(25, 35), &item) == 1 && item == &item_b,
+          "nearest entry and its item are returned");
+    check(spatial_index_nearest(&index, MAKE_COORD(0, 0), NULL) == 0, "item pointer is optional");
+
+    spatial_index_insert(&index, 1, MAKE_COORD(1, 1), &item_b);
+    check(spatial_index_nearest(&index, MAKE_COORD(0, 0), NULL) == 1, "moved entry is found at its new cell");
+    check(spatial_index_count(&index) == 2, "moving does not change the count");
+
+    spatial_index_remove(&index, 1);
+    spatial_index_remove(&index, 1);
+    check(spatial_index_nearest(&index, MAKE_COORD(0, 0), NULL) == 0, "removed entry is no longer returned");
+    check(spatial_index_count(&index) == 1, "removing twice only counts once");
+
+    printf("\n=== PHASE 2: Edges and growth ===\n");
+    spatial_index_insert(&index, 7, MAKE_COORD(-4, 45), &item_b);
+    check(spatial_index_nearest(&index, MAKE_COORD(0, 39), &item) == 7 && item == &item_b,
+          "point outside the map is found");
+    check(index.capacity > 7, "key table grows past its initial capacity");
+    check(spatial_index_insert(&index, -1, MAKE_COORD(0, 0), NULL) == -1, "negative keys are rejected");
+    spatial_index_destroy(&index);
+
+    printf("\n=== PHASE 3: Random operations against a linear scan ===\n");
+    check(random_operations_match(1), "one bucket per cell matches the linear scan");
+    check(random_operations_match(2), "2x2-cell buckets match the linear scan");
+    check(random_operations_match(3), "3x3-cell buckets match the linear scan");
+    check(random_operations_match(4), "4x4-cell buckets match the linear scan");
+
+    printf("\n=== PHASE 4: k-nearest queries ===\n");
+    check(nearest_k_matches(1, 1), "k = 1 returns the nearest entry");
+    check(nearest_k_matches(1, 16), "k = 16 returns the 16 nearest entries in order");
+    check(nearest_k_matches(3, 16), "k = 16 with 3x3-cell buckets");
+    check(nearest_k_matches(1, RANDOM_KEYS), "k larger than the index returns every entry");
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All spatial index checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of spatial_index_testing group
@@ -0,0 +1,315 @@
+/**
+ * @file survivor_store_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the structure-of-arrays survivor store
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Checks the status bitsets and counters of SurvivorStore against its
+ * status byte array.
+ *
+ * **Test Coverage:**
+ * - Adding survivors, coordinates and zeroed cold fields
+ * - Iterating one status with survivor_store_next(), across word bounds
+ * - Changing status while iterating
+ * - Random status changes: counters equal bitset popcounts and every
+ *   bit agrees with the status byte
+ * - A full store: SURVIVOR_STORE_MAX survivors and the capacity limit
+ * - Clearing and reusing a store
+ * - Concurrent compare-and-swap claims: each survivor is claimed once and
+ *   the bitsets and counters stay exact
+ *
+ * **Usage:**
+ * Run with `make test_survivor_store`. The program exits non-zero if any
+ * check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/survivor_store.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @defgroup survivor_store_testing Survivor Store Testing
+ * @brief Test program for the survivor store
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Survivors in the random status test */
+#define RANDOM_SURVIVORS 5000
+
+/** @brief Random status changes applied */
+#define RANDOM_CHANGES 200000
+
+/** @brief Threads claiming survivors at the same time */
+#define CLAIM_THREADS 8
+
+/** @brief Survivors the claiming threads race for */
+#define CLAIM_SURVIVORS 20000
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief Check every bitset and counter against the status bytes
+ *
+ * @return 1 if the store is consistent
+ */
+static int store_consistent(const SurvivorStore *store)
+{
+    for (int s = 0; s < SURVIVOR_STATUS_COUNT; s++)
+    {
+        int popcount = 0;
+        for (int w = 0; w < (store->count + 63) / 64; w++)
+        {
+            popcount += __builtin_popcountll(store->status_bits[s][w]);
+        }
+        if (popcount != store->status_count[s])
+            return 0;
+    }
+
+    for (int i = 0; i < store->count; i++)
+    {
+        for (int s = 0; s < SURVIVOR_STATUS_COUNT; s++)
+        {
+            int bit = (store->status_bits[s][i / 64] >> (i % 64)) & 1;
+            if (bit != (store->status[i] == s))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Check that iterating a status visits exactly its survivors in order
+ *
+ * @return 1 if survivor_store_next() agrees with a scan of the status bytes
+ */
+static int iteration_matches(const SurvivorStore *store, int status)
+{
+    int expected = -1;
+    for (int i = survivor_store_next(store, status, 0); i >= 0; i = survivor_store_next(store, status, i + 1))
+    {
+        // Next survivor with this status according to the bytes
+        do
+        {
+            expected++;
+        } while (expected < store->count && store->status[expected] != status);
+
+        if (i != expected)
+            return 0;
+    }
+
+    // Nothing with this status may follow the last one visited
+    for (expected++; expected < store->count; expected++)
+    {
+        if (store->status[expected] == status)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Arguments of a claiming thread
+ */
+typedef struct claim_args {
+    SurvivorStore *store; /**< Store shared by all threads */
+    int first;            /**< Survivor the thread starts at, so threads collide everywhere */
+    int claimed;          /**< Survivors this thread claimed */
+    // clang-format off
+    unsigned char *won;   /**< Per survivor, set by the thread whose claim succeeded */
+    // clang-format on
+} ClaimArgs;
+
+/**
+ * @brief Claim every survivor once, starting at a per-thread offset
+ *
+ * @param arg ClaimArgs of this thread
+ * @return NULL
+ */
+static void *claim_all(void *arg)
+{
+    // clang-format off
+    ClaimArgs *args = arg;
+    // clang-format on
+    for (int n = 0; n < CLAIM_SURVIVORS; n++)
+    {
+        int i = (args->first + n) % CLAIM_SURVIVORS;
+        if (survivor_store_claim(args->store, i, 0, 1))
+        {
+            args->won[i]++;
+            args->claimed++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run all store checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    SurvivorStore store;
+
+    printf("=== PHASE 1: Adding survivors ===\n");
+    check(survivor_store_init(&store, 0) != 0, "zero capacity is rejected");
+    check(survivor_store_init(&store, SURVIVOR_STORE_MAX + 1) != 0, "capacity above SURVIVOR_STORE_MAX is rejected");
+    check(survivor_store_init(&store, RANDOM_SURVIVORS) == 0, "store with capacity RANDOM_SURVIVORS is created");
+    check(survivor_store_next(&store, 0, 0) == -1, "empty store has no waiting survivor");
+
+    // clang-format off
+    int *x = store.x;
+    _Atomic uint8_t *status = store.status;
+    // clang-format on
+    int ok = 1;
+    for (int i = 0; i < 200; i++)
+    {
+        ok &= survivor_store_add(&store, MAKE_COORD(i % 30, i % 40), i % 3 == 0 ? 0 : 1) == i;
+    }
+    check(ok && store.count == 200, "200 survivors are added in order");
+    check(store.x == x && store.status == status, "arrays do not move while filling");
+
+    Coord c = survivor_store_coord(&store, 137);
+    check(c.x == 137 % 30 && c.y == 137 % 40, "coordinates are stored");
+    check(store.info[150][0] == '\0' && store.times[150].discovery_time.tm_year == 0,
+          "new survivors have zeroed cold fields");
+    check(store.status_count[0] == 67 && store.status_count[1] == 133, "counters match the added statuses");
+    check(store_consistent(&store), "bitsets agree with status bytes");
+
+    printf("\n=== PHASE 2: Iteration ===\n");
+    check(iteration_matches(&store, 0) && iteration_matches(&store, 1), "iteration visits each status in order");
+    check(survivor_store_next(&store, 0, 64) == 66, "iteration starts mid-word");
+    check(survivor_store_next(&store, 2, 0) == -1, "a status nobody has is empty");
+    check(survivor_store_next(&store, 0, 198) == 198 && survivor_store_next(&store, 0, 199) == -1,
+          "iteration stops at count");
+
+    // Archive every helped survivor while walking them
+    for (int i = survivor_store_next(&store, 1, 0); i >= 0; i = survivor_store_next(&store, 1, i + 1))
+    {
+        survivor_store_set_status(&store, i, 3);
+    }
+    check(store.status_count[1] == 0 && store.status_count[3] == 133 && store_consistent(&store),
+          "status changes while iterating");
+
+    printf("\n=== PHASE 3: Random status changes ===\n");
+    survivor_store_clear(&store);
+    check(store.count == 0 && store.status_count[0] == 0 && survivor_store_next(&store, 3, 0) == -1,
+          "cleared store is empty");
+
+    srand(11);
+    for (int i = 0; i < RANDOM_SURVIVORS; i++)
+    {
+        survivor_store_add(&store, MAKE_COORD(rand() % 30, rand() % 40), rand() % SURVIVOR_STATUS_COUNT);
+    }
+    check(store_consistent(&store), "survivors added after clearing start consistent");
+
+    for (int i = 0; i < RANDOM_CHANGES; i++)
+    {
+        survivor_store_set_status(&store, rand() % RANDOM_SURVIVORS, rand() % SURVIVOR_STATUS_COUNT);
+    }
+    ok = store_consistent(&store);
+    for (int s = 0; s < SURVIVOR_STATUS_COUNT; s++)
+    {
+        ok &= iteration_matches(&store, s);
+    }
+    check(ok, "counters and bitsets stay exact over random changes");
+    survivor_store_destroy(&store);
+    survivor_store_destroy(&store);
+
+    printf("\n=== PHASE 4: Capacity ===\n");
+    check(survivor_store_init(&store, SURVIVOR_STORE_MAX) == 0, "store with capacity SURVIVOR_STORE_MAX is created");
+    ok = 1;
+    for (int i = 0; i < SURVIVOR_STORE_MAX && ok; i++)
+    {
+        ok = survivor_store_add(&store, MAKE_COORD(0, 0), 0) == i;
+    }
+    check(ok && store.count == SURVIVOR_STORE_MAX, "store holds SURVIVOR_STORE_MAX survivors");
+    check(survivor_store_add(&store, MAKE_COORD(0, 0), 0) == -1, "adding past SURVIVOR_STORE_MAX fails");
+    survivor_store_set_status(&store, SURVIVOR_STORE_MAX - 1, 2);
+    check(survivor_store_next(&store, 2, 0) == SURVIVOR_STORE_MAX - 1 &&
+              store.status_count[0] == SURVIVOR_STORE_MAX - 1,
+          "last survivor is reachable through its bitset");
+    survivor_store_destroy(&store);
+
+    printf("\n=== PHASE 5: Concurrent claims ===\n");
+    check(survivor_store_init(&store, CLAIM_SURVIVORS) == 0, "claim store is created");
+    for (int i = 0; i < CLAIM_SURVIVORS; i++)
+    {
+        survivor_store_add(&store, MAKE_COORD(i % 30, i % 40), 0);
+    }
+    check(survivor_store_claim(&store, 0, 1, 2) == 0 && store.status[0] == 0,
+          "claim fails when the survivor has another status");
+    check(survivor_store_claim(&store, 0, 0, 0) == 0, "claim to the same status changes nothing");
+
+    // clang-format off
+    unsigned char *won = calloc(CLAIM_SURVIVORS, 1);
+    // clang-format on
+    pthread_t threads[CLAIM_THREADS];
+    ClaimArgs args[CLAIM_THREADS];
+    for (int t = 0; t < CLAIM_THREADS; t++)
+    {
+        args[t] = (ClaimArgs){ &store, t * (CLAIM_SURVIVORS / CLAIM_THREADS), 0, won };
+        pthread_create(&threads[t], NULL, claim_all, &args[t]);
+    }
+    int claimed = 0;
+    for (int t = 0; t < CLAIM_THREADS; t++)
+    {
+        pthread_join(threads[t], NULL);
+        claimed += args[t].claimed;
+    }
+
+    ok = 1;
+    for (int i = 0; i < CLAIM_SURVIVORS; i++)
+    {
+        ok &= won[i] == 1;
+    }
+    check(ok && claimed == CLAIM_SURVIVORS, "each survivor is claimed by exactly one thread");
+    check(store.status_count[0] == 0 && store.status_count[1] == CLAIM_SURVIVORS && store_consistent(&store),
+          "bitsets and counters are exact after concurrent claims");
+
+    // Roll one back, as a failed mission send does
+    check(survivor_store_claim(&store, 42, 1, 0) == 1 && survivor_store_claim(&store, 42, 1, 0) == 0,
+          "a claimed survivor is released once");
+    check(survivor_store_next(&store, 0, 0) == 42 && store.status_count[0] == 1 && store_consistent(&store),
+          "released survivor is waiting again");
+    free(won);
+    survivor_store_destroy(&store);
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All survivor store checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of survivor_store_testing group
@@ -0,0 +1,310 @@
+/**
+ * @file world_snapshot_test.c
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @brief Validation of the triple-buffered world snapshots
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Checks what world_snapshot_capture() copies from the drone list and
+ * survivor store, and that snapshots handed from a publisher thread to a
+ * reader thread arrive whole and in order.
+ *
+ * **Test Coverage:**
+ * - An unpublished buffer reads as an empty snapshot
+ * - Capture skips disconnected drones and rescued survivors
+ * - Tile counts at every level add up to the copied entities
+ * - The reader always gets the newest publication
+ * - Concurrent publishing and reading never exposes a half-written
+ *   snapshot and never goes back in time
+ *
+ * **Usage:**
+ * Run with `make test_world_snapshot`. The program exits non-zero if any
+ * check fails.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup testing
+ */
+
+#include "../headers/drone.h"
+#include "../headers/map.h"
+#include "../headers/survivor.h"
+#include "../headers/world_snapshot.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @defgroup world_snapshot_testing World Snapshot Testing
+ * @brief Test program for the world snapshot buffer
+ * @ingroup testing
+ * @{
+ */
+
+/** @brief Snapshots published in the concurrency test */
+#define PUBLICATIONS 200000
+
+/** @brief Largest drone count used in the concurrency test */
+#define MAX_DRONES 64
+
+/** @brief Survivors added in the capture test; the store is sized for exactly these */
+#define CAPTURE_SURVIVORS 10
+
+// Simulation globals read by world_snapshot_capture()
+// clang-format off
+List *drones = NULL;
+// clang-format on
+SurvivorStore survivor_store;
+Map map = { .height = 10, .width = 10 };
+pthread_mutex_t survivors_mutex = PTHREAD_MUTEX_INITIALIZER;
+volatile int running = 1;
+
+/** @brief Number of failed checks */
+static int failures = 0;
+
+/** @brief Buffer shared by the concurrency test threads */
+static WorldSnapshotBuffer shared;
+
+/** @brief Set by the publisher once its last snapshot is published */
+static atomic_int publisher_done = 0;
+
+/**
+ * @brief Record and report the outcome of a single check
+ *
+ * @param condition Non-zero if the check passed
+ * @param description What was checked
+ */
+static void check(int condition, const char *description)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", description);
+    }
+    else
+    {
+        printf("✗ %s\n", description);
+        failures++;
+    }
+}
+
+/**
+ * @brief Publisher of the concurrency test
+ *
+ * Publication n holds n % MAX_DRONES drones, each at row n, so a reader
+ * can tell whether every field of a snapshot came from one publication.
+ */
+static void *publisher(void *arg)
+{
+    (void)arg;
+    for (unsigned long n = 1; n <= PUBLICATIONS; n++)
+    {
+        // clang-format off
+        WorldSnapshot *snapshot = world_snapshot_back(&shared);
+        // clang-format on
+        int count = (int)(n % MAX_DRONES);
+        world_snapshot_reserve(snapshot, count, 0);
+        snapshot->drone_count = count;
+        snapshot->total_drones = (int)n;
+        for (int i = 0; i < count; i++)
+        {
+            snapshot->drones[i].coord = (Coord){ (int)n, i };
+        }
+        world_snapshot_publish(&shared);
+    }
+    atomic_store(&publisher_done, 1);
+    return NULL;
+}
+
+/**
+ * @brief Add a drone to the global list
+ */
+static void add_drone(int id, DroneStatus status, Coord coord, Coord target)
+{
+    Drone drone;
+    memset(&drone, 0, sizeof(drone));
+    drone.id = id;
+    drone.status = status;
+    drone.coord = coord;
+    drone.target = target;
+    drone.socket = -1;
+    pthread_mutex_init(&drone.lock, NULL);
+    drones->add(drones, &drone);
+}
+
+/**
+ * @brief Run all snapshot checks
+ *
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void)
+{
+    static WorldSnapshotBuffer buffer;
+
+    printf("=== PHASE 1: Empty buffer ===\n");
+    world_snapshot_init(&buffer);
+    // clang-format off
+    const WorldSnapshot *front = world_snapshot_acquire(&buffer);
+    // clang-format on
+    check(front->sequence == 0 && front->drone_count == 0 && front->survivor_count == 0,
+          "nothing published reads as an empty snapshot");
+
+    printf("\n=== PHASE 2: Capture ===\n");
+    drones = create_list(sizeof(Drone), 8, LIST_BACKEND_GROWABLE);
+    if (!drones || survivor_store_init(&survivor_store, CAPTURE_SURVIVORS) != 0)
+    {
+        fprintf(stderr, "Failed to set up the simulation state\n");
+        return 1;
+    }
+    add_drone(1, IDLE, (Coord){ 1, 2 }, (Coord){ 0, 0 });
+    add_drone(2, ON_MISSION, (Coord){ 3, 4 }, (Coord){ 5, 6 });
+    add_drone(3, DISCONNECTED, (Coord){ 7, 8 }, (Coord){ 0, 0 });
+    for (int i = 0; i < CAPTURE_SURVIVORS; i++)
+    {
+        survivor_store_add(&survivor_store, (Coord){ i, i }, i % 3);
+    }
+
+    world_snapshot_capture(world_snapshot_back(&buffer));
+    world_snapshot_publish(&buffer);
+    front = world_snapshot_acquire(&buffer);
+    check(front->sequence == 1 && front->total_drones == 3 && front->drone_count == 2,
+          "disconnected drones are counted but not copied");
+
+    int idle = -1;
+    int on_mission = -1;
+    for (int i = 0; i < front->drone_count; i++)
+    {
+        if (front->drones[i].on_mission)
+            on_mission = i;
+        else
+            idle = i;
+    }
+    check(idle >= 0 && on_mission >= 0 && front->drones[idle].coord.y == 2 &&
+              front->drones[on_mission].target.x == 5 && front->drones[on_mission].target.y == 6,
+          "drone positions, targets and status are copied");
+
+    int rescued_drawn = 0;
+    for (int i = 0; i < front->survivor_count; i++)
+    {
+        rescued_drawn |= front->survivors[i].x % 3 == 2;
+    }
+    check(front->survivor_count == 7 && !rescued_drawn, "only waiting and helped survivors are copied");
+
+    printf("\n=== PHASE 3: Tile aggregates ===\n");
+    // clang-format off
+    const TileLevel *base = &front->tiles[0];
+    const TileLevel *top = &front->tiles[front->tile_level_count - 1];
+    // clang-format on
+    check(front->tile_level_count == 3 && base->span == WORLD_TILE_SPAN && base->rows == 3 && base->cols == 3 &&
+              top->rows == 1 && top->cols == 1,
+          "a 10x10 map has 3x3, 2x2 and 1x1 tile levels");
+    // Survivors (i, i) with i % 3 != 2 on tiles (0,0): 0 1 3, (1,1): 4 6 7, (2,2): 9; drones on (0,0) and (0,1)
+    check(base->survivors[0] == 3 && base->survivors[4] == 3 && base->survivors[8] == 1 && base->survivors[1] == 0,
+          "level 0 counts survivors per tile");
+    check(base->drones[0] == 1 && base->drones[1] == 1 && base->drones[3] == 0 && base->drones[4] == 0,
+          "level 0 counts connected drones per tile");
+
+    int sums_match = 1;
+    for (int level = 0; level < front->tile_level_count; level++)
+    {
+        // clang-format off
+        const TileLevel *tiles = &front->tiles[level];
+        // clang-format on
+        unsigned int survivors = 0;
+        unsigned int drone_total = 0;
+        for (int i = 0; i < tiles->rows * tiles->cols; i++)
+        {
+            survivors += tiles->survivors[i];
+            drone_total += tiles->drones[i];
+        }
+        sums_match &=
+            survivors == (unsigned int)front->survivor_count && drone_total == (unsigned int)front->drone_count;
+    }
+    check(sums_match, "every level adds up to the copied survivors and drones");
+
+    WorldSnapshot large;
+    memset(&large, 0, sizeof(large));
+    world_snapshot_reserve(&large, 1, 1);
+    large.drones[0].coord = (Coord){ 999, 999 };
+    large.survivors[0] = (Coord){ 500, 3 };
+    large.drone_count = 1;
+    large.survivor_count = 1;
+    int built = world_snapshot_build_tiles(&large, 1000, 1000);
+    top = &large.tiles[large.tile_level_count - 1];
+    check(built == 0 && large.tile_level_count == 9 && top->survivors[0] == 1 && top->drones[0] == 1 &&
+              large.tiles[0].survivors[125 * large.tiles[0].cols] == 1,
+          "a 1000x1000 map reduces to one tile in 9 levels");
+    free(large.drones);
+    free(large.survivors);
+    for (int level = 0; level < large.tile_level_count; level++)
+    {
+        free(large.tiles[level].survivors);
+        free(large.tiles[level].drones);
+    }
+
+    printf("\n=== PHASE 4: Hand-over ===\n");
+    for (int n = 0; n < 2; n++)
+    {
+        world_snapshot_capture(world_snapshot_back(&buffer));
+        world_snapshot_publish(&buffer);
+    }
+    front = world_snapshot_acquire(&buffer);
+    check(front->sequence == 3, "the reader gets the newest of several publications");
+    check(world_snapshot_acquire(&buffer) == front && front->sequence == 3,
+          "without a new publication the same snapshot is returned");
+
+    printf("\n=== PHASE 5: Concurrent publishing ===\n");
+    world_snapshot_init(&shared);
+    pthread_t thread;
+    pthread_create(&thread, NULL, publisher, NULL);
+
+    unsigned long last = 0;
+    unsigned long distinct = 0;
+    int consistent = 1;
+    int ordered = 1;
+    int finished = 0;
+    while (!finished)
+    {
+        // Read once more after the publisher finished to see its last snapshot
+        finished = atomic_load(&publisher_done);
+        // clang-format off
+        const WorldSnapshot *snapshot = world_snapshot_acquire(&shared);
+        // clang-format on
+        if (snapshot->sequence == 0)
+            continue;
+
+        ordered &= snapshot->sequence >= last;
+        if (snapshot->sequence != last)
+            distinct++;
+        last = snapshot->sequence;
+
+        consistent &= snapshot->total_drones == (int)snapshot->sequence &&
+                      snapshot->drone_count == (int)(snapshot->sequence % MAX_DRONES);
+        for (int i = 0; i < snapshot->drone_count; i++)
+        {
+            consistent &= snapshot->drones[i].coord.x == (int)snapshot->sequence && snapshot->drones[i].coord.y == i;
+        }
+    }
+    pthread_join(thread, NULL);
+
+    printf("  %lu of %d publications seen by the reader\n", distinct, PUBLICATIONS);
+    check(consistent, "every snapshot read comes whole from one publication");
+    check(ordered, "sequence numbers read never decrease");
+    check(last == PUBLICATIONS, "the last publication is read");
+
+    world_snapshot_destroy(&shared);
+    world_snapshot_destroy(&buffer);
+    survivor_store_destroy(&survivor_store);
+    drones->destroy(drones);
+
+    if (failures)
+    {
+        printf("\n=== %d check(s) FAILED ===\n", failures);
+        return 1;
+    }
+
+    printf("\n=== All world snapshot checks passed ===\n");
+    return 0;
+}
+
+/** @} */ // end of world_snapshot_testing group
@@ -34,9 +34,27 @@
  * **Technical Features:**
  * - SDL2 hardware-accelerated rendering
  * - TTF font support with multiple fallback options
- * - Thread-safe data access with proper synchronization
+ * - Draws from world snapshots without taking simulation locks
  * - Scalable display system based on map dimensions
- * - Efficient redraw cycles with minimal overhead
+ * - Panel and legend drawn once into a cached texture
+ * - Cells drawn in batches with one SDL_RenderFillRects call per color,
+ *   at most one rectangle per visible map cell
+ * - Rendered strings and digits kept in a texture cache
+ *
+ * **Zoom and Pan:**
+ * The map area of the window is a viewport onto the map, at most
+ * VIEW_MAX_WIDTH x VIEW_MAX_HEIGHT pixels. The mouse wheel or +/- zoom
+ * (around the cursor or the center), arrow keys or dragging with the left
+ * button pan, and 0 or Home shows the whole map again. Only cells in the
+ * viewport are drawn; grid lines appear once cells are GRID_MIN_ZOOM
+ * pixels wide.
+ *
+ * **Level of Detail:**
+ * When a cell would be smaller than MIN_CELL_PIXELS, survivors and drones
+ * are drawn as density heatmaps from the tile counts of the snapshot,
+ * using the finest tile level whose tiles are at least MIN_CELL_PIXELS
+ * wide. A frame then costs at most one rectangle per visible tile and per
+ * shade batch, however large the map or the number of survivors.
  * 
  * @copyright Copyright (c) 2024
  * 
@@ -47,6 +65,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
@@ -54,10 +73,41 @@
 #include "headers/map.h"
 #include "headers/survivor.h"
 #include "headers/globals.h"
+#include "headers/world_snapshot.h"
 
-/** @brief Pixels per map cell */
+/** @brief Pixels per map cell at the default zoom */
 #define CELL_SIZE 20
 
+/** @brief Largest width of the map viewport in pixels */
+#define VIEW_MAX_WIDTH 1200
+
+/** @brief Largest height of the map viewport in pixels */
+#define VIEW_MAX_HEIGHT 800
+
+/** @brief Largest zoom in pixels per cell */
+#define MAX_ZOOM 40.0
+
+/** @brief Smallest cell or tile drawn, in pixels; smaller cells are drawn as heatmap tiles */
+#define MIN_CELL_PIXELS 4
+
+/** @brief Zoom from which grid lines are drawn */
+#define GRID_MIN_ZOOM 8.0
+
+/** @brief Zoom factor of one wheel step or +/- key press */
+#define ZOOM_STEP 1.25
+
+/** @brief Pixels panned by one arrow key press */
+#define PAN_STEP 40
+
+/** @brief Shades of a heatmap color */
+#define HEAT_SHADES 8
+
+/** @brief Rectangles in a batch: one per visible cell or tile of MIN_CELL_PIXELS or more */
+#define BATCH_CAPACITY ((VIEW_MAX_WIDTH / MIN_CELL_PIXELS + 2) * (VIEW_MAX_HEIGHT / MIN_CELL_PIXELS + 2))
+
+/** @brief Most grid lines across the viewport in one direction */
+#define GRID_MAX_LINES (VIEW_MAX_WIDTH / (int)GRID_MIN_ZOOM + 2)
+
 /** @brief Width of the right info panel */
 #define PANEL_WIDTH 200
 
@@ -70,6 +120,34 @@
 /** @brief Bold font size */
 #define BOLD_FONT_SIZE 9
 
+/** @brief Top of the first statistics line in the info panel */
+#define PANEL_STATS_TOP 70
+
+/** @brief Vertical distance between statistics lines */
+#define PANEL_LINE_SPACING (TEXT_HEIGHT + 10)
+
+/** @brief Extra space before a new info panel section */
+#define PANEL_SECTION_GAP 20
+
+/** @brief Rendered strings kept as textures */
+#define TEXT_CACHE_SIZE 64
+
+/** @brief Strings this long or longer are not cached */
+#define TEXT_CACHE_MAX_LENGTH 32
+
+/**
+ * @struct text_cache_entry
+ * @brief A string rasterized once and drawn from its texture afterwards
+ */
+typedef struct text_cache_entry {
+    char text[TEXT_CACHE_MAX_LENGTH]; /**< The string */
+    bool bold;                        /**< Rendered with font_bold */
+    SDL_Color color;                  /**< Text color */
+    SDL_Texture *texture;             /**< Rendered text, NULL if the entry is unused */
+    int w;                            /**< Width in pixels */
+    int h;                            /**< Height in pixels */
+} TextCacheEntry;
+
 // SDL globals
 // clang-format off
 SDL_Window *window = NULL;
@@ -91,14 +169,172 @@ const SDL_Color LIGHT_GRAY = {200, 200, 200, 255};
 const SDL_Color DARK_GRAY = {50, 50, 50, 255};
 const SDL_Color YELLOW = {255, 255, 0, 255};
 
-// External references to controller's stats
-extern int waiting_count;
-extern int helped_count;
-extern int rescued_count;
-extern int idle_drones;
-extern int mission_drones;
+// Statistics counters (waiting_count, idle_drones, ...) come from globals.h
+
+// Render caches, used by the rendering thread only
+// Grid, panel and legend drawn once; NULL if render targets are unsupported
+static SDL_Texture *static_layer = NULL;
+static int static_layer_valid = 0;
+static int static_layer_failed = 0;
+
+// Recently rendered strings (round-robin replacement)
+static TextCacheEntry text_cache[TEXT_CACHE_SIZE];
+static int text_cache_next = 0;
+
+// Rectangles of one batch, and per visible cell the number of the last batch it joined
+static SDL_Rect *cell_rects = NULL;
+static unsigned int *cell_marks = NULL;
+static unsigned int cell_batch = 1;
+
+// Viewport: map area size in pixels, zoom in pixels per cell, and the
+// map position (in cells) at its top-left corner
+static int view_width, view_height;
+static double zoom = CELL_SIZE;
+static double view_row = 0, view_col = 0;
+static int dragging = 0;
+
+// Map cells at least partly inside the viewport, updated by update_view()
+static int first_row, last_row, first_col, last_col;
 
 //format on
+/**
+ * @brief Largest integer not greater than a value
+ */
+static int floor_int(double value)
+{
+    int truncated = (int)value;
+    return value < truncated ? truncated - 1 : truncated;
+}
+
+/**
+ * @brief Zoom at which the whole map fits the viewport
+ */
+static double fit_zoom(void)
+{
+    double across = (double)view_width / map.width;
+    double down = (double)view_height / map.height;
+    return across < down ? across : down;
+}
+
+/**
+ * @brief Clamp zoom and pan to the map and find the visible cells
+ *
+ * Called once per frame before anything is drawn, and after every zoom
+ * or pan.
+ */
+static void update_view(void)
+{
+    double min_zoom = fit_zoom();
+    double max_zoom = min_zoom > MAX_ZOOM ? min_zoom : MAX_ZOOM;
+    if (zoom < min_zoom)
+        zoom = min_zoom;
+    if (zoom > max_zoom)
+        zoom = max_zoom;
+
+    // Keep the viewport on the map; a map narrower than it stays at the left
+    double max_row = map.height - view_height / zoom;
+    double max_col = map.width - view_width / zoom;
+    if (view_row > max_row)
+        view_row = max_row;
+    if (view_col > max_col)
+        view_col = max_col;
+    if (view_row < 0)
+        view_row = 0;
+    if (view_col < 0)
+        view_col = 0;
+
+    first_row = floor_int(view_row);
+    first_col = floor_int(view_col);
+    last_row = floor_int(view_row + view_height / zoom);
+    last_col = floor_int(view_col + view_width / zoom);
+    if (last_row >= map.height)
+        last_row = map.height - 1;
+    if (last_col >= map.width)
+        last_col = map.width - 1;
+
+    // A cell starting exactly at the far edge is not visible
+    if (last_row > first_row && floor_int((last_row - view_row) * zoom) >= view_height)
+        last_row--;
+    if (last_col > first_col && floor_int((last_col - view_col) * zoom) >= view_width)
+        last_col--;
+}
+
+/**
+ * @brief Zoom by a factor, keeping the map position under a viewport
+ *        pixel in place
+ *
+ * @param factor Zoom multiplier (> 1 zooms in)
+ * @param x Viewport pixel column to zoom around
+ * @param y Viewport pixel row to zoom around
+ */
+static void zoom_view(double factor, int x, int y)
+{
+    double row = view_row + y / zoom;
+    double col = view_col + x / zoom;
+    zoom *= factor;
+    update_view();
+    view_row = row - y / zoom;
+    view_col = col - x / zoom;
+    update_view();
+}
+
+/**
+ * @brief Move the viewport by a number of pixels
+ */
+static void pan_view(int dx, int dy)
+{
+    view_col += dx / zoom;
+    view_row += dy / zoom;
+    update_view();
+}
+
+/**
+ * @brief Check whether cells are drawn one by one at the current zoom
+ *
+ * @return 1 for cells, 0 for heatmap tiles
+ */
+static int detail_view(void)
+{
+    return zoom >= MIN_CELL_PIXELS;
+}
+
+/**
+ * @brief Screen rectangle of a block of map cells
+ *
+ * Neighbouring blocks share their edges exactly, so no pixel is left
+ * between cells at fractional zoom levels.
+ *
+ * @param row First map row of the block
+ * @param col First map column of the block
+ * @param rows Rows in the block
+ * @param cols Columns in the block
+ * @param gap Pixels left free on the right and bottom edge (for grid lines)
+ */
+static SDL_Rect map_rect(int row, int col, int rows, int cols, int gap)
+{
+    int left = floor_int((col - view_col) * zoom);
+    int top = floor_int((row - view_row) * zoom);
+    int right = floor_int((col + cols - view_col) * zoom) - gap;
+    int bottom = floor_int((row + rows - view_row) * zoom) - gap;
+    return (SDL_Rect){ left, top, right > left ? right - left : 1, bottom > top ? bottom - top : 1 };
+}
+
+/**
+ * @brief Pixels left between cells for the grid lines at the current zoom
+ */
+static int cell_gap(void)
+{
+    return zoom >= GRID_MIN_ZOOM ? 1 : 0;
+}
+
+/**
+ * @brief Check whether a map cell is at least partly inside the viewport
+ */
+static int cell_visible(int x, int y)
+{
+    return x >= first_row && x <= last_row && y >= first_col && y <= last_col;
+}
+
 /**
  * @brief Initialize SDL window and renderer based on map dimensions plus info panel
  * 
@@ -108,9 +344,14 @@ extern int mission_drones;
  */
 int init_sdl_window()
 {
-    // Calculate window dimensions to include both map and info panel
-    window_width = (map.width * CELL_SIZE) + PANEL_WIDTH;
-    window_height = map.height * CELL_SIZE;
+    // Calculate window dimensions to include both map viewport and info panel
+    view_width = map.width * CELL_SIZE < VIEW_MAX_WIDTH ? map.width * CELL_SIZE : VIEW_MAX_WIDTH;
+    view_height = map.height * CELL_SIZE < VIEW_MAX_HEIGHT ? map.height * CELL_SIZE : VIEW_MAX_HEIGHT;
+    window_width = view_width + PANEL_WIDTH;
+    window_height = view_height;
+
+    // Start with the whole map in view
+    zoom = fit_zoom();
 
     printf("Creating window with dimensions: %d x %d (including panel width: %d)\n",
            window_width, window_height, PANEL_WIDTH);
@@ -191,10 +432,101 @@ int init_sdl_window()
     return 0;
 }
 
+/**
+ * @brief Rasterize a string into a new texture
+ *
+ * @param w Out: width of the text in pixels
+ * @param h Out: height of the text in pixels
+ * @return The texture, or NULL on failure (reported)
+ */
+// clang-format off
+static SDL_Texture *create_text_texture(TTF_Font *text_font, const char *text, SDL_Color color, int *w, int *h)
+// clang-format on
+{
+    // clang-format off
+    SDL_Surface *surface = TTF_RenderText_Blended(text_font, text, color);
+    // clang-format on
+    if (!surface)
+    {
+        fprintf(stderr, "TTF_RenderText_Blended Error: %s\n", TTF_GetError());
+        return NULL;
+    }
+    // clang-format off
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    // clang-format on
+    if (!texture)
+    {
+        fprintf(stderr, "SDL_CreateTextureFromSurface Error: %s\n", SDL_GetError());
+        SDL_FreeSurface(surface);
+        return NULL;
+    }
+
+    *w = surface->w;
+    *h = surface->h;
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+/**
+ * @brief Destroy every texture in the text cache
+ */
+static void text_cache_clear(void)
+{
+    for (int i = 0; i < TEXT_CACHE_SIZE; i++)
+    {
+        if (text_cache[i].texture)
+            SDL_DestroyTexture(text_cache[i].texture);
+    }
+    memset(text_cache, 0, sizeof(text_cache));
+    text_cache_next = 0;
+}
+
+/**
+ * @brief Texture of a string, rasterized on first use
+ *
+ * When the cache is full the oldest entry is replaced.
+ *
+ * @param text String shorter than TEXT_CACHE_MAX_LENGTH
+ * @return The cache entry, or NULL if the text could not be rasterized
+ */
+// clang-format off
+static const TextCacheEntry *text_cache_get(const char *text, bool use_bold, SDL_Color color)
+// clang-format on
+{
+    for (int i = 0; i < TEXT_CACHE_SIZE; i++)
+    {
+        // clang-format off
+        const TextCacheEntry *entry = &text_cache[i];
+        // clang-format on
+        if (entry->texture && entry->bold == use_bold && entry->color.r == color.r && entry->color.g == color.g &&
+            entry->color.b == color.b && entry->color.a == color.a && strcmp(entry->text, text) == 0)
+        {
+            return entry;
+        }
+    }
+
+    // clang-format off
+    TextCacheEntry *entry = &text_cache[text_cache_next];
+    // clang-format on
+    text_cache_next = (text_cache_next + 1) % TEXT_CACHE_SIZE;
+    if (entry->texture)
+        SDL_DestroyTexture(entry->texture);
+
+    entry->texture = create_text_texture(use_bold ? font_bold : font, text, color, &entry->w, &entry->h);
+    if (!entry->texture)
+        return NULL;
+    strcpy(entry->text, text);
+    entry->bold = use_bold;
+    entry->color = color;
+    return entry;
+}
+
 /**
  * @brief Render text with SDL_ttf
  * 
- * Draws text on the screen at the specified position and color
+ * Draws text on the screen at the specified position and color. Strings
+ * shorter than TEXT_CACHE_MAX_LENGTH are rasterized once and drawn from
+ * the text cache afterwards.
  * 
  * @param text Text to render
  * @param x X position on screen
@@ -223,47 +555,92 @@ void render_text(const char *text, int x, int y, SDL_Color color, bool use_bold)
         return;
     }
 
-    // clang-format off
-    SDL_Surface *surface = TTF_RenderText_Blended(current_font, text, color);
-    // clang-format on
-    if (!surface)
+    if (strlen(text) < TEXT_CACHE_MAX_LENGTH)
     {
-        fprintf(stderr, "TTF_RenderText_Blended Error: %s\n", TTF_GetError());
+        // clang-format off
+        const TextCacheEntry *entry = text_cache_get(text, use_bold, color);
+        // clang-format on
+        if (entry)
+        {
+            SDL_Rect rect = { x, y, entry->w, entry->h };
+            SDL_RenderCopy(renderer, entry->texture, NULL, &rect);
+        }
         return;
     }
+
+    int w, h;
     // clang-format off
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_Texture *texture = create_text_texture(current_font, text, color, &w, &h);
     // clang-format on
     if (!texture)
+        return;
+
+    SDL_Rect rect = { x, y, w, h };
+    SDL_RenderCopy(renderer, texture, NULL, &rect);
+    SDL_DestroyTexture(texture);
+}
+
+/**
+ * @brief Render a number in the bold font, one cached glyph per digit
+ *
+ * Values change every frame, so they are not cached as whole strings;
+ * after the first frame every digit is already a texture.
+ *
+ * @param value Number to render
+ * @param x X position on screen
+ * @param y Y position on screen
+ */
+static void render_number(int value, int x, int y)
+{
+    char digits[16];
+    snprintf(digits, sizeof(digits), "%d", value);
+
+    if (!font_bold)
     {
-        fprintf(stderr, "SDL_CreateTextureFromSurface Error: %s\n", SDL_GetError());
-        SDL_FreeSurface(surface);
+        render_text(digits, x, y, WHITE, true);
         return;
     }
 
-    SDL_Rect rect = { x, y, surface->w, surface->h };
-    SDL_RenderCopy(renderer, texture, NULL, &rect);
+    for (const char *c = digits; *c; c++)
+    {
+        // clang-format off
+        const TextCacheEntry *glyph = text_cache_get((const char[]){ *c, '\0' }, true, WHITE);
+        // clang-format on
+        if (!glyph)
+            return;
 
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+        SDL_Rect rect = { x, y, glyph->w, glyph->h };
+        SDL_RenderCopy(renderer, glyph->texture, NULL, &rect);
+        x += glyph->w;
+    }
 }
 
 /**
- * @brief Render a text line in the info panel with a label and value
- * 
- * Creates a standardized text line with background and value display
- * 
+ * @brief Top of a statistics line in the info panel
+ *
+ * Lines 0-2 are survivor counts, lines 3-5 drone counts after a section
+ * gap; line 6 is where the legend section starts.
+ *
+ * @param line Line number
+ * @return Y position of the line
+ */
+static int panel_line_y(int line)
+{
+    return PANEL_STATS_TOP + line * PANEL_LINE_SPACING + (line >= 3 ? PANEL_SECTION_GAP : 0);
+}
+
+/**
+ * @brief Draw the fixed part of a statistics line: background, color
+ *        indicator and label
+ *
  * @param text Text label to render
  * @param y Y position in the panel
  * @param color Color for the label indicator
- * @param value Numeric value to display
  */
-// clang-format off
-void render_text_line(const char *text, int y, SDL_Color color, int value)
-// clang-format on
+static void draw_panel_label(const char *text, int y, SDL_Color color)
 {
     // Calculate the starting position for text
-    int text_x = map.width * CELL_SIZE + 10; // 10px padding from panel start
+    int text_x = view_width + 10; // 10px padding from panel start
     int text_y = y;
 
     // Background rectangle for label
@@ -286,11 +663,35 @@ void render_text_line(const char *text, int y, SDL_Color color, int value)
 
     // Render the text label
     render_text(text, text_x + 15, text_y + 5, WHITE, false);
+}
 
-    // Render the numeric value
-    char value_str[16];
-    sprintf(value_str, "%d", value);
-    render_text(value_str, text_x + 120, text_y + 5, WHITE, true);
+/**
+ * @brief Draw the value of a statistics line
+ *
+ * @param y Y position in the panel (as given to draw_panel_label())
+ * @param value Numeric value to display
+ */
+static void draw_panel_value(int y, int value)
+{
+    render_number(value, view_width + 130, y + 5);
+}
+
+/**
+ * @brief Render a text line in the info panel with a label and value
+ * 
+ * Creates a standardized text line with background and value display
+ * 
+ * @param text Text label to render
+ * @param y Y position in the panel
+ * @param color Color for the label indicator
+ * @param value Numeric value to display
+ */
+// clang-format off
+void render_text_line(const char *text, int y, SDL_Color color, int value)
+// clang-format on
+{
+    draw_panel_label(text, y, color);
+    draw_panel_value(y, value);
 }
 
 /**
@@ -300,31 +701,34 @@ void render_text_line(const char *text, int y, SDL_Color color, int value)
  */
 void update_window_title()
 {
-    // Update window title with stats from controller
-    char title[100];
+    // Update window title with stats from controller and the view mode
+    char title[160];
     snprintf(title,
              sizeof(title),
-             "Drone Simulator | Waiting: %d | Being Helped: %d | Rescued: %d | Drones: %d",
+             "Drone Simulator | Waiting: %d | Being Helped: %d | Rescued: %d | Drones: %d | %s %.1f px/cell",
              waiting_count,
              helped_count,
              rescued_count,
-             num_drones);
+             num_drones,
+             zoom >= MIN_CELL_PIXELS ? "Cells" : "Heatmap",
+             zoom);
     SDL_SetWindowTitle(window, title);
 }
 
 /**
- * @brief Draw the info panel on the right side of the window
+ * @brief Draw the parts of the info panel that never change
  * 
- * Creates a detailed panel showing statistics and a legend
+ * Background, title, statistics labels and the legend. Drawn once into
+ * the static layer; draw_info_panel() adds the values every frame.
  */
-void draw_info_panel()
+static void draw_panel_chrome(void)
 {
     // First, draw the panel background
     SDL_Rect panel_rect = {
-        map.width * CELL_SIZE, // X position (right after the map)
-        0,                     // Y position (top of window)
-        PANEL_WIDTH,           // Width of panel
-        window_height          // Full height of window
+        view_width,   // X position (right after the map)
+        0,            // Y position (top of window)
+        PANEL_WIDTH,  // Width of panel
+        window_height // Full height of window
     };
 
     // Set the panel background color
@@ -336,119 +740,118 @@ void draw_info_panel()
     SDL_RenderDrawRect(renderer, &panel_rect);
 
     // Draw vertical separator line
-    SDL_RenderDrawLine(renderer, map.width * CELL_SIZE, 0, map.width * CELL_SIZE, window_height);
+    SDL_RenderDrawLine(renderer, view_width, 0, view_width, window_height);
 
     // Draw title
     SDL_Rect title_rect = {
-        map.width * CELL_SIZE + 10, // X position with padding
-        10,                         // Y position with padding
-        PANEL_WIDTH - 20,           // Width minus padding
-        40                          // Height
+        view_width + 10,  // X position with padding
+        10,               // Y position with padding
+        PANEL_WIDTH - 20, // Width minus padding
+        40                // Height
     };
 
     SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
     SDL_RenderFillRect(renderer, &title_rect);
 
     // Draw title text
-    render_text("DRONE SIMULATION", map.width * CELL_SIZE + 30, 20, WHITE, true);
-
-    // Render stats with their actual values - using controller's stats
-    int y_pos = 70; // Starting Y position for stats
-
-    // Survivors waiting - RED
-    render_text_line("Survivors Waiting:", y_pos, RED, waiting_count);
+    render_text("DRONE SIMULATION", view_width + 30, 20, WHITE, true);
 
-    // Survivors being helped - GREEN
-    y_pos += TEXT_HEIGHT + 10; // Add spacing between lines
-    render_text_line("Being Helped:", y_pos, GREEN, helped_count);
-
-    // Survivors rescued - BLUE
-    y_pos += TEXT_HEIGHT + 10;
-    render_text_line("Rescued:", y_pos, BLUE, rescued_count);
-
-    // Drones section
-    y_pos += TEXT_HEIGHT + 30; // Add more spacing for section break
+    // Survivor statistics labels
+    draw_panel_label("Survivors Waiting:", panel_line_y(0), RED);
+    draw_panel_label("Being Helped:", panel_line_y(1), GREEN);
+    draw_panel_label("Rescued:", panel_line_y(2), BLUE);
 
     // Draw section separator
+    int y_pos = panel_line_y(3);
     SDL_SetRenderDrawColor(renderer, BLACK.r, BLACK.g, BLACK.b, BLACK.a);
-    SDL_RenderDrawLine(
-        renderer, map.width * CELL_SIZE + 10, y_pos - 15, map.width * CELL_SIZE + PANEL_WIDTH - 10, y_pos - 15);
-
-    // Idle drones - BLUE
-    render_text_line("Idle Drones:", y_pos, BLUE, idle_drones);
+    SDL_RenderDrawLine(renderer, view_width + 10, y_pos - 15, view_width + PANEL_WIDTH - 10, y_pos - 15);
 
-    // On mission drones - GREEN
-    y_pos += TEXT_HEIGHT + 10;
-    render_text_line("On Mission:", y_pos, GREEN, mission_drones);
-
-    // Total drones count
-    y_pos += TEXT_HEIGHT + 10;
-    render_text_line("Total Drones:", y_pos, WHITE, drones->number_of_elements);
+    // Drone statistics labels
+    draw_panel_label("Idle Drones:", panel_line_y(3), BLUE);
+    draw_panel_label("On Mission:", panel_line_y(4), GREEN);
+    draw_panel_label("Total Drones:", panel_line_y(5), WHITE);
 
     // Legend section
-    y_pos += TEXT_HEIGHT + 30; // Add more spacing for section break
+    y_pos = panel_line_y(6) + PANEL_SECTION_GAP;
 
     // Draw section separator
     SDL_SetRenderDrawColor(renderer, BLACK.r, BLACK.g, BLACK.b, BLACK.a);
-    SDL_RenderDrawLine(
-        renderer, map.width * CELL_SIZE + 10, y_pos - 15, map.width * CELL_SIZE + PANEL_WIDTH - 10, y_pos - 15);
+    SDL_RenderDrawLine(renderer, view_width + 10, y_pos - 15, view_width + PANEL_WIDTH - 10, y_pos - 15);
 
     // Legend title
     SDL_Rect legend_title = {
-        map.width * CELL_SIZE + 10, // X position with padding
-        y_pos,                      // Current Y position
-        PANEL_WIDTH - 20,           // Width minus padding
-        30                          // Height
+        view_width + 10,  // X position with padding
+        y_pos,            // Current Y position
+        PANEL_WIDTH - 20, // Width minus padding
+        30                // Height
     };
 
     SDL_SetRenderDrawColor(renderer, DARK_GRAY.r, DARK_GRAY.g, DARK_GRAY.b, DARK_GRAY.a);
     SDL_RenderFillRect(renderer, &legend_title);
 
     // Draw legend title text
-    render_text("LEGEND", map.width * CELL_SIZE + 75, y_pos + 5, WHITE, true);
+    render_text("LEGEND", view_width + 75, y_pos + 5, WHITE, true);
 
     // Legend items
     y_pos += 40;
 
     // Survivor - RED
-    SDL_Rect survivor_icon = { map.width * CELL_SIZE + 20, y_pos + 5, 15, 15 };
+    SDL_Rect survivor_icon = { view_width + 20, y_pos + 5, 15, 15 };
     SDL_SetRenderDrawColor(renderer, RED.r, RED.g, RED.b, RED.a);
     SDL_RenderFillRect(renderer, &survivor_icon);
 
     // Legend text
-    render_text("Survivor", map.width * CELL_SIZE + 45, y_pos + 5, WHITE, false);
+    render_text("Survivor", view_width + 45, y_pos + 5, WHITE, false);
 
     // Idle drone - BLUE
     y_pos += 25;
-    SDL_Rect idle_icon = { map.width * CELL_SIZE + 20, y_pos + 5, 15, 15 };
+    SDL_Rect idle_icon = { view_width + 20, y_pos + 5, 15, 15 };
     SDL_SetRenderDrawColor(renderer, BLUE.r, BLUE.g, BLUE.b, BLUE.a);
     SDL_RenderFillRect(renderer, &idle_icon);
 
     // Legend text
-    render_text("Idle Drone", map.width * CELL_SIZE + 45, y_pos + 5, WHITE, false);
+    render_text("Idle Drone", view_width + 45, y_pos + 5, WHITE, false);
 
     // Active drone - GREEN
     y_pos += 25;
-    SDL_Rect active_icon = { map.width * CELL_SIZE + 20, y_pos + 5, 15, 15 };
+    SDL_Rect active_icon = { view_width + 20, y_pos + 5, 15, 15 };
     SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
     SDL_RenderFillRect(renderer, &active_icon);
 
     // Legend text
-    render_text("Active Drone", map.width * CELL_SIZE + 45, y_pos + 5, WHITE, false);
+    render_text("Active Drone", view_width + 45, y_pos + 5, WHITE, false);
 
     // Mission line - GREEN
     y_pos += 25;
     SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
-    SDL_RenderDrawLine(renderer, map.width * CELL_SIZE + 20, y_pos + 12, map.width * CELL_SIZE + 40, y_pos + 12);
+    SDL_RenderDrawLine(renderer, view_width + 20, y_pos + 12, view_width + 40, y_pos + 12);
 
     // Legend text
-    render_text("Mission Path", map.width * CELL_SIZE + 45, y_pos + 5, WHITE, false);
+    render_text("Mission Path", view_width + 45, y_pos + 5, WHITE, false);
+}
+
+/**
+ * @brief Draw the live values of the info panel
+ * 
+ * The panel itself is part of the static layer drawn by draw_grid().
+ * 
+ * @param snapshot Snapshot the total drone count is taken from
+ */
+void draw_info_panel(const WorldSnapshot *snapshot)
+{
+    draw_panel_value(panel_line_y(0), waiting_count);
+    draw_panel_value(panel_line_y(1), helped_count);
+    draw_panel_value(panel_line_y(2), rescued_count);
+    draw_panel_value(panel_line_y(3), idle_drones);
+    draw_panel_value(panel_line_y(4), mission_drones);
+    draw_panel_value(panel_line_y(5), snapshot->total_drones);
 }
 
 /**
  * @brief Draw a colored cell at the specified map coordinates
  * 
- * Fills a single grid cell with the specified color
+ * Fills a single grid cell with the specified color, at the current zoom
+ * and pan. Cells outside the viewport are skipped.
  * 
  * @param x Map x-coordinate
  * @param y Map y-coordinate
@@ -457,18 +860,14 @@ void draw_info_panel()
 void draw_cell(int x, int y, SDL_Color color)
 {
     // Boundary check to prevent invalid memory access
-    if (x < 0 || x >= map.height || y < 0 || y >= map.width)
+    if (x < 0 || x >= map.height || y < 0 || y >= map.width || !cell_visible(x, y))
     {
         return;
     }
 
-    // Create a rectangle for the cell
-    SDL_Rect rect = {
-        y * CELL_SIZE, // Note: x and y are transposed for SDL
-        x * CELL_SIZE,
-        CELL_SIZE - 1, // Make slightly smaller than cell
-        CELL_SIZE - 1  // to ensure grid lines remain visible
-    };
+    // Note: x and y are transposed for SDL; the cell is made slightly
+    // smaller to ensure grid lines remain visible
+    SDL_Rect rect = map_rect(x, y, 1, 1, cell_gap());
 
     // Set the color
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
@@ -478,100 +877,426 @@ void draw_cell(int x, int y, SDL_Color color)
 }
 
 /**
- * @brief Draw all drones with colors indicating their status
- * 
- * Blue for IDLE drones, Green for ON_MISSION drones
- * Also draws lines between drones and their targets when on mission
+ * @brief Allocate the batch buffers, one entry per cell or tile that can
+ *        be visible
+ *
+ * Cells and tiles are at least MIN_CELL_PIXELS wide when batched, so a
+ * batch never needs more than BATCH_CAPACITY rectangles, whatever the
+ * size of the map.
+ *
+ * @return 0 if the buffers are ready, -1 on allocation failure
  */
-void draw_drones()
+static int reserve_cell_batch(void)
 {
-    // Lock the drones list for iteration
-    pthread_mutex_lock(&drones->lock);
+    if (cell_rects)
+        return 0;
 
-    // Iterate through all drones in the list
     // clang-format off
-    Node *current = drones->head;
+    cell_rects = malloc(BATCH_CAPACITY * sizeof(SDL_Rect));
     // clang-format on
-    while (current != NULL)
+    cell_marks = calloc(BATCH_CAPACITY, sizeof(unsigned int));
+    if (!cell_rects || !cell_marks)
     {
-        // clang-format off
-        Drone *d = (Drone *)current->data;
-        // clang-format on
-        // Lock this specific drone while drawing it
-        pthread_mutex_lock(&d->lock);
+        fprintf(stderr, "Failed to allocate cell batch; drawing cells one at a time\n");
+        free(cell_rects);
+        free(cell_marks);
+        cell_rects = NULL;
+        cell_marks = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Add a cell to the current batch unless it is outside the
+ *        viewport or already in it
+ *
+ * @param count In/out: rectangles in the batch
+ */
+static void batch_cell(int *count, int x, int y)
+{
+    // Boundary check to prevent invalid memory access
+    if (x < 0 || x >= map.height || y < 0 || y >= map.width || !cell_visible(x, y))
+    {
+        return;
+    }
+
+    int mark = (x - first_row) * (last_col - first_col + 1) + (y - first_col);
+    if (cell_marks[mark] == cell_batch || *count == BATCH_CAPACITY)
+        return;
+
+    cell_marks[mark] = cell_batch;
+    cell_rects[(*count)++] = map_rect(x, y, 1, 1, cell_gap());
+}
+
+/**
+ * @brief Fill every cell of the current batch in one call and start a
+ *        new batch
+ *
+ * @param count Rectangles in the batch
+ * @param color Color to fill the cells with
+ */
+static void flush_cells(int count, SDL_Color color)
+{
+    if (count > 0)
+    {
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRects(renderer, cell_rects, count);
+    }
+
+    // A new batch number empties the batch; clear the marks when it wraps
+    if (++cell_batch == 0)
+    {
+        memset(cell_marks, 0, BATCH_CAPACITY * sizeof(unsigned int));
+        cell_batch = 1;
+    }
+}
+
+/**
+ * @brief Tile level drawn at the current zoom
+ *
+ * The finest level whose tiles are at least MIN_CELL_PIXELS wide on
+ * screen, or the coarsest level if none is.
+ *
+ * @return The level, or NULL if the snapshot has no tile counts
+ */
+// clang-format off
+static const TileLevel *heatmap_level(const WorldSnapshot *snapshot)
+// clang-format on
+{
+    for (int level = 0; level < snapshot->tile_level_count; level++)
+    {
+        if (snapshot->tiles[level].span * zoom >= MIN_CELL_PIXELS)
+            return &snapshot->tiles[level];
+    }
+    return snapshot->tile_level_count ? &snapshot->tiles[snapshot->tile_level_count - 1] : NULL;
+}
 
-        if (d->status != DISCONNECTED)
+/**
+ * @brief Shade of a tile count, from 0 (faintest) to HEAT_SHADES - 1
+ *
+ * @param count Non-zero count of the tile
+ * @param densest Largest count of the visible tiles
+ */
+static int heat_shade(unsigned int count, unsigned int densest)
+{
+    return (int)(((unsigned long)count * HEAT_SHADES - 1) / densest);
+}
+
+/**
+ * @brief Draw per-tile counts as shades of one color
+ *
+ * Each visible tile with a non-zero count is filled with one of
+ * HEAT_SHADES shades, scaled to the largest visible count. Tiles are
+ * grouped by shade, so a frame costs one SDL_RenderFillRects call per
+ * shade and at most one rectangle per visible tile.
+ *
+ * @param tiles Tile level to draw
+ * @param counts Counts of that level (survivors or drones)
+ * @param color Color of the densest tiles
+ * @param inset Fraction of a tile left free on each side (0: whole tile)
+ */
+static void draw_heat(const TileLevel *tiles, const unsigned int *counts, SDL_Color color, double inset)
+{
+    int top = first_row / tiles->span;
+    int bottom = last_row / tiles->span;
+    int left = first_col / tiles->span;
+    int right = last_col / tiles->span;
+    if ((bottom - top + 1) * (right - left + 1) > BATCH_CAPACITY)
+        return;
+
+    unsigned int densest = 0;
+    for (int r = top; r <= bottom; r++)
+    {
+        for (int c = left; c <= right; c++)
         {
+            if (counts[r * tiles->cols + c] > densest)
+                densest = counts[r * tiles->cols + c];
+        }
+    }
+    if (densest == 0)
+        return;
 
-            // Choose color based on drone status
-            SDL_Color color = (d->status == IDLE) ? BLUE : GREEN;
+    // Count the tiles of each shade, then place each shade's rectangles
+    // in its own run of cell_rects
+    int shade_count[HEAT_SHADES] = { 0 };
+    for (int r = top; r <= bottom; r++)
+    {
+        for (int c = left; c <= right; c++)
+        {
+            unsigned int count = counts[r * tiles->cols + c];
+            if (count)
+                shade_count[heat_shade(count, densest)]++;
+        }
+    }
 
-            // Draw the drone
-            draw_cell(d->coord.x, d->coord.y, color);
+    int shade_start[HEAT_SHADES];
+    int shade_fill[HEAT_SHADES];
+    for (int shade = 0, start = 0; shade < HEAT_SHADES; shade++)
+    {
+        shade_start[shade] = shade_fill[shade] = start;
+        start += shade_count[shade];
+    }
 
-            // Draw mission line if on mission
-            if (d->status == ON_MISSION)
+    int border = (int)(tiles->span * zoom * inset);
+    for (int r = top; r <= bottom; r++)
+    {
+        for (int c = left; c <= right; c++)
+        {
+            unsigned int count = counts[r * tiles->cols + c];
+            if (!count)
+                continue;
+
+            int row = r * tiles->span;
+            int col = c * tiles->span;
+            int rows = row + tiles->span > map.height ? map.height - row : tiles->span;
+            int cols = col + tiles->span > map.width ? map.width - col : tiles->span;
+            SDL_Rect rect = map_rect(row, col, rows, cols, 0);
+            if (rect.w > 2 * border && rect.h > 2 * border)
             {
-                SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
-                SDL_RenderDrawLine(renderer,
-                                   d->coord.y * CELL_SIZE + CELL_SIZE / 2,
-                                   d->coord.x * CELL_SIZE + CELL_SIZE / 2,
-                                   d->target.y * CELL_SIZE + CELL_SIZE / 2,
-                                   d->target.x * CELL_SIZE + CELL_SIZE / 2);
+                rect.x += border;
+                rect.y += border;
+                rect.w -= 2 * border;
+                rect.h -= 2 * border;
             }
+            cell_rects[shade_fill[heat_shade(count, densest)]++] = rect;
         }
+    }
 
-        pthread_mutex_unlock(&d->lock);
-        current = current->next;
+    for (int shade = 0; shade < HEAT_SHADES; shade++)
+    {
+        if (shade_count[shade] == 0)
+            continue;
+
+        // Faintest shade at a quarter of the full color
+        int scale = 64 + 191 * shade / (HEAT_SHADES - 1);
+        SDL_SetRenderDrawColor(renderer, color.r * scale / 255, color.g * scale / 255, color.b * scale / 255, color.a);
+        SDL_RenderFillRects(renderer, cell_rects + shade_start[shade], shade_count[shade]);
     }
+}
 
-    pthread_mutex_unlock(&drones->lock);
+/**
+ * @brief Draw all drones with colors indicating their status
+ * 
+ * Blue for IDLE drones, Green for ON_MISSION drones
+ * Also draws lines between drones and their targets when on mission
+ *
+ * Each color is one SDL_RenderFillRects call covering every visible cell
+ * with a drone of that status. SDL has no call for separate line
+ * segments, so mission lines are still drawn one by one, with the color
+ * set once; lines entirely outside the viewport are skipped.
+ *
+ * Zoomed out below MIN_CELL_PIXELS, drone density per tile is drawn in
+ * shades of blue, inset so the survivor heatmap stays visible around it,
+ * and mission lines are left out.
+ */
+void draw_drones(const WorldSnapshot *snapshot)
+{
+    // The snapshot is owned by this thread, so no lock is needed
+    // clang-format off
+    const TileLevel *tiles = detail_view() ? NULL : heatmap_level(snapshot);
+    // clang-format on
+    if (tiles && reserve_cell_batch() == 0)
+    {
+        draw_heat(tiles, tiles->drones, BLUE, 0.25);
+        return;
+    }
+
+    if (!detail_view() || reserve_cell_batch() != 0)
+    {
+        for (int i = 0; i < snapshot->drone_count; i++)
+        {
+            draw_cell(snapshot->drones[i].coord.x, snapshot->drones[i].coord.y,
+                      snapshot->drones[i].on_mission ? GREEN : BLUE);
+        }
+    }
+    else
+    {
+        for (int on_mission = 0; on_mission <= 1; on_mission++)
+        {
+            int count = 0;
+            for (int i = 0; i < snapshot->drone_count; i++)
+            {
+                if (snapshot->drones[i].on_mission == on_mission)
+                    batch_cell(&count, snapshot->drones[i].coord.x, snapshot->drones[i].coord.y);
+            }
+            flush_cells(count, on_mission ? GREEN : BLUE);
+        }
+    }
+
+    // Draw mission lines
+    SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
+    for (int i = 0; i < snapshot->drone_count; i++)
+    {
+        // clang-format off
+        const SnapshotDrone *d = &snapshot->drones[i];
+        // clang-format on
+        if (!d->on_mission || (d->coord.x < first_row && d->target.x < first_row) ||
+            (d->coord.x > last_row && d->target.x > last_row) || (d->coord.y < first_col && d->target.y < first_col) ||
+            (d->coord.y > last_col && d->target.y > last_col))
+        {
+            continue;
+        }
+
+        SDL_Rect from = map_rect(d->coord.x, d->coord.y, 1, 1, 0);
+        SDL_Rect to = map_rect(d->target.x, d->target.y, 1, 1, 0);
+        SDL_RenderDrawLine(renderer, from.x + from.w / 2, from.y + from.h / 2, to.x + to.w / 2, to.y + to.h / 2);
+    }
 }
 
 /**
  * @brief Draw all active survivors on the map in red
  * 
- * Only draws survivors with status 0 (waiting) or 1 (being helped)
+ * The snapshot only holds survivors with status 0 (waiting) or 1 (being helped)
+ *
+ * Survivors sharing a cell are drawn once, so a frame costs at most one
+ * rectangle per visible cell however many survivors there are, and all
+ * of them go to the renderer in one SDL_RenderFillRects call. Zoomed out
+ * below MIN_CELL_PIXELS, survivor density per tile is drawn in shades of
+ * red instead.
  */
-void draw_survivors()
+void draw_survivors(const WorldSnapshot *snapshot)
 {
-    // Lock the mutex before accessing the survivor array
-    pthread_mutex_lock(&survivors_mutex);
+    // clang-format off
+    const TileLevel *tiles = detail_view() ? NULL : heatmap_level(snapshot);
+    // clang-format on
+    if (tiles && reserve_cell_batch() == 0)
+    {
+        draw_heat(tiles, tiles->survivors, RED, 0);
+        return;
+    }
 
-    // Draw each survivor in the array
-    for (int i = 0; i < num_survivors; i++)
+    if (!detail_view() || reserve_cell_batch() != 0)
     {
-        // Only draw survivors that are waiting for help (status 0) or being helped (status 1)
-        // Don't draw rescued survivors (status 2 or 3)
-        if (survivor_array[i].status == 0 || survivor_array[i].status == 1)
+        for (int i = 0; i < snapshot->survivor_count; i++)
         {
-            draw_cell(survivor_array[i].coord.x, survivor_array[i].coord.y, RED);
+            draw_cell(snapshot->survivors[i].x, snapshot->survivors[i].y, RED);
         }
+        return;
+    }
+
+    int count = 0;
+    for (int i = 0; i < snapshot->survivor_count; i++)
+    {
+        batch_cell(&count, snapshot->survivors[i].x, snapshot->survivors[i].y);
+    }
+    flush_cells(count, RED);
+}
+
+/**
+ * @brief Draw the grid lines of the visible cells
+ *
+ * One SDL_RenderDrawLines call per direction: the points zigzag along the
+ * edges of the visible cells, so the connecting segments run along the
+ * border and every other segment is a grid line. Lines are only drawn
+ * from GRID_MIN_ZOOM, so there are never more than GRID_MAX_LINES of them
+ * per direction.
+ */
+static void draw_grid_lines(void)
+{
+    SDL_Point points[2 * GRID_MAX_LINES];
+    SDL_Rect visible = map_rect(first_row, first_col, last_row - first_row + 1, last_col - first_col + 1, 0);
+    int right = visible.x + visible.w;
+    int bottom = visible.y + visible.h;
+
+    SDL_SetRenderDrawColor(renderer, WHITE.r, WHITE.g, WHITE.b, WHITE.a);
+
+    // Horizontal grid lines, alternately left to right and right to left
+    int count = 0;
+    for (int i = first_row; i <= last_row + 1 && count < 2 * GRID_MAX_LINES; i++)
+    {
+        int left_first = i % 2 == 0;
+        int y = map_rect(i, 0, 1, 1, 0).y;
+        points[count++] = (SDL_Point){ left_first ? visible.x : right, y };
+        points[count++] = (SDL_Point){ left_first ? right : visible.x, y };
     }
+    SDL_RenderDrawLines(renderer, points, count);
 
-    // Unlock after reading the array
-    pthread_mutex_unlock(&survivors_mutex);
+    // Vertical grid lines, alternately top to bottom and bottom to top
+    count = 0;
+    for (int j = first_col; j <= last_col + 1 && count < 2 * GRID_MAX_LINES; j++)
+    {
+        int top_first = j % 2 == 0;
+        int x = map_rect(0, j, 1, 1, 0).x;
+        points[count++] = (SDL_Point){ x, top_first ? visible.y : bottom };
+        points[count++] = (SDL_Point){ x, top_first ? bottom : visible.y };
+    }
+    SDL_RenderDrawLines(renderer, points, count);
+}
+
+/**
+ * @brief Draw everything that does not change between frames
+ *
+ * Black background and the info panel without its values.
+ */
+static void draw_static_elements(void)
+{
+    SDL_SetRenderDrawColor(renderer, BLACK.r, BLACK.g, BLACK.b, BLACK.a);
+    SDL_RenderClear(renderer);
+    draw_panel_chrome();
+}
+
+/**
+ * @brief Draw the static elements into the static layer texture
+ *
+ * @return 0 on success, -1 if the renderer cannot draw into textures
+ */
+static int build_static_layer(void)
+{
+    if (!SDL_RenderTargetSupported(renderer))
+        return -1;
+
+    if (!static_layer)
+    {
+        static_layer = SDL_CreateTexture(
+            renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, window_width, window_height);
+        if (!static_layer)
+        {
+            fprintf(stderr, "SDL_CreateTexture Error: %s\n", SDL_GetError());
+            return -1;
+        }
+    }
+
+    if (SDL_SetRenderTarget(renderer, static_layer) != 0)
+    {
+        fprintf(stderr, "SDL_SetRenderTarget Error: %s\n", SDL_GetError());
+        return -1;
+    }
+    draw_static_elements();
+    SDL_SetRenderTarget(renderer, NULL);
+
+    static_layer_valid = 1;
+    return 0;
 }
 
 /**
  * @brief Draw the grid lines that represent the map
  * 
- * Creates a visual grid for the map area
+ * Copies the static layer: info panel background and labels, and legend,
+ * drawn once on the first call and again only after the renderer lost its
+ * textures. Renderers without render target support draw the same
+ * elements directly every frame. Grid lines of the visible cells are then
+ * drawn over the map area when zoomed in to GRID_MIN_ZOOM or more.
  */
 void draw_grid()
 {
-    SDL_SetRenderDrawColor(renderer, WHITE.r, WHITE.g, WHITE.b, WHITE.a);
-
-    // Draw horizontal grid lines
-    for (int i = 0; i <= map.height; i++)
+    if (!static_layer_valid && !static_layer_failed && build_static_layer() != 0)
     {
-        SDL_RenderDrawLine(renderer, 0, i * CELL_SIZE, map.width * CELL_SIZE, i * CELL_SIZE);
+        fprintf(stderr, "Static layer unavailable; drawing panel every frame\n");
+        static_layer_failed = 1;
     }
 
-    // Draw vertical grid lines
-    for (int j = 0; j <= map.width; j++)
+    if (static_layer_valid)
+        SDL_RenderCopy(renderer, static_layer, NULL, NULL);
+    else
+        draw_static_elements();
+
+    if (zoom >= GRID_MIN_ZOOM)
     {
-        SDL_RenderDrawLine(renderer, j * CELL_SIZE, 0, j * CELL_SIZE, window_height);
+        SDL_Rect map_area = { 0, 0, view_width, view_height };
+        SDL_RenderSetClipRect(renderer, &map_area);
+        draw_grid_lines();
+        SDL_RenderSetClipRect(renderer, NULL);
     }
 }
 
@@ -617,14 +1342,21 @@ int draw_map()
     SDL_SetRenderDrawColor(renderer, BLACK.r, BLACK.g, BLACK.b, BLACK.a);
     SDL_RenderClear(renderer);
 
-    // Draw all elements
-    draw_survivors();
-    draw_drones();
+    // Draw all elements from the latest snapshot, clipped to the map viewport
+    // clang-format off
+    const WorldSnapshot *snapshot = world_snapshot_acquire(&world_snapshots);
+    // clang-format on
+    update_view();
     draw_grid();
+    SDL_Rect map_area = { 0, 0, view_width, view_height };
+    SDL_RenderSetClipRect(renderer, &map_area);
+    draw_survivors(snapshot);
+    draw_drones(snapshot);
+    SDL_RenderSetClipRect(renderer, NULL);
 
     // Update window title and draw the info panel
     update_window_title();
-    draw_info_panel();
+    draw_info_panel(snapshot);
 
     // Present the rendered frame
     SDL_RenderPresent(renderer);
@@ -682,10 +1414,55 @@ void draw_diagnostic()
     }
 }
 
+/**
+ * @brief Zoom or pan the view for a key press
+ *
+ * +/= and -, also on the keypad, zoom around the center of the viewport;
+ * arrow keys pan; 0 and Home show the whole map.
+ */
+static void handle_view_key(SDL_Keycode key)
+{
+    switch (key)
+    {
+        case SDLK_PLUS:
+        case SDLK_EQUALS:
+        case SDLK_KP_PLUS:
+            zoom_view(ZOOM_STEP, view_width / 2, view_height / 2);
+            break;
+        case SDLK_MINUS:
+        case SDLK_KP_MINUS:
+            zoom_view(1 / ZOOM_STEP, view_width / 2, view_height / 2);
+            break;
+        case SDLK_LEFT:
+            pan_view(-PAN_STEP, 0);
+            break;
+        case SDLK_RIGHT:
+            pan_view(PAN_STEP, 0);
+            break;
+        case SDLK_UP:
+            pan_view(0, -PAN_STEP);
+            break;
+        case SDLK_DOWN:
+            pan_view(0, PAN_STEP);
+            break;
+        case SDLK_0:
+        case SDLK_HOME:
+            zoom = fit_zoom();
+            view_row = 0;
+            view_col = 0;
+            update_view();
+            break;
+        default:
+            break;
+    }
+}
+
 /**
  * @brief Check SDL events for user input
  * 
- * Processes SDL events like window close or escape key
+ * Processes SDL events like window close or escape key, and the zoom and
+ * pan controls: mouse wheel, +/- and arrow keys, and dragging with the
+ * left mouse button.
  * 
  * @return 1 if quit requested, 0 otherwise
  */
@@ -697,6 +1474,41 @@ int check_events()
             return 1;
         if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)
             return 1;
+        if (event.type == SDL_KEYDOWN)
+            handle_view_key(event.key.keysym.sym);
+
+        // The wheel zooms around the cursor when it is over the map
+        if (event.type == SDL_MOUSEWHEEL && event.wheel.y != 0)
+        {
+            int x, y;
+            SDL_GetMouseState(&x, &y);
+            if (x >= view_width || y >= view_height)
+            {
+                x = view_width / 2;
+                y = view_height / 2;
+            }
+            zoom_view(event.wheel.y > 0 ? ZOOM_STEP : 1 / ZOOM_STEP, x, y);
+        }
+        if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT &&
+            event.button.x < view_width)
+            dragging = 1;
+        if (event.type == SDL_MOUSEBUTTONUP && event.button.button == SDL_BUTTON_LEFT)
+            dragging = 0;
+        if (event.type == SDL_MOUSEMOTION && dragging)
+            pan_view(-event.motion.xrel, -event.motion.yrel);
+
+        // Texture contents were lost: redraw the static layer, and after a
+        // device reset recreate every cached texture
+        if (event.type == SDL_RENDER_TARGETS_RESET)
+            static_layer_valid = 0;
+        if (event.type == SDL_RENDER_DEVICE_RESET)
+        {
+            text_cache_clear();
+            if (static_layer)
+                SDL_DestroyTexture(static_layer);
+            static_layer = NULL;
+            static_layer_valid = 0;
+        }
     }
     return 0;
 }
@@ -718,6 +1530,18 @@ void quit_all()
         TTF_CloseFont(font_bold);
     }
 
+    // Textures belong to the renderer, so free them first
+    text_cache_clear();
+    if (static_layer)
+    {
+        SDL_DestroyTexture(static_layer);
+        static_layer = NULL;
+    }
+    free(cell_rects);
+    free(cell_marks);
+    cell_rects = NULL;
+    cell_marks = NULL;
+
     if (renderer)
     {
         SDL_DestroyRenderer(renderer);
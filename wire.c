@@ -0,0 +1,201 @@
+/**
+ * @file wire.c
+ * @brief Compact binary encoding of the drone protocol
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the encoders and decoders declared in wire.h. Fields
+ * are written byte by byte in network order, so the layout does not depend
+ * on the host's endianness or structure padding.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup networking
+ */
+
+#include "headers/wire.h"
+#include "headers/drone.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/** @name Payload sizes of the fixed-layout messages
+ * @{ */
+#define WIRE_STATUS_UPDATE_SIZE 10
+#define WIRE_MISSION_COMPLETE_SIZE 9
+#define WIRE_ASSIGN_MISSION_SIZE 16
+/** @} */
+
+/**
+ * @brief Store a 32-bit value in network byte order
+ */
+static unsigned char *put_u32(unsigned char *p, unsigned long value)
+{
+    p[0] = (unsigned char)(value >> 24);
+    p[1] = (unsigned char)(value >> 16);
+    p[2] = (unsigned char)(value >> 8);
+    p[3] = (unsigned char)value;
+    return p + 4;
+}
+
+/**
+ * @brief Load a 32-bit value stored in network byte order
+ */
+static unsigned long get_u32(const unsigned char *p)
+{
+    return ((unsigned long)p[0] << 24) | ((unsigned long)p[1] << 16) | ((unsigned long)p[2] << 8) | p[3];
+}
+
+/**
+ * @brief Load a signed 32-bit value stored in network byte order
+ */
+static int get_i32(const unsigned char *p)
+{
+    return (int32_t)get_u32(p);
+}
+
+/**
+ * @brief Clamp a value into a single unsigned byte
+ */
+static unsigned char clamp_u8(int value)
+{
+    return value < 0 ? 0 : value > 255 ? 255 : (unsigned char)value;
+}
+
+/**
+ * @brief Write a message header
+ *
+ * @return Pointer to the first payload byte
+ */
+static unsigned char *put_header(char *buffer, WireMessageType type, size_t payload_length)
+{
+    unsigned char *p = (unsigned char *)buffer;
+    p[0] = WIRE_PROTOCOL_VERSION;
+    p[1] = (unsigned char)type;
+    p[2] = (unsigned char)(payload_length >> 8);
+    p[3] = (unsigned char)payload_length;
+    return p + WIRE_HEADER_SIZE;
+}
+
+int wire_frame_type(const char *data, size_t length)
+{
+    const unsigned char *p = (const unsigned char *)data;
+
+    if (length < WIRE_HEADER_SIZE || p[0] != WIRE_PROTOCOL_VERSION)
+    {
+        return -1;
+    }
+    if (WIRE_HEADER_SIZE + (((size_t)p[2] << 8) | p[3]) != length)
+    {
+        return -1;
+    }
+    return p[1];
+}
+
+size_t wire_encode_drone_message(char *buffer, const DroneMessage *message)
+{
+    unsigned char *p;
+
+    switch (message->type)
+    {
+        case DRONE_MSG_STATUS_UPDATE:
+            p = put_header(buffer, WIRE_STATUS_UPDATE, WIRE_STATUS_UPDATE_SIZE);
+            p = put_u32(p, (unsigned long)message->location.x);
+            p = put_u32(p, (unsigned long)message->location.y);
+            p[0] = clamp_u8(message->status);
+            p[1] = clamp_u8(message->battery);
+            return WIRE_HEADER_SIZE + WIRE_STATUS_UPDATE_SIZE;
+
+        case DRONE_MSG_MISSION_COMPLETE:
+            p = put_header(buffer, WIRE_MISSION_COMPLETE, WIRE_MISSION_COMPLETE_SIZE);
+            p = put_u32(p, (unsigned long)message->target.x);
+            p = put_u32(p, (unsigned long)message->target.y);
+            p[0] = message->success ? 1 : 0;
+            return WIRE_HEADER_SIZE + WIRE_MISSION_COMPLETE_SIZE;
+
+        case DRONE_MSG_HEARTBEAT_RESPONSE:
+            put_header(buffer, WIRE_HEARTBEAT_RESPONSE, 0);
+            return WIRE_HEADER_SIZE;
+
+        default:
+            return 0;
+    }
+}
+
+int wire_decode_drone_message(const char *data, size_t length, DroneMessage *message)
+{
+    int type = wire_frame_type(data, length);
+    const unsigned char *p = (const unsigned char *)data + WIRE_HEADER_SIZE;
+    size_t payload_length = length - WIRE_HEADER_SIZE;
+
+    if (type < 0)
+    {
+        return -1;
+    }
+
+    memset(message, 0, sizeof(DroneMessage));
+
+    switch (type)
+    {
+        case WIRE_STATUS_UPDATE:
+            if (payload_length < WIRE_STATUS_UPDATE_SIZE)
+                return -1;
+            message->type = DRONE_MSG_STATUS_UPDATE;
+            message->location.x = get_i32(p);
+            message->location.y = get_i32(p + 4);
+            message->battery = p[9];
+            message->fields = DRONE_FIELD_LOCATION | DRONE_FIELD_BATTERY;
+            if (p[8] == IDLE || p[8] == ON_MISSION)
+            {
+                message->status = p[8];
+                message->fields |= DRONE_FIELD_STATUS;
+            }
+            return 0;
+
+        case WIRE_MISSION_COMPLETE:
+            if (payload_length < WIRE_MISSION_COMPLETE_SIZE)
+                return -1;
+            message->type = DRONE_MSG_MISSION_COMPLETE;
+            message->target.x = get_i32(p);
+            message->target.y = get_i32(p + 4);
+            message->success = p[8] != 0;
+            message->fields = DRONE_FIELD_TARGET | DRONE_FIELD_SUCCESS;
+            return 0;
+
+        case WIRE_HEARTBEAT_RESPONSE:
+            message->type = DRONE_MSG_HEARTBEAT_RESPONSE;
+            return 0;
+
+        default:
+            // Unknown types are skipped, not treated as errors
+            message->type = DRONE_MSG_UNKNOWN;
+            return 0;
+    }
+}
+
+size_t wire_encode_assignment(char *buffer, const WireAssignment *assignment)
+{
+    unsigned char *p = put_header(buffer, WIRE_ASSIGN_MISSION, WIRE_ASSIGN_MISSION_SIZE);
+    p = put_u32(p, assignment->mission_id);
+    p = put_u32(p, (unsigned long)assignment->target.x);
+    p = put_u32(p, (unsigned long)assignment->target.y);
+    put_u32(p, (unsigned long)assignment->expiry);
+    return WIRE_HEADER_SIZE + WIRE_ASSIGN_MISSION_SIZE;
+}
+
+int wire_decode_assignment(const char *data, size_t length, WireAssignment *assignment)
+{
+    const unsigned char *p = (const unsigned char *)data + WIRE_HEADER_SIZE;
+
+    if (wire_frame_type(data, length) != WIRE_ASSIGN_MISSION || length < WIRE_HEADER_SIZE + WIRE_ASSIGN_MISSION_SIZE)
+    {
+        return -1;
+    }
+
+    assignment->mission_id = (unsigned int)get_u32(p);
+    assignment->target.x = get_i32(p + 4);
+    assignment->target.y = get_i32(p + 8);
+    assignment->expiry = (long)get_u32(p + 12);
+    return 0;
+}
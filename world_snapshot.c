@@ -0,0 +1,287 @@
+/**
+ * @file world_snapshot.c
+ * @brief Triple-buffered copies of the world for lock-free rendering
+ * @author Amar Daskin - Wilmer Cuevas - Jelsin Sanchez
+ * @version 0.1
+ * @date 2025-05-22
+ *
+ * Implementation of the buffer declared in world_snapshot.h. The middle
+ * slot index and the WORLD_SNAPSHOT_FRESH flag share one atomic word, so
+ * handing a snapshot over is a single atomic exchange on either side.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * @ingroup visualization
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "headers/world_snapshot.h"
+#include "headers/globals.h"
+#include "headers/server_throughput.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+WorldSnapshotBuffer world_snapshots;
+
+/** @brief Mask of the slot index in WorldSnapshotBuffer.middle */
+#define SLOT_MASK (WORLD_SNAPSHOT_FRESH - 1)
+
+void world_snapshot_init(WorldSnapshotBuffer *buffer)
+{
+    memset(buffer, 0, sizeof(*buffer));
+    buffer->back = 0;
+    atomic_init(&buffer->middle, 1);
+    buffer->front = 2;
+}
+
+/**
+ * @brief Free the tile levels of a snapshot
+ */
+static void free_tiles(WorldSnapshot *snapshot)
+{
+    for (int level = 0; level < snapshot->tile_level_count; level++)
+    {
+        free(snapshot->tiles[level].survivors);
+        free(snapshot->tiles[level].drones);
+    }
+    memset(snapshot->tiles, 0, sizeof(snapshot->tiles));
+    snapshot->tile_level_count = 0;
+}
+
+void world_snapshot_destroy(WorldSnapshotBuffer *buffer)
+{
+    for (int i = 0; i < WORLD_SNAPSHOT_SLOTS; i++)
+    {
+        free(buffer->slots[i].drones);
+        free(buffer->slots[i].survivors);
+        free_tiles(&buffer->slots[i]);
+    }
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+// clang-format off
+WorldSnapshot *world_snapshot_back(WorldSnapshotBuffer *buffer)
+// clang-format on
+{
+    return &buffer->slots[buffer->back];
+}
+
+void world_snapshot_publish(WorldSnapshotBuffer *buffer)
+{
+    buffer->slots[buffer->back].sequence = ++buffer->published;
+
+    // Release the filled snapshot and take whatever was in the middle
+    unsigned int previous =
+        atomic_exchange_explicit(&buffer->middle, buffer->back | WORLD_SNAPSHOT_FRESH, memory_order_acq_rel);
+    buffer->back = previous & SLOT_MASK;
+}
+
+// clang-format off
+const WorldSnapshot *world_snapshot_acquire(WorldSnapshotBuffer *buffer)
+// clang-format on
+{
+    if (atomic_load_explicit(&buffer->middle, memory_order_relaxed) & WORLD_SNAPSHOT_FRESH)
+    {
+        // Give back the snapshot drawn last and take the newest one
+        unsigned int latest = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+        buffer->front = latest & SLOT_MASK;
+    }
+    return &buffer->slots[buffer->front];
+}
+
+int world_snapshot_reserve(WorldSnapshot *snapshot, int drones, int survivors)
+{
+    if (drones > snapshot->drone_capacity)
+    {
+        int capacity = snapshot->drone_capacity ? snapshot->drone_capacity : 16;
+        while (capacity < drones)
+            capacity *= 2;
+        // clang-format off
+        SnapshotDrone *grown = realloc(snapshot->drones, capacity * sizeof(SnapshotDrone));
+        // clang-format on
+        if (!grown)
+            return -1;
+        snapshot->drones = grown;
+        snapshot->drone_capacity = capacity;
+    }
+
+    if (survivors > snapshot->survivor_capacity)
+    {
+        int capacity = snapshot->survivor_capacity ? snapshot->survivor_capacity : 64;
+        while (capacity < survivors)
+            capacity *= 2;
+        // clang-format off
+        Coord *grown = realloc(snapshot->survivors, capacity * sizeof(Coord));
+        // clang-format on
+        if (!grown)
+            return -1;
+        snapshot->survivors = grown;
+        snapshot->survivor_capacity = capacity;
+    }
+    return 0;
+}
+
+/**
+ * @brief Allocate the tile levels of a snapshot for a map size
+ *
+ * @return 0 on success, -1 on allocation failure (no levels left)
+ */
+static int allocate_tiles(WorldSnapshot *snapshot, int height, int width)
+{
+    int span = WORLD_TILE_SPAN;
+    int rows = (height + span - 1) / span;
+    int cols = (width + span - 1) / span;
+
+    for (int level = 0; level < WORLD_TILE_LEVELS; level++)
+    {
+        // clang-format off
+        TileLevel *tiles = &snapshot->tiles[level];
+        // clang-format on
+        tiles->span = span;
+        tiles->rows = rows;
+        tiles->cols = cols;
+        tiles->survivors = calloc((size_t)rows * cols, sizeof(unsigned int));
+        tiles->drones = calloc((size_t)rows * cols, sizeof(unsigned int));
+        snapshot->tile_level_count = level + 1;
+        if (!tiles->survivors || !tiles->drones)
+        {
+            free_tiles(snapshot);
+            return -1;
+        }
+
+        if (rows == 1 && cols == 1)
+            break;
+        span *= 2;
+        rows = (rows + 1) / 2;
+        cols = (cols + 1) / 2;
+    }
+    return 0;
+}
+
+int world_snapshot_build_tiles(WorldSnapshot *snapshot, int height, int width)
+{
+    // clang-format off
+    TileLevel *base = &snapshot->tiles[0];
+    // clang-format on
+    if (snapshot->tile_level_count == 0 || base->rows != (height + WORLD_TILE_SPAN - 1) / WORLD_TILE_SPAN ||
+        base->cols != (width + WORLD_TILE_SPAN - 1) / WORLD_TILE_SPAN)
+    {
+        free_tiles(snapshot);
+        if (allocate_tiles(snapshot, height, width) != 0)
+            return -1;
+    }
+
+    memset(base->survivors, 0, (size_t)base->rows * base->cols * sizeof(unsigned int));
+    memset(base->drones, 0, (size_t)base->rows * base->cols * sizeof(unsigned int));
+    for (int i = 0; i < snapshot->survivor_count; i++)
+    {
+        Coord c = snapshot->survivors[i];
+        if (c.x >= 0 && c.x < height && c.y >= 0 && c.y < width)
+            base->survivors[(c.x / WORLD_TILE_SPAN) * base->cols + c.y / WORLD_TILE_SPAN]++;
+    }
+    for (int i = 0; i < snapshot->drone_count; i++)
+    {
+        Coord c = snapshot->drones[i].coord;
+        if (c.x >= 0 && c.x < height && c.y >= 0 && c.y < width)
+            base->drones[(c.x / WORLD_TILE_SPAN) * base->cols + c.y / WORLD_TILE_SPAN]++;
+    }
+
+    // Each tile above is the sum of the (up to) 2x2 tiles below it
+    for (int level = 1; level < snapshot->tile_level_count; level++)
+    {
+        // clang-format off
+        const TileLevel *below = &snapshot->tiles[level - 1];
+        TileLevel *tiles = &snapshot->tiles[level];
+        // clang-format on
+        memset(tiles->survivors, 0, (size_t)tiles->rows * tiles->cols * sizeof(unsigned int));
+        memset(tiles->drones, 0, (size_t)tiles->rows * tiles->cols * sizeof(unsigned int));
+        for (int r = 0; r < below->rows; r++)
+        {
+            for (int c = 0; c < below->cols; c++)
+            {
+                tiles->survivors[(r / 2) * tiles->cols + c / 2] += below->survivors[r * below->cols + c];
+                tiles->drones[(r / 2) * tiles->cols + c / 2] += below->drones[r * below->cols + c];
+            }
+        }
+    }
+    return 0;
+}
+
+int world_snapshot_capture(WorldSnapshot *snapshot)
+{
+    int result = 0;
+
+    pthread_mutex_lock(&drones->lock);
+    snapshot->total_drones = drones->number_of_elements;
+    if (world_snapshot_reserve(snapshot, drones->number_of_elements, 0) != 0)
+        result = -1;
+
+    snapshot->drone_count = 0;
+    // clang-format off
+    Node *current = drones->head;
+    // clang-format on
+    for (; current && snapshot->drone_count < snapshot->drone_capacity; current = current->next)
+    {
+        // clang-format off
+        Drone *d = (Drone *)current->data;
+        // clang-format on
+        pthread_mutex_lock(&d->lock);
+        if (d->status != DISCONNECTED)
+        {
+            // clang-format off
+            SnapshotDrone *copy = &snapshot->drones[snapshot->drone_count++];
+            // clang-format on
+            copy->coord = d->coord;
+            copy->target = d->target;
+            copy->on_mission = d->status == ON_MISSION;
+        }
+        pthread_mutex_unlock(&d->lock);
+    }
+    pthread_mutex_unlock(&drones->lock);
+
+    pthread_mutex_lock(&survivors_mutex);
+    if (world_snapshot_reserve(snapshot, 0, survivor_store.status_count[0] + survivor_store.status_count[1]) != 0)
+        result = -1;
+
+    // Waiting (0) and being helped (1) survivors are drawn; rescued ones are not
+    snapshot->survivor_count = 0;
+    for (int status = 0; status <= 1; status++)
+    {
+        for (int i = survivor_store_next(&survivor_store, status, 0);
+             i >= 0 && snapshot->survivor_count < snapshot->survivor_capacity;
+             i = survivor_store_next(&survivor_store, status, i + 1))
+        {
+            snapshot->survivors[snapshot->survivor_count++] = (Coord){ survivor_store.x[i], survivor_store.y[i] };
+        }
+    }
+    pthread_mutex_unlock(&survivors_mutex);
+
+    // Tile counts come from the copies, so no lock is needed
+    if (world_snapshot_build_tiles(snapshot, map.height, map.width) != 0)
+        result = -1;
+
+    if (result != 0)
+    {
+        fprintf(stderr, "Failed to grow world snapshot; drawing a partial frame\n");
+        perf_record_error();
+    }
+    return result;
+}
+
+// clang-format off
+void *world_snapshot_publisher(void *arg)
+// clang-format on
+{
+    (void)arg;
+    struct timespec interval = { .tv_sec = 0, .tv_nsec = WORLD_SNAPSHOT_INTERVAL_MS * 1000000L };
+
+    while (running)
+    {
+        world_snapshot_capture(world_snapshot_back(&world_snapshots));
+        world_snapshot_publish(&world_snapshots);
+        nanosleep(&interval, NULL);
+    }
+    return NULL;
+}